@@ -0,0 +1,170 @@
+#include <nano/benchmark/benchmark.hpp>
+#include <nano/lib/config.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+nano::benchmark::key_generator::key_generator (uint64_t seed_a) :
+	seed{ seed_a }
+{
+}
+
+nano::keypair nano::benchmark::key_generator::operator() (uint32_t index) const
+{
+	return nano::keypair{ nano::deterministic_key (seed, index) };
+}
+
+double nano::benchmark::result::throughput () const
+{
+	auto const seconds = std::chrono::duration<double> (duration).count ();
+	return seconds > 0 ? operations / seconds : 0;
+}
+
+void nano::benchmark::result::set_latencies (std::vector<std::chrono::nanoseconds> samples)
+{
+	if (samples.empty ())
+	{
+		return;
+	}
+	std::sort (samples.begin (), samples.end ());
+	// Nearest rank percentile
+	auto percentile = [&samples] (double fraction) {
+		auto const rank = static_cast<std::size_t> (std::ceil (fraction * samples.size ()));
+		return samples[std::clamp<std::size_t> (rank, 1, samples.size ()) - 1];
+	};
+	latency_p50 = percentile (0.50);
+	latency_p99 = percentile (0.99);
+}
+
+boost::property_tree::ptree nano::benchmark::result::serialize () const
+{
+	boost::property_tree::ptree tree;
+	tree.put ("scenario", scenario);
+	tree.put ("operations", operations);
+	tree.put ("duration_ms", std::chrono::duration_cast<std::chrono::milliseconds> (duration).count ());
+	tree.put ("throughput", static_cast<uint64_t> (throughput ()));
+	tree.put ("latency_p50_us", std::chrono::duration_cast<std::chrono::microseconds> (latency_p50).count ());
+	tree.put ("latency_p99_us", std::chrono::duration_cast<std::chrono::microseconds> (latency_p99).count ());
+	tree.put ("rss_bytes", rss_bytes);
+	tree.put ("db_bytes", db_bytes);
+	return tree;
+}
+
+boost::property_tree::ptree nano::benchmark::serialize (nano::benchmark::config const & config, std::vector<nano::benchmark::result> const & results)
+{
+	boost::property_tree::ptree document;
+	document.put ("schema", schema_version);
+	document.put ("version", NANO_VERSION_STRING);
+	document.put ("seed", config.seed);
+	document.put ("count", config.count);
+	boost::property_tree::ptree results_l;
+	for (auto const & result : results)
+	{
+		results_l.push_back (std::make_pair ("", result.serialize ()));
+	}
+	document.add_child ("results", results_l);
+	return document;
+}
+
+bool nano::benchmark::comparison::regression () const
+{
+	return std::any_of (entries.begin (), entries.end (), [] (auto const & entry) { return entry.regression; });
+}
+
+nano::benchmark::comparison nano::benchmark::compare (boost::property_tree::ptree const & baseline, boost::property_tree::ptree const & current, double threshold)
+{
+	nano::benchmark::comparison result;
+	for (auto const & key : { "schema", "seed", "count" })
+	{
+		if (baseline.get<std::string> (key, "") != current.get<std::string> (key, ""))
+		{
+			result.error = std::string{ "Results differ in " } + key + " and cannot be compared";
+			return result;
+		}
+	}
+	// Metrics where a higher value is better, all others are better when lower
+	auto const higher_is_better = [] (std::string const & metric) { return metric == "throughput"; };
+	auto const metrics = { "throughput", "latency_p50_us", "latency_p99_us", "rss_bytes", "db_bytes" };
+	auto const baseline_results = baseline.get_child_optional ("results");
+	auto const current_results = current.get_child_optional ("results");
+	if (!baseline_results || !current_results)
+	{
+		result.error = "Missing results";
+		return result;
+	}
+	for (auto const & [unused, current_scenario] : *current_results)
+	{
+		auto const name = current_scenario.get<std::string> ("scenario", "");
+		auto const baseline_scenario = std::find_if (baseline_results->begin (), baseline_results->end (), [&name] (auto const & entry) {
+			return entry.second.template get<std::string> ("scenario", "") == name;
+		});
+		if (baseline_scenario == baseline_results->end ())
+		{
+			continue;
+		}
+		for (std::string const metric : metrics)
+		{
+			// Documents of the same schema always contain every metric, a missing or non numeric one means the document is malformed
+			auto const baseline_value = baseline_scenario->second.get_optional<double> (metric);
+			auto const current_value = current_scenario.get_optional<double> (metric);
+			if (!baseline_value || !current_value)
+			{
+				result.error = "Missing " + metric + " of scenario " + name + " in " + (baseline_value ? "current" : "baseline") + " results";
+				result.entries.clear ();
+				return result;
+			}
+			nano::benchmark::comparison::entry entry{ name, metric, *baseline_value, *current_value, 0, false };
+			if (entry.baseline > 0)
+			{
+				auto const difference = higher_is_better (metric) ? entry.current - entry.baseline : entry.baseline - entry.current;
+				entry.change = 100 * difference / entry.baseline;
+				entry.regression = entry.change < -threshold;
+			}
+			result.entries.push_back (entry);
+		}
+	}
+	return result;
+}
+
+uint64_t nano::benchmark::resident_memory ()
+{
+#if defined(__linux__)
+	// Second field is the number of resident pages
+	std::ifstream statm ("/proc/self/statm");
+	uint64_t size{ 0 };
+	uint64_t resident{ 0 };
+	statm >> size >> resident;
+	return resident * sysconf (_SC_PAGESIZE);
+#elif defined(_WIN32)
+	return 0;
+#else
+	// Only the peak is available, reported in bytes on macOS and kilobytes elsewhere
+	rusage usage;
+	getrusage (RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+	return usage.ru_maxrss;
+#else
+	return usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+uint64_t nano::benchmark::directory_size (std::filesystem::path const & path)
+{
+	uint64_t result{ 0 };
+	std::error_code ec;
+	for (auto const & entry : std::filesystem::recursive_directory_iterator (path, ec))
+	{
+		if (entry.is_regular_file (ec))
+		{
+			result += entry.file_size (ec);
+		}
+	}
+	return result;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+#include <nano/secure/common.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nano::benchmark
+{
+/** Version of the result document, bumped whenever a field changes its meaning so results of different versions are never compared */
+unsigned constexpr schema_version = 1;
+
+class config final
+{
+public:
+	/** Seed for all keys used by the scenarios, the same seed always produces the same ledger */
+	uint64_t seed{ 0 };
+	/** Number of measured operations, each scenario derives its workload from it */
+	std::size_t count{ 10000 };
+	/** Upper bound for the measured section of a single scenario */
+	std::chrono::seconds timeout{ 300 };
+	/** Scenarios simulating a network write the stats of every node to this file, if set */
+	std::filesystem::path node_stats;
+};
+
+/** Deterministic keys derived from the configured seed */
+class key_generator final
+{
+public:
+	explicit key_generator (uint64_t seed);
+	nano::keypair operator() (uint32_t index) const;
+
+private:
+	nano::raw_key seed;
+};
+
+/**
+ * Latencies of individual operations, started and finished from arbitrary threads.
+ * Observers recording into a tracker cannot be removed, the tracker has to outlive the nodes it observes.
+ */
+template <typename Key>
+class latency_tracker final
+{
+public:
+	/** Starts or restarts the operation identified by \p key */
+	void start (Key const & key)
+	{
+		auto const now = std::chrono::steady_clock::now ();
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		pending.insert_or_assign (key, now);
+	}
+
+	void finish (Key const & key)
+	{
+		auto const now = std::chrono::steady_clock::now ();
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		if (auto existing = pending.find (key); existing != pending.end ())
+		{
+			samples.push_back (now - existing->second);
+			pending.erase (existing);
+		}
+	}
+
+	/** Records an operation whose latency is already known */
+	void record (std::chrono::nanoseconds latency)
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		samples.push_back (latency);
+	}
+
+	std::size_t finished () const
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		return samples.size ();
+	}
+
+	std::vector<std::chrono::nanoseconds> take ()
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		return std::move (samples);
+	}
+
+private:
+	mutable nano::mutex mutex;
+	std::unordered_map<Key, std::chrono::steady_clock::time_point> pending;
+	std::vector<std::chrono::nanoseconds> samples;
+};
+
+class result final
+{
+public:
+	std::string scenario;
+	uint64_t operations{ 0 };
+	std::chrono::nanoseconds duration{ 0 };
+	std::chrono::nanoseconds latency_p50{ 0 };
+	std::chrono::nanoseconds latency_p99{ 0 };
+	/** Resident memory of the process at the end of the measured section */
+	uint64_t rss_bytes{ 0 };
+	/** Size of the data directory of the measured node */
+	uint64_t db_bytes{ 0 };
+
+	/** Operations per second */
+	double throughput () const;
+	void set_latencies (std::vector<std::chrono::nanoseconds> samples);
+	boost::property_tree::ptree serialize () const;
+};
+
+using scenario = std::function<nano::benchmark::result (nano::benchmark::config const &)>;
+
+/** All scenarios in the order they are run */
+std::vector<std::pair<std::string, nano::benchmark::scenario>> const & scenarios ();
+
+/** Builds the result document written by a run */
+boost::property_tree::ptree serialize (nano::benchmark::config const &, std::vector<nano::benchmark::result> const &);
+
+class comparison final
+{
+public:
+	class entry final
+	{
+	public:
+		std::string scenario;
+		std::string metric;
+		double baseline;
+		double current;
+		/** Relative change in percent, positive values are improvements */
+		double change;
+		bool regression;
+	};
+
+	std::vector<entry> entries;
+	/** Set if the documents cannot be compared, e.g. because they were produced with a different seed */
+	std::string error;
+
+	bool regression () const;
+};
+
+/**
+ * Compares two result documents metric by metric. A metric regresses if it got worse by more than \p threshold percent.
+ * Scenarios missing from either document are skipped, a scenario present in both but missing a metric is an error.
+ */
+nano::benchmark::comparison compare (boost::property_tree::ptree const & baseline, boost::property_tree::ptree const & current, double threshold);
+
+uint64_t resident_memory ();
+uint64_t directory_size (std::filesystem::path const &);
+}
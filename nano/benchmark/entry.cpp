@@ -0,0 +1,171 @@
+#include <nano/benchmark/benchmark.hpp>
+#include <nano/lib/files.hpp>
+#include <nano/lib/logging.hpp>
+#include <nano/lib/memory.hpp>
+
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace nano
+{
+namespace test
+{
+	void cleanup_dev_directories_on_exit ();
+}
+void force_nano_dev_network ();
+}
+
+namespace
+{
+int compare (std::string const & baseline_path, std::string const & current_path, double threshold)
+{
+	boost::property_tree::ptree baseline;
+	boost::property_tree::ptree current;
+	try
+	{
+		boost::property_tree::read_json (baseline_path, baseline);
+		boost::property_tree::read_json (current_path, current);
+	}
+	catch (boost::property_tree::json_parser_error const & err)
+	{
+		std::cerr << err.what () << std::endl;
+		return 2;
+	}
+	auto const comparison = nano::benchmark::compare (baseline, current, threshold);
+	if (!comparison.error.empty ())
+	{
+		std::cerr << comparison.error << std::endl;
+		return 2;
+	}
+	std::cout << std::left << std::setw (20) << "scenario" << std::setw (16) << "metric" << std::right << std::setw (16) << "baseline" << std::setw (16) << "current" << std::setw (10) << "change" << std::endl;
+	for (auto const & entry : comparison.entries)
+	{
+		std::cout << std::left << std::setw (20) << entry.scenario << std::setw (16) << entry.metric << std::right << std::fixed << std::setprecision (0) << std::setw (16) << entry.baseline << std::setw (16) << entry.current << std::setprecision (1) << std::showpos << std::setw (9) << entry.change << "%" << std::noshowpos << (entry.regression ? " REGRESSION" : "") << std::endl;
+	}
+	return comparison.regression () ? 1 : 0;
+}
+}
+
+int main (int argc, char * const * argv)
+{
+	nano::initialize_file_descriptor_limit ();
+	nano::logger::initialize_for_tests (nano::log_config::tests_default ());
+	nano::force_nano_dev_network ();
+	nano::node_singleton_memory_pool_purge_guard memory_pool_cleanup_guard;
+
+	boost::program_options::options_description description ("Command line options");
+
+	// clang-format off
+	description.add_options ()
+		("help", "Print out options")
+		("list", "List available scenarios")
+		("scenario", boost::program_options::value<std::vector<std::string>> ()->multitoken (), "Scenarios to run, all scenarios are run if not specified")
+		("count", boost::program_options::value<std::size_t> ()->default_value (10000), "Number of measured operations per scenario")
+		("seed", boost::program_options::value<uint64_t> ()->default_value (0), "Seed for the keys of all generated accounts")
+		("timeout", boost::program_options::value<unsigned> ()->default_value (300), "Seconds after which a scenario is aborted")
+		("output", boost::program_options::value<std::string> (), "Write results to this file instead of stdout")
+		("node_stats", boost::program_options::value<std::string> (), "Write the stats of every node of simulated network scenarios to this file")
+		("compare", boost::program_options::value<std::vector<std::string>> ()->multitoken (), "Compare two result files <baseline> <current> instead of running scenarios, exits with 1 if any metric regressed")
+		("threshold", boost::program_options::value<double> ()->default_value (10.0), "Change in percent a metric may get worse by before it is reported as a regression");
+	// clang-format on
+
+	boost::program_options::variables_map vm;
+	try
+	{
+		boost::program_options::store (boost::program_options::parse_command_line (argc, argv, description), vm);
+	}
+	catch (boost::program_options::error const & err)
+	{
+		std::cerr << err.what () << std::endl;
+		return 2;
+	}
+	boost::program_options::notify (vm);
+
+	if (vm.count ("help"))
+	{
+		std::cout << description << std::endl;
+		return 0;
+	}
+	if (vm.count ("list"))
+	{
+		for (auto const & [name, scenario] : nano::benchmark::scenarios ())
+		{
+			std::cout << name << std::endl;
+		}
+		return 0;
+	}
+	if (vm.count ("compare"))
+	{
+		auto const & files = vm["compare"].as<std::vector<std::string>> ();
+		if (files.size () != 2)
+		{
+			std::cerr << "--compare requires a baseline and a current result file" << std::endl;
+			return 2;
+		}
+		return compare (files[0], files[1], vm["threshold"].as<double> ());
+	}
+
+	nano::benchmark::config config;
+	config.count = vm["count"].as<std::size_t> ();
+	config.seed = vm["seed"].as<uint64_t> ();
+	config.timeout = std::chrono::seconds (vm["timeout"].as<unsigned> ());
+	if (vm.count ("node_stats"))
+	{
+		config.node_stats = vm["node_stats"].as<std::string> ();
+	}
+
+	std::vector<std::string> selected;
+	if (vm.count ("scenario"))
+	{
+		selected = vm["scenario"].as<std::vector<std::string>> ();
+		for (auto const & name : selected)
+		{
+			auto const & scenarios = nano::benchmark::scenarios ();
+			if (std::none_of (scenarios.begin (), scenarios.end (), [&name] (auto const & scenario) { return scenario.first == name; }))
+			{
+				std::cerr << "Unknown scenario: " << name << std::endl;
+				return 2;
+			}
+		}
+	}
+
+	std::vector<nano::benchmark::result> results;
+	for (auto const & [name, scenario] : nano::benchmark::scenarios ())
+	{
+		if (!selected.empty () && std::find (selected.begin (), selected.end (), name) == selected.end ())
+		{
+			continue;
+		}
+		std::cerr << "Running " << name << "..." << std::endl;
+		try
+		{
+			results.push_back (scenario (config));
+		}
+		catch (std::exception const & ex)
+		{
+			std::cerr << "Scenario " << name << " failed: " << ex.what () << std::endl;
+			return 1;
+		}
+		auto const & result = results.back ();
+		std::cerr << boost::str (boost::format ("%1% operations in %2% ms, %3% per second, p50 %4% us, p99 %5% us\n") % result.operations % std::chrono::duration_cast<std::chrono::milliseconds> (result.duration).count () % static_cast<uint64_t> (result.throughput ()) % std::chrono::duration_cast<std::chrono::microseconds> (result.latency_p50).count () % std::chrono::duration_cast<std::chrono::microseconds> (result.latency_p99).count ());
+	}
+
+	auto const document = nano::benchmark::serialize (config, results);
+	if (vm.count ("output"))
+	{
+		std::ofstream output (vm["output"].as<std::string> ());
+		boost::property_tree::write_json (output, document);
+	}
+	else
+	{
+		boost::property_tree::write_json (std::cout, document);
+	}
+	nano::test::cleanup_dev_directories_on_exit ();
+	return 0;
+}
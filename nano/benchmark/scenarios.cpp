@@ -0,0 +1,579 @@
+#include <nano/benchmark/benchmark.hpp>
+#include <nano/lib/blockbuilders.hpp>
+#include <nano/node/block_processor.hpp>
+#include <nano/node/confirming_set.hpp>
+#include <nano/node/node_observers.hpp>
+#include <nano/node/rep_tiers.hpp>
+#include <nano/node/transport/fake.hpp>
+#include <nano/node/transport/tcp_socket.hpp>
+#include <nano/node/vote_processor.hpp>
+#include <nano/secure/ledger.hpp>
+#include <nano/secure/vote.hpp>
+#include <nano/test_common/simulator.hpp>
+#include <nano/test_common/system.hpp>
+#include <nano/test_common/testutil.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// Key indices of the different roles, kept apart so that scenarios never reuse an account for two purposes
+uint32_t constexpr account_index = 0;
+uint32_t constexpr destination_index = 1'000'000;
+uint32_t constexpr representative_index = 2'000'000;
+
+/**
+ * Builds state blocks on top of the frontiers it created, generating work up front so that it is never part of a measurement
+ */
+class block_factory final
+{
+public:
+	explicit block_factory (nano::work_pool & work_a) :
+		work{ work_a }
+	{
+		frontiers[nano::dev::genesis_key.pub] = { nano::dev::genesis->hash (), nano::dev::constants.genesis_amount, nano::dev::genesis_key.pub };
+	}
+
+	std::shared_ptr<nano::block> send (nano::keypair const & source, nano::account const & destination, nano::uint128_t const & amount)
+	{
+		auto & frontier = frontiers.at (source.pub);
+		auto block = make_send (source, frontier, destination, amount);
+		frontier = { block->hash (), frontier.balance - amount, frontier.representative };
+		return block;
+	}
+
+	/** Two sends competing for the current frontier of \p source, the frontier is not advanced */
+	std::pair<std::shared_ptr<nano::block>, std::shared_ptr<nano::block>> fork (nano::keypair const & source, nano::account const & destination_1, nano::account const & destination_2, nano::uint128_t const & amount)
+	{
+		auto const & frontier = frontiers.at (source.pub);
+		return { make_send (source, frontier, destination_1, amount), make_send (source, frontier, destination_2, amount) };
+	}
+
+	/** Receives \p send, opening the account of \p destination if it does not have a frontier yet */
+	std::shared_ptr<nano::block> receive (nano::keypair const & destination, nano::block_hash const & send, nano::uint128_t const & amount, nano::account const & representative)
+	{
+		auto existing = frontiers.find (destination.pub);
+		auto const previous = existing != frontiers.end () ? existing->second.hash : nano::block_hash{ 0 };
+		auto const balance = (existing != frontiers.end () ? existing->second.balance : nano::uint128_t{ 0 }) + amount;
+		auto block = builder.make_block ()
+					 .account (destination.pub)
+					 .previous (previous)
+					 .representative (representative)
+					 .link (send)
+					 .balance (balance)
+					 .sign (destination.prv, destination.pub)
+					 .work (*work.generate (previous.is_zero () ? nano::root{ destination.pub } : nano::root{ previous }))
+					 .build ();
+		frontiers[destination.pub] = { block->hash (), balance, representative };
+		return block;
+	}
+
+private:
+	class frontier final
+	{
+	public:
+		nano::block_hash hash;
+		nano::uint128_t balance;
+		nano::account representative;
+	};
+
+	std::shared_ptr<nano::block> make_send (nano::keypair const & source, frontier const & frontier_a, nano::account const & destination, nano::uint128_t const & amount)
+	{
+		return builder.make_block ()
+		.account (source.pub)
+		.previous (frontier_a.hash)
+		.representative (frontier_a.representative)
+		.link (destination)
+		.balance (frontier_a.balance - amount)
+		.sign (source.prv, source.pub)
+		.work (*work.generate (frontier_a.hash))
+		.build ();
+	}
+
+	nano::work_pool & work;
+	nano::state_block_builder builder;
+	std::unordered_map<nano::account, frontier> frontiers;
+};
+
+/** Sends \p amount from genesis to each of \p keys and opens their accounts, returns all blocks in processing order */
+std::vector<std::shared_ptr<nano::block>> open_accounts (block_factory & factory, std::vector<nano::keypair> const & keys, nano::uint128_t const & amount, bool own_representative)
+{
+	std::vector<std::shared_ptr<nano::block>> sends;
+	std::vector<std::shared_ptr<nano::block>> opens;
+	for (auto const & key : keys)
+	{
+		sends.push_back (factory.send (nano::dev::genesis_key, key.pub, amount));
+		opens.push_back (factory.receive (key, sends.back ()->hash (), amount, own_representative ? key.pub : nano::dev::genesis_key.pub));
+	}
+	sends.insert (sends.end (), opens.begin (), opens.end ());
+	return sends;
+}
+
+std::vector<nano::keypair> make_keys (nano::benchmark::config const & config, uint32_t first, std::size_t count)
+{
+	nano::benchmark::key_generator generator{ config.seed };
+	std::vector<nano::keypair> result;
+	result.reserve (count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		result.push_back (generator (first + static_cast<uint32_t> (i)));
+	}
+	return result;
+}
+
+void ensure (bool condition, std::string const & message)
+{
+	if (!condition)
+	{
+		throw std::runtime_error (message);
+	}
+}
+
+/** Queues \p block for processing, waiting for space if the queue is full */
+void add_block (nano::node & node, std::shared_ptr<nano::block> const & block)
+{
+	while (!node.block_processor.add (block, nano::block_source::local))
+	{
+		std::this_thread::sleep_for (1ms);
+	}
+}
+
+/** Runs \p execute and polls until \p done returns true, the measured duration covers both */
+void measure (nano::test::system & system, nano::benchmark::config const & config, nano::benchmark::result & result, std::function<void ()> const & execute, std::function<bool ()> const & done)
+{
+	auto const start = std::chrono::steady_clock::now ();
+	execute ();
+	auto ec = system.poll_until_true (config.timeout, done);
+	result.duration = std::chrono::steady_clock::now () - start;
+	ensure (!ec, result.scenario + " did not finish within " + std::to_string (config.timeout.count ()) + " seconds");
+}
+
+template <typename Key>
+void finish (nano::benchmark::result & result, nano::node & node, nano::benchmark::latency_tracker<Key> & latencies)
+{
+	result.set_latencies (latencies.take ());
+	result.rss_bytes = nano::benchmark::resident_memory ();
+	result.db_bytes = nano::benchmark::directory_size (node.application_path);
+}
+
+/*
+ * Processes `count` blocks through the block processor, half of them sends from genesis and half of them opening the receiving accounts.
+ * Latency is the time a block spent in the block processor queue and being processed.
+ */
+nano::benchmark::result send_receive (nano::benchmark::config const & config)
+{
+	nano::benchmark::result result{ .scenario = "send_receive" };
+	nano::benchmark::latency_tracker<nano::block_hash> latencies;
+	std::atomic<uint64_t> processed{ 0 };
+	std::atomic<uint64_t> failed{ 0 };
+	nano::test::system system;
+	auto & node = *system.add_node ();
+
+	block_factory factory{ system.work };
+	auto const blocks = open_accounts (factory, make_keys (config, account_index, config.count / 2), nano::Knano_ratio, false);
+
+	node.block_processor.batch_processed.add ([&] (auto const & batch) {
+		auto const now = std::chrono::steady_clock::now ();
+		for (auto const & [status, context] : batch)
+		{
+			latencies.record (now - context.arrival);
+			if (status == nano::block_status::progress)
+			{
+				++processed;
+			}
+			else
+			{
+				++failed;
+			}
+		}
+	});
+	measure (
+	system, config, result, [&] () {
+		for (auto const & block : blocks)
+		{
+			add_block (node, block);
+		}
+	},
+	[&] () { return processed + failed >= blocks.size (); });
+	ensure (failed == 0, "Blocks failed to process");
+
+	result.operations = blocks.size ();
+	finish (result, node, latencies);
+	return result;
+}
+
+/*
+ * Publishes two competing sends for each of `count / 10` cemented accounts to a node voting with the genesis weight.
+ * Latency is the time from publishing a fork until the winner is cemented.
+ */
+nano::benchmark::result forks (nano::benchmark::config const & config)
+{
+	nano::benchmark::result result{ .scenario = "forks" };
+	nano::benchmark::latency_tracker<nano::account> latencies;
+	nano::test::system system;
+	auto node_config = system.default_config ();
+	node_config.enable_voting = true;
+	auto & node = *system.add_node (node_config, nano::node_flags{}, nano::transport::transport_type::tcp, nano::dev::genesis_key);
+
+	block_factory factory{ system.work };
+	auto const keys = make_keys (config, account_index, std::max<std::size_t> (config.count / 10, 1));
+	auto const setup = open_accounts (factory, keys, nano::Knano_ratio, false);
+	ensure (nano::test::process (node, setup), "Setup blocks failed to process");
+	nano::test::confirm (node.ledger, setup);
+	std::vector<std::pair<std::shared_ptr<nano::block>, std::shared_ptr<nano::block>>> forks;
+	auto const destinations = make_keys (config, destination_index, 2);
+	for (auto const & key : keys)
+	{
+		forks.push_back (factory.fork (key, destinations[0].pub, destinations[1].pub, nano::raw_ratio));
+	}
+
+	node.confirming_set.batch_cemented.add ([&latencies] (auto const & cemented) {
+		for (auto const & context : cemented)
+		{
+			latencies.finish (context.block->account ());
+		}
+	});
+	measure (
+	system, config, result, [&] () {
+		for (auto const & [first, second] : forks)
+		{
+			latencies.start (first->account ());
+			node.process_active (first);
+			node.process_active (second);
+		}
+	},
+	[&] () { return latencies.finished () >= forks.size (); });
+
+	result.operations = forks.size ();
+	finish (result, node, latencies);
+	return result;
+}
+
+/*
+ * Floods the vote processor with `count` votes from 8 representatives, each vote for a single unconfirmed block.
+ * Latency is the time from queueing a vote until it was processed.
+ */
+nano::benchmark::result vote_flood (nano::benchmark::config const & config)
+{
+	nano::benchmark::result result{ .scenario = "vote_flood" };
+	nano::benchmark::latency_tracker<nano::vote const *> latencies;
+	nano::test::system system;
+	auto & node = *system.add_node ();
+
+	block_factory factory{ system.work };
+	auto const representatives = make_keys (config, representative_index, 8);
+	auto setup = open_accounts (factory, representatives, nano::dev::constants.genesis_amount / 16, true);
+	ensure (nano::test::process (node, setup), "Setup blocks failed to process");
+	nano::test::confirm (node.ledger, setup);
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	for (auto const & destination : make_keys (config, destination_index, std::max<std::size_t> (config.count / representatives.size (), 1)))
+	{
+		blocks.push_back (factory.send (nano::dev::genesis_key, destination.pub, nano::raw_ratio));
+	}
+	ensure (nano::test::process (node, blocks), "Voted blocks failed to process");
+	// Votes of representatives without a tier are queued separately with a much smaller limit
+	auto ec = system.poll_until_true (10s, [&] () {
+		return std::all_of (representatives.begin (), representatives.end (), [&node] (auto const & representative) {
+			return node.rep_tiers.tier (representative.pub) != nano::rep_tier::none;
+		});
+	});
+	ensure (!ec, "Representative tiers were not calculated");
+	std::vector<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> votes;
+	std::vector<std::shared_ptr<nano::transport::channel>> channels;
+	for (auto const & representative : representatives)
+	{
+		channels.push_back (nano::test::fake_channel (node, representative.pub));
+	}
+	for (auto const & block : blocks)
+	{
+		for (std::size_t i = 0; i < representatives.size (); ++i)
+		{
+			votes.emplace_back (nano::test::make_vote (representatives[i], { block->hash () }, nano::vote::timestamp_min), channels[i]);
+		}
+	}
+
+	node.observers.vote.add ([&latencies] (std::shared_ptr<nano::vote> const & vote, auto const &, auto, auto) {
+		latencies.finish (vote.get ());
+	});
+	measure (
+	system, config, result, [&] () {
+		for (auto const & [vote, channel] : votes)
+		{
+			// Waiting for space in a full queue is part of the latency
+			latencies.start (vote.get ());
+			while (!node.vote_processor.vote (vote, channel))
+			{
+				std::this_thread::yield ();
+			}
+		}
+	},
+	[&] () { return latencies.finished () >= votes.size (); });
+
+	result.operations = votes.size ();
+	finish (result, node, latencies);
+	return result;
+}
+
+/*
+ * Bootstraps a fresh node from a node holding `count` blocks.
+ * Latency is the time a block spent in the block processor of the bootstrapping node.
+ */
+nano::benchmark::result bootstrap_serving (nano::benchmark::config const & config)
+{
+	nano::benchmark::result result{ .scenario = "bootstrap_serving" };
+	nano::benchmark::latency_tracker<nano::block_hash> latencies;
+	nano::test::system system;
+	auto & server = *system.add_node ();
+
+	block_factory factory{ system.work };
+	auto const blocks = open_accounts (factory, make_keys (config, account_index, config.count / 2), nano::Knano_ratio, false);
+	ensure (nano::test::process (server, blocks), "Served blocks failed to process");
+
+	auto & client = *system.make_disconnected_node ();
+	client.block_processor.batch_processed.add ([&latencies] (auto const & batch) {
+		auto const now = std::chrono::steady_clock::now ();
+		for (auto const & [status, context] : batch)
+		{
+			latencies.record (now - context.arrival);
+		}
+	});
+	measure (
+	system, config, result, [&] () {
+		client.network.merge_peer (server.network.endpoint ());
+	},
+	[&] () { return client.ledger.block_count () >= server.ledger.block_count (); });
+
+	result.operations = blocks.size ();
+	finish (result, client, latencies);
+	return result;
+}
+
+/*
+ * Cements `count` blocks, the open blocks of `count / 2` accounts are added to the confirming set which cements their sources as dependencies.
+ * Latency is the time from adding an open block until it was cemented.
+ */
+nano::benchmark::result cementing (nano::benchmark::config const & config)
+{
+	nano::benchmark::result result{ .scenario = "cementing" };
+	nano::benchmark::latency_tracker<nano::block_hash> latencies;
+	nano::test::system system;
+	auto node_config = system.default_config ();
+	// Elections started by the backlog scan would compete with the measured cementing
+	node_config.backlog_scan.enable = false;
+	auto & node = *system.add_node (node_config);
+
+	block_factory factory{ system.work };
+	auto const blocks = open_accounts (factory, make_keys (config, account_index, config.count / 2), nano::Knano_ratio, false);
+	ensure (nano::test::process (node, blocks), "Blocks failed to process");
+	auto const cemented = node.ledger.cemented_count ();
+
+	node.confirming_set.batch_cemented.add ([&latencies] (auto const & batch) {
+		for (auto const & context : batch)
+		{
+			latencies.finish (context.block->hash ());
+		}
+	});
+	measure (
+	system, config, result, [&] () {
+		// Open blocks are in the second half
+		for (auto i = blocks.begin () + blocks.size () / 2, n = blocks.end (); i != n; ++i)
+		{
+			latencies.start ((*i)->hash ());
+			node.confirming_set.add ((*i)->hash ());
+		}
+	},
+	[&] () { return node.ledger.cemented_count () >= cemented + blocks.size (); });
+
+	result.operations = blocks.size ();
+	finish (result, node, latencies);
+	return result;
+}
+
+/*
+ * Streams `count` keepalive messages over 256 loopback connections served by the io_context of a node, eight messages in flight per connection.
+ * Compare the results of builds configured with and without NANO_IO_URING to compare the epoll and io_uring backends.
+ * Latency is the time from queueing a message until its write completed.
+ */
+nano::benchmark::result loopback_peers (nano::benchmark::config const & config)
+{
+	std::size_t constexpr peer_count = 256;
+	std::size_t constexpr window = 8;
+
+	nano::benchmark::result result{ .scenario = "loopback_peers" };
+	nano::benchmark::latency_tracker<uint64_t> latencies;
+	nano::test::system system;
+	auto & node = *system.add_node ();
+	auto const message = nano::keepalive{ node.network_params.network }.to_shared_const_buffer ();
+
+	boost::asio::ip::tcp::acceptor acceptor{ node.io_ctx, { boost::asio::ip::address_v6::loopback (), 0 } };
+	std::vector<std::shared_ptr<nano::transport::tcp_socket>> clients;
+	std::vector<std::shared_ptr<nano::transport::tcp_socket>> servers;
+	for (std::size_t i = 0; i < peer_count; ++i)
+	{
+		auto client = std::make_shared<nano::transport::tcp_socket> (node);
+		std::atomic<bool> connected{ false };
+		std::atomic<bool> failed{ false };
+		client->async_connect (acceptor.local_endpoint (), [&] (boost::system::error_code const & ec) {
+			(ec ? failed : connected) = true;
+		});
+		boost::asio::ip::tcp::socket raw{ node.io_ctx };
+		acceptor.accept (raw);
+		ensure (!system.poll_until_true (5s, [&] () { return connected || failed; }) && connected, "Loopback connection failed");
+		auto const remote = raw.remote_endpoint ();
+		auto const local = raw.local_endpoint ();
+		servers.push_back (std::make_shared<nano::transport::tcp_socket> (node, std::move (raw), remote, local));
+		clients.push_back (client);
+	}
+
+	// Servers read whatever is available until the connection is closed
+	std::atomic<uint64_t> received{ 0 };
+	std::function<void (std::shared_ptr<nano::transport::tcp_socket> const &, std::shared_ptr<std::vector<uint8_t>> const &)> read_loop;
+	read_loop = [&received, &read_loop] (auto const & socket, auto const & buffer) {
+		socket->async_read_some (buffer, 0, 1, [&received, &read_loop, socket, buffer] (boost::system::error_code const & ec, std::size_t size) {
+			if (!ec)
+			{
+				received += size;
+				read_loop (socket, buffer);
+			}
+		});
+	};
+	for (auto const & server : servers)
+	{
+		read_loop (server, std::make_shared<std::vector<uint8_t>> (64 * 1024));
+	}
+
+	// Every client keeps a window of messages queued, queueing the next one when a write completes
+	auto const per_peer = std::max<std::size_t> (config.count / peer_count, 1);
+	auto const total = per_peer * peer_count;
+	std::atomic<uint64_t> started{ 0 };
+	std::atomic<uint64_t> completed{ 0 };
+	std::atomic<uint64_t> failed{ 0 };
+	std::function<void (std::shared_ptr<nano::transport::tcp_socket> const &, std::shared_ptr<std::atomic<int64_t>> const &)> send;
+	send = [&] (auto const & socket, auto const & remaining) {
+		if (remaining->fetch_sub (1) <= 0)
+		{
+			return;
+		}
+		++started;
+		socket->async_write (message, [&, socket, remaining, queued = std::chrono::steady_clock::now ()] (boost::system::error_code const & ec, std::size_t) {
+			latencies.record (std::chrono::steady_clock::now () - queued);
+			if (ec)
+			{
+				++failed;
+			}
+			else
+			{
+				send (socket, remaining);
+			}
+			++completed;
+		});
+	};
+	measure (
+	system, config, result, [&] () {
+		for (auto const & client : clients)
+		{
+			auto remaining = std::make_shared<std::atomic<int64_t>> (per_peer);
+			for (std::size_t i = 0; i < window; ++i)
+			{
+				send (client, remaining);
+			}
+		}
+	},
+	[&] () { return received >= total * message.size () || failed > 0; });
+
+	for (auto const & socket : clients)
+	{
+		socket->close ();
+	}
+	for (auto const & socket : servers)
+	{
+		socket->close ();
+	}
+	acceptor.close ();
+	// Write callbacks reference this frame
+	ensure (!system.poll_until_true (5s, [&] () { return completed == started; }), "Writes did not complete");
+	ensure (failed == 0, "Writes failed");
+
+	result.operations = total;
+	finish (result, node, latencies);
+	return result;
+}
+
+/*
+ * Floods `count / 100` sends from a node of a simulated network until all of its 32 nodes cemented them.
+ * Eight of the nodes are representatives, every node links to at least 8 peers with 50 ms latency and 10 MB/s.
+ * Latency is the time from flooding a block until the last node cemented it.
+ */
+nano::benchmark::result network_confirmation (nano::benchmark::config const & config)
+{
+	nano::benchmark::result result{ .scenario = "network_confirmation" };
+	nano::test::system system;
+	nano::test::simulator_config simulation;
+	simulation.nodes = 32;
+	simulation.representatives = 8;
+	simulation.peers = 8;
+	simulation.link.latency = 50ms;
+	simulation.link.bandwidth = 10 * 1024 * 1024;
+	simulation.seed = config.seed;
+	nano::test::simulator simulator{ system, simulation };
+	ensure (!simulator.wait_representatives (60s), "Representatives were not found");
+
+	// Blocks originate from a node that does not vote
+	auto const origin = simulation.representatives;
+	auto & node = simulator.node (origin);
+	nano::state_block_builder builder;
+	auto previous = node.latest (nano::dev::genesis_key.pub);
+	auto balance = node.balance (nano::dev::genesis_key.pub);
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	for (auto const & destination : make_keys (config, destination_index, std::max<std::size_t> (config.count / 100, 1)))
+	{
+		balance -= nano::raw_ratio;
+		blocks.push_back (builder.make_block ()
+						  .account (nano::dev::genesis_key.pub)
+						  .previous (previous)
+						  .representative (nano::dev::genesis_key.pub)
+						  .link (destination.pub)
+						  .balance (balance)
+						  .sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+						  .work (*system.work.generate (previous))
+						  .build ());
+		previous = blocks.back ()->hash ();
+	}
+
+	bool error = false;
+	measure (
+	system, config, result, [&] () {
+		error = simulator.confirm (blocks, origin, config.timeout);
+	},
+	[] () { return true; });
+	ensure (!error, "Blocks were not cemented by all nodes");
+	if (!config.node_stats.empty ())
+	{
+		ensure (!simulator.write_json (config.node_stats), "Node stats could not be written");
+	}
+
+	result.operations = blocks.size ();
+	result.set_latencies (simulator.network_latencies ());
+	result.rss_bytes = nano::benchmark::resident_memory ();
+	result.db_bytes = nano::benchmark::directory_size (node.application_path);
+	return result;
+}
+}
+
+std::vector<std::pair<std::string, nano::benchmark::scenario>> const & nano::benchmark::scenarios ()
+{
+	static std::vector<std::pair<std::string, nano::benchmark::scenario>> const result{
+		{ "send_receive", send_receive },
+		{ "forks", forks },
+		{ "vote_flood", vote_flood },
+		{ "bootstrap_serving", bootstrap_serving },
+		{ "cementing", cementing },
+		{ "loopback_peers", loopback_peers },
+		{ "network_confirmation", network_confirmation },
+	};
+	return result;
+}
@@ -0,0 +1,86 @@
+#include <nano/benchmark/benchmark.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace
+{
+boost::property_tree::ptree result_document (double throughput, double latency_p99_us)
+{
+	nano::benchmark::config config;
+	nano::benchmark::result result;
+	result.scenario = "scenario";
+	auto document = nano::benchmark::serialize (config, { result });
+	auto & scenario = document.get_child ("results").begin ()->second;
+	scenario.put ("throughput", throughput);
+	scenario.put ("latency_p50_us", 100);
+	scenario.put ("latency_p99_us", latency_p99_us);
+	scenario.put ("rss_bytes", 1000);
+	scenario.put ("db_bytes", 1000);
+	return document;
+}
+
+nano::benchmark::comparison::entry const & find_entry (nano::benchmark::comparison const & comparison, std::string const & metric)
+{
+	auto existing = std::find_if (comparison.entries.begin (), comparison.entries.end (), [&metric] (auto const & entry) {
+		return entry.metric == metric;
+	});
+	release_assert (existing != comparison.entries.end ());
+	return *existing;
+}
+}
+
+TEST (benchmark, compare)
+{
+	auto const baseline = result_document (1000, 100);
+	// Throughput improved by 10%, the p99 latency got 20% worse
+	auto const current = result_document (1100, 120);
+	auto const comparison = nano::benchmark::compare (baseline, current, 15);
+	ASSERT_TRUE (comparison.error.empty ());
+	ASSERT_EQ (5, comparison.entries.size ());
+	auto const & throughput = find_entry (comparison, "throughput");
+	ASSERT_DOUBLE_EQ (10, throughput.change);
+	ASSERT_FALSE (throughput.regression);
+	auto const & latency = find_entry (comparison, "latency_p99_us");
+	ASSERT_DOUBLE_EQ (-20, latency.change);
+	ASSERT_TRUE (latency.regression);
+	ASSERT_TRUE (comparison.regression ());
+	// Within the threshold nothing regresses
+	ASSERT_FALSE (nano::benchmark::compare (baseline, current, 25).regression ());
+	ASSERT_FALSE (nano::benchmark::compare (baseline, baseline, 0).regression ());
+}
+
+TEST (benchmark, compare_different_seed)
+{
+	auto const baseline = result_document (1000, 100);
+	auto current = result_document (1000, 100);
+	current.put ("seed", 1);
+	auto const comparison = nano::benchmark::compare (baseline, current, 15);
+	ASSERT_FALSE (comparison.error.empty ());
+	ASSERT_TRUE (comparison.entries.empty ());
+}
+
+TEST (benchmark, compare_missing_metric)
+{
+	auto const baseline = result_document (1000, 100);
+	auto current = result_document (1000, 100);
+	current.get_child ("results").begin ()->second.erase ("latency_p99_us");
+	auto const comparison = nano::benchmark::compare (baseline, current, 15);
+	ASSERT_FALSE (comparison.error.empty ());
+	ASSERT_TRUE (comparison.entries.empty ());
+	// Non numeric values are malformed the same as missing ones
+	current.get_child ("results").begin ()->second.put ("latency_p99_us", "fast");
+	ASSERT_FALSE (nano::benchmark::compare (baseline, current, 15).error.empty ());
+	ASSERT_FALSE (nano::benchmark::compare (current, baseline, 15).error.empty ());
+}
+
+TEST (benchmark, compare_missing_scenario)
+{
+	auto const baseline = result_document (1000, 100);
+	auto current = result_document (1000, 100);
+	current.get_child ("results").begin ()->second.put ("scenario", "other");
+	auto const comparison = nano::benchmark::compare (baseline, current, 15);
+	ASSERT_TRUE (comparison.error.empty ());
+	ASSERT_TRUE (comparison.entries.empty ());
+}
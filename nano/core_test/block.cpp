@@ -1,3 +1,4 @@
+#include <nano/crypto_lib/random_pool.hpp>
 #include <nano/lib/block_uniquer.hpp>
 #include <nano/lib/blocks.hpp>
 #include <nano/lib/stream.hpp>
@@ -28,6 +29,35 @@ TEST (ed25519, signing)
 	ASSERT_NE (0, valid2);
 }
 
+TEST (ed25519, batch)
+{
+	std::size_t const size (3);
+	std::vector<nano::keypair> keys (size);
+	std::vector<nano::block_hash> hashes;
+	std::vector<nano::signature> signatures;
+	for (auto const & key : keys)
+	{
+		hashes.push_back (nano::random_pool::generate<nano::block_hash> ());
+		signatures.push_back (nano::sign_message (key.prv, key.pub, hashes.back ()));
+	}
+	signatures[1].bytes[32] ^= 0x1;
+	std::vector<unsigned char const *> messages;
+	std::vector<size_t> lengths (size, sizeof (nano::block_hash));
+	std::vector<unsigned char const *> pub_keys;
+	std::vector<unsigned char const *> signature_bytes;
+	for (std::size_t i (0); i < size; ++i)
+	{
+		messages.push_back (hashes[i].bytes.data ());
+		pub_keys.push_back (keys[i].pub.bytes.data ());
+		signature_bytes.push_back (signatures[i].bytes.data ());
+	}
+	std::vector<int> valid (size, 0);
+	nano::validate_message_batch (messages.data (), lengths.data (), pub_keys.data (), signature_bytes.data (), size, valid.data ());
+	ASSERT_EQ (1, valid[0]);
+	ASSERT_EQ (0, valid[1]);
+	ASSERT_EQ (1, valid[2]);
+}
+
 TEST (transaction_block, empty)
 {
 	nano::keypair key1;
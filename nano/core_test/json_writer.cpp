@@ -0,0 +1,193 @@
+#include <nano/lib/json_writer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+std::string to_json (boost::property_tree::ptree const & tree)
+{
+	std::stringstream ostream;
+	boost::property_tree::write_json (ostream, tree);
+	return ostream.str ();
+}
+}
+
+TEST (json_writer, empty)
+{
+	nano::json_writer writer;
+	ASSERT_TRUE (writer.empty ());
+	ASSERT_EQ (to_json ({}), writer.finish ());
+}
+
+TEST (json_writer, values)
+{
+	boost::property_tree::ptree tree;
+	tree.put ("account", "nano_1111");
+	tree.put ("balance", "1000");
+	tree.put ("confirmed", true);
+
+	nano::json_writer writer;
+	writer.put ("account", "nano_1111");
+	writer.put ("balance", "1000");
+	writer.put ("confirmed", "true");
+	ASSERT_FALSE (writer.empty ());
+	ASSERT_EQ (to_json (tree), writer.finish ());
+}
+
+TEST (json_writer, escapes)
+{
+	std::string value{ "quote\" backslash\\ slash/ \b\f\n\r\t control\x01\x1f del\x7f utf8\xc3\xa9" };
+	boost::property_tree::ptree tree;
+	tree.put ("key\"/", value);
+	boost::property_tree::ptree array;
+	boost::property_tree::ptree entry;
+	entry.put ("", value);
+	array.push_back (std::make_pair ("", entry));
+	tree.add_child ("array", array);
+
+	nano::json_writer writer;
+	writer.put ("key\"/", value);
+	writer.begin_array ("array");
+	writer.push (value);
+	writer.end ();
+	ASSERT_EQ (to_json (tree), writer.finish ());
+}
+
+TEST (json_writer, nested)
+{
+	boost::property_tree::ptree tree;
+	tree.put ("deprecated", "1");
+	boost::property_tree::ptree blocks;
+	for (auto i = 0; i < 3; ++i)
+	{
+		boost::property_tree::ptree entry;
+		entry.put ("height", std::to_string (i));
+		boost::property_tree::ptree hashes;
+		for (auto j = 0; j < i; ++j)
+		{
+			boost::property_tree::ptree hash;
+			hash.put ("", std::to_string (j));
+			hashes.push_back (std::make_pair ("", hash));
+		}
+		entry.add_child ("hashes", hashes);
+		blocks.push_back (std::make_pair ("block" + std::to_string (i), entry));
+	}
+	tree.add_child ("blocks", blocks);
+	boost::property_tree::ptree history;
+	boost::property_tree::ptree item;
+	item.put ("type", "send");
+	history.push_back (std::make_pair ("", item));
+	history.push_back (std::make_pair ("", item));
+	tree.add_child ("history", history);
+	tree.put ("previous", "0");
+
+	nano::json_writer writer;
+	writer.put ("deprecated", "1");
+	writer.begin_object ("blocks");
+	for (auto i = 0; i < 3; ++i)
+	{
+		writer.begin_object ("block" + std::to_string (i));
+		writer.put ("height", std::to_string (i));
+		writer.begin_array ("hashes");
+		for (auto j = 0; j < i; ++j)
+		{
+			writer.push (std::to_string (j));
+		}
+		writer.end ();
+		writer.end ();
+	}
+	writer.end ();
+	writer.begin_array ("history");
+	writer.begin_object ();
+	writer.put ("type", "send");
+	writer.end ();
+	writer.push_tree (item);
+	writer.end ();
+	writer.put ("previous", "0");
+	ASSERT_EQ (to_json (tree), writer.finish ());
+}
+
+TEST (json_writer, empty_containers)
+{
+	boost::property_tree::ptree tree;
+	tree.add_child ("blocks", {});
+	tree.add_child ("history", {});
+
+	nano::json_writer writer;
+	writer.begin_object ("blocks");
+	writer.end ();
+	writer.begin_array ("history");
+	writer.end ();
+	writer.begin_object ("balances", true);
+	writer.end ();
+	writer.begin_array ("errors", true);
+	writer.end ();
+	ASSERT_EQ (to_json (tree), writer.finish ());
+}
+
+TEST (json_writer, omit_if_empty)
+{
+	nano::json_writer writer;
+	writer.begin_object ("balances", true);
+	writer.end ();
+	ASSERT_TRUE (writer.empty ());
+
+	boost::property_tree::ptree tree;
+	boost::property_tree::ptree balance;
+	balance.put ("balance", "1");
+	tree.add_child ("balances.account", balance);
+	writer.begin_object ("balances", true);
+	writer.begin_object ("account", true);
+	writer.put ("balance", "1");
+	writer.end ();
+	writer.end ();
+	ASSERT_EQ (to_json (tree), writer.finish ());
+}
+
+TEST (json_writer, trees)
+{
+	boost::property_tree::ptree contents;
+	contents.put ("type", "state");
+	contents.put ("link", "0");
+	contents.add_child ("empty", {});
+	boost::property_tree::ptree array;
+	boost::property_tree::ptree value;
+	value.put ("", "1");
+	array.push_back (std::make_pair ("", value));
+	contents.add_child ("array", array);
+
+	boost::property_tree::ptree response;
+	response.put ("deprecated", "1");
+	boost::property_tree::ptree tree;
+	tree.put ("deprecated", "1");
+	boost::property_tree::ptree blocks;
+	boost::property_tree::ptree entry;
+	entry.add_child ("contents", contents);
+	blocks.push_back (std::make_pair ("hash", entry));
+	blocks.push_back (std::make_pair ("empty", boost::property_tree::ptree{}));
+	tree.add_child ("blocks", blocks);
+	boost::property_tree::ptree list;
+	list.push_back (std::make_pair ("", contents));
+	list.push_back (std::make_pair ("", contents));
+	tree.add_child ("list", list);
+
+	nano::json_writer writer;
+	writer.put_children (response);
+	writer.begin_object ("blocks");
+	writer.begin_object ("hash");
+	writer.put_tree ("contents", contents);
+	writer.end ();
+	writer.put_tree ("empty", {});
+	writer.end ();
+	writer.begin_array ("list");
+	writer.push_tree (contents);
+	writer.push_tree (contents);
+	writer.end ();
+	ASSERT_EQ (to_json (tree), writer.finish ());
+}
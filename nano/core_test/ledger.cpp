@@ -21,6 +21,7 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
 #include <limits>
 
 using namespace std::chrono_literals;
@@ -4867,6 +4868,94 @@ TEST (ledger, cache)
 	}
 }
 
+TEST (ledger, cache_snapshot)
+{
+	auto ctx = nano::test::ledger_send_receive ();
+	auto & store = ctx.store ();
+	nano::stats stats{ ctx.logger () };
+	nano::generate_cache_flags flags;
+	flags.snapshot = nano::unique_path () / "ledger_cache.snapshot";
+	auto cache_check = [&ctx] (nano::ledger const & ledger) {
+		ASSERT_EQ (ctx.ledger ().account_count (), ledger.account_count ());
+		ASSERT_EQ (ctx.ledger ().block_count (), ledger.block_count ());
+		ASSERT_EQ (ctx.ledger ().cemented_count (), ledger.cemented_count ());
+		ASSERT_EQ (ctx.ledger ().weight (nano::dev::genesis_key.pub), ledger.weight (nano::dev::genesis_key.pub));
+	};
+	{
+		nano::ledger ledger{ store, stats, nano::dev::constants, flags };
+		ASSERT_EQ (1, stats.count (nano::stat::type::ledger, nano::stat::detail::snapshot_missing));
+		cache_check (ledger);
+		ASSERT_FALSE (ledger.write_cache_snapshot ());
+	}
+	// The database has not been written since, the cache is loaded from the snapshot
+	{
+		nano::ledger ledger{ store, stats, nano::dev::constants, flags };
+		ASSERT_EQ (1, stats.count (nano::stat::type::ledger, nano::stat::detail::snapshot_loaded));
+		cache_check (ledger);
+	}
+	// Any commit makes the snapshot stale
+	{
+		auto transaction = store.tx_begin_write ();
+		store.online_weight.put (transaction, 1, 1);
+	}
+	{
+		nano::ledger ledger{ store, stats, nano::dev::constants, flags };
+		ASSERT_EQ (1, stats.count (nano::stat::type::ledger, nano::stat::detail::snapshot_stale));
+		cache_check (ledger);
+		ASSERT_FALSE (ledger.write_cache_snapshot ());
+	}
+	// Corrupted snapshots fail the checksum
+	{
+		std::fstream file{ flags.snapshot, std::ios::binary | std::ios::in | std::ios::out };
+		file.seekp (sizeof (uint8_t) + sizeof (nano::block_hash) + sizeof (nano::uint256_union) + sizeof (uint64_t));
+		file.put (0x7f);
+	}
+	{
+		nano::ledger ledger{ store, stats, nano::dev::constants, flags };
+		ASSERT_EQ (1, stats.count (nano::stat::type::ledger, nano::stat::detail::snapshot_invalid));
+		ASSERT_EQ (1, stats.count (nano::stat::type::ledger, nano::stat::detail::snapshot_loaded));
+		cache_check (ledger);
+		ASSERT_FALSE (ledger.write_cache_snapshot ());
+	}
+	// A different database with the same commit sequence does not match the snapshot
+	auto other = nano::test::ledger_send_receive ();
+	while (other.store ().commit_sequence () < store.commit_sequence ())
+	{
+		auto transaction = other.store ().tx_begin_write ();
+		other.store ().online_weight.put (transaction, other.store ().commit_sequence (), 1);
+	}
+	ASSERT_EQ (store.commit_sequence (), other.store ().commit_sequence ());
+	{
+		nano::ledger ledger{ other.store (), stats, nano::dev::constants, flags };
+		ASSERT_EQ (2, stats.count (nano::stat::type::ledger, nano::stat::detail::snapshot_stale));
+	}
+}
+
+// Cache generation reports the progress of each table it traverses until all of its ranges are completed
+TEST (ledger, cache_generation_progress)
+{
+	auto ctx = nano::test::ledger_send_receive ();
+	nano::stats stats{ ctx.logger () };
+	nano::generate_cache_flags flags;
+	flags.threads = 2;
+	nano::mutex mutex;
+	std::map<std::string, std::pair<std::size_t, std::size_t>> progress;
+	flags.progress = [&] (std::string_view table, std::size_t completed, std::size_t total) {
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		auto & [completed_l, total_l] = progress[std::string{ table }];
+		completed_l = std::max (completed_l, completed);
+		total_l = total;
+	};
+	nano::ledger ledger{ ctx.store (), stats, nano::dev::constants, flags };
+	ASSERT_EQ (3, progress.size ());
+	for (auto const & table : { "account", "rep_weight", "confirmation_height" })
+	{
+		ASSERT_EQ (1, progress.count (table));
+		ASSERT_GT (progress[table].second, 0);
+		ASSERT_EQ (progress[table].second, progress[table].first);
+	}
+}
+
 TEST (ledger, pruning_action)
 {
 	nano::logger logger;
@@ -5508,11 +5597,45 @@ TEST (ledger, migrate_lmdb_to_rocksdb)
 	ASSERT_TRUE (rocksdb_store.final_vote.get (rocksdb_transaction, send->qualified_root ()).has_value ());
 	ASSERT_EQ (rocksdb_store.final_vote.get (rocksdb_transaction, send->qualified_root ()).value (), nano::block_hash (2));
 
+	// The migration directory is removed once the migration has completed
+	ASSERT_FALSE (std::filesystem::exists (path / "rocksdb_migration"));
+
 	// Retry migration while rocksdb folder is still present
 	auto error_on_retry = ledger.migrate_lmdb_to_rocksdb (path);
 	ASSERT_EQ (error_on_retry, true);
 }
 
+TEST (ledger, migrate_lmdb_to_rocksdb_resume)
+{
+	nano::test::system system{};
+	auto path = nano::unique_path ();
+	nano::logger logger;
+	nano::store::lmdb::component store{ logger, path / "data.ldb", nano::dev::constants };
+	nano::ledger ledger{ store, system.stats, nano::dev::constants };
+	{
+		auto transaction = ledger.tx_begin_write ();
+		store.initialize (transaction, ledger.cache, ledger.constants);
+	}
+
+	// Emulate a migration interrupted while writing the first range of the blocks table, after the RocksDB database has been created
+	std::filesystem::create_directories (path / "rocksdb_migration");
+	std::ofstream (path / "rocksdb_migration" / "checkpoint.json") << R"({ "threads": "1" })";
+	std::ofstream (path / "rocksdb_migration" / "blocks_0.sst.tmp") << "partial";
+	{
+		nano::store::rocksdb::component rocksdb_store{ logger, path / "rocksdb", nano::dev::constants };
+		ASSERT_FALSE (rocksdb_store.init_error ());
+	}
+
+	ASSERT_FALSE (ledger.migrate_lmdb_to_rocksdb (path));
+	ASSERT_FALSE (std::filesystem::exists (path / "rocksdb_migration"));
+
+	nano::store::rocksdb::component rocksdb_store{ logger, path / "rocksdb", nano::dev::constants };
+	auto transaction = rocksdb_store.tx_begin_read ();
+	ASSERT_EQ (*nano::dev::genesis, *rocksdb_store.block.get (transaction, nano::dev::genesis->hash ()));
+	ASSERT_TRUE (rocksdb_store.account.get (transaction, nano::dev::genesis_key.pub));
+	ASSERT_EQ (1, rocksdb_store.count (transaction, nano::tables::confirmation_height));
+}
+
 TEST (ledger, is_send_genesis)
 {
 	auto ctx = nano::test::ledger_empty ();
@@ -5797,6 +5920,88 @@ TEST (ledger_receivable, any_one)
 	ASSERT_FALSE (ctx.ledger ().any.receivable_exists (ctx.ledger ().tx_begin_read (), key.pub));
 }
 
+TEST (ledger_receivable, for_each)
+{
+	nano::test::system system;
+	nano::node_flags flags;
+	flags.generate_cache.receivable = true;
+	auto & node = *system.add_node (flags);
+	auto & ledger = node.ledger;
+	std::vector<nano::keypair> keys (3);
+	std::sort (keys.begin (), keys.end (), [] (auto const & key1, auto const & key2) { return key1.pub < key2.pub; });
+	nano::block_builder builder;
+	nano::block_hash previous = nano::dev::genesis->hash ();
+	nano::uint128_t balance = nano::dev::constants.genesis_amount;
+	auto send = [&] (nano::account const & destination, nano::uint128_t const & amount) {
+		balance -= amount;
+		auto block = builder
+					 .state ()
+					 .account (nano::dev::genesis_key.pub)
+					 .previous (previous)
+					 .representative (nano::dev::genesis_key.pub)
+					 .balance (balance)
+					 .link (destination)
+					 .sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+					 .work (*system.work.generate (previous))
+					 .build ();
+		previous = block->hash ();
+		return block;
+	};
+	// Nothing is sent to keys[1], the second send to keys[2] stays unconfirmed
+	auto send1 = send (keys[0].pub, 1);
+	auto send2 = send (keys[2].pub, 2);
+	auto send3 = send (keys[2].pub, 3);
+	{
+		auto transaction = ledger.tx_begin_write ();
+		ASSERT_EQ (nano::block_status::progress, ledger.process (transaction, send1));
+		ASSERT_EQ (nano::block_status::progress, ledger.process (transaction, send2));
+		ASSERT_EQ (nano::block_status::progress, ledger.process (transaction, send3));
+		ledger.confirm (transaction, send2->hash ());
+	}
+	ASSERT_EQ (1, ledger.cache.receivable_sums.get (keys[0].pub));
+	ASSERT_EQ (0, ledger.cache.receivable_sums.get (keys[1].pub));
+	ASSERT_EQ (5, ledger.cache.receivable_sums.get (keys[2].pub));
+	ASSERT_EQ (5, ledger.account_receivable (ledger.tx_begin_read (), keys[2].pub));
+	ASSERT_EQ (2, ledger.account_receivable (ledger.tx_begin_read (), keys[2].pub, true));
+
+	std::vector<nano::account> accounts{ keys[0].pub, keys[1].pub, keys[2].pub };
+	std::map<nano::block_hash, std::pair<nano::account, bool>> visited;
+	ledger.receivable_for_each (ledger.tx_begin_read (), accounts, true, [&] (nano::pending_key const & key, nano::pending_info const & info, bool confirmed) {
+		visited.emplace (key.hash, std::make_pair (key.account, confirmed));
+		return true;
+	});
+	ASSERT_EQ (3, visited.size ());
+	ASSERT_EQ (std::make_pair (nano::account{ keys[0].pub }, true), visited[send1->hash ()]);
+	ASSERT_EQ (std::make_pair (nano::account{ keys[2].pub }, true), visited[send2->hash ()]);
+	ASSERT_EQ (std::make_pair (nano::account{ keys[2].pub }, false), visited[send3->hash ()]);
+
+	// Returning false skips the remaining entries of an account only
+	size_t count{ 0 };
+	ledger.receivable_for_each (ledger.tx_begin_read (), accounts, false, [&] (nano::pending_key const &, nano::pending_info const &, bool) {
+		++count;
+		return false;
+	});
+	ASSERT_EQ (2, count);
+
+	// Receiving and rolling back update the sums
+	auto open = builder
+				.state ()
+				.account (keys[2].pub)
+				.previous (0)
+				.representative (keys[2].pub)
+				.balance (2)
+				.link (send2->hash ())
+				.sign (keys[2].prv, keys[2].pub)
+				.work (*system.work.generate (keys[2].pub))
+				.build ();
+	ASSERT_EQ (nano::block_status::progress, ledger.process (ledger.tx_begin_write (), open));
+	ASSERT_EQ (3, ledger.cache.receivable_sums.get (keys[2].pub));
+	ASSERT_FALSE (ledger.rollback (ledger.tx_begin_write (), send3->hash ()));
+	ASSERT_EQ (0, ledger.cache.receivable_sums.get (keys[2].pub));
+	ASSERT_FALSE (ledger.rollback (ledger.tx_begin_write (), open->hash ()));
+	ASSERT_EQ (2, ledger.cache.receivable_sums.get (keys[2].pub));
+}
+
 TEST (ledger_transaction, write_refresh)
 {
 	auto ctx = nano::test::ledger_empty ();
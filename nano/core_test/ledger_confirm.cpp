@@ -7,6 +7,7 @@
 #include <nano/secure/ledger.hpp>
 #include <nano/secure/ledger_set_any.hpp>
 #include <nano/secure/ledger_set_confirmed.hpp>
+#include <nano/test_common/ledger_context.hpp>
 #include <nano/test_common/system.hpp>
 #include <nano/test_common/testutil.hpp>
 
@@ -863,3 +864,105 @@ TEST (ledger_confirmDeathTest, rollback_added_block)
 		ASSERT_DEATH_IF_SUPPORTED (ledger.confirm (transaction, send->hash ()), "");
 	}
 }
+
+// A chain of blocks on a single account, including sends to itself, is confirmed in ascending order without revisiting dependencies
+TEST (ledger_confirm, single_chain_segment)
+{
+	auto ctx = nano::test::ledger_single_chain (64);
+	auto & ledger = ctx.ledger ();
+	auto top = ctx.blocks ().back ();
+
+	auto transaction = ledger.tx_begin_write ();
+	auto confirmed = ledger.confirm (transaction, top->hash ());
+	ASSERT_EQ (ctx.blocks ().size (), confirmed.size ());
+	for (std::size_t i = 0; i < confirmed.size (); ++i)
+	{
+		ASSERT_EQ (ctx.blocks ()[i]->hash (), confirmed[i]->hash ());
+	}
+	ASSERT_EQ (ctx.blocks ().size (), ctx.stats ().count (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed, nano::stat::dir::in));
+	ASSERT_EQ (0, ctx.stats ().count (nano::stat::type::confirmation_height, nano::stat::detail::dependent_unconfirmed, nano::stat::dir::in));
+	ASSERT_EQ (ctx.blocks ().size () + 1, ledger.cemented_count ());
+	auto info = ledger.store.confirmation_height.get (transaction, nano::dev::genesis_key.pub);
+	ASSERT_TRUE (info);
+	ASSERT_EQ (top->sideband ().height, info->height);
+	ASSERT_EQ (top->hash (), info->frontier);
+}
+
+// Bounded confirmation of a long chain confirms the lowest blocks first and continues from there
+TEST (ledger_confirm, single_chain_segment_bounded)
+{
+	auto ctx = nano::test::ledger_single_chain (64);
+	auto & ledger = ctx.ledger ();
+	auto top = ctx.blocks ().back ();
+
+	auto transaction = ledger.tx_begin_write ();
+	auto confirmed1 = ledger.confirm (transaction, top->hash (), 10);
+	ASSERT_EQ (10, confirmed1.size ());
+	ASSERT_EQ (ctx.blocks ()[0]->hash (), confirmed1.front ()->hash ());
+	ASSERT_EQ (ctx.blocks ()[9]->hash (), confirmed1.back ()->hash ());
+	ASSERT_EQ (11, ledger.confirmed.account_height (transaction, nano::dev::genesis_key.pub));
+
+	auto confirmed2 = ledger.confirm (transaction, top->hash ());
+	ASSERT_EQ (ctx.blocks ().size () - 10, confirmed2.size ());
+	ASSERT_EQ (ctx.blocks ()[10]->hash (), confirmed2.front ()->hash ());
+	ASSERT_TRUE (ledger.confirmed.block_exists (transaction, top->hash ()));
+}
+
+// Each receive of a long chain depends on a send of another unconfirmed chain, confirmation resumes above the confirmed part after every dependency
+TEST (ledger_confirm, long_chain_unconfirmed_sources)
+{
+	auto ctx = nano::test::ledger_empty ();
+	auto & ledger = ctx.ledger ();
+	nano::keypair key;
+	nano::block_builder builder;
+	std::vector<std::shared_ptr<nano::block>> sends;
+	std::vector<std::shared_ptr<nano::block>> receives;
+	auto const count = 128;
+	{
+		auto transaction = ledger.tx_begin_write ();
+		auto send_previous = nano::dev::genesis->hash ();
+		for (auto i = 0; i < count; ++i)
+		{
+			auto send = builder.state ()
+						.account (nano::dev::genesis_key.pub)
+						.previous (send_previous)
+						.representative (nano::dev::genesis_key.pub)
+						.balance (nano::dev::constants.genesis_amount - (i + 1))
+						.link (key.pub)
+						.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+						.work (*ctx.pool ().generate (send_previous))
+						.build ();
+			ASSERT_EQ (nano::block_status::progress, ledger.process (transaction, send));
+			send_previous = send->hash ();
+			sends.push_back (send);
+			auto receive_previous = receives.empty () ? nano::block_hash{ 0 } : receives.back ()->hash ();
+			auto receive = builder.state ()
+						   .account (key.pub)
+						   .previous (receive_previous)
+						   .representative (key.pub)
+						   .balance (i + 1)
+						   .link (send->hash ())
+						   .sign (key.prv, key.pub)
+						   .work (*ctx.pool ().generate (receives.empty () ? nano::root{ key.pub } : nano::root{ receive_previous }))
+						   .build ();
+			ASSERT_EQ (nano::block_status::progress, ledger.process (transaction, receive));
+			receives.push_back (receive);
+		}
+	}
+
+	auto transaction = ledger.tx_begin_write ();
+	auto confirmed = ledger.confirm (transaction, receives.back ()->hash ());
+	ASSERT_EQ (2 * count, confirmed.size ());
+	// Every send is confirmed directly before the receive depending on it
+	for (auto i = 0; i < count; ++i)
+	{
+		ASSERT_EQ (sends[i]->hash (), confirmed[2 * i]->hash ());
+		ASSERT_EQ (receives[i]->hash (), confirmed[2 * i + 1]->hash ());
+	}
+	ASSERT_EQ (count + 1, ledger.confirmed.account_height (transaction, nano::dev::genesis_key.pub));
+	ASSERT_EQ (count, ledger.confirmed.account_height (transaction, key.pub));
+	ASSERT_EQ (count, ctx.stats ().count (nano::stat::type::confirmation_height, nano::stat::detail::dependent_unconfirmed, nano::stat::dir::in));
+
+	// Nothing is left to confirm
+	ASSERT_TRUE (ledger.confirm (transaction, receives.back ()->hash ()).empty ());
+}
@@ -1,3 +1,4 @@
+#include <nano/crypto_lib/random_pool.hpp>
 #include <nano/lib/blocks.hpp>
 #include <nano/node/transport/message_deserializer.hpp>
 #include <nano/secure/vote.hpp>
@@ -20,19 +21,19 @@ auto message_deserializer_success_checker (message_type & message_original) -> v
 	nano::vote_uniquer vote_uniquer;
 
 	// Data used to simulate the incoming buffer to be deserialized, the offset tracks how much has been read from the input_source
-	// as the read function is called first to read the header, then called again to read the payload.
+	// as the read function is called with as much data as is available.
 	std::vector<uint8_t> input_source;
 	std::size_t offset{ 0 };
 
 	// Message Deserializer with the query function tweaked to read from the `input_source`.
 	auto const message_deserializer = std::make_shared<nano::transport::message_deserializer> (nano::dev::network_params.network, filter, block_uniquer, vote_uniquer,
-	[&input_source, &offset] (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a) {
-		debug_assert (input_source.size () >= size_a);
-		data_a->resize (size_a);
+	[&input_source, &offset] (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t offset_a, std::size_t min_size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a) {
+		auto const size = std::min (input_source.size () - offset, data_a->size () - offset_a);
+		debug_assert (size >= min_size_a);
 		auto const copy_start = input_source.begin () + offset;
-		std::copy (copy_start, copy_start + size_a, data_a->data ());
-		offset += size_a;
-		callback_a (boost::system::errc::make_error_code (boost::system::errc::success), size_a);
+		std::copy (copy_start, copy_start + size, data_a->data () + offset_a);
+		offset += size;
+		callback_a (boost::system::errc::make_error_code (boost::system::errc::success), size);
 	});
 
 	// Generating the values for the `input_source`.
@@ -204,3 +205,216 @@ TEST (message_deserializer, exact_asc_pull_ack)
 
 	message_deserializer_success_checker<decltype (message)> (message);
 }
+
+// Messages arriving in a single read are all parsed in one batch, a message split across reads is completed by the next read
+TEST (message_deserializer, read_batch)
+{
+	nano::network_filter filter (1);
+	nano::block_uniquer block_uniquer;
+	nano::vote_uniquer vote_uniquer;
+
+	std::vector<uint8_t> input_source;
+	std::size_t offset{ 0 };
+	std::size_t read_size{ 0 };
+	std::size_t read_count{ 0 };
+
+	// Returns at most `read_size` bytes per read, unless more are required
+	auto const message_deserializer = std::make_shared<nano::transport::message_deserializer> (nano::dev::network_params.network, filter, block_uniquer, vote_uniquer,
+	[&] (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t offset_a, std::size_t min_size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a) {
+		auto const size = std::min ({ input_source.size () - offset, data_a->size () - offset_a, std::max (read_size, min_size_a) });
+		ASSERT_GE (size, min_size_a);
+		std::copy (input_source.begin () + offset, input_source.begin () + offset + size, data_a->data () + offset_a);
+		offset += size;
+		++read_count;
+		callback_a (boost::system::errc::make_error_code (boost::system::errc::success), size);
+	});
+
+	nano::keepalive keepalive{ nano::dev::network_params.network };
+	nano::telemetry_req telemetry_req{ nano::dev::network_params.network };
+	{
+		nano::vectorstream stream (input_source);
+		keepalive.serialize (stream);
+		telemetry_req.serialize (stream);
+		keepalive.serialize (stream);
+	}
+	auto const keepalive_size = keepalive.to_shared_const_buffer ().size ();
+
+	// Everything is available at once
+	read_size = input_source.size ();
+	std::vector<nano::transport::message_deserializer::result> batch;
+	message_deserializer->read_batch ([&batch] (boost::system::error_code ec, std::vector<nano::transport::message_deserializer::result> batch_a) {
+		ASSERT_FALSE (ec);
+		batch = std::move (batch_a);
+	});
+	ASSERT_EQ (3, batch.size ());
+	ASSERT_EQ (1, read_count);
+	ASSERT_EQ (nano::message_type::keepalive, batch[0].message->type ());
+	ASSERT_EQ (nano::message_type::telemetry_req, batch[1].message->type ());
+	ASSERT_EQ (nano::message_type::keepalive, batch[2].message->type ());
+	for (auto const & entry : batch)
+	{
+		ASSERT_EQ (nano::transport::parse_status::success, entry.status);
+	}
+
+	// The second message ends in the middle of the second read
+	{
+		nano::vectorstream stream (input_source);
+		keepalive.serialize (stream);
+		keepalive.serialize (stream);
+	}
+	read_size = keepalive_size + keepalive_size / 2;
+	read_count = 0;
+	batch.clear ();
+	message_deserializer->read_batch ([&batch] (boost::system::error_code ec, std::vector<nano::transport::message_deserializer::result> batch_a) {
+		ASSERT_FALSE (ec);
+		batch = std::move (batch_a);
+	});
+	ASSERT_EQ (1, batch.size ());
+	ASSERT_EQ (1, read_count);
+	batch.clear ();
+	message_deserializer->read_batch ([&batch] (boost::system::error_code ec, std::vector<nano::transport::message_deserializer::result> batch_a) {
+		ASSERT_FALSE (ec);
+		batch = std::move (batch_a);
+	});
+	ASSERT_EQ (1, batch.size ());
+	ASSERT_EQ (2, read_count);
+	ASSERT_EQ (input_source.size (), offset);
+}
+
+// Hashes sent in full on a connection are sent as indices afterwards, the receiver expands them to the regular vote
+TEST (message_deserializer, compact_votes)
+{
+	nano::network_filter filter (256);
+	nano::block_uniquer block_uniquer;
+	nano::vote_uniquer vote_uniquer;
+
+	std::vector<uint8_t> input_source;
+	std::size_t offset{ 0 };
+	auto read = [&] (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t offset_a, std::size_t min_size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a) {
+		auto const size = std::min (input_source.size () - offset, data_a->size () - offset_a);
+		ASSERT_GE (size, min_size_a);
+		std::copy (input_source.begin () + offset, input_source.begin () + offset + size, data_a->data () + offset_a);
+		offset += size;
+		callback_a (boost::system::errc::make_error_code (boost::system::errc::success), size);
+	};
+	auto const message_deserializer = std::make_shared<nano::transport::message_deserializer> (nano::dev::network_params.network, filter, block_uniquer, vote_uniquer, read);
+	message_deserializer->enable_compact_votes ();
+	auto parse = [&] (nano::shared_const_buffer const & buffer) {
+		auto const bytes = buffer.to_bytes ();
+		input_source.insert (input_source.end (), bytes.begin (), bytes.end ());
+		std::vector<nano::transport::message_deserializer::result> batch;
+		message_deserializer->read_batch ([&batch] (boost::system::error_code ec, std::vector<nano::transport::message_deserializer::result> batch_a) {
+			ASSERT_FALSE (ec);
+			batch = std::move (batch_a);
+		});
+		EXPECT_EQ (1, batch.size ());
+		return batch.empty () ? nano::transport::message_deserializer::result{ nullptr, nano::transport::parse_status::none } : std::move (batch.front ());
+	};
+
+	nano::keypair key;
+	std::vector<nano::block_hash> hashes;
+	for (auto i = 0; i < 20; ++i)
+	{
+		hashes.push_back (nano::random_pool::generate<nano::block_hash> ());
+	}
+	auto vote1 = std::make_shared<nano::vote> (key.pub, key.prv, 1, 0, hashes);
+	nano::transport::compact_vote_encoder encoder;
+
+	// All hashes are new, the vote is sent in the regular format
+	auto const regular1 = nano::confirm_ack{ nano::dev::network_params.network, vote1 }.to_shared_const_buffer ();
+	auto const encoded1 = encoder.encode (regular1, true);
+	ASSERT_EQ (regular1.to_bytes (), encoded1.to_bytes ());
+	auto result1 = parse (encoded1);
+	ASSERT_EQ (nano::transport::parse_status::success, result1.status);
+
+	// A vote on the same hashes and one new hash only sends the new hash in full
+	hashes.push_back (nano::random_pool::generate<nano::block_hash> ());
+	auto vote2 = std::make_shared<nano::vote> (key.pub, key.prv, 2, 0, hashes);
+	auto const regular2 = nano::confirm_ack{ nano::dev::network_params.network, vote2 }.to_shared_const_buffer ();
+	auto const encoded2 = encoder.encode (regular2, true);
+	ASSERT_EQ (regular2.size () - 20 * (sizeof (nano::block_hash) - nano::confirm_ack::compact_index_size) + (hashes.size () + 7) / 8, encoded2.size ());
+	auto result2 = parse (encoded2);
+	ASSERT_EQ (nano::transport::parse_status::success, result2.status);
+	auto confirm2 = dynamic_cast<nano::confirm_ack *> (result2.message.get ());
+	ASSERT_NE (nullptr, confirm2);
+	ASSERT_EQ (*vote2, *confirm2->vote);
+	ASSERT_FALSE (nano::confirm_ack::is_compact (confirm2->header));
+	ASSERT_EQ (regular2.to_bytes (), *confirm2->to_bytes ());
+
+	// Duplicates are filtered by the regular payload of the vote
+	auto result3 = parse (encoder.encode (regular2, true));
+	ASSERT_EQ (nano::transport::parse_status::duplicate_confirm_ack_message, result3.status);
+
+	// A connection that did not advertise support rejects compact votes
+	auto const message_deserializer_regular = std::make_shared<nano::transport::message_deserializer> (nano::dev::network_params.network, filter, block_uniquer, vote_uniquer, read);
+	input_source.clear ();
+	offset = 0;
+	auto const bytes = encoded2.to_bytes ();
+	input_source.insert (input_source.end (), bytes.begin (), bytes.end ());
+	std::vector<nano::transport::message_deserializer::result> batch;
+	message_deserializer_regular->read_batch ([&batch] (boost::system::error_code ec, std::vector<nano::transport::message_deserializer::result> batch_a) {
+		ASSERT_FALSE (ec);
+		batch = std::move (batch_a);
+	});
+	ASSERT_EQ (1, batch.size ());
+	ASSERT_EQ (nano::transport::parse_status::invalid_compact_confirm_ack_message, batch.front ().status);
+
+	// Without support of the peer the vote is sent in the regular format
+	ASSERT_EQ (regular2.to_bytes (), encoder.encode (regular2, false).to_bytes ());
+}
+
+// Indices into a table that is out of sync with the sender decode to a vote with an invalid signature, which is rejected like an undecodable compact vote
+TEST (message_deserializer, compact_votes_out_of_sync)
+{
+	nano::network_filter filter (256);
+	nano::block_uniquer block_uniquer;
+	nano::vote_uniquer vote_uniquer;
+
+	std::vector<uint8_t> input_source;
+	std::size_t offset{ 0 };
+	auto read = [&] (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t offset_a, std::size_t min_size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a) {
+		auto const size = std::min (input_source.size () - offset, data_a->size () - offset_a);
+		ASSERT_GE (size, min_size_a);
+		std::copy (input_source.begin () + offset, input_source.begin () + offset + size, data_a->data () + offset_a);
+		offset += size;
+		callback_a (boost::system::errc::make_error_code (boost::system::errc::success), size);
+	};
+	auto const message_deserializer = std::make_shared<nano::transport::message_deserializer> (nano::dev::network_params.network, filter, block_uniquer, vote_uniquer, read);
+	message_deserializer->enable_compact_votes ();
+	auto parse = [&] (nano::shared_const_buffer const & buffer) {
+		auto const bytes = buffer.to_bytes ();
+		input_source.insert (input_source.end (), bytes.begin (), bytes.end ());
+		std::vector<nano::transport::message_deserializer::result> batch;
+		message_deserializer->read_batch ([&batch] (boost::system::error_code ec, std::vector<nano::transport::message_deserializer::result> batch_a) {
+			ASSERT_FALSE (ec);
+			batch = std::move (batch_a);
+		});
+		EXPECT_EQ (1, batch.size ());
+		return batch.empty () ? nano::transport::message_deserializer::result{ nullptr, nano::transport::parse_status::none } : std::move (batch.front ());
+	};
+	auto random_hashes = [] () {
+		std::vector<nano::block_hash> hashes;
+		for (auto i = 0; i < 20; ++i)
+		{
+			hashes.push_back (nano::random_pool::generate<nano::block_hash> ());
+		}
+		return hashes;
+	};
+
+	nano::keypair key;
+	auto const hashes = random_hashes ();
+	nano::transport::compact_vote_encoder encoder;
+	// The sender tracks a vote the receiver never sees, the receiver tracks a different vote with the same number of hashes instead
+	auto vote1 = std::make_shared<nano::vote> (key.pub, key.prv, 1, 0, hashes);
+	encoder.encode (nano::confirm_ack{ nano::dev::network_params.network, vote1 }.to_shared_const_buffer (), true);
+	auto other = std::make_shared<nano::vote> (key.pub, key.prv, 1, 0, random_hashes ());
+	ASSERT_EQ (nano::transport::parse_status::success, parse (nano::confirm_ack{ nano::dev::network_params.network, other }.to_shared_const_buffer ()).status);
+
+	auto vote2 = std::make_shared<nano::vote> (key.pub, key.prv, 2, 0, hashes);
+	auto const regular2 = nano::confirm_ack{ nano::dev::network_params.network, vote2 }.to_shared_const_buffer ();
+	auto const encoded2 = encoder.encode (regular2, true);
+	ASSERT_LT (encoded2.size (), regular2.size ());
+	auto result = parse (encoded2);
+	ASSERT_EQ (nano::transport::parse_status::invalid_compact_confirm_ack_message, result.status);
+	ASSERT_EQ (nullptr, result.message);
+}
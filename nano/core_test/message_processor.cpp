@@ -0,0 +1,27 @@
+#include <nano/node/message_processor.hpp>
+#include <nano/node/transport/inproc.hpp>
+#include <nano/test_common/system.hpp>
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+// Messages of different channels are spread over the shards, even though channel addresses share their alignment
+TEST (message_processor, shard_spread)
+{
+	nano::test::system system;
+	auto config = system.default_config ();
+	config.message_processor.threads = 4;
+	auto & node = *system.add_node (config);
+	std::vector<std::shared_ptr<nano::transport::channel>> channels;
+	std::set<std::size_t> indices;
+	for (auto i = 0; i < 16; ++i)
+	{
+		auto channel = channels.emplace_back (std::make_shared<nano::transport::inproc::channel> (node, node));
+		auto const index = node.message_processor.shard_index (*channel);
+		ASSERT_LT (index, 4);
+		ASSERT_EQ (index, node.message_processor.shard_index (*channel));
+		indices.insert (index);
+	}
+	ASSERT_GT (indices.size (), 1);
+}
@@ -1,4 +1,5 @@
 #include <nano/lib/blocks.hpp>
+#include <nano/lib/thread_runner.hpp>
 #include <nano/node/election.hpp>
 #include <nano/node/network.hpp>
 #include <nano/node/nodeconfig.hpp>
@@ -6,10 +7,12 @@
 #include <nano/node/scheduler/priority.hpp>
 #include <nano/node/transport/fake.hpp>
 #include <nano/node/transport/inproc.hpp>
+#include <nano/node/transport/tcp_channel.hpp>
 #include <nano/node/transport/tcp_listener.hpp>
 #include <nano/node/transport/tcp_socket.hpp>
 #include <nano/secure/ledger.hpp>
 #include <nano/secure/ledger_set_any.hpp>
+#include <nano/secure/vote.hpp>
 #include <nano/test_common/network.hpp>
 #include <nano/test_common/system.hpp>
 #include <nano/test_common/testutil.hpp>
@@ -822,6 +825,32 @@ TEST (network, bandwidth_limiter_with_burst)
 	ASSERT_TIMELY_EQ (1s, 0, node.stats.count (nano::stat::type::drop, nano::stat::detail::publish, nano::stat::dir::out));
 }
 
+// Bootstrap traffic is charged to the bootstrap limiter even when it is sent in a batch together with generic traffic
+TEST (network, bandwidth_limiter_per_type)
+{
+	nano::test::system system;
+	nano::node_config node_config = system.default_config ();
+	node_config.bandwidth_limit = 0; // Unlimited
+	node_config.bootstrap_bandwidth_limit = 1;
+	node_config.bootstrap_bandwidth_burst_ratio = 1.0;
+	auto & node0 = *system.add_node (node_config);
+	auto & node1 = *system.add_node ();
+	auto channel = node0.network.tcp_channels.find_node_id (node1.get_node_id ());
+	ASSERT_NE (nullptr, channel);
+	nano::keepalive keepalive{ nano::dev::network_params.network };
+	channel->send (keepalive, nano::transport::traffic_type::keepalive);
+	channel->send (keepalive, nano::transport::traffic_type::bootstrap_server);
+	ASSERT_TIMELY (5s, node0.stats.count (nano::stat::type::tcp_channel_wait, nano::stat::detail::wait_bandwidth, nano::stat::dir::out) > 0);
+	ASSERT_EQ (0, node0.stats.count (nano::stat::type::tcp_channel_send, nano::stat::detail::bootstrap_server, nano::stat::dir::out));
+}
+
+TEST (bandwidth_limiter, limit_type)
+{
+	ASSERT_EQ (nano::bandwidth_limit_type::bootstrap, nano::to_bandwidth_limit_type (nano::transport::traffic_type::bootstrap_server));
+	ASSERT_EQ (nano::bandwidth_limit_type::generic, nano::to_bandwidth_limit_type (nano::transport::traffic_type::bootstrap_requests));
+	ASSERT_EQ (nano::bandwidth_limit_type::generic, nano::to_bandwidth_limit_type (nano::transport::traffic_type::vote));
+}
+
 namespace nano
 {
 TEST (peer_exclusion, validate)
@@ -1149,3 +1178,94 @@ TEST (network, purge_dead_channel_remote)
 	};
 	ASSERT_TIMELY (5s, !channel_exists (node2, channel));
 }
+
+TEST (network, send_all)
+{
+	nano::test::system system (3);
+	auto & node1 (*system.nodes[0]);
+	ASSERT_TIMELY_EQ (5s, node1.network.size (), 2);
+	auto const sent_before = node1.stats.count (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::out);
+	nano::publish message{ nano::dev::network_params.network, nano::dev::genesis };
+	// One serialized buffer is shared by both channels, each send is still counted
+	node1.network.send_all (message, node1.network.list (), nano::transport::traffic_type::test);
+	ASSERT_EQ (sent_before + 2, node1.stats.count (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::out));
+	ASSERT_TIMELY (5s, std::all_of (system.nodes.begin () + 1, system.nodes.end (), [] (auto const & node) { return node->stats.count (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::in) > 0; }));
+}
+
+TEST (network, channel_snapshot)
+{
+	nano::test::system system (3);
+	auto & node1 (*system.nodes[0]);
+	ASSERT_TIMELY_EQ (5s, node1.network.size (), 2);
+	auto snapshot = node1.network.tcp_channels.get_snapshot ();
+	ASSERT_EQ (2, snapshot->all.size ());
+	ASSERT_EQ (2, snapshot->non_principal.size ());
+	ASSERT_TRUE (snapshot->principal.empty ());
+	ASSERT_EQ (2, node1.network.list ().size ());
+	ASSERT_EQ (1, node1.network.list (1).size ());
+
+	// A new representative publishes a new snapshot, readers holding the previous one are unaffected
+	auto channel = node1.network.list (1).front ();
+	node1.rep_crawler.force_add_rep (nano::dev::genesis_key.pub, channel);
+	ASSERT_EQ (2, snapshot->non_principal.size ());
+	auto list_pr = node1.network.list_pr ();
+	ASSERT_EQ (1, list_pr.size ());
+	ASSERT_EQ (channel, list_pr.front ());
+	auto list_non_pr = node1.network.list_non_pr (node1.network.fanout (10.0f));
+	ASSERT_EQ (1, list_non_pr.size ());
+	ASSERT_NE (channel, list_non_pr.front ());
+}
+
+TEST (network, io_shards)
+{
+	nano::test::system system;
+	auto config1 = system.default_config ();
+	config1.io_shards = 2;
+	auto & node1 = *system.add_node (config1);
+	auto config2 = system.default_config ();
+	config2.io_shards = 2;
+	auto & node2 = *system.add_node (config2);
+	ASSERT_EQ (2, node1.io_pool.size ());
+	ASSERT_TIMELY_EQ (5s, node1.network.size (), 1);
+	ASSERT_TIMELY_EQ (5s, node2.network.size (), 1);
+
+	// Connections run on the shards instead of the shared io_context
+	auto channel = std::dynamic_pointer_cast<nano::transport::tcp_channel> (node1.network.list ().front ());
+	ASSERT_NE (nullptr, channel);
+	ASSERT_NE (&node1.io_ctx, &channel->socket->executor ().context ());
+
+	nano::publish message{ nano::dev::network_params.network, nano::dev::genesis };
+	channel->send (message, nano::transport::traffic_type::test);
+	ASSERT_TIMELY (5s, node2.stats.count (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::in) > 0);
+}
+
+// Votes repeating hashes already sent on a connection are sent compact between nodes that both enable compact votes
+TEST (network, compact_votes)
+{
+	nano::test::system system;
+	auto config0 = system.default_config ();
+	config0.tcp.compact_votes = true;
+	auto & node0 = *system.add_node (config0);
+	auto config1 = system.default_config ();
+	config1.tcp.compact_votes = true;
+	auto & node1 = *system.add_node (config1);
+	auto channel = node0.network.tcp_channels.find_node_id (node1.get_node_id ());
+	ASSERT_NE (nullptr, channel);
+
+	nano::keypair key;
+	std::vector<nano::block_hash> hashes;
+	for (auto i = 0; i < 20; ++i)
+	{
+		hashes.push_back (nano::block_hash{ static_cast<uint64_t> (i + 1) });
+	}
+	auto vote1 = std::make_shared<nano::vote> (key.pub, key.prv, 1, 0, hashes);
+	auto vote2 = std::make_shared<nano::vote> (key.pub, key.prv, 2, 0, hashes);
+	channel->send (nano::confirm_ack{ nano::dev::network_params.network, vote1 }, nano::transport::traffic_type::test);
+	channel->send (nano::confirm_ack{ nano::dev::network_params.network, vote2 }, nano::transport::traffic_type::test);
+	ASSERT_TIMELY (5s, node1.stats.count (nano::stat::type::message, nano::stat::detail::confirm_ack, nano::stat::dir::in) >= 2);
+	ASSERT_EQ (1, node0.stats.count (nano::stat::type::tcp_channel, nano::stat::detail::compact_vote, nano::stat::dir::out));
+	ASSERT_GT (node0.stats.count (nano::stat::type::tcp_channel, nano::stat::detail::compact_vote_saved_bytes, nano::stat::dir::out), 0);
+	// Both votes were decoded, the connection stays open
+	ASSERT_NE (nullptr, node1.network.tcp_channels.find_node_id (node0.get_node_id ()));
+	ASSERT_TRUE (channel->alive ());
+}
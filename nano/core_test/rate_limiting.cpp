@@ -3,8 +3,11 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <fstream>
 #include <future>
+#include <thread>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -110,4 +113,60 @@ TEST (rate, busy_spin)
 
 	// Bucket starts fully refilled, therefore we see 1 additional request
 	ASSERT_EQ (counter, 6);
-}
\ No newline at end of file
+}
+
+TEST (rate_limiter, basic)
+{
+	// Bursts of 20 tokens, refilled at 10 tokens per second
+	nano::rate_limiter limiter (10, 2.0);
+	ASSERT_EQ (20, limiter.size ());
+	ASSERT_TRUE (limiter.should_pass (15));
+	ASSERT_FALSE (limiter.should_pass (10));
+	ASSERT_TRUE (limiter.should_pass (5));
+	ASSERT_FALSE (limiter.should_pass (1));
+
+	// With a refill rate of 10 tokens/sec, await 1/3 sec and get 3 tokens
+	std::this_thread::sleep_for (300ms);
+	ASSERT_TRUE (limiter.should_pass (3));
+	ASSERT_FALSE (limiter.should_pass (21));
+
+	// Unlimited
+	limiter.reset (0);
+	ASSERT_TRUE (limiter.should_pass (1000000));
+	ASSERT_TRUE (limiter.should_pass (1000000));
+	ASSERT_EQ (static_cast<std::size_t> (1e9), limiter.size ());
+
+	// Limited again, starting with a full bucket
+	limiter.reset (100);
+	ASSERT_TRUE (limiter.should_pass (100));
+	ASSERT_FALSE (limiter.should_pass (100));
+}
+
+// Concurrent callers never pass more than the burst plus what was refilled
+TEST (rate_limiter, concurrent)
+{
+	std::size_t const rate = 1000;
+	nano::rate_limiter limiter (rate);
+	std::atomic<std::size_t> passed{ 0 };
+	auto const start = std::chrono::steady_clock::now ();
+	std::vector<std::thread> threads;
+	for (auto i = 0; i < 8; ++i)
+	{
+		threads.emplace_back ([&] () {
+			while (std::chrono::steady_clock::now () < start + 500ms)
+			{
+				if (limiter.should_pass (1))
+				{
+					++passed;
+				}
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - start);
+	ASSERT_GE (passed.load (), rate);
+	ASSERT_LE (passed.load (), rate + rate * (elapsed.count () + 1) / 1000);
+}
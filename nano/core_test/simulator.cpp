@@ -0,0 +1,107 @@
+#include <nano/lib/blockbuilders.hpp>
+#include <nano/lib/blocks.hpp>
+#include <nano/node/network.hpp>
+#include <nano/test_common/simulator.hpp>
+#include <nano/test_common/system.hpp>
+#include <nano/test_common/testutil.hpp>
+
+#include <gtest/gtest.h>
+
+#include <boost/property_tree/ptree.hpp>
+
+using namespace std::chrono_literals;
+
+TEST (simulator, link_model)
+{
+	nano::test::system system;
+	nano::test::simulator_config config;
+	config.nodes = 2;
+	config.representatives = 0;
+	config.link.latency = 100ms;
+	nano::test::simulator simulator{ system, config };
+	auto & node0 = simulator.node (0);
+	auto & node1 = simulator.node (1);
+	ASSERT_EQ (1, node0.network.size ());
+	auto channel = std::dynamic_pointer_cast<nano::test::simulated_channel> (node0.network.list ().front ());
+	ASSERT_NE (nullptr, channel);
+	ASSERT_EQ (node1.node_id.pub, channel->get_node_id ());
+
+	nano::block_builder builder;
+	auto send1 = builder.state ()
+				 .account (nano::dev::genesis_key.pub)
+				 .previous (nano::dev::genesis->hash ())
+				 .representative (nano::dev::genesis_key.pub)
+				 .link (nano::dev::genesis_key.pub)
+				 .balance (nano::dev::constants.genesis_amount - 1)
+				 .sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				 .work (*system.work.generate (nano::dev::genesis->hash ()))
+				 .build ();
+	auto send2 = builder.state ()
+				 .account (nano::dev::genesis_key.pub)
+				 .previous (send1->hash ())
+				 .representative (nano::dev::genesis_key.pub)
+				 .link (nano::dev::genesis_key.pub)
+				 .balance (nano::dev::constants.genesis_amount - 2)
+				 .sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				 .work (*system.work.generate (send1->hash ()))
+				 .build ();
+
+	// Messages arrive after the latency of the link
+	auto const sent = std::chrono::steady_clock::now ();
+	channel->send (nano::publish{ nano::dev::network_params.network, send1 }, nano::transport::traffic_type::test);
+	ASSERT_TIMELY (5s, nano::test::exists (node1, { send1 }));
+	ASSERT_GE (std::chrono::steady_clock::now () - sent, 100ms);
+
+	// All messages of a link losing everything are transmitted and lost
+	nano::test::link_model lossy;
+	lossy.loss = 1.0;
+	simulator.set_link (0, 1, lossy);
+	auto const lost = channel->lost.load ();
+	channel->send (nano::publish{ nano::dev::network_params.network, send2 }, nano::transport::traffic_type::test);
+	ASSERT_LT (lost, channel->lost.load ());
+	ASSERT_NEVER (500ms, nano::test::exists (node1, { send2 }));
+}
+
+TEST (simulator, confirm)
+{
+	nano::test::system system;
+	nano::test::simulator_config config;
+	config.nodes = 6;
+	config.representatives = 2;
+	config.peers = 2;
+	config.link.latency = 5ms;
+	config.link.bandwidth = 1024 * 1024;
+	nano::test::simulator simulator{ system, config };
+	ASSERT_FALSE (simulator.wait_representatives (10s));
+
+	auto & node = simulator.node (0);
+	nano::keypair key;
+	auto send = nano::state_block_builder ()
+				.account (nano::dev::genesis_key.pub)
+				.previous (node.latest (nano::dev::genesis_key.pub))
+				.representative (nano::dev::genesis_key.pub)
+				.link (key.pub)
+				.balance (node.balance (nano::dev::genesis_key.pub) - nano::Knano_ratio)
+				.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				.work (*system.work.generate (node.latest (nano::dev::genesis_key.pub)))
+				.build ();
+	ASSERT_FALSE (simulator.confirm ({ send }, 0, 30s));
+	for (std::size_t i = 0; i < simulator.size (); ++i)
+	{
+		ASSERT_TRUE (nano::test::confirmed (simulator.node (i), { send }));
+	}
+	auto const latencies = simulator.network_latencies ();
+	ASSERT_EQ (1, latencies.size ());
+	// Votes of both representatives have to cross at least one link
+	ASSERT_GE (latencies.front (), 5ms);
+
+	auto const document = simulator.serialize ();
+	ASSERT_EQ (6, document.get_child ("nodes").size ());
+	ASSERT_EQ (1, document.get<uint64_t> ("confirmation.count"));
+	for (auto const & [name, entry] : document.get_child ("nodes"))
+	{
+		ASSERT_GE (entry.get_child ("links").size (), 2);
+		ASSERT_EQ (1, entry.get<uint64_t> ("confirmation.count"));
+		ASSERT_FALSE (entry.get_child ("stats.entries").empty ());
+	}
+}
@@ -178,6 +178,22 @@ TEST (socket, drop_policy)
 	ASSERT_EQ (0, failed_writes);
 }
 
+TEST (socket, queue_pop_batch)
+{
+	nano::transport::socket_queue queue{ nano::transport::tcp_socket::default_queue_size };
+	ASSERT_TRUE (queue.pop_batch (1024).empty ());
+	for (auto i = 0; i < 4; ++i)
+	{
+		ASSERT_TRUE (queue.insert (nano::shared_const_buffer (std::vector<uint8_t> (100)), nullptr, nano::transport::traffic_type::generic));
+	}
+	// Entries are taken until the byte limit is reached
+	ASSERT_EQ (2, queue.pop_batch (250).size ());
+	// An entry larger than the limit is still taken on its own
+	ASSERT_EQ (1, queue.pop_batch (10).size ());
+	ASSERT_EQ (1, queue.pop_batch (1024).size ());
+	ASSERT_TRUE (queue.empty ());
+}
+
 // This is abusing the socket class, it's interfering with the normal node lifetimes and as a result deadlocks
 // TEST (socket, DISABLED_concurrent_writes)
 TEST (socket, concurrent_writes)
@@ -2,6 +2,7 @@
 #include <nano/lib/thread_runner.hpp>
 #include <nano/lib/work_version.hpp>
 #include <nano/node/transport/inproc.hpp>
+#include <nano/secure/block_corpus.hpp>
 #include <nano/secure/ledger.hpp>
 #include <nano/secure/ledger_set_any.hpp>
 #include <nano/test_common/network.hpp>
@@ -215,3 +216,44 @@ TEST (system, transport_basic)
 	// Ensure the keepalive has been reecived on the target.
 	ASSERT_TIMELY (5s, node1.stats.count (nano::stat::type::message, nano::stat::detail::keepalive, nano::stat::dir::in) > 0);
 }
+
+TEST (system, initialization_corpus)
+{
+	nano::test::system system;
+	nano::block_corpus_topology topology;
+	topology.seed = 1;
+	topology.accounts = 4;
+	topology.depth = 2;
+	topology.fanout = 2;
+	topology.forks = 2;
+	auto path = nano::unique_path ();
+	ASSERT_FALSE (nano::generate_block_corpus (path, topology, system.work));
+	system.set_initialization_corpus (path);
+	auto & node = *system.add_node ();
+
+	nano::block_corpus corpus{ path };
+	ASSERT_EQ (topology.block_count (), corpus.block_count);
+	ASSERT_EQ (2, corpus.fork_count);
+	ASSERT_EQ (1 + corpus.block_count, node.ledger.block_count ());
+	// Every account keeps its opening balance, one raw moves per send and receive
+	for (uint32_t i = 0; i < topology.accounts; ++i)
+	{
+		ASSERT_EQ (nano::nano_ratio, node.balance (nano::keypair{ nano::deterministic_key (topology.seed, i) }.pub));
+	}
+
+	// Forks follow all blocks in processing order
+	for (uint64_t i = 0; i < corpus.block_count; ++i)
+	{
+		ASSERT_TRUE (node.block_or_pruned_exists (corpus.next ()->hash ()));
+	}
+	for (uint64_t i = 0; i < corpus.fork_count; ++i)
+	{
+		auto fork = corpus.next ();
+		ASSERT_NE (nullptr, fork);
+		ASSERT_EQ (nano::block_status::fork, node.ledger.process (node.ledger.tx_begin_write (), fork));
+	}
+	ASSERT_EQ (nullptr, corpus.next ());
+	corpus.rewind ();
+	ASSERT_EQ (0, corpus.position ());
+	ASSERT_NE (nullptr, corpus.next ());
+}
@@ -224,6 +224,8 @@ TEST (toml_config, rpc_config_deserialize_defaults)
 	ASSERT_EQ (conf.rpc_process.ipc_address, defaults.rpc_process.ipc_address);
 	ASSERT_EQ (conf.rpc_process.ipc_port, defaults.rpc_process.ipc_port);
 	ASSERT_EQ (conf.rpc_process.num_ipc_connections, defaults.rpc_process.num_ipc_connections);
+	ASSERT_EQ (conf.rpc_process.max_ipc_connections, defaults.rpc_process.max_ipc_connections);
+	ASSERT_EQ (conf.rpc_process.ipc_pipeline_depth, defaults.rpc_process.ipc_pipeline_depth);
 
 	ASSERT_EQ (conf.rpc_logging.log_rpc, defaults.rpc_logging.log_rpc);
 }
@@ -292,6 +294,7 @@ TEST (toml_config, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.external_address, defaults.node.external_address);
 	ASSERT_EQ (conf.node.external_port, defaults.node.external_port);
 	ASSERT_EQ (conf.node.io_threads, defaults.node.io_threads);
+	ASSERT_EQ (conf.node.io_shards, defaults.node.io_shards);
 	ASSERT_EQ (conf.node.max_work_generate_multiplier, defaults.node.max_work_generate_multiplier);
 	ASSERT_EQ (conf.node.network_threads, defaults.node.network_threads);
 	ASSERT_EQ (conf.node.background_threads, defaults.node.background_threads);
@@ -300,6 +303,8 @@ TEST (toml_config, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.representative_vote_weight_minimum, defaults.node.representative_vote_weight_minimum);
 	ASSERT_EQ (conf.node.rep_crawler_weight_minimum, defaults.node.rep_crawler_weight_minimum);
 	ASSERT_EQ (conf.node.password_fanout, defaults.node.password_fanout);
+	ASSERT_EQ (conf.node.kdf_threads, defaults.node.kdf_threads);
+	ASSERT_EQ (conf.node.kdf_cache_lifetime, defaults.node.kdf_cache_lifetime);
 	ASSERT_EQ (conf.node.peering_port, defaults.node.peering_port);
 	ASSERT_EQ (conf.node.pow_sleep_interval, defaults.node.pow_sleep_interval);
 	ASSERT_EQ (conf.node.preconfigured_peers, defaults.node.preconfigured_peers);
@@ -426,6 +431,7 @@ TEST (toml_config, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.tcp.connect_timeout, defaults.node.tcp.connect_timeout);
 	ASSERT_EQ (conf.node.tcp.handshake_timeout, defaults.node.tcp.handshake_timeout);
 	ASSERT_EQ (conf.node.tcp.io_timeout, defaults.node.tcp.io_timeout);
+	ASSERT_EQ (conf.node.tcp.compact_votes, defaults.node.tcp.compact_votes);
 }
 
 /** Deserialize a node config with non-default values */
@@ -453,6 +459,7 @@ TEST (toml_config, daemon_config_deserialize_no_defaults)
 	external_address = "0:0:0:0:0:ffff:7f01:101"
 	external_port = 999
 	io_threads = 999
+	io_shards = 999
 	lmdb_max_dbs = 999
 	network_threads = 999
 	background_threads = 999
@@ -460,6 +467,8 @@ TEST (toml_config, daemon_config_deserialize_no_defaults)
 	representative_vote_weight_minimum = "999"
 	rep_crawler_weight_minimum = "999"
 	password_fanout = 999
+	kdf_threads = 999
+	kdf_cache_lifetime = 999
 	peering_port = 999
 	pow_sleep_interval= 999
 	preconfigured_peers = ["dev.org"]
@@ -656,6 +665,7 @@ TEST (toml_config, daemon_config_deserialize_no_defaults)
 	connect_timeout = 999
 	handshake_timeout = 999
 	io_timeout = 999
+	compact_votes = true
 
 	[opencl]
 	device = 999
@@ -708,6 +718,7 @@ TEST (toml_config, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.external_address, defaults.node.external_address);
 	ASSERT_NE (conf.node.external_port, defaults.node.external_port);
 	ASSERT_NE (conf.node.io_threads, defaults.node.io_threads);
+	ASSERT_NE (conf.node.io_shards, defaults.node.io_shards);
 	ASSERT_NE (conf.node.max_work_generate_multiplier, defaults.node.max_work_generate_multiplier);
 	ASSERT_NE (conf.node.max_unchecked_blocks, defaults.node.max_unchecked_blocks);
 	ASSERT_NE (conf.node.max_backlog, defaults.node.max_backlog);
@@ -720,6 +731,8 @@ TEST (toml_config, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.representative_vote_weight_minimum, defaults.node.representative_vote_weight_minimum);
 	ASSERT_NE (conf.node.rep_crawler_weight_minimum, defaults.node.rep_crawler_weight_minimum);
 	ASSERT_NE (conf.node.password_fanout, defaults.node.password_fanout);
+	ASSERT_NE (conf.node.kdf_threads, defaults.node.kdf_threads);
+	ASSERT_NE (conf.node.kdf_cache_lifetime, defaults.node.kdf_cache_lifetime);
 	ASSERT_NE (conf.node.peering_port, defaults.node.peering_port);
 	ASSERT_NE (conf.node.pow_sleep_interval, defaults.node.pow_sleep_interval);
 	ASSERT_NE (conf.node.preconfigured_peers, defaults.node.preconfigured_peers);
@@ -846,6 +859,7 @@ TEST (toml_config, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.tcp.connect_timeout, defaults.node.tcp.connect_timeout);
 	ASSERT_NE (conf.node.tcp.handshake_timeout, defaults.node.tcp.handshake_timeout);
 	ASSERT_NE (conf.node.tcp.io_timeout, defaults.node.tcp.io_timeout);
+	ASSERT_NE (conf.node.tcp.compact_votes, defaults.node.tcp.compact_votes);
 }
 
 /** There should be no required values **/
@@ -894,7 +908,9 @@ TEST (toml_config, rpc_config_deserialize_no_defaults)
 	[process]
 	io_threads = 999
 	ipc_address = "0:0:0:0:0:ffff:7f01:101"
+	ipc_pipeline_depth = 99
 	ipc_port = 999
+	max_ipc_connections = 9999
 	num_ipc_connections = 999
 	[logging]
 	log_rpc = false
@@ -918,6 +934,8 @@ TEST (toml_config, rpc_config_deserialize_no_defaults)
 	ASSERT_NE (conf.rpc_process.ipc_address, defaults.rpc_process.ipc_address);
 	ASSERT_NE (conf.rpc_process.ipc_port, defaults.rpc_process.ipc_port);
 	ASSERT_NE (conf.rpc_process.num_ipc_connections, defaults.rpc_process.num_ipc_connections);
+	ASSERT_NE (conf.rpc_process.max_ipc_connections, defaults.rpc_process.max_ipc_connections);
+	ASSERT_NE (conf.rpc_process.ipc_pipeline_depth, defaults.rpc_process.ipc_pipeline_depth);
 
 	ASSERT_NE (conf.rpc_logging.log_rpc, defaults.rpc_logging.log_rpc);
 }
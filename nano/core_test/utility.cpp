@@ -4,6 +4,7 @@
 #include <nano/lib/relaxed_atomic.hpp>
 #include <nano/lib/timer.hpp>
 #include <nano/lib/utility.hpp>
+#include <nano/secure/parallel_traversal.hpp>
 #include <nano/secure/pending_info.hpp>
 #include <nano/secure/utility.hpp>
 
@@ -172,3 +173,54 @@ TEST (pending_key, sorting)
 	ASSERT_EQ (std::hash<nano::pending_key>{}(one), std::hash<nano::pending_key>{}(one_same));
 	ASSERT_NE (std::hash<nano::pending_key>{}(one), std::hash<nano::pending_key>{}(two));
 }
+
+// Every range is traversed exactly once and together they cover the whole key space, even when threads take over ranges from each other
+TEST (parallel_traversal, ranges)
+{
+	nano::parallel_traversal_config config;
+	config.threads = 4;
+	config.ranges_per_thread = 8;
+	std::atomic<std::size_t> progress_calls{ 0 };
+	std::atomic<std::size_t> total{ 0 };
+	config.progress = [&progress_calls, &total] (std::size_t completed, std::size_t total_a) {
+		++progress_calls;
+		total = total_a;
+	};
+	nano::mutex mutex;
+	std::vector<std::tuple<uint64_t, uint64_t, bool>> ranges;
+	std::vector<unsigned> threads;
+	parallel_traversal<uint64_t> (config, [&] (uint64_t const & start, uint64_t const & end, bool const is_last, unsigned const thread) {
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		ranges.emplace_back (start, end, is_last);
+		threads.push_back (thread);
+	});
+	ASSERT_EQ (32, ranges.size ());
+	ASSERT_EQ (32, progress_calls);
+	ASSERT_EQ (32, total);
+	std::sort (ranges.begin (), ranges.end ());
+	ASSERT_EQ (0, std::get<0> (ranges.front ()));
+	ASSERT_TRUE (std::get<2> (ranges.back ()));
+	for (std::size_t i = 1; i < ranges.size (); ++i)
+	{
+		ASSERT_EQ (std::get<1> (ranges[i - 1]), std::get<0> (ranges[i]));
+		ASSERT_FALSE (std::get<2> (ranges[i - 1]));
+	}
+	ASSERT_TRUE (std::all_of (threads.begin (), threads.end (), [] (auto thread) { return thread < 4; }));
+}
+
+TEST (parallel_traversal, scheduler_steals_largest_run)
+{
+	nano::parallel_traversal_scheduler scheduler{ 2, 8 };
+	// Thread 0 owns ranges 0-3 and thread 1 owns ranges 4-7
+	ASSERT_EQ (4, scheduler.next (1));
+	for (std::size_t range = 0; range < 4; ++range)
+	{
+		ASSERT_EQ (range, scheduler.next (0));
+	}
+	// Thread 0 takes over the upper half of ranges 5-7
+	ASSERT_EQ (6, scheduler.next (0));
+	ASSERT_EQ (5, scheduler.next (1));
+	ASSERT_EQ (7, scheduler.next (0));
+	ASSERT_EQ (std::nullopt, scheduler.next (1));
+	ASSERT_EQ (std::nullopt, scheduler.next (0));
+}
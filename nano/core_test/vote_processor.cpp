@@ -108,6 +108,26 @@ TEST (vote_processor, overflow)
 	ASSERT_LT (std::chrono::system_clock::now () - start_time, 10s);
 }
 
+// Votes queued in bulk are subject to the same per channel limit as individually queued votes
+TEST (vote_processor, vote_batch)
+{
+	nano::test::system system;
+	auto & node (*system.add_node ());
+	nano::keypair key;
+	auto vote = nano::test::make_vote (key, { nano::dev::genesis }, nano::vote::timestamp_min * 1, 0);
+	auto channel (std::make_shared<nano::transport::inproc::channel> (node, node));
+
+	std::vector<std::pair<std::shared_ptr<nano::vote>, nano::vote_source>> votes (node.config.vote_processor.max_non_pr_queue + 10, { vote, nano::vote_source::live });
+	auto const added = node.vote_processor.vote_batch (votes, channel);
+	ASSERT_EQ (votes.size (), added.size ());
+	auto const added_count = std::count (added.begin (), added.end (), true);
+	ASSERT_EQ (node.config.vote_processor.max_non_pr_queue, added_count);
+	// Votes are queued in order, only the tail of the batch overflows
+	ASSERT_TRUE (std::is_partitioned (added.begin (), added.end (), [] (bool added) { return added; }));
+	ASSERT_EQ (votes.size () - added_count, node.stats.count (nano::stat::type::vote_processor, nano::stat::detail::overfill));
+	ASSERT_EQ (added_count, node.stats.count (nano::stat::type::vote_processor, nano::stat::detail::process));
+}
+
 TEST (vote_processor, weights)
 {
 	nano::test::system system (4);
@@ -73,6 +73,39 @@ TEST (vote_generator, cache)
 	ASSERT_TRUE (std::any_of (votes[0]->hashes.begin (), votes[0]->hashes.end (), [hash = epoch1->hash ()] (nano::block_hash const & hash_a) { return hash_a == hash; }));
 }
 
+TEST (vote_generator, final_vote_persisted)
+{
+	nano::test::system system (1);
+	auto & node (*system.nodes[0]);
+	auto epoch1 = system.upgrade_genesis_epoch (node, nano::epoch::epoch_1);
+	system.wallet (0)->insert_adhoc (nano::dev::genesis_key.prv);
+	node.final_generator.add (epoch1->root (), epoch1->hash ());
+	ASSERT_TIMELY (5s, !node.history.votes (epoch1->root (), epoch1->hash ()).empty ());
+	auto votes (node.history.votes (epoch1->root (), epoch1->hash ()));
+	ASSERT_TRUE (votes[0]->is_final ());
+	auto transaction = node.ledger.tx_begin_read ();
+	auto final_hash = node.ledger.store.final_vote.get (transaction, epoch1->qualified_root ());
+	ASSERT_TRUE (final_hash.has_value ());
+	ASSERT_EQ (epoch1->hash (), final_hash.value ());
+}
+
+// A final vote already persisted for a different block with the same root prevents final voting
+TEST (vote_generator, final_vote_conflict)
+{
+	nano::test::system system (1);
+	auto & node (*system.nodes[0]);
+	auto epoch1 = system.upgrade_genesis_epoch (node, nano::epoch::epoch_1);
+	system.wallet (0)->insert_adhoc (nano::dev::genesis_key.prv);
+	{
+		auto transaction = node.ledger.tx_begin_write ();
+		ASSERT_TRUE (node.ledger.store.final_vote.put (transaction, epoch1->qualified_root (), nano::block_hash{ 1 }));
+	}
+	node.final_generator.add (epoch1->root (), epoch1->hash ());
+	ASSERT_NEVER (1s, !node.history.votes (epoch1->root (), epoch1->hash ()).empty ());
+	auto transaction = node.ledger.tx_begin_read ();
+	ASSERT_EQ (nano::block_hash{ 1 }, node.ledger.store.final_vote.get (transaction, epoch1->qualified_root ()).value ());
+}
+
 TEST (vote_generator, multiple_representatives)
 {
 	nano::test::system system (1);
@@ -380,6 +380,87 @@ TEST (wallet, hash_password)
 	ASSERT_NE (hash1, hash3);
 }
 
+TEST (wallet, kdf_cache)
+{
+	unsigned kdf_work = nano::dev::network_params.kdf_work;
+	nano::kdf kdf{ kdf_work, 2, std::chrono::seconds{ 60 } };
+	nano::uint256_union salt1 (1);
+	nano::uint256_union salt2 (2);
+	nano::raw_key key1;
+	kdf.phs (key1, "password", salt1);
+	ASSERT_EQ (1, kdf.cache_size ());
+	nano::raw_key key2;
+	kdf.phs (key2, "password", salt1);
+	ASSERT_EQ (key1, key2);
+	ASSERT_EQ (1, kdf.cache_size ());
+	nano::raw_key key3;
+	kdf.phs (key3, "password", salt2);
+	ASSERT_NE (key1, key3);
+	ASSERT_EQ (2, kdf.cache_size ());
+	// Cached keys must match freshly derived ones
+	nano::kdf uncached{ kdf_work };
+	nano::raw_key key4;
+	uncached.phs (key4, "password", salt2);
+	ASSERT_EQ (key3, key4);
+	ASSERT_EQ (0, uncached.cache_size ());
+	kdf.cache_clear ();
+	ASSERT_EQ (0, kdf.cache_size ());
+}
+
+TEST (wallet, kdf_cache_purge)
+{
+	unsigned kdf_work = nano::dev::network_params.kdf_work;
+	nano::kdf kdf{ kdf_work, 1, std::chrono::seconds{ 1 } };
+	nano::raw_key key;
+	kdf.phs (key, "password", nano::uint256_union{ 1 });
+	ASSERT_EQ (1, kdf.cache_size ());
+	kdf.cache_purge ();
+	ASSERT_EQ (1, kdf.cache_size ());
+	std::this_thread::sleep_for (1s);
+	kdf.cache_purge ();
+	ASSERT_EQ (0, kdf.cache_size ());
+}
+
+// Expired keys are removed by the wallets periodically, without waiting for another derivation, and all keys are removed on stop
+TEST (wallet, kdf_cache_purge_ongoing)
+{
+	nano::test::system system;
+	auto config = system.default_config ();
+	config.kdf_cache_lifetime = 1s;
+	auto & node = *system.add_node (config);
+	auto wallet = system.wallet (0);
+	{
+		auto transaction (wallet->wallets.tx_begin_write ());
+		ASSERT_FALSE (wallet->store.rekey (transaction, "1234"));
+	}
+	ASSERT_FALSE (wallet->enter_password (wallet->wallets.tx_begin_read (), "1234"));
+	ASSERT_GE (node.wallets.kdf.cache_size (), 1);
+	ASSERT_TIMELY_EQ (5s, node.wallets.kdf.cache_size (), 0);
+	ASSERT_FALSE (wallet->enter_password (wallet->wallets.tx_begin_read (), "1234"));
+	ASSERT_GE (node.wallets.kdf.cache_size (), 1);
+	system.stop_node (node);
+	ASSERT_EQ (0, node.wallets.kdf.cache_size ());
+}
+
+TEST (wallet, enter_password_async)
+{
+	nano::test::system system (1);
+	auto wallet = system.wallet (0);
+	{
+		auto transaction (wallet->wallets.tx_begin_write ());
+		ASSERT_FALSE (wallet->store.rekey (transaction, "1234"));
+		ASSERT_TRUE (wallet->store.attempt_password (transaction, "0000"));
+	}
+	std::atomic<int> result{ -1 };
+	wallet->enter_password_async ("0000", [&result] (bool error) { result = error; });
+	ASSERT_TIMELY_EQ (5s, result, 1);
+	ASSERT_FALSE (wallet->store.valid_password (wallet->wallets.tx_begin_read ()));
+	result = -1;
+	wallet->enter_password_async ("1234", [&result] (bool error) { result = error; });
+	ASSERT_TIMELY_EQ (5s, result, 0);
+	ASSERT_TRUE (wallet->store.valid_password (wallet->wallets.tx_begin_read ()));
+}
+
 TEST (fan, reconstitute)
 {
 	nano::raw_key value0 (0);
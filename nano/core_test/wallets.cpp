@@ -2,6 +2,7 @@
 #include <nano/node/active_elections.hpp>
 #include <nano/node/election.hpp>
 #include <nano/node/inactive_node.hpp>
+#include <nano/node/wallet_sweep.hpp>
 #include <nano/secure/ledger.hpp>
 #include <nano/secure/ledger_set_any.hpp>
 #include <nano/store/versioning.hpp>
@@ -262,3 +263,52 @@ TEST (wallets, search_receivable)
 		ASSERT_EQ (send->hash (), receive->source ());
 	}
 }
+
+TEST (wallets, sweep_ordered_delivery)
+{
+	nano::test::system system;
+	auto & node = *system.add_node ();
+	std::vector<nano::account> accounts;
+	for (auto i = 0; i < 3000; ++i)
+	{
+		accounts.push_back (nano::keypair{}.pub);
+	}
+	std::atomic<std::size_t> processed{ 0 };
+	std::vector<std::size_t> delivered;
+	std::atomic<bool> finished{ false };
+	auto sweep = std::make_shared<nano::wallet_sweep> (
+	node.workers, node.ledger, accounts, [&processed] (nano::secure::transaction const &, std::size_t, auto begin, auto end) { processed += std::distance (begin, end); },
+	[&delivered] (std::size_t shard) { delivered.push_back (shard); },
+	4, 100);
+	ASSERT_EQ (30, sweep->shard_count ());
+	bool cancelled = true;
+	sweep->start ([&] (bool cancelled_a) {
+		cancelled = cancelled_a;
+		finished = true;
+	});
+	ASSERT_TIMELY (5s, finished);
+	ASSERT_FALSE (cancelled);
+	ASSERT_EQ (accounts.size (), processed);
+	ASSERT_EQ (accounts.size (), sweep->progress ());
+	ASSERT_EQ (30, delivered.size ());
+	ASSERT_TRUE (std::is_sorted (delivered.begin (), delivered.end ()));
+	ASSERT_EQ (29, delivered.back ());
+}
+
+TEST (wallets, sweep_cancel)
+{
+	nano::test::system system;
+	auto & node = *system.add_node ();
+	std::vector<nano::account> accounts (1000);
+	std::atomic<bool> finished{ false };
+	auto sweep = std::make_shared<nano::wallet_sweep> (node.workers, node.ledger, accounts, [] (nano::secure::transaction const &, std::size_t, auto, auto) {});
+	sweep->cancel ();
+	bool cancelled = false;
+	sweep->start ([&] (bool cancelled_a) {
+		cancelled = cancelled_a;
+		finished = true;
+	});
+	ASSERT_TIMELY (5s, finished);
+	ASSERT_TRUE (cancelled);
+	ASSERT_EQ (0, sweep->progress ());
+}
@@ -3,6 +3,7 @@
 #include <nano/lib/jsonconfig.hpp>
 #include <nano/lib/work_version.hpp>
 #include <nano/node/active_elections.hpp>
+#include <nano/node/election_status.hpp>
 #include <nano/node/online_reps.hpp>
 #include <nano/node/telemetry.hpp>
 #include <nano/node/transport/fake.hpp>
@@ -975,3 +976,139 @@ TEST (websocket, new_unconfirmed_block)
 	ASSERT_EQ ("state", message_contents.get<std::string> ("type"));
 	ASSERT_EQ ("send", message_contents.get<std::string> ("subtype"));
 }
+
+// Confirmation filtering uses the accounts decoded when the message is built
+TEST (websocket, confirmation_options_filter_accounts)
+{
+	nano::test::system system;
+	auto & node = *system.add_node ();
+	nano::keypair key1, key2;
+
+	nano::state_block_builder builder;
+	auto send = builder
+				.account (nano::dev::genesis_key.pub)
+				.previous (nano::dev::genesis->hash ())
+				.representative (nano::dev::genesis_key.pub)
+				.balance (nano::dev::constants.genesis_amount - 1)
+				.link (key1.pub)
+				.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				.work (0)
+				.build ();
+	nano::election_status status{ send, nano::election_status_type::active_confirmed_quorum };
+
+	auto make_options = [&node] (nano::account const & account, bool include_block) {
+		boost::property_tree::ptree accounts;
+		boost::property_tree::ptree entry;
+		entry.put ("", account.to_account ());
+		accounts.push_back (std::make_pair ("", entry));
+		boost::property_tree::ptree options;
+		options.add_child ("accounts", accounts);
+		options.put ("include_block", include_block);
+		return nano::websocket::confirmation_options{ options, node.wallets, node.logger };
+	};
+
+	nano::websocket::message_builder message_builder;
+	auto build = [&] (nano::websocket::confirmation_options const & options) {
+		return message_builder.block_confirmed (send, nano::dev::genesis_key.pub, 1, "send", options.get_include_block (), status, {}, options);
+	};
+
+	// Destination account
+	auto options1 = make_options (key1.pub, true);
+	auto message1 = build (options1);
+	ASSERT_TRUE (message1.confirmation);
+	ASSERT_EQ (key1.pub, message1.confirmation->destination);
+	ASSERT_FALSE (options1.should_filter (message1));
+
+	// Source account
+	auto options2 = make_options (nano::dev::genesis_key.pub, true);
+	ASSERT_FALSE (options2.should_filter (build (options2)));
+
+	// Unrelated account
+	auto options3 = make_options (key2.pub, true);
+	ASSERT_TRUE (options3.should_filter (build (options3)));
+
+	// Account filtering requires block contents
+	auto options4 = make_options (key1.pub, false);
+	auto message4 = build (options4);
+	ASSERT_FALSE (message4.confirmation->destination);
+	ASSERT_TRUE (options4.should_filter (message4));
+	ASSERT_NE (options1.content_variant (), options4.content_variant ());
+}
+
+// Confirmations are routed through the account index to account filtered subscribers and to every unfiltered subscriber
+TEST (websocket, confirmation_index)
+{
+	nano::test::system system;
+	nano::node_config config = system.default_config ();
+	config.websocket_config.enabled = true;
+	config.websocket_config.port = system.get_available_port ();
+	auto & node = *system.add_node (config);
+	auto & server = *node.websocket.server;
+	nano::keypair key1;
+	nano::keypair key2;
+
+	fake_websocket_client filtered (server.listening_port ());
+	filtered.send_message (boost::str (boost::format (R"json({"action": "subscribe", "topic": "confirmation", "ack": "true", "options": {"accounts": ["%1%"]}})json") % key1.pub.to_account ()));
+	filtered.await_ack ();
+	fake_websocket_client unfiltered (server.listening_port ());
+	unfiltered.send_message (R"json({"action": "subscribe", "topic": "confirmation", "ack": "true", "options": {}})json");
+	unfiltered.await_ack ();
+	ASSERT_EQ (1, server.confirmation_indexed_count (key1.pub));
+	ASSERT_EQ (0, server.confirmation_indexed_count (key2.pub));
+	ASSERT_EQ (1, server.confirmation_unindexed_count ());
+
+	auto balance = nano::dev::constants.genesis_amount;
+	auto confirm = [&] (nano::account const & destination) {
+		nano::block_builder builder;
+		auto send = builder.state ()
+					.account (nano::dev::genesis_key.pub)
+					.previous (nano::dev::genesis->hash ())
+					.representative (nano::dev::genesis_key.pub)
+					.balance (--balance)
+					.link (destination)
+					.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+					.work (0)
+					.build ();
+		nano::election_status status{ send, nano::election_status_type::active_confirmed_quorum };
+		server.broadcast_confirmation (send, nano::dev::genesis_key.pub, 1, "send", status, {});
+		return send->hash ();
+	};
+	auto received_hash = [] (fake_websocket_client & client) -> std::string {
+		auto response = client.get_response (1s);
+		if (!response)
+		{
+			return {};
+		}
+		boost::property_tree::ptree event;
+		std::stringstream stream{ *response };
+		boost::property_tree::read_json (stream, event);
+		return event.get<std::string> ("message.hash");
+	};
+
+	// The filtered subscriber only receives confirmations involving its account, the unfiltered one receives everything
+	auto hash1 = confirm (key2.pub);
+	ASSERT_EQ (hash1.to_string (), received_hash (unfiltered));
+	ASSERT_TRUE (received_hash (filtered).empty ());
+	auto hash2 = confirm (key1.pub);
+	ASSERT_EQ (hash2.to_string (), received_hash (unfiltered));
+	ASSERT_EQ (hash2.to_string (), received_hash (filtered));
+
+	// Removing the only account leaves the subscription filtering everything, it is neither indexed nor checked for every confirmation
+	filtered.send_message (boost::str (boost::format (R"json({"action": "update", "topic": "confirmation", "ack": "true", "options": {"accounts_del": ["%1%"]}})json") % key1.pub.to_account ()));
+	filtered.await_ack ();
+	ASSERT_EQ (0, server.confirmation_indexed_count (key1.pub));
+	ASSERT_EQ (1, server.confirmation_unindexed_count ());
+
+	// Adding an account moves the unfiltered subscription into the index
+	unfiltered.send_message (boost::str (boost::format (R"json({"action": "update", "topic": "confirmation", "ack": "true", "options": {"accounts_add": ["%1%"]}})json") % key2.pub.to_account ()));
+	unfiltered.await_ack ();
+	ASSERT_EQ (1, server.confirmation_indexed_count (key2.pub));
+	ASSERT_EQ (0, server.confirmation_unindexed_count ());
+
+	confirm (key1.pub);
+	ASSERT_TRUE (received_hash (unfiltered).empty ());
+	ASSERT_TRUE (received_hash (filtered).empty ());
+	auto hash3 = confirm (key2.pub);
+	ASSERT_EQ (hash3.to_string (), received_hash (unfiltered));
+	ASSERT_TRUE (received_hash (filtered).empty ());
+}
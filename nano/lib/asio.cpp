@@ -1,5 +1,20 @@
 #include <nano/lib/asio.hpp>
 
+std::string_view nano::io_backend ()
+{
+#if defined(BOOST_ASIO_HAS_IO_URING_AS_DEFAULT)
+	return "io_uring";
+#elif defined(BOOST_ASIO_HAS_IOCP)
+	return "iocp";
+#elif defined(BOOST_ASIO_HAS_EPOLL)
+	return "epoll";
+#elif defined(BOOST_ASIO_HAS_KQUEUE)
+	return "kqueue";
+#else
+	return "select";
+#endif
+}
+
 nano::shared_const_buffer::shared_const_buffer (std::vector<uint8_t> const & data) :
 	m_data (std::make_shared<std::vector<uint8_t>> (data)),
 	m_buffer (boost::asio::buffer (*m_data))
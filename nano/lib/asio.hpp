@@ -2,8 +2,13 @@
 
 #include <nano/boost/asio/write.hpp>
 
+#include <string_view>
+
 namespace nano
 {
+/** Name of the mechanism asio uses to wait for socket readiness or completion, selected at build time */
+std::string_view io_backend ();
+
 class shared_const_buffer
 {
 public:
@@ -11,6 +11,7 @@ class block;
 class block_details;
 class block_visitor;
 class container_info;
+class io_context_pool;
 class jsonconfig;
 class mutable_block_visitor;
 class network_constants;
@@ -0,0 +1,269 @@
+#include <nano/lib/assert.hpp>
+#include <nano/lib/json_writer.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+nano::json_writer::json_writer ()
+{
+	// The root object is always written, even if empty
+	stack.push_back ({ .key = {}, .array = false, .omit_if_empty = false, .opened = true });
+	buffer += "{\n";
+}
+
+nano::json_writer & nano::json_writer::put (std::string_view key, std::string_view value)
+{
+	debug_assert (!stack.back ().array);
+	begin_child (key);
+	write_string (value);
+	return *this;
+}
+
+nano::json_writer & nano::json_writer::push (std::string_view value)
+{
+	debug_assert (stack.back ().array);
+	begin_child ({});
+	write_string (value);
+	return *this;
+}
+
+nano::json_writer & nano::json_writer::begin_object (std::string_view key, bool omit_if_empty)
+{
+	debug_assert (!stack.back ().array);
+	return begin (key, false, omit_if_empty);
+}
+
+nano::json_writer & nano::json_writer::begin_object ()
+{
+	debug_assert (stack.back ().array);
+	return begin ({}, false, false);
+}
+
+nano::json_writer & nano::json_writer::begin_array (std::string_view key, bool omit_if_empty)
+{
+	debug_assert (!stack.back ().array);
+	return begin (key, true, omit_if_empty);
+}
+
+nano::json_writer & nano::json_writer::begin_array ()
+{
+	debug_assert (stack.back ().array);
+	return begin ({}, true, false);
+}
+
+nano::json_writer & nano::json_writer::begin (std::string_view key, bool array, bool omit_if_empty)
+{
+	// Nothing is written until the first child, empty containers are written as an empty string
+	stack.push_back ({ .key = std::string{ key }, .array = array, .omit_if_empty = omit_if_empty });
+	return *this;
+}
+
+nano::json_writer & nano::json_writer::end ()
+{
+	debug_assert (stack.size () > 1);
+	auto const index = stack.size () - 1;
+	auto const & current = stack.back ();
+	if (current.opened)
+	{
+		debug_assert (current.has_children);
+		buffer += '\n';
+		indent (index);
+		buffer += current.array ? ']' : '}';
+		stack.pop_back ();
+	}
+	else if (!current.omit_if_empty)
+	{
+		auto key = std::move (stack.back ().key);
+		stack.pop_back ();
+		begin_child (key);
+		write_string ({});
+	}
+	else
+	{
+		stack.pop_back ();
+	}
+	return *this;
+}
+
+nano::json_writer & nano::json_writer::put_tree (std::string_view key, boost::property_tree::ptree const & tree)
+{
+	debug_assert (!stack.back ().array);
+	begin_child (key);
+	write_tree (tree, stack.size ());
+	return *this;
+}
+
+nano::json_writer & nano::json_writer::push_tree (boost::property_tree::ptree const & tree)
+{
+	debug_assert (stack.back ().array);
+	begin_child ({});
+	write_tree (tree, stack.size ());
+	return *this;
+}
+
+nano::json_writer & nano::json_writer::put_children (boost::property_tree::ptree const & tree)
+{
+	for (auto const & [key, child] : tree)
+	{
+		put_tree (key, child);
+	}
+	return *this;
+}
+
+std::string nano::json_writer::finish ()
+{
+	debug_assert (stack.size () == 1);
+	if (stack.back ().has_children)
+	{
+		buffer += '\n';
+	}
+	buffer += "}\n";
+	stack.clear ();
+	return std::move (buffer);
+}
+
+std::size_t nano::json_writer::size () const
+{
+	return buffer.size ();
+}
+
+bool nano::json_writer::empty () const
+{
+	debug_assert (!stack.empty ());
+	return !stack.front ().has_children;
+}
+
+void nano::json_writer::begin_child (std::string_view key)
+{
+	auto const index = stack.size () - 1;
+	if (!stack[index].opened)
+	{
+		open (index);
+	}
+	auto & current = stack[index];
+	if (current.has_children)
+	{
+		buffer += ",\n";
+	}
+	current.has_children = true;
+	indent (index + 1);
+	if (!current.array)
+	{
+		write_string (key);
+		buffer += ": ";
+	}
+}
+
+void nano::json_writer::open (std::size_t index)
+{
+	debug_assert (index > 0);
+	// Opening a container makes it a child of its parent, which may not have been opened yet either
+	auto const parent = index - 1;
+	if (!stack[parent].opened)
+	{
+		open (parent);
+	}
+	auto & parent_frame = stack[parent];
+	if (parent_frame.has_children)
+	{
+		buffer += ",\n";
+	}
+	parent_frame.has_children = true;
+	indent (index);
+	if (!parent_frame.array)
+	{
+		write_string (stack[index].key);
+		buffer += ": ";
+	}
+	buffer += stack[index].array ? "[\n" : "{\n";
+	stack[index].opened = true;
+}
+
+void nano::json_writer::indent (std::size_t level)
+{
+	buffer.append (4 * level, ' ');
+}
+
+/*
+ * Escapes characters the same way as boost::property_tree::json_parser::create_escapes
+ */
+void nano::json_writer::write_string (std::string_view value)
+{
+	static char const * hexdigits = "0123456789ABCDEF";
+	buffer += '"';
+	for (char ch : value)
+	{
+		auto const c = static_cast<unsigned char> (ch);
+		if (c == 0x20 || c == 0x21 || (c >= 0x23 && c <= 0x2E) || (c >= 0x30 && c <= 0x5B) || c >= 0x5D)
+		{
+			buffer += ch;
+		}
+		else
+		{
+			buffer += '\\';
+			switch (ch)
+			{
+				case '\b':
+					buffer += 'b';
+					break;
+				case '\f':
+					buffer += 'f';
+					break;
+				case '\n':
+					buffer += 'n';
+					break;
+				case '\r':
+					buffer += 'r';
+					break;
+				case '\t':
+					buffer += 't';
+					break;
+				case '/':
+					buffer += '/';
+					break;
+				case '"':
+					buffer += '"';
+					break;
+				case '\\':
+					buffer += '\\';
+					break;
+				default:
+					buffer += "u00";
+					buffer += hexdigits[c / 16];
+					buffer += hexdigits[c % 16];
+					break;
+			}
+		}
+	}
+	buffer += '"';
+}
+
+/*
+ * Mirrors boost::property_tree::json_parser::write_json_helper, \p level is the indentation level of the tree
+ */
+void nano::json_writer::write_tree (boost::property_tree::ptree const & tree, std::size_t level)
+{
+	if (tree.empty ())
+	{
+		write_string (tree.data ());
+		return;
+	}
+	bool const array = tree.count ({}) == tree.size ();
+	buffer += array ? "[\n" : "{\n";
+	for (auto i = tree.begin (), n = tree.end (); i != n; ++i)
+	{
+		if (i != tree.begin ())
+		{
+			buffer += ",\n";
+		}
+		indent (level + 1);
+		if (!array)
+		{
+			write_string (i->first);
+			buffer += ": ";
+		}
+		write_tree (i->second, level + 1);
+	}
+	buffer += '\n';
+	indent (level);
+	buffer += array ? ']' : '}';
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Streaming JSON writer, writing directly into a string buffer without building an intermediate ptree.
+ * The output is byte for byte identical to boost::property_tree::write_json with pretty printing enabled:
+ * - all values are written as strings
+ * - empty objects and arrays are written as an empty string ("")
+ * - the root is always an object and the document is terminated by a newline
+ * Keys are written as given, unlike ptree::put they are neither interpreted as paths nor deduplicated.
+ */
+class json_writer final
+{
+public:
+	json_writer ();
+
+	/** Writes a value for \p key in the current object */
+	json_writer & put (std::string_view key, std::string_view value);
+	/** Appends a value to the current array */
+	json_writer & push (std::string_view value);
+
+	/** Starts an object for \p key in the current object. If \p omit_if_empty is set and no children are written, the key is not written either */
+	json_writer & begin_object (std::string_view key, bool omit_if_empty = false);
+	/** Starts an object appended to the current array */
+	json_writer & begin_object ();
+	/** Starts an array for \p key in the current object. If \p omit_if_empty is set and no children are written, the key is not written either */
+	json_writer & begin_array (std::string_view key, bool omit_if_empty = false);
+	/** Starts an array appended to the current array */
+	json_writer & begin_array ();
+	/** Ends the current object or array */
+	json_writer & end ();
+
+	/** Writes \p tree as the value for \p key in the current object */
+	json_writer & put_tree (std::string_view key, boost::property_tree::ptree const & tree);
+	/** Appends \p tree to the current array */
+	json_writer & push_tree (boost::property_tree::ptree const & tree);
+	/** Writes all children of \p tree into the current object */
+	json_writer & put_children (boost::property_tree::ptree const & tree);
+
+	/** Ends the root object and returns the document. The writer must not be used afterwards */
+	std::string finish ();
+
+	/** Number of bytes written so far */
+	std::size_t size () const;
+	/** True if nothing has been written to the root object yet */
+	bool empty () const;
+
+private:
+	class frame final
+	{
+	public:
+		std::string key;
+		bool array;
+		bool omit_if_empty;
+		bool opened{ false };
+		bool has_children{ false };
+	};
+
+	json_writer & begin (std::string_view key, bool array, bool omit_if_empty);
+	/** Prepares the current frame for a new child and writes its separator, indentation and key (if in an object) */
+	void begin_child (std::string_view key);
+	void open (std::size_t index);
+	void indent (std::size_t level);
+	void write_string (std::string_view value);
+	void write_tree (boost::property_tree::ptree const & tree, std::size_t level);
+
+private:
+	std::string buffer;
+	std::vector<frame> stack;
+};
+}
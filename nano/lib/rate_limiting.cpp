@@ -2,8 +2,6 @@
 #include <nano/lib/rate_limiting.hpp>
 #include <nano/lib/utility.hpp>
 
-#include <limits>
-
 /*
  * token_bucket
  */
@@ -72,25 +70,71 @@ std::size_t nano::rate::token_bucket::size () const
  * rate_limiter
  */
 
-nano::rate_limiter::rate_limiter (std::size_t limit_a, double burst_ratio_a) :
-	bucket (static_cast<std::size_t> (limit_a * burst_ratio_a), limit_a)
+namespace
+{
+int64_t steady_now ()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+/** Nanoseconds it takes to refill \p tokens */
+int64_t refill_time (std::size_t tokens, std::size_t rate)
+{
+	debug_assert (rate > 0);
+	return static_cast<int64_t> (static_cast<double> (tokens) * 1e9 / static_cast<double> (rate));
+}
+}
+
+nano::rate_limiter::rate_limiter (std::size_t limit_a, double burst_ratio_a)
 {
+	reset (limit_a, burst_ratio_a);
 }
 
 bool nano::rate_limiter::should_pass (std::size_t message_size_a)
 {
-	nano::lock_guard<nano::mutex> guard{ mutex };
-	return bucket.try_consume (nano::narrow_cast<unsigned int> (message_size_a));
+	auto const rate = refill_rate.load (std::memory_order_acquire);
+	if (rate == 0)
+	{
+		return true;
+	}
+	auto const now = steady_now ();
+	auto const cost = refill_time (message_size_a, rate);
+	// Tokens are not accumulated beyond the capacity
+	auto const earliest = now - refill_time (capacity.load (std::memory_order_relaxed), rate);
+	auto empty = empty_time.load (std::memory_order_relaxed);
+	while (true)
+	{
+		auto const start = std::max (empty, earliest);
+		if (start + cost > now)
+		{
+			return false;
+		}
+		if (empty_time.compare_exchange_weak (empty, start + cost, std::memory_order_relaxed))
+		{
+			return true;
+		}
+	}
 }
 
 void nano::rate_limiter::reset (std::size_t limit_a, double burst_ratio_a)
 {
-	nano::lock_guard<nano::mutex> guard{ mutex };
-	bucket.reset (static_cast<std::size_t> (limit_a * burst_ratio_a), limit_a);
+	auto const capacity_l = static_cast<std::size_t> (limit_a * burst_ratio_a);
+	// A limit or capacity of 0 is unlimited
+	auto const rate = capacity_l == 0 ? 0 : limit_a;
+	capacity.store (capacity_l, std::memory_order_relaxed);
+	// Starts with a full bucket
+	empty_time.store (rate == 0 ? 0 : steady_now () - refill_time (capacity_l, rate), std::memory_order_relaxed);
+	refill_rate.store (rate, std::memory_order_release);
 }
 
 std::size_t nano::rate_limiter::size () const
 {
-	nano::lock_guard<nano::mutex> guard{ mutex };
-	return bucket.size ();
-}
\ No newline at end of file
+	auto const rate = refill_rate.load (std::memory_order_acquire);
+	if (rate == 0)
+	{
+		// Same sentinel the token bucket reports for unlimited buckets
+		return static_cast<std::size_t> (1e9);
+	}
+	auto const elapsed = std::max<int64_t> (0, steady_now () - empty_time.load (std::memory_order_relaxed));
+	return std::min (capacity.load (std::memory_order_relaxed), static_cast<std::size_t> (static_cast<double> (elapsed) / 1e9 * static_cast<double> (rate)));
+}
@@ -3,6 +3,7 @@
 #include <nano/lib/locks.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <mutex>
 
@@ -63,6 +64,12 @@ private:
 
 namespace nano
 {
+/**
+ * Thread safe token bucket, shared by many callers such as the sending coroutines of all channels.
+ * Instead of a token count and a refill time guarded by a mutex, the bucket is kept as the time at which it was empty,
+ * the tokens available at any moment follow from the refill rate. Consuming tokens moves that time forward with a single
+ * compare and swap, so concurrent callers never block each other.
+ */
 class rate_limiter final
 {
 public:
@@ -75,7 +82,11 @@ public:
 	std::size_t size () const;
 
 private:
-	nano::rate::token_bucket bucket;
-	mutable nano::mutex mutex;
+	/** Tokens per second, 0 is unlimited */
+	std::atomic<std::size_t> refill_rate{ 0 };
+	/** Maximum number of tokens, which limits bursts */
+	std::atomic<std::size_t> capacity{ 0 };
+	/** Steady clock time in nanoseconds at which the bucket was empty, it is full once the capacity was refilled since */
+	std::atomic<int64_t> empty_time{ 0 };
 };
 }
@@ -32,6 +32,8 @@ nano::error nano::rpc_config::serialize_toml (nano::tomlconfig & toml) const
 	rpc_process_l.put ("ipc_address", rpc_process.ipc_address, "Address of IPC server.\ntype:string,ip");
 	rpc_process_l.put ("ipc_port", rpc_process.ipc_port, "Listening port of IPC server.\ntype:uint16");
 	rpc_process_l.put ("num_ipc_connections", rpc_process.num_ipc_connections, "Number of IPC connections to establish.\ntype:uint32");
+	rpc_process_l.put ("max_ipc_connections", rpc_process.max_ipc_connections, "Maximum number of IPC connections to establish when all connections are busy.\ntype:uint32");
+	rpc_process_l.put ("ipc_pipeline_depth", rpc_process.ipc_pipeline_depth, "Maximum number of requests in flight on a single IPC connection.\ntype:uint32");
 	toml.put_child ("process", rpc_process_l);
 
 	nano::tomlconfig rpc_logging_l;
@@ -67,6 +69,8 @@ nano::error nano::rpc_config::deserialize_toml (nano::tomlconfig & toml)
 			rpc_process_l->get_optional<boost::asio::ip::address_v6> ("ipc_address", ipc_address_l, boost::asio::ip::address_v6::loopback ());
 			rpc_process.ipc_address = address_l.to_string ();
 			rpc_process_l->get_optional<unsigned> ("num_ipc_connections", rpc_process.num_ipc_connections);
+			rpc_process_l->get_optional<unsigned> ("max_ipc_connections", rpc_process.max_ipc_connections);
+			rpc_process_l->get_optional<unsigned> ("ipc_pipeline_depth", rpc_process.ipc_pipeline_depth);
 		}
 	}
 
@@ -25,6 +25,10 @@ public:
 	uint16_t ipc_port{ network_constants.default_ipc_port };
 	unsigned num_ipc_connections{ (network_constants.is_live_network () || network_constants.is_test_network ()) ? 8u : network_constants.is_beta_network () ? 4u
 																																							 : 1u };
+	/** Upper bound the IPC connection pool may grow to under load, it never shrinks below num_ipc_connections */
+	unsigned max_ipc_connections{ num_ipc_connections * 4 };
+	/** Number of requests which may be written to a single IPC connection before their responses have been read */
+	unsigned ipc_pipeline_depth{ 4 };
 };
 
 class rpc_logging_config final
@@ -298,6 +298,7 @@ enum class detail
 	invalid_publish_message,
 	invalid_confirm_req_message,
 	invalid_confirm_ack_message,
+	invalid_compact_confirm_ack_message,
 	invalid_node_id_handshake_message,
 	invalid_telemetry_req_message,
 	invalid_telemetry_ack_message,
@@ -362,6 +363,8 @@ enum class detail
 	// tcp_channel
 	wait_socket,
 	wait_bandwidth,
+	compact_vote,
+	compact_vote_saved_bytes,
 
 	// tcp_channels
 	channel_accepted,
@@ -619,6 +622,13 @@ enum class detail
 	rep_update,
 	update_online,
 
+	// ledger cache snapshot
+	snapshot_loaded,
+	snapshot_missing,
+	snapshot_invalid,
+	snapshot_stale,
+	snapshot_written,
+
 	// error codes
 	no_buffer_space,
 	timed_out,
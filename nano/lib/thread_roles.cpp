@@ -61,9 +61,6 @@ std::string nano::thread_role::get_string (nano::thread_role::name role)
 		case nano::thread_role::name::signature_checking:
 			thread_role_name_string = "Signature check";
 			break;
-		case nano::thread_role::name::rpc_request_processor:
-			thread_role_name_string = "RPC processor";
-			break;
 		case nano::thread_role::name::rpc_process_container:
 			thread_role_name_string = "RPC process";
 			break;
@@ -79,6 +76,9 @@ std::string nano::thread_role::get_string (nano::thread_role::name role)
 		case nano::thread_role::name::wallet_worker:
 			thread_role_name_string = "Wallet work";
 			break;
+		case nano::thread_role::name::wallet_kdf:
+			thread_role_name_string = "Wallet KDF";
+			break;
 		case nano::thread_role::name::election_worker:
 			thread_role_name_string = "Election work";
 			break;
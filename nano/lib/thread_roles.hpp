@@ -25,12 +25,12 @@ enum class name
 	bootstrap_connections,
 	voting,
 	signature_checking,
-	rpc_request_processor,
 	rpc_process_container,
 	confirmation_height,
 	confirmation_height_notifications,
 	worker,
 	wallet_worker,
+	wallet_kdf,
 	election_worker,
 	request_aggregator,
 	state_block_signature_verification,
@@ -107,3 +107,52 @@ void nano::thread_runner::run ()
 		}
 	}
 }
+
+/*
+ * io_context_pool
+ */
+
+nano::io_context_pool::io_context_pool (asio::io_context & default_ctx_a, nano::logger & logger_a, unsigned shards_a) :
+	default_ctx{ default_ctx_a }
+{
+	for (unsigned i = 0; i < shards_a; ++i)
+	{
+		auto & ctx = contexts.emplace_back (std::make_shared<asio::io_context> (/* concurrency hint */ 1));
+		runners.emplace_back (std::make_unique<nano::thread_runner> (ctx, logger_a, 1u));
+	}
+}
+
+nano::io_context_pool::~io_context_pool ()
+{
+	join ();
+}
+
+boost::asio::io_context & nano::io_context_pool::next ()
+{
+	if (contexts.empty ())
+	{
+		return default_ctx;
+	}
+	return *contexts[counter++ % contexts.size ()];
+}
+
+std::size_t nano::io_context_pool::size () const
+{
+	return contexts.size ();
+}
+
+void nano::io_context_pool::join ()
+{
+	for (auto & runner : runners)
+	{
+		runner->join ();
+	}
+}
+
+void nano::io_context_pool::abort ()
+{
+	for (auto & runner : runners)
+	{
+		runner->abort ();
+	}
+}
@@ -8,6 +8,10 @@
 
 #include <boost/thread.hpp>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 namespace nano
 {
 namespace asio = boost::asio;
@@ -39,6 +43,31 @@ private:
 	void run ();
 };
 
+/**
+ * Independent io_contexts, each run by a single thread, peer connections are spread over them round robin.
+ * Handlers of different shards never share a scheduler queue or lock, so a connection must only post work to its own shard.
+ * Without shards every connection is assigned to the default io_context.
+ */
+class io_context_pool final
+{
+public:
+	io_context_pool (asio::io_context & default_ctx, nano::logger &, unsigned shards);
+	~io_context_pool ();
+
+	/** io_context the next connection is assigned to */
+	asio::io_context & next ();
+	std::size_t size () const;
+
+	void join ();
+	void abort ();
+
+private:
+	asio::io_context & default_ctx;
+	std::vector<std::shared_ptr<asio::io_context>> contexts;
+	std::vector<std::unique_ptr<nano::thread_runner>> runners;
+	std::atomic<std::size_t> counter{ 0 };
+};
+
 constexpr unsigned asio_handler_tracking_threshold ()
 {
 #if NANO_ASIO_HANDLER_TRACKING == 0
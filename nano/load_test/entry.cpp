@@ -11,6 +11,7 @@
 #include <nano/lib/threading.hpp>
 #include <nano/lib/tomlconfig.hpp>
 #include <nano/node/daemonconfig.hpp>
+#include <nano/secure/block_corpus.hpp>
 #include <nano/secure/utility.hpp>
 #include <nano/test_common/testutil.hpp>
 
@@ -490,6 +491,66 @@ account_info account_info_rpc (boost::asio::io_context & ioc, tcp::resolver::res
 	return account_info;
 }
 
+void process_rpc (boost::asio::io_context & ioc, tcp::resolver::results_type const & results, nano::block const & block)
+{
+	boost::property_tree::ptree request;
+	request.put ("action", "process");
+	request.put ("json_block", "true");
+	boost::property_tree::ptree block_l;
+	block.serialize_json (block_l);
+	request.add_child ("block", block_l);
+
+	auto json = rpc_request (request, ioc, results);
+	auto error = json.get_optional<std::string> ("error");
+	if (error)
+	{
+		throw std::runtime_error ("Processing " + block.hash ().to_string () + " failed: " + *error);
+	}
+}
+
+uint64_t block_count_rpc (boost::asio::io_context & ioc, tcp::resolver::results_type const & results)
+{
+	boost::property_tree::ptree request;
+	request.put ("action", "block_count");
+
+	auto json = rpc_request (request, ioc, results);
+	return json.get<uint64_t> ("count");
+}
+
+/** Publishes all blocks of the corpus except its forks to the primary node and waits for every other node to reach the same block count */
+void publish_corpus (boost::asio::io_context & ioc, tcp::resolver & resolver, tcp::resolver::results_type const & primary_node_results, int node_count, std::filesystem::path const & path)
+{
+	nano::block_corpus corpus{ path };
+	for (uint64_t i = 0; i < corpus.block_count; ++i)
+	{
+		process_rpc (ioc, primary_node_results, *corpus.next ());
+		if ((i + 1) % 1000 == 0 || i + 1 == corpus.block_count)
+		{
+			std::cout << "\rPrimary node processing corpus: " << (i + 1) << "/" << corpus.block_count << std::flush;
+		}
+	}
+	std::cout << std::endl;
+
+	std::cout << "Waiting for nodes to catch up..." << std::endl;
+	auto const expected = block_count_rpc (ioc, primary_node_results);
+	nano::timer<std::chrono::milliseconds> timer;
+	timer.start ();
+	for (int i = 1; i < node_count; ++i)
+	{
+		auto const results = resolver.resolve ("::1", std::to_string (rpc_port_start + i));
+		while (block_count_rpc (ioc, results) < expected)
+		{
+			if (timer.since_start () > std::chrono::seconds (120))
+			{
+				throw std::runtime_error ("Timed out");
+			}
+			std::this_thread::sleep_for (std::chrono::seconds (1));
+		}
+		stop_rpc (ioc, results);
+	}
+	stop_rpc (ioc, primary_node_results);
+}
+
 /** This launches a node and fires a lot of send/recieve RPC requests at it (configurable), then other nodes are tested to make sure they observe these blocks as well. */
 int main (int argc, char * const * argv)
 {
@@ -506,7 +567,8 @@ int main (int argc, char * const * argv)
 		("simultaneous_process_calls", boost::program_options::value<int> ()->default_value (20), "Number of simultaneous rpc sends to do")
 		("destination_count", boost::program_options::value<int> ()->default_value (2), "How many destination accounts to choose between")
 		("node_path", boost::program_options::value<std::string> (), "The path to the nano_node to test")
-		("rpc_path", boost::program_options::value<std::string> (), "The path to the nano_rpc to test");
+		("rpc_path", boost::program_options::value<std::string> (), "The path to the nano_rpc to test")
+		("corpus", boost::program_options::value<std::string> (), "Publish the blocks of a corpus generated with nano_node --debug_generate_corpus instead of sending from a wallet");
 	// clang-format on
 
 	boost::program_options::variables_map vm;
@@ -525,6 +587,11 @@ int main (int argc, char * const * argv)
 	auto destination_count = vm.find ("destination_count")->second.as<int> ();
 	auto send_count = vm.find ("send_count")->second.as<int> ();
 	auto simultaneous_process_calls = vm.find ("simultaneous_process_calls")->second.as<int> ();
+	std::filesystem::path corpus_path;
+	if (auto corpus_it = vm.find ("corpus"); corpus_it != vm.end ())
+	{
+		corpus_path = corpus_it->second.as<std::string> ();
+	}
 
 	boost::system::error_code err;
 	auto running_executable_filepath = boost::dll::program_location (err);
@@ -608,12 +675,19 @@ int main (int argc, char * const * argv)
 	tcp::resolver resolver{ ioc };
 	auto const primary_node_results = resolver.resolve ("::1", std::to_string (rpc_port_start));
 
-	std::thread t ([send_count, &ioc, &primary_node_results, &resolver, &node_count, &destination_count] () {
+	std::thread t ([send_count, &ioc, &primary_node_results, &resolver, &node_count, &destination_count, &corpus_path] () {
 		for (int i = 0; i < node_count; ++i)
 		{
 			keepalive_rpc (ioc, primary_node_results, peering_port_start + i);
 		}
 
+		if (!corpus_path.empty ())
+		{
+			std::cout << "Beginning corpus test" << std::endl;
+			publish_corpus (ioc, resolver, primary_node_results, node_count, corpus_path);
+			return;
+		}
+
 		std::cout << "Beginning tests" << std::endl;
 
 		// Create keys
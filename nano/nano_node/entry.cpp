@@ -17,8 +17,10 @@
 #include <nano/node/node.hpp>
 #include <nano/node/online_reps.hpp>
 #include <nano/node/transport/inproc.hpp>
+#include <nano/secure/block_corpus.hpp>
 #include <nano/secure/ledger.hpp>
 #include <nano/secure/ledger_set_any.hpp>
+#include <nano/secure/parallel_traversal.hpp>
 #include <nano/secure/vote.hpp>
 #include <nano/store/pending.hpp>
 
@@ -115,6 +117,7 @@ int main (int argc, char * const * argv)
 		("debug_block_dump", "Display all the blocks in the ledger in text format")
 		("debug_block_count", "Display the number of blocks")
 		("debug_bootstrap_generate", "Generate bootstrap sequence of blocks")
+		("debug_generate_corpus", "Generate a corpus of blocks on top of the dev genesis into <file>, keys are derived from <seed>")
 		("debug_dump_frontier_unchecked_dependents", "Dump frontiers which have matching unchecked keys")
 		("debug_dump_trended_weight", "Dump trended weights table")
 		("debug_dump_representatives", "List representatives and weights")
@@ -148,6 +151,11 @@ int main (int argc, char * const * argv)
 		("difficulty", boost::program_options::value<std::string> (), "Defines <difficulty> for OpenCL command, HEX")
 		("multiplier", boost::program_options::value<std::string> (), "Defines <multiplier> for work generation. Overrides <difficulty>")
 		("count", boost::program_options::value<std::string> (), "Defines <count> for various commands")
+		("accounts", boost::program_options::value<std::string> (), "Defines the number of <accounts> for --debug_generate_corpus")
+		("depth", boost::program_options::value<std::string> (), "Defines the number of send and receive rounds per account for --debug_generate_corpus")
+		("fanout", boost::program_options::value<std::string> (), "Defines the number of distinct destinations per account for --debug_generate_corpus")
+		("forks", boost::program_options::value<std::string> (), "Defines the number of forked frontiers for --debug_generate_corpus")
+		("corpus", boost::program_options::value<std::string> (), "Defines the block <corpus> file processed by --debug_profile_process instead of generating blocks")
 		("pow_sleep_interval", boost::program_options::value<std::string> (), "Defines the amount to sleep inbetween each pow calculation attempt")
 		("address_column", boost::program_options::value<std::string> (), "Defines which column the addresses are located, 0 indexed (check --debug_output_last_backtrace_dump output)")
 		("silent", "Silent command execution")
@@ -433,6 +441,59 @@ int main (int argc, char * const * argv)
 				result = -1;
 			}
 		}
+		else if (vm.count ("debug_generate_corpus"))
+		{
+			nano::block_corpus_topology topology;
+			auto file_it = vm.find ("file");
+			auto seed_it = vm.find ("seed");
+			if (file_it != vm.end () && seed_it != vm.end () && !topology.seed.decode_hex (seed_it->second.as<std::string> ()))
+			{
+				auto parse = [&vm, &result] (std::string const & name, uint32_t & value) {
+					auto it = vm.find (name);
+					if (it != vm.end ())
+					{
+						try
+						{
+							value = boost::lexical_cast<uint32_t> (it->second.as<std::string> ());
+						}
+						catch (boost::bad_lexical_cast &)
+						{
+							std::cerr << "Invalid " << name << " parameter\n";
+							result = -1;
+						}
+					}
+				};
+				parse ("accounts", topology.accounts);
+				parse ("depth", topology.depth);
+				parse ("fanout", topology.fanout);
+				parse ("forks", topology.forks);
+				if (result == 0)
+				{
+					// Blocks are always built on the dev genesis and carry work for the dev network thresholds
+					nano::work_pool work{ nano::dev::network_params.network, std::numeric_limits<unsigned>::max () };
+					std::cout << boost::str (boost::format ("Generating %1% blocks and %2% forks\n") % topology.block_count () % std::min (topology.forks, topology.accounts));
+					auto begin (std::chrono::steady_clock::now ());
+					auto error = nano::generate_block_corpus (file_it->second.as<std::string> (), topology, work, [] (uint64_t generated, uint64_t total) {
+						std::cout << boost::str (boost::format ("%1% of %2% blocks generated\n") % generated % total);
+					});
+					if (!error)
+					{
+						auto time (std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now () - begin).count ());
+						std::cout << boost::str (boost::format ("Corpus written in %1% seconds\n") % time);
+					}
+					else
+					{
+						std::cerr << "Error writing corpus\n";
+						result = -1;
+					}
+				}
+			}
+			else
+			{
+				std::cerr << "Generating a corpus requires one <file> and one hex <seed> option\n";
+				result = -1;
+			}
+		}
 		else if (vm.count ("debug_dump_trended_weight"))
 		{
 			auto inactive_node = nano::default_inactive_node (data_path, vm);
@@ -940,89 +1001,106 @@ int main (int argc, char * const * argv)
 		}
 		else if (vm.count ("debug_profile_process"))
 		{
-			nano::block_builder builder;
-			size_t num_accounts (100000);
-			size_t num_iterations (5); // 100,000 * 5 * 2 = 1,000,000 blocks
-			size_t max_blocks (2 * num_accounts * num_iterations + num_accounts * 2); //  1,000,000 + 2 * 100,000 = 1,200,000 blocks
-			std::cout << boost::str (boost::format ("Starting pregenerating %1% blocks\n") % max_blocks);
 			nano::node_flags node_flags;
 			nano::update_flags (node_flags, vm);
 			nano::inactive_node inactive_node (nano::unique_path (), data_path, node_flags);
 			auto node = inactive_node.node;
 
-			nano::block_hash genesis_latest (node->latest (nano::dev::genesis_key.pub));
-			nano::uint128_t genesis_balance (std::numeric_limits<nano::uint128_t>::max ());
-			// Generating keys
-			std::vector<nano::keypair> keys (num_accounts);
-			std::vector<nano::root> frontiers (num_accounts);
-			std::vector<nano::uint128_t> balances (num_accounts, 1000000000);
-			// Generating blocks
 			std::deque<std::shared_ptr<nano::block>> blocks;
-			for (auto i (0); i != num_accounts; ++i)
-			{
-				genesis_balance = genesis_balance - 1000000000;
-
-				auto send = builder.state ()
-							.account (nano::dev::genesis_key.pub)
-							.previous (genesis_latest)
-							.representative (nano::dev::genesis_key.pub)
-							.balance (genesis_balance)
-							.link (keys[i].pub)
-							.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
-							.work (*node->work.generate (nano::work_version::work_1, genesis_latest, node->network_params.work.epoch_1))
-							.build ();
-
-				genesis_latest = send->hash ();
-				blocks.push_back (std::move (send));
-
-				auto open = builder.state ()
-							.account (keys[i].pub)
-							.previous (0)
-							.representative (keys[i].pub)
-							.balance (balances[i])
-							.link (genesis_latest)
-							.sign (keys[i].prv, keys[i].pub)
-							.work (*node->work.generate (nano::work_version::work_1, keys[i].pub, node->network_params.work.epoch_1))
-							.build ();
-
-				frontiers[i] = open->hash ();
-				blocks.push_back (std::move (open));
+			size_t max_blocks (0);
+			auto corpus_it = vm.find ("corpus");
+			if (corpus_it != vm.end ())
+			{
+				// Forks are left out, every block of the corpus is expected to be processed
+				nano::block_corpus corpus{ corpus_it->second.as<std::string> () };
+				max_blocks = corpus.block_count;
+				std::cout << boost::str (boost::format ("Loading %1% blocks from corpus\n") % max_blocks);
+				for (uint64_t i = 0; i < corpus.block_count; ++i)
+				{
+					blocks.push_back (corpus.next ());
+				}
 			}
-			for (auto i (0); i != num_iterations; ++i)
+			else
 			{
-				for (auto j (0); j != num_accounts; ++j)
+				nano::block_builder builder;
+				size_t num_accounts (100000);
+				size_t num_iterations (5); // 100,000 * 5 * 2 = 1,000,000 blocks
+				max_blocks = 2 * num_accounts * num_iterations + num_accounts * 2; //  1,000,000 + 2 * 100,000 = 1,200,000 blocks
+				std::cout << boost::str (boost::format ("Starting pregenerating %1% blocks\n") % max_blocks);
+
+				nano::block_hash genesis_latest (node->latest (nano::dev::genesis_key.pub));
+				nano::uint128_t genesis_balance (std::numeric_limits<nano::uint128_t>::max ());
+				// Generating keys
+				std::vector<nano::keypair> keys (num_accounts);
+				std::vector<nano::root> frontiers (num_accounts);
+				std::vector<nano::uint128_t> balances (num_accounts, 1000000000);
+				// Generating blocks
+				for (auto i (0); i != num_accounts; ++i)
 				{
-					size_t other (num_accounts - j - 1);
-					// Sending to other account
-					--balances[j];
+					genesis_balance = genesis_balance - 1000000000;
 
 					auto send = builder.state ()
-								.account (keys[j].pub)
-								.previous (frontiers[j].as_block_hash ())
-								.representative (keys[j].pub)
-								.balance (balances[j])
-								.link (keys[other].pub)
-								.sign (keys[j].prv, keys[j].pub)
-								.work (*node->work.generate (nano::work_version::work_1, frontiers[j], node->network_params.work.epoch_1))
+								.account (nano::dev::genesis_key.pub)
+								.previous (genesis_latest)
+								.representative (nano::dev::genesis_key.pub)
+								.balance (genesis_balance)
+								.link (keys[i].pub)
+								.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+								.work (*node->work.generate (nano::work_version::work_1, genesis_latest, node->network_params.work.epoch_1))
 								.build ();
 
-					frontiers[j] = send->hash ();
+					genesis_latest = send->hash ();
 					blocks.push_back (std::move (send));
-					// Receiving
-					++balances[other];
-
-					auto receive = builder.state ()
-								   .account (keys[other].pub)
-								   .previous (frontiers[other].as_block_hash ())
-								   .representative (keys[other].pub)
-								   .balance (balances[other])
-								   .link (frontiers[j].as_block_hash ())
-								   .sign (keys[other].prv, keys[other].pub)
-								   .work (*node->work.generate (nano::work_version::work_1, frontiers[other], node->network_params.work.epoch_1))
-								   .build ();
-
-					frontiers[other] = receive->hash ();
-					blocks.push_back (std::move (receive));
+
+					auto open = builder.state ()
+								.account (keys[i].pub)
+								.previous (0)
+								.representative (keys[i].pub)
+								.balance (balances[i])
+								.link (genesis_latest)
+								.sign (keys[i].prv, keys[i].pub)
+								.work (*node->work.generate (nano::work_version::work_1, keys[i].pub, node->network_params.work.epoch_1))
+								.build ();
+
+					frontiers[i] = open->hash ();
+					blocks.push_back (std::move (open));
+				}
+				for (auto i (0); i != num_iterations; ++i)
+				{
+					for (auto j (0); j != num_accounts; ++j)
+					{
+						size_t other (num_accounts - j - 1);
+						// Sending to other account
+						--balances[j];
+
+						auto send = builder.state ()
+									.account (keys[j].pub)
+									.previous (frontiers[j].as_block_hash ())
+									.representative (keys[j].pub)
+									.balance (balances[j])
+									.link (keys[other].pub)
+									.sign (keys[j].prv, keys[j].pub)
+									.work (*node->work.generate (nano::work_version::work_1, frontiers[j], node->network_params.work.epoch_1))
+									.build ();
+
+						frontiers[j] = send->hash ();
+						blocks.push_back (std::move (send));
+						// Receiving
+						++balances[other];
+
+						auto receive = builder.state ()
+									   .account (keys[other].pub)
+									   .previous (frontiers[other].as_block_hash ())
+									   .representative (keys[other].pub)
+									   .balance (balances[other])
+									   .link (frontiers[j].as_block_hash ())
+									   .sign (keys[other].prv, keys[other].pub)
+									   .work (*node->work.generate (nano::work_version::work_1, frontiers[other], node->network_params.work.epoch_1))
+									   .build ();
+
+						frontiers[other] = receive->hash ();
+						blocks.push_back (std::move (receive));
+					}
 				}
 			}
 			// Processing blocks
@@ -1402,12 +1480,9 @@ int main (int argc, char * const * argv)
 				}
 			}
 			threads_count = std::max (1u, threads_count);
-			std::vector<std::thread> threads;
-			nano::mutex mutex;
-			nano::condition_variable condition;
-			std::atomic<bool> finished (false);
-			std::deque<std::pair<nano::account, nano::account_info>> accounts;
-			std::atomic<size_t> count (0);
+			nano::parallel_traversal_config traversal_config;
+			traversal_config.threads = threads_count;
+			std::atomic<uint64_t> count (0);
 			std::atomic<uint64_t> block_count (0);
 			std::atomic<uint64_t> errors (0);
 
@@ -1421,37 +1496,115 @@ int main (int argc, char * const * argv)
 				++errors;
 			};
 
-			auto start_threads = [node, &threads_count, &threads, &mutex, &condition, &finished] (auto const & function_a, auto & deque_a) {
-				for (auto i (0U); i < threads_count; ++i)
+			/*
+			 * Runs one validation pass with the key space split into ranges which are traversed in parallel, each range with its own read transaction.
+			 * While the pass is running a JSON progress line is printed every 10 seconds, \p processed and \p total are used for the rate and ETA.
+			 */
+			auto run_pass = [&silent, &traversal_config, node] (std::string const & phase, std::atomic<uint64_t> const & processed, uint64_t total, std::function<void (nano::secure::read_transaction const &, nano::uint256_t const &, nano::uint256_t const &, bool)> const & action) {
+				nano::mutex progress_mutex;
+				nano::condition_variable progress_condition;
+				bool pass_finished (false);
+				auto const start (std::chrono::steady_clock::now ());
+				std::thread progress_thread ([&] () {
+					nano::unique_lock<nano::mutex> lock{ progress_mutex };
+					while (!progress_condition.wait_for (lock, std::chrono::seconds (10), [&pass_finished] () { return pass_finished; }))
+					{
+						if (!silent)
+						{
+							auto const processed_l (processed.load ());
+							auto const elapsed (std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ());
+							auto const rate (processed_l / std::max (elapsed, 1.0));
+							auto const eta (rate > 0 && total > processed_l ? static_cast<uint64_t> ((total - processed_l) / rate) : 0);
+							std::cout << boost::str (boost::format ("{\"phase\": \"%1%\", \"processed\": %2%, \"total\": %3%, \"per_second\": %4%, \"eta_seconds\": %5%}\n") % phase % processed_l % total % static_cast<uint64_t> (rate) % eta) << std::flush;
+						}
+					}
+				});
+				parallel_traversal<nano::uint256_t> (traversal_config, [&action, node] (nano::uint256_t const & start, nano::uint256_t const & end, bool const is_last, unsigned const) {
+					auto transaction = node->ledger.tx_begin_read ();
+					action (transaction, start, end, is_last);
+				});
+				{
+					nano::lock_guard<nano::mutex> lock{ progress_mutex };
+					pass_finished = true;
+				}
+				progress_condition.notify_all ();
+				progress_thread.join ();
+			};
+
+			/** Signatures of one traversal range, collected while walking the account chains and verified in batches */
+			class signature_batch
+			{
+			public:
+				void add (nano::account const & account, nano::block_hash const & hash, std::shared_ptr<nano::block> const & block)
+				{
+					accounts.push_back (account);
+					hashes.push_back (hash);
+					blocks.push_back (block);
+				}
+				bool full () const
+				{
+					return blocks.size () >= 256;
+				}
+				std::vector<nano::account> accounts;
+				std::vector<nano::block_hash> hashes;
+				std::vector<std::shared_ptr<nano::block>> blocks;
+			};
+
+			auto verify_signatures = [&print_error_message, node] (nano::secure::read_transaction const & transaction, signature_batch & batch_a) {
+				auto const size (batch_a.blocks.size ());
+				std::vector<unsigned char const *> messages (size);
+				std::vector<size_t> lengths (size, sizeof (nano::block_hash));
+				std::vector<unsigned char const *> keys (size);
+				std::vector<unsigned char const *> signatures (size);
+				std::vector<int> verifications (size, 0);
+				for (std::size_t i (0); i < size; ++i)
+				{
+					messages[i] = batch_a.hashes[i].bytes.data ();
+					keys[i] = batch_a.accounts[i].bytes.data ();
+					signatures[i] = batch_a.blocks[i]->block_signature ().bytes.data ();
+				}
+				if (size > 0)
+				{
+					nano::validate_message_batch (messages.data (), lengths.data (), keys.data (), signatures.data (), size, verifications.data ());
+				}
+				for (std::size_t i (0); i < size; ++i)
 				{
-					threads.emplace_back ([&function_a, node, &mutex, &condition, &finished, &deque_a] () {
-						auto transaction = node->ledger.tx_begin_read ();
-						nano::unique_lock<nano::mutex> lock{ mutex };
-						while (!deque_a.empty () || !finished)
+					if (verifications[i] != 1)
+					{
+						auto const & hash (batch_a.hashes[i]);
+						auto const & block (batch_a.blocks[i]);
+						bool invalid (true);
+						// Epoch blocks are signed by the epoch signer instead of the account
+						if (block->type () == nano::block_type::state)
 						{
-							while (deque_a.empty () && !finished)
+							auto & state_block (static_cast<nano::state_block &> (*block.get ()));
+							nano::amount prev_balance (0);
+							bool error_or_pruned (false);
+							if (!state_block.hashables.previous.is_zero ())
 							{
-								condition.wait (lock);
+								prev_balance = node->ledger.any.block_balance (transaction, state_block.hashables.previous).value_or (0);
 							}
-							if (!deque_a.empty ())
+							if (node->ledger.is_epoch_link (state_block.hashables.link))
 							{
-								auto pair (deque_a.front ());
-								deque_a.pop_front ();
-								lock.unlock ();
-								function_a (node, transaction, pair.first, pair.second);
-								lock.lock ();
+								if ((state_block.hashables.balance == prev_balance && !error_or_pruned) || (node->ledger.pruning && error_or_pruned && block->sideband ().details.is_epoch))
+								{
+									invalid = validate_message (node->ledger.epoch_signer (block->link_field ().value ()), hash, block->block_signature ());
+								}
 							}
 						}
-					});
+						if (invalid)
+						{
+							print_error_message (boost::str (boost::format ("Invalid signature for block %1%\n") % hash.to_string ()));
+						}
+					}
 				}
+				batch_a.accounts.clear ();
+				batch_a.hashes.clear ();
+				batch_a.blocks.clear ();
 			};
 
-			auto check_account = [&print_error_message, &silent, &count, &block_count] (std::shared_ptr<nano::node> const & node, nano::secure::read_transaction const & transaction, nano::account const & account, nano::account_info const & info) {
+			auto check_account = [&print_error_message, &verify_signatures, &count, &block_count] (std::shared_ptr<nano::node> const & node, nano::secure::read_transaction const & transaction, nano::account const & account, nano::account_info const & info, signature_batch & signatures) {
 				++count;
-				if (!silent && (count % 20000) == 0)
-				{
-					std::cout << boost::str (boost::format ("%1% accounts validated\n") % count);
-				}
 				nano::confirmation_height_info confirmation_height_info;
 				node->store.confirmation_height.get (transaction, account, confirmation_height_info);
 
@@ -1533,32 +1686,11 @@ int main (int argc, char * const * argv)
 					{
 						print_error_message (boost::str (boost::format ("Invalid data inside block %1% calculated hash: %2%\n") % hash.to_string () % calculated_hash.to_string ()));
 					}
-					// Check if block signature is correct
-					if (validate_message (account, hash, block->block_signature ()))
+					// Check if block signature is correct, signatures are verified in batches
+					signatures.add (account, hash, block);
+					if (signatures.full ())
 					{
-						bool invalid (true);
-						// Epoch blocks
-						if (block->type () == nano::block_type::state)
-						{
-							auto & state_block (static_cast<nano::state_block &> (*block.get ()));
-							nano::amount prev_balance (0);
-							bool error_or_pruned (false);
-							if (!state_block.hashables.previous.is_zero ())
-							{
-								prev_balance = node->ledger.any.block_balance (transaction, state_block.hashables.previous).value_or (0);
-							}
-							if (node->ledger.is_epoch_link (state_block.hashables.link))
-							{
-								if ((state_block.hashables.balance == prev_balance && !error_or_pruned) || (node->ledger.pruning && error_or_pruned && block->sideband ().details.is_epoch))
-								{
-									invalid = validate_message (node->ledger.epoch_signer (block->link_field ().value ()), hash, block->block_signature ());
-								}
-							}
-						}
-						if (invalid)
-						{
-							print_error_message (boost::str (boost::format ("Invalid signature for block %1%\n") % hash.to_string ()));
-						}
+						verify_signatures (transaction, signatures);
 					}
 					// Validate block details set in the sideband
 					bool block_details_error = false;
@@ -1666,44 +1798,25 @@ int main (int argc, char * const * argv)
 				}
 			};
 
-			start_threads (check_account, accounts);
-
 			if (!silent)
 			{
 				std::cout << boost::str (boost::format ("Performing %1% threads blocks hash, signature, work validation...\n") % threads_count);
 			}
-			size_t const accounts_deque_overflow (32 * 1024);
-			auto transaction = node->ledger.tx_begin_read ();
-			for (auto i (node->store.account.begin (transaction)), n (node->store.account.end (transaction)); i != n; ++i)
-			{
+			run_pass ("blocks", block_count, node->ledger.block_count (), [&check_account, &verify_signatures, node] (nano::secure::read_transaction const & transaction, nano::uint256_t const & start, nano::uint256_t const & end, bool const is_last) {
+				signature_batch signatures;
+				for (auto i (node->store.account.begin (transaction, start)), n (!is_last ? node->store.account.begin (transaction, end) : node->store.account.end (transaction)); i != n; ++i)
 				{
-					nano::unique_lock<nano::mutex> lock{ mutex };
-					if (accounts.size () > accounts_deque_overflow)
-					{
-						auto wait_ms (250 * accounts.size () / accounts_deque_overflow);
-						auto const wakeup (std::chrono::steady_clock::now () + std::chrono::milliseconds (wait_ms));
-						condition.wait_until (lock, wakeup);
-					}
-					accounts.emplace_back (i->first, i->second);
+					check_account (node, transaction, i->first, i->second, signatures);
 				}
-				condition.notify_all ();
-			}
-			{
-				nano::lock_guard<nano::mutex> lock{ mutex };
-				finished = true;
-			}
-			condition.notify_all ();
-			for (auto & thread : threads)
-			{
-				thread.join ();
-			}
-			threads.clear ();
+				verify_signatures (transaction, signatures);
+			});
 			if (!silent)
 			{
 				std::cout << boost::str (boost::format ("%1% accounts validated\n") % count);
 			}
 
 			// Validate total block count
+			auto transaction = node->ledger.tx_begin_read ();
 			auto ledger_block_count (node->store.block.count (transaction));
 			if (node->flags.enable_pruning)
 			{
@@ -1716,15 +1829,9 @@ int main (int argc, char * const * argv)
 
 			// Validate pending blocks
 			count = 0;
-			finished = false;
-			std::deque<std::pair<nano::pending_key, nano::pending_info>> pending;
 
-			auto check_pending = [&print_error_message, &silent, &count] (std::shared_ptr<nano::node> const & node, nano::secure::read_transaction const & transaction, nano::pending_key const & key, nano::pending_info const & info) {
+			auto check_pending = [&print_error_message, &count] (std::shared_ptr<nano::node> const & node, nano::secure::read_transaction const & transaction, nano::pending_key const & key, nano::pending_info const & info) {
 				++count;
-				if (!silent && (count % 500000) == 0)
-				{
-					std::cout << boost::str (boost::format ("%1% pending blocks validated\n") % count);
-				}
 				// Check block existence
 				auto block = node->ledger.any.block_get (transaction, key.hash);
 				bool pruned (false);
@@ -1782,32 +1889,12 @@ int main (int argc, char * const * argv)
 				}
 			};
 
-			start_threads (check_pending, pending);
-
-			size_t const pending_deque_overflow (64 * 1024);
-			for (auto i (node->store.pending.begin (transaction)), n (node->store.pending.end (transaction)); i != n; ++i)
-			{
+			run_pass ("pending", count, node->store.count (transaction, nano::tables::pending), [&check_pending, node] (nano::secure::read_transaction const & transaction, nano::uint256_t const & start, nano::uint256_t const & end, bool const is_last) {
+				for (auto i (node->store.pending.begin (transaction, nano::pending_key (start, 0))), n (!is_last ? node->store.pending.begin (transaction, nano::pending_key (end, 0)) : node->store.pending.end (transaction)); i != n; ++i)
 				{
-					nano::unique_lock<nano::mutex> lock{ mutex };
-					if (pending.size () > pending_deque_overflow)
-					{
-						auto wait_ms (50 * pending.size () / pending_deque_overflow);
-						auto const wakeup (std::chrono::steady_clock::now () + std::chrono::milliseconds (wait_ms));
-						condition.wait_until (lock, wakeup);
-					}
-					pending.emplace_back (i->first, i->second);
+					check_pending (node, transaction, i->first, i->second);
 				}
-				condition.notify_all ();
-			}
-			{
-				nano::lock_guard<nano::mutex> lock{ mutex };
-				finished = true;
-			}
-			condition.notify_all ();
-			for (auto & thread : threads)
-			{
-				thread.join ();
-			}
+			});
 			if (!silent)
 			{
 				std::cout << boost::str (boost::format ("%1% pending blocks validated\n") % count);
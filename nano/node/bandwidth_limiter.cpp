@@ -2,6 +2,17 @@
 #include <nano/node/bandwidth_limiter.hpp>
 #include <nano/node/nodeconfig.hpp>
 
+nano::bandwidth_limit_type nano::to_bandwidth_limit_type (nano::transport::traffic_type type)
+{
+	switch (type)
+	{
+		case nano::transport::traffic_type::bootstrap_server:
+			return nano::bandwidth_limit_type::bootstrap;
+		default:
+			return nano::bandwidth_limit_type::generic;
+	}
+}
+
 /*
  * bandwidth_limiter
  */
@@ -13,18 +24,24 @@ nano::bandwidth_limiter::bandwidth_limiter (nano::node_config const & node_confi
 {
 }
 
-nano::rate_limiter & nano::bandwidth_limiter::select_limiter (nano::transport::traffic_type type)
+nano::rate_limiter & nano::bandwidth_limiter::select_limiter (nano::bandwidth_limit_type type)
 {
 	switch (type)
 	{
-		case nano::transport::traffic_type::bootstrap_server:
+		case nano::bandwidth_limit_type::bootstrap:
 			return limiter_bootstrap;
-		default:
-			return limiter_generic;
+		case nano::bandwidth_limit_type::generic:
+			break;
 	}
+	return limiter_generic;
 }
 
 bool nano::bandwidth_limiter::should_pass (std::size_t buffer_size, nano::transport::traffic_type type)
+{
+	return should_pass (buffer_size, to_bandwidth_limit_type (type));
+}
+
+bool nano::bandwidth_limiter::should_pass (std::size_t buffer_size, nano::bandwidth_limit_type type)
 {
 	auto & limiter = select_limiter (type);
 	return limiter.should_pass (buffer_size);
@@ -32,7 +49,7 @@ bool nano::bandwidth_limiter::should_pass (std::size_t buffer_size, nano::transp
 
 void nano::bandwidth_limiter::reset (std::size_t limit, double burst_ratio, nano::transport::traffic_type type)
 {
-	auto & limiter = select_limiter (type);
+	auto & limiter = select_limiter (to_bandwidth_limit_type (type));
 	limiter.reset (limit, burst_ratio);
 }
 
@@ -6,6 +6,15 @@
 
 namespace nano
 {
+/** Traffic types sharing the same bandwidth limit */
+enum class bandwidth_limit_type
+{
+	generic,
+	bootstrap,
+};
+
+nano::bandwidth_limit_type to_bandwidth_limit_type (nano::transport::traffic_type);
+
 class bandwidth_limiter_config final
 {
 public:
@@ -32,6 +41,7 @@ public:
 	 * @return true if OK, false if needs to be dropped
 	 */
 	bool should_pass (std::size_t buffer_size, nano::transport::traffic_type type);
+	bool should_pass (std::size_t buffer_size, nano::bandwidth_limit_type type);
 	/**
 	 * Reset limits of selected limiter type to values passed in arguments
 	 */
@@ -43,7 +53,7 @@ private:
 	/**
 	 * Returns reference to limiter corresponding to the limit type
 	 */
-	nano::rate_limiter & select_limiter (nano::transport::traffic_type type);
+	nano::rate_limiter & select_limiter (nano::bandwidth_limit_type type);
 
 private:
 	bandwidth_limiter_config const config;
@@ -124,6 +124,47 @@ bool nano::block_processor::add (std::shared_ptr<nano::block> const & block, blo
 	return add_impl (context{ block, source, std::move (callback) }, channel);
 }
 
+std::vector<bool> nano::block_processor::add_batch (std::vector<std::pair<std::shared_ptr<nano::block>, nano::block_source>> const & blocks, std::shared_ptr<nano::transport::channel> const & channel)
+{
+	std::vector<bool> result (blocks.size (), false);
+	std::vector<std::size_t> valid;
+	valid.reserve (blocks.size ());
+	for (std::size_t i = 0; i < blocks.size (); ++i)
+	{
+		if (network_params.work.validate_entry (*blocks[i].first)) // true => error
+		{
+			stats.inc (nano::stat::type::block_processor, nano::stat::detail::insufficient_work);
+			continue;
+		}
+		stats.inc (nano::stat::type::block_processor, nano::stat::detail::process);
+		valid.push_back (i);
+	}
+
+	bool any_added = false;
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		for (auto i : valid)
+		{
+			auto const & [block, source] = blocks[i];
+			result[i] = queue.push (context{ block, source }, { source, channel });
+			any_added |= result[i];
+		}
+	}
+	if (any_added)
+	{
+		condition.notify_all ();
+	}
+	for (auto i : valid)
+	{
+		if (!result[i])
+		{
+			stats.inc (nano::stat::type::block_processor, nano::stat::detail::overfill);
+			stats.inc (nano::stat::type::block_processor_overfill, to_stat_detail (blocks[i].second));
+		}
+	}
+	return result;
+}
+
 std::optional<nano::block_status> nano::block_processor::add_blocking (std::shared_ptr<nano::block> const & block, block_source const source)
 {
 	stats.inc (nano::stat::type::block_processor, nano::stat::detail::process_blocking);
@@ -93,6 +93,8 @@ public:
 	std::size_t size () const;
 	std::size_t size (nano::block_source) const;
 	bool add (std::shared_ptr<nano::block> const &, nano::block_source = nano::block_source::live, std::shared_ptr<nano::transport::channel> const & channel = nullptr, std::function<void (nano::block_status)> callback = {});
+	/** Queues blocks received from the same channel under a single lock, @returns for each block whether it was queued */
+	std::vector<bool> add_batch (std::vector<std::pair<std::shared_ptr<nano::block>, nano::block_source>> const &, std::shared_ptr<nano::transport::channel> const & channel);
 	std::optional<nano::block_status> add_blocking (std::shared_ptr<nano::block> const & block, nano::block_source);
 	void force (std::shared_ptr<nano::block> const &);
 
@@ -59,7 +59,7 @@ void nano::add_node_options (boost::program_options::options_description & descr
 	("confirmation_height_clear", "Clear confirmation height. Requires an <account> option that can be 'all' to clear all accounts")
 	("final_vote_clear", "Clear final votes")
 	("rebuild_database", "Rebuild LMDB database with vacuum for best compaction")
-	("migrate_database_lmdb_to_rocksdb", "Migrates LMDB database to RocksDB")
+	("migrate_database_lmdb_to_rocksdb", "Migrates LMDB database to RocksDB, running it again after an interruption resumes the migration")
 	("diagnostics", "Run internal diagnostics")
 	("generate_config", boost::program_options::value<std::string> (), "Write configuration to stdout, populated with defaults suitable for this system. Pass the configuration type node, rpc or log. See also use_defaults.")
 	("update_config", "Reads the current node configuration and updates it with missing keys and values and delete keys that are no longer used. Updated configuration is written to stdout.")
@@ -113,7 +113,9 @@ void nano::add_node_flag_options (boost::program_options::options_description &
 		("disable_tcp_realtime", "Disables TCP realtime connections")
 		("disable_block_processor_republishing", "Disables block republishing by disabling the local_block_broadcaster component")
 		("disable_search_pending", "Disables the periodic search for pending transactions")
+		("disable_ledger_cache_snapshot", "Disables loading the ledger cache from a snapshot at startup and writing snapshots periodically and on shutdown")
 		("enable_pruning", "Enable experimental ledger pruning")
+		("enable_receivable_cache", "Keeps the sum of receivable amounts of every account in memory to speed up receivable queries of large wallets")
 		("allow_bootstrap_peers_duplicates", "Allow multiple connections to same peer in bootstrap attempts")
 		("fast_bootstrap", "Increase bootstrap speed for high end nodes with higher limits")
 		("block_processor_batch_size", boost::program_options::value<std::size_t>(), "Increase block processor transaction batch write size, default 0 (limited by config block_processor_batch_max_time), 256k for fast_bootstrap")
@@ -121,6 +123,7 @@ void nano::add_node_flag_options (boost::program_options::options_description &
 		("block_processor_verification_size", boost::program_options::value<std::size_t>(), "Increase batch signature verification size in block processor, default 0 (limited by config signature_checker_threads), unlimited for fast_bootstrap")
 		("inactive_votes_cache_size", boost::program_options::value<std::size_t>(), "Increase cached votes without active elections size, default 16384")
 		("vote_processor_capacity", boost::program_options::value<std::size_t>(), "Vote processor queue size before dropping votes, default 144k")
+		("ledger_cache_threads", boost::program_options::value<unsigned>(), "Number of threads used to generate ledger caches at startup, default 0 (selected based on hardware concurrency)")
 		("disable_large_votes", boost::program_options::value<bool>(), "Disable large votes")
 		;
 	// clang-format on
@@ -145,6 +148,7 @@ std::error_code nano::update_flags (nano::node_flags & flags_a, boost::program_o
 	flags_a.disable_tcp_realtime = (vm.count ("disable_tcp_realtime") > 0);
 	flags_a.disable_block_processor_republishing = (vm.count ("disable_block_processor_republishing") > 0);
 	flags_a.disable_search_pending = (vm.count ("disable_search_pending") > 0);
+	flags_a.disable_ledger_cache_snapshot = (vm.count ("disable_ledger_cache_snapshot") > 0);
 	if (!flags_a.inactive_node)
 	{
 		flags_a.disable_bootstrap_listener = (vm.count ("disable_bootstrap_listener") > 0);
@@ -181,6 +185,12 @@ std::error_code nano::update_flags (nano::node_flags & flags_a, boost::program_o
 	{
 		flags_a.vote_processor_capacity = vote_processor_capacity_it->second.as<std::size_t> ();
 	}
+	flags_a.generate_cache.receivable = (vm.count ("enable_receivable_cache") > 0);
+	auto ledger_cache_threads_it = vm.find ("ledger_cache_threads");
+	if (ledger_cache_threads_it != vm.end ())
+	{
+		flags_a.generate_cache.threads = ledger_cache_threads_it->second.as<unsigned> ();
+	}
 	auto disable_large_votes_it = vm.find ("disable_large_votes");
 	if (disable_large_votes_it != vm.end ())
 	{
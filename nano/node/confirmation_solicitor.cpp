@@ -35,6 +35,7 @@ bool nano::confirmation_solicitor::broadcast (nano::election const & election_a)
 	{
 		auto const & hash (election_a.status.winner->hash ());
 		nano::publish winner{ config.network_params.network, election_a.status.winner };
+		std::deque<std::shared_ptr<nano::transport::channel>> channels;
 		unsigned count = 0;
 		// Directed broadcasting to principal representatives
 		for (auto i (representatives_broadcasts.begin ()), n (representatives_broadcasts.end ()); i != n && count < max_election_broadcasts; ++i)
@@ -44,13 +45,16 @@ bool nano::confirmation_solicitor::broadcast (nano::election const & election_a)
 			bool const different (exists && existing->second.hash != hash);
 			if (!exists || different)
 			{
-				i->channel->send (winner, nano::transport::traffic_type::block_broadcast);
+				channels.push_back (i->channel);
 				count += different ? 0 : 1;
 			}
 		}
 		// Random flood for block propagation
 		// TODO: Avoid broadcasting to the same peers that were already broadcasted to
-		network.flood_message (winner, nano::transport::traffic_type::block_broadcast, 0.5f);
+		auto random = network.list (network.fanout (0.5f));
+		channels.insert (channels.end (), random.begin (), random.end ());
+		// The winner is serialized once for the representatives and the random flood
+		network.send_all (winner, channels, nano::transport::traffic_type::block_broadcast);
 		error = false;
 	}
 	return error;
@@ -22,6 +22,7 @@ class election_status;
 class local_block_broadcaster;
 class local_vote_history;
 class logger;
+class message_visitor;
 class network;
 class network_params;
 class node;
@@ -2,6 +2,7 @@
 #include <nano/lib/blocks.hpp>
 #include <nano/lib/config.hpp>
 #include <nano/lib/json_error_response.hpp>
+#include <nano/lib/json_writer.hpp>
 #include <nano/lib/jsonconfig.hpp>
 #include <nano/lib/stats_sinks.hpp>
 #include <nano/lib/timer.hpp>
@@ -26,6 +27,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <unordered_set>
 #include <vector>
 
 namespace
@@ -166,6 +168,83 @@ void nano::json_handler::response_errors ()
 	}
 }
 
+/*
+ * Sends a response which was streamed into \p writer, any properties already placed in response_l must have been written to it first
+ */
+void nano::json_handler::response_errors (nano::json_writer & writer)
+{
+	if (!ec && writer.empty ())
+	{
+		// Return an error code if no response data was given
+		ec = nano::error_rpc::empty_response;
+	}
+	if (ec)
+	{
+		response_errors ();
+	}
+	else
+	{
+		response (writer.finish ());
+	}
+}
+
+/*
+ * Streams an entry per account of \p wallet into the response under \p key, in wallet order.
+ * Entries are built by \p entry on the node workers with a read transaction per shard of accounts, so large wallets neither hold a wallet lock
+ * nor a single transaction for the whole request. The response is sent once all shards are written, after \p finish ran.
+ */
+void nano::json_handler::wallet_sweep_impl (std::shared_ptr<nano::wallet> const & wallet, std::string const & key, bool array, std::function<void (secure::transaction const &, nano::account const &, boost::property_tree::ptree & entries)> entry, std::function<void ()> finish)
+{
+	std::vector<nano::account> accounts;
+	{
+		auto transaction (node.wallets.tx_begin_read ());
+		accounts = wallet->store.accounts (transaction);
+	}
+	auto writer = std::make_shared<nano::json_writer> ();
+	array ? writer->begin_array (key) : writer->begin_object (key);
+	// Entries of a shard are held until all preceding shards have been written
+	auto shards = std::make_shared<nano::locked<std::unordered_map<std::size_t, boost::property_tree::ptree>>> ();
+	node.wallets.sweep (
+	std::move (accounts),
+	[entry = std::move (entry), shards] (secure::transaction const & transaction, std::size_t shard, auto begin, auto end) {
+		boost::property_tree::ptree entries;
+		for (auto i = begin; i != end; ++i)
+		{
+			entry (transaction, *i, entries);
+		}
+		shards->lock ()->emplace (shard, std::move (entries));
+	},
+	[writer, shards, array] (std::size_t shard) {
+		boost::property_tree::ptree entries;
+		{
+			auto shards_l = shards->lock ();
+			auto existing = shards_l->find (shard);
+			debug_assert (existing != shards_l->end ());
+			entries.swap (existing->second);
+			shards_l->erase (existing);
+		}
+		for (auto const & [name, value] : entries)
+		{
+			array ? writer->push_tree (value) : writer->put_tree (name, value);
+		}
+	},
+	[rpc_l = shared_from_this (), writer, finish = std::move (finish)] (bool cancelled) {
+		if (!cancelled)
+		{
+			writer->end ();
+			if (finish)
+			{
+				finish ();
+			}
+		}
+		else
+		{
+			rpc_l->ec = nano::error_common::generic;
+		}
+		rpc_l->response_errors (*writer);
+	});
+}
+
 std::shared_ptr<nano::wallet> nano::json_handler::wallet_impl ()
 {
 	if (!ec)
@@ -884,36 +963,47 @@ void nano::json_handler::account_weight ()
 
 void nano::json_handler::accounts_balances ()
 {
-	boost::property_tree::ptree balances;
+	// Accounts are decoded up front as decoding may add properties to response_l, which precede the streamed balances
+	std::vector<std::pair<std::string const *, nano::account>> accounts;
+	std::unordered_set<std::string> accounts_text;
 	boost::property_tree::ptree errors;
-	auto transaction = node.store.tx_begin_read ();
 	for (auto & account_from_request : request.get_child ("accounts"))
 	{
-		boost::property_tree::ptree entry;
-		auto account = account_impl (account_from_request.second.data ());
+		auto const & account_text = account_from_request.second.data ();
+		auto account = account_impl (account_text);
 		if (!ec)
 		{
-			bool const include_only_confirmed = request.get<bool> ("include_only_confirmed", true);
-			auto balance = node.balance_pending (account, include_only_confirmed);
-			entry.put ("balance", balance.first.convert_to<std::string> ());
-			entry.put ("pending", balance.second.convert_to<std::string> ());
-			entry.put ("receivable", balance.second.convert_to<std::string> ());
-			balances.put_child (account_from_request.second.data (), entry);
+			// Repeated accounts are only reported once, at the position of their first occurrence
+			if (accounts_text.insert (account_text).second)
+			{
+				accounts.emplace_back (&account_text, account);
+			}
 			continue;
 		}
 		debug_assert (ec);
-		errors.put (account_from_request.second.data (), ec.message ());
+		errors.put (account_text, ec.message ());
 		ec = {};
 	}
-	if (!balances.empty ())
-	{
-		response_l.add_child ("balances", balances);
-	}
+	bool const include_only_confirmed = request.get<bool> ("include_only_confirmed", true);
+	nano::json_writer writer;
+	writer.put_children (response_l);
+	writer.begin_object ("balances", true);
+	for (auto const & [account_text, account] : accounts)
+	{
+		auto balance = node.balance_pending (account, include_only_confirmed);
+		auto const receivable = balance.second.convert_to<std::string> ();
+		writer.begin_object (*account_text);
+		writer.put ("balance", balance.first.convert_to<std::string> ());
+		writer.put ("pending", receivable);
+		writer.put ("receivable", receivable);
+		writer.end ();
+	}
+	writer.end ();
 	if (!errors.empty ())
 	{
-		response_l.add_child ("errors", errors);
+		writer.put_tree ("errors", errors);
 	}
-	response_errors ();
+	response_errors (writer);
 }
 
 void nano::json_handler::accounts_representatives ()
@@ -1024,65 +1114,78 @@ void nano::json_handler::accounts_receivable ()
 	bool const include_only_confirmed = request.get<bool> ("include_only_confirmed", true);
 	bool const sorting = request.get<bool> ("sorting", false);
 	auto simple (threshold.is_zero () && !source && !sorting); // if simple, response is a list of hashes for each account
-	boost::property_tree::ptree pending;
-	auto transaction = node.ledger.tx_begin_read ();
-	for (auto & accounts : request.get_child ("accounts"))
+	// Accounts are queried in sorted order with a single pass over the pending table, results are reported in request order
+	std::vector<nano::account> accounts;
+	for (auto & accounts_l : request.get_child ("accounts"))
 	{
-		auto account (account_impl (accounts.second.data ()));
+		auto account (account_impl (accounts_l.second.data ()));
 		if (!ec)
 		{
-			boost::property_tree::ptree peers_l;
-			for (auto i (node.store.pending.begin (transaction, nano::pending_key (account, 0))), n (node.store.pending.end (transaction)); i != n && nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
+			accounts.push_back (account);
+		}
+	}
+	std::vector<nano::account> sorted (accounts);
+	std::sort (sorted.begin (), sorted.end ());
+	sorted.erase (std::unique (sorted.begin (), sorted.end ()), sorted.end ());
+	std::unordered_map<nano::account, boost::property_tree::ptree> peers;
+	auto transaction = node.ledger.tx_begin_read ();
+	node.ledger.receivable_for_each (transaction, sorted, include_only_confirmed, [&] (nano::pending_key const & key, nano::pending_info const & info, bool confirmed) {
+		if (include_only_confirmed ? confirmed : block_confirmed (node, transaction, key.hash, include_active, include_only_confirmed))
+		{
+			auto & peers_l = peers[key.account];
+			if (simple)
 			{
-				nano::pending_key const & key (i->first);
-				if (block_confirmed (node, transaction, key.hash, include_active, include_only_confirmed))
-				{
-					if (simple)
-					{
-						boost::property_tree::ptree entry;
-						entry.put ("", key.hash.to_string ());
-						peers_l.push_back (std::make_pair ("", entry));
-					}
-					else
-					{
-						nano::pending_info const & info (i->second);
-						if (info.amount.number () >= threshold.number ())
-						{
-							if (source)
-							{
-								boost::property_tree::ptree pending_tree;
-								pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
-								pending_tree.put ("source", info.source.to_account ());
-								peers_l.add_child (key.hash.to_string (), pending_tree);
-							}
-							else
-							{
-								peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
-							}
-						}
-					}
-				}
+				boost::property_tree::ptree entry;
+				entry.put ("", key.hash.to_string ());
+				peers_l.push_back (std::make_pair ("", entry));
 			}
-			if (sorting && !simple)
+			else if (info.amount.number () >= threshold.number ())
 			{
 				if (source)
 				{
-					peers_l.sort ([] (auto const & child1, auto const & child2) -> bool {
-						return child1.second.template get<nano::uint128_t> ("amount") > child2.second.template get<nano::uint128_t> ("amount");
-					});
+					boost::property_tree::ptree pending_tree;
+					pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
+					pending_tree.put ("source", info.source.to_account ());
+					peers_l.add_child (key.hash.to_string (), pending_tree);
 				}
 				else
 				{
-					peers_l.sort ([] (auto const & child1, auto const & child2) -> bool {
-						return child1.second.template get<nano::uint128_t> ("") > child2.second.template get<nano::uint128_t> ("");
-					});
+					peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
 				}
 			}
-			if (!peers_l.empty ())
+			return peers_l.size () < count;
+		}
+		return true;
+	});
+	boost::property_tree::ptree pending;
+	for (auto const & account : accounts)
+	{
+		auto existing = peers.find (account);
+		if (existing == peers.end ())
+		{
+			continue;
+		}
+		auto & peers_l = existing->second;
+		if (sorting && !simple)
+		{
+			if (source)
+			{
+				peers_l.sort ([] (auto const & child1, auto const & child2) -> bool {
+					return child1.second.template get<nano::uint128_t> ("amount") > child2.second.template get<nano::uint128_t> ("amount");
+				});
+			}
+			else
 			{
-				pending.add_child (account.to_account (), peers_l);
+				peers_l.sort ([] (auto const & child1, auto const & child2) -> bool {
+					return child1.second.template get<nano::uint128_t> ("") > child2.second.template get<nano::uint128_t> ("");
+				});
 			}
 		}
+		if (!peers_l.empty ())
+		{
+			pending.add_child (account.to_account (), peers_l);
+		}
+		peers.erase (existing);
 	}
 	response_l.add_child ("blocks", pending);
 	response_errors ();
@@ -1277,52 +1380,55 @@ void nano::json_handler::blocks_info ()
 	bool const json_block_l = request.get<bool> ("json_block", false);
 	bool const include_not_found = request.get<bool> ("include_not_found", false);
 
-	boost::property_tree::ptree blocks;
-	boost::property_tree::ptree blocks_not_found;
+	// Blocks are streamed as they are read, hashes of missing blocks are collected and written afterwards
+	std::vector<std::string const *> blocks_not_found;
+	nano::json_writer writer;
+	writer.put_children (response_l);
+	writer.begin_object ("blocks");
 	auto transaction = node.ledger.tx_begin_read ();
 	for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
 	{
 		if (!ec)
 		{
-			std::string hash_text = hashes.second.data ();
+			std::string const & hash_text = hashes.second.data ();
 			nano::block_hash hash;
 			if (!hash.decode_hex (hash_text))
 			{
 				auto block = node.ledger.any.block_get (transaction, hash);
 				if (block != nullptr)
 				{
-					boost::property_tree::ptree entry;
+					writer.begin_object (hash_text);
 					auto account = block->account ();
-					entry.put ("block_account", account.to_account ());
+					writer.put ("block_account", account.to_account ());
 					auto amount = node.ledger.any.block_amount (transaction, hash);
 					if (amount)
 					{
-						entry.put ("amount", amount.value ().number ().convert_to<std::string> ());
+						writer.put ("amount", amount.value ().number ().convert_to<std::string> ());
 					}
 					auto balance = block->balance ();
-					entry.put ("balance", balance.number ().convert_to<std::string> ());
-					entry.put ("height", std::to_string (block->sideband ().height));
-					entry.put ("local_timestamp", std::to_string (block->sideband ().timestamp));
-					entry.put ("successor", block->sideband ().successor.to_string ());
+					writer.put ("balance", balance.number ().convert_to<std::string> ());
+					writer.put ("height", std::to_string (block->sideband ().height));
+					writer.put ("local_timestamp", std::to_string (block->sideband ().timestamp));
+					writer.put ("successor", block->sideband ().successor.to_string ());
 					auto confirmed (node.ledger.confirmed.block_exists_or_pruned (transaction, hash));
-					entry.put ("confirmed", confirmed);
+					writer.put ("confirmed", confirmed ? "true" : "false");
 
 					if (json_block_l)
 					{
 						boost::property_tree::ptree block_node_l;
 						block->serialize_json (block_node_l);
-						entry.add_child ("contents", block_node_l);
+						writer.put_tree ("contents", block_node_l);
 					}
 					else
 					{
 						std::string contents;
 						block->serialize_json (contents);
-						entry.put ("contents", contents);
+						writer.put ("contents", contents);
 					}
 					if (block->type () == nano::block_type::state)
 					{
 						auto subtype (nano::state_subtype (block->sideband ().details));
-						entry.put ("subtype", subtype);
+						writer.put ("subtype", subtype);
 					}
 					if (receivable || receive_hash)
 					{
@@ -1330,38 +1436,38 @@ void nano::json_handler::blocks_info ()
 						{
 							if (receivable)
 							{
-								entry.put ("pending", "0");
-								entry.put ("receivable", "0");
+								writer.put ("pending", "0");
+								writer.put ("receivable", "0");
 							}
 							if (receive_hash)
 							{
-								entry.put ("receive_hash", nano::block_hash (0).to_string ());
+								writer.put ("receive_hash", nano::block_hash (0).to_string ());
 							}
 						}
 						else if (node.ledger.any.pending_get (transaction, nano::pending_key{ block->destination (), hash }))
 						{
 							if (receivable)
 							{
-								entry.put ("pending", "1");
-								entry.put ("receivable", "1");
+								writer.put ("pending", "1");
+								writer.put ("receivable", "1");
 							}
 							if (receive_hash)
 							{
-								entry.put ("receive_hash", nano::block_hash (0).to_string ());
+								writer.put ("receive_hash", nano::block_hash (0).to_string ());
 							}
 						}
 						else
 						{
 							if (receivable)
 							{
-								entry.put ("pending", "0");
-								entry.put ("receivable", "0");
+								writer.put ("pending", "0");
+								writer.put ("receivable", "0");
 							}
 							if (receive_hash)
 							{
 								std::shared_ptr<nano::block> receive_block = node.ledger.find_receive_block_by_send_hash (transaction, block->destination (), hash);
 								std::string receive_hash = receive_block ? receive_block->hash ().to_string () : nano::block_hash (0).to_string ();
-								entry.put ("receive_hash", receive_hash);
+								writer.put ("receive_hash", receive_hash);
 							}
 						}
 					}
@@ -1369,22 +1475,20 @@ void nano::json_handler::blocks_info ()
 					{
 						if (!block->is_receive () || !node.ledger.any.block_exists (transaction, block->source ()))
 						{
-							entry.put ("source_account", "0");
+							writer.put ("source_account", "0");
 						}
 						else
 						{
 							auto block_a = node.ledger.any.block_get (transaction, block->source ());
 							release_assert (block_a);
-							entry.put ("source_account", block_a->account ().to_account ());
+							writer.put ("source_account", block_a->account ().to_account ());
 						}
 					}
-					blocks.push_back (std::make_pair (hash_text, entry));
+					writer.end ();
 				}
 				else if (include_not_found)
 				{
-					boost::property_tree::ptree entry;
-					entry.put ("", hash_text);
-					blocks_not_found.push_back (std::make_pair ("", entry));
+					blocks_not_found.push_back (&hash_text);
 				}
 				else
 				{
@@ -1397,15 +1501,17 @@ void nano::json_handler::blocks_info ()
 			}
 		}
 	}
-	if (!ec)
+	writer.end ();
+	if (include_not_found)
 	{
-		response_l.add_child ("blocks", blocks);
-		if (include_not_found)
+		writer.begin_array ("blocks_not_found");
+		for (auto const * hash_text : blocks_not_found)
 		{
-			response_l.add_child ("blocks_not_found", blocks_not_found);
+			writer.push (*hash_text);
 		}
+		writer.end ();
 	}
-	response_errors ();
+	response_errors (writer);
 }
 
 void nano::json_handler::block_account ()
@@ -2593,11 +2699,13 @@ void nano::json_handler::account_history ()
 			}
 		}
 	}
+	nano::json_writer writer;
 	if (!ec)
 	{
-		boost::property_tree::ptree history;
 		bool output_raw (request.get_optional<bool> ("raw") == true);
-		response_l.put ("account", account.to_account ());
+		writer.put_children (response_l);
+		writer.put ("account", account.to_account ());
+		writer.begin_array ("history");
 		auto block = node.ledger.any.block_get (transaction, hash);
 		while (block != nullptr && count > 0)
 		{
@@ -2621,20 +2729,20 @@ void nano::json_handler::account_history ()
 						entry.put ("work", nano::to_string_hex (block->block_work ()));
 						entry.put ("signature", block->block_signature ().to_string ());
 					}
-					history.push_back (std::make_pair ("", entry));
+					writer.push_tree (entry);
 					--count;
 				}
 			}
 			hash = reverse ? node.ledger.any.block_successor (transaction, hash).value_or (0) : block->previous ();
 			block = node.ledger.any.block_get (transaction, hash);
 		}
-		response_l.add_child ("history", history);
+		writer.end ();
 		if (!hash.is_zero ())
 		{
-			response_l.put (reverse ? "next" : "previous", hash.to_string ());
+			writer.put (reverse ? "next" : "previous", hash.to_string ());
 		}
 	}
-	response_errors ();
+	response_errors (writer);
 }
 
 void nano::json_handler::keepalive ()
@@ -2887,17 +2995,17 @@ void nano::json_handler::password_change ()
 
 void nano::json_handler::password_enter ()
 {
-	node.workers.post (create_worker_task ([] (std::shared_ptr<nano::json_handler> const & rpc_l) {
-		auto wallet (rpc_l->wallet_impl ());
-		if (!rpc_l->ec)
-		{
-			std::string password_text (rpc_l->request.get<std::string> ("password"));
-			auto transaction (wallet->wallets.tx_begin_write ());
-			auto error (wallet->enter_password (transaction, password_text));
+	auto wallet (wallet_impl ());
+	if (!ec)
+	{
+		std::string password_text (request.get<std::string> ("password"));
+		wallet->enter_password_async (password_text, [rpc_l = shared_from_this ()] (bool error) {
 			rpc_l->response_l.put ("valid", error ? "0" : "1");
-		}
-		rpc_l->response_errors ();
-	}));
+			rpc_l->response_errors ();
+		});
+		return;
+	}
+	response_errors ();
 }
 
 void nano::json_handler::password_valid (bool wallet_locked)
@@ -2981,15 +3089,25 @@ void nano::json_handler::receivable ()
 	bool const sorting = request.get<bool> ("sorting", false);
 	auto simple (threshold.is_zero () && !source && !min_version && !sorting); // if simple, response is a list of hashes
 	bool const should_sort = sorting && !simple;
+	nano::json_writer writer;
 	if (!ec)
 	{
 		auto offset_counter = offset;
-		boost::property_tree::ptree peers_l;
+		std::size_t blocks_count = 0;
+		writer.put_children (response_l);
+		if (simple)
+		{
+			writer.begin_array ("blocks");
+		}
+		else
+		{
+			writer.begin_object ("blocks");
+		}
 		auto transaction = node.ledger.tx_begin_read ();
 		// The ptree container is used if there are any children nodes (e.g source/min_version) otherwise the amount container is used.
 		std::vector<std::pair<std::string, boost::property_tree::ptree>> hash_ptree_pairs;
 		std::vector<std::pair<std::string, nano::uint128_t>> hash_amount_pairs;
-		for (auto i (node.store.pending.begin (transaction, nano::pending_key (account, 0))), n (node.store.pending.end (transaction)); i != n && nano::pending_key (i->first).account == account && (should_sort || peers_l.size () < count); ++i)
+		for (auto i (node.store.pending.begin (transaction, nano::pending_key (account, 0))), n (node.store.pending.end (transaction)); i != n && nano::pending_key (i->first).account == account && (should_sort || blocks_count < count); ++i)
 		{
 			nano::pending_key const & key (i->first);
 			if (block_confirmed (node, transaction, key.hash, include_active, include_only_confirmed))
@@ -3002,9 +3120,8 @@ void nano::json_handler::receivable ()
 
 				if (simple)
 				{
-					boost::property_tree::ptree entry;
-					entry.put ("", key.hash.to_string ());
-					peers_l.push_back (std::make_pair ("", entry));
+					writer.push (key.hash.to_string ());
+					++blocks_count;
 				}
 				else
 				{
@@ -3030,7 +3147,8 @@ void nano::json_handler::receivable ()
 							}
 							else
 							{
-								peers_l.add_child (key.hash.to_string (), pending_tree);
+								writer.put_tree (key.hash.to_string (), pending_tree);
+								++blocks_count;
 							}
 						}
 						else
@@ -3041,7 +3159,8 @@ void nano::json_handler::receivable ()
 							}
 							else
 							{
-								peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+								writer.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+								++blocks_count;
 							}
 						}
 					}
@@ -3057,7 +3176,7 @@ void nano::json_handler::receivable ()
 				});
 				for (auto i = offset, j = offset + count; i < hash_ptree_pairs.size () && i < j; ++i)
 				{
-					peers_l.add_child (hash_ptree_pairs[i].first, hash_ptree_pairs[i].second);
+					writer.put_tree (hash_ptree_pairs[i].first, hash_ptree_pairs[i].second);
 				}
 			}
 			else
@@ -3068,13 +3187,13 @@ void nano::json_handler::receivable ()
 
 				for (auto i = offset, j = offset + count; i < hash_amount_pairs.size () && i < j; ++i)
 				{
-					peers_l.put (hash_amount_pairs[i].first, hash_amount_pairs[i].second.convert_to<std::string> ());
+					writer.put (hash_amount_pairs[i].first, hash_amount_pairs[i].second.convert_to<std::string> ());
 				}
 			}
 		}
-		response_l.add_child ("blocks", peers_l);
+		writer.end ();
 	}
-	response_errors ();
+	response_errors (writer);
 }
 
 void nano::json_handler::pending_exists ()
@@ -4379,12 +4498,7 @@ void nano::json_handler::wallet_balances ()
 	auto threshold (threshold_optional_impl ());
 	if (!ec)
 	{
-		boost::property_tree::ptree balances;
-		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction = node.ledger.tx_begin_read ();
-		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end (transaction)); i != n; ++i)
-		{
-			nano::account const & account (i->first);
+		wallet_sweep_impl (wallet, "balances", false, [this, threshold] (secure::transaction const & block_transaction, nano::account const & account, boost::property_tree::ptree & balances) {
 			nano::uint128_t balance = node.ledger.any.account_balance (block_transaction, account).value_or (0).number ();
 			if (balance >= threshold.number ())
 			{
@@ -4395,8 +4509,8 @@ void nano::json_handler::wallet_balances ()
 				entry.put ("receivable", receivable.convert_to<std::string> ());
 				balances.push_back (std::make_pair (account.to_account (), entry));
 			}
-		}
-		response_l.add_child ("balances", balances);
+		});
+		return;
 	}
 	response_errors ();
 }
@@ -4635,12 +4749,7 @@ void nano::json_handler::wallet_ledger ()
 	auto wallet (wallet_impl ());
 	if (!ec)
 	{
-		boost::property_tree::ptree accounts;
-		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction = node.ledger.tx_begin_read ();
-		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end (transaction)); i != n; ++i)
-		{
-			nano::account const & account (i->first);
+		wallet_sweep_impl (wallet, "accounts", false, [this, representative, weight, receivable, modified_since] (secure::transaction const & block_transaction, nano::account const & account, boost::property_tree::ptree & accounts) {
 			auto info = node.ledger.any.account_get (block_transaction, account);
 			if (info)
 			{
@@ -4673,8 +4782,8 @@ void nano::json_handler::wallet_ledger ()
 					accounts.push_back (std::make_pair (account.to_account (), entry));
 				}
 			}
-		}
-		response_l.add_child ("accounts", accounts);
+		});
+		return;
 	}
 	response_errors ();
 }
@@ -4711,56 +4820,65 @@ void nano::json_handler::wallet_receivable ()
 	bool const include_only_confirmed = request.get<bool> ("include_only_confirmed", true);
 	if (!ec)
 	{
+		std::vector<nano::account> accounts;
+		{
+			auto transaction (node.wallets.tx_begin_read ());
+			for (auto i (wallet->store.begin (transaction)), n (wallet->store.end (transaction)); i != n; ++i)
+			{
+				accounts.push_back (i->first);
+			}
+		}
+		std::sort (accounts.begin (), accounts.end ());
 		boost::property_tree::ptree pending;
-		auto transaction (node.wallets.tx_begin_read ());
+		boost::property_tree::ptree peers_l;
+		nano::account current{};
+		auto flush = [&pending, &peers_l, &current] () {
+			if (!peers_l.empty ())
+			{
+				pending.add_child (current.to_account (), peers_l);
+				peers_l.clear ();
+			}
+		};
 		auto block_transaction = node.ledger.tx_begin_read ();
-		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end (transaction)); i != n; ++i)
-		{
-			nano::account const & account (i->first);
-			boost::property_tree::ptree peers_l;
-			for (auto ii (node.store.pending.begin (block_transaction, nano::pending_key (account, 0))), nn (node.store.pending.end (block_transaction)); ii != nn && nano::pending_key (ii->first).account == account && peers_l.size () < count; ++ii)
+		node.ledger.receivable_for_each (block_transaction, accounts, include_only_confirmed, [&] (nano::pending_key const & key, nano::pending_info const & info, bool confirmed) {
+			if (key.account != current)
 			{
-				nano::pending_key key (ii->first);
-				if (block_confirmed (node, block_transaction, key.hash, include_active, include_only_confirmed))
+				flush ();
+				current = key.account;
+			}
+			if (include_only_confirmed ? confirmed : block_confirmed (node, block_transaction, key.hash, include_active, include_only_confirmed))
+			{
+				if (threshold.is_zero () && !source)
+				{
+					boost::property_tree::ptree entry;
+					entry.put ("", key.hash.to_string ());
+					peers_l.push_back (std::make_pair ("", entry));
+				}
+				else if (info.amount.number () >= threshold.number ())
 				{
-					if (threshold.is_zero () && !source)
+					if (source || min_version)
 					{
-						boost::property_tree::ptree entry;
-						entry.put ("", key.hash.to_string ());
-						peers_l.push_back (std::make_pair ("", entry));
+						boost::property_tree::ptree pending_tree;
+						pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
+						if (source)
+						{
+							pending_tree.put ("source", info.source.to_account ());
+						}
+						if (min_version)
+						{
+							pending_tree.put ("min_version", epoch_as_string (info.epoch));
+						}
+						peers_l.add_child (key.hash.to_string (), pending_tree);
 					}
 					else
 					{
-						nano::pending_info info (ii->second);
-						if (info.amount.number () >= threshold.number ())
-						{
-							if (source || min_version)
-							{
-								boost::property_tree::ptree pending_tree;
-								pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
-								if (source)
-								{
-									pending_tree.put ("source", info.source.to_account ());
-								}
-								if (min_version)
-								{
-									pending_tree.put ("min_version", epoch_as_string (info.epoch));
-								}
-								peers_l.add_child (key.hash.to_string (), pending_tree);
-							}
-							else
-							{
-								peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
-							}
-						}
+						peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
 					}
 				}
 			}
-			if (!peers_l.empty ())
-			{
-				pending.add_child (account.to_account (), peers_l);
-			}
-		}
+			return peers_l.size () < count;
+		});
+		flush ();
 		response_l.add_child ("blocks", pending);
 	}
 	response_errors ();
@@ -4835,13 +4953,9 @@ void nano::json_handler::wallet_republish ()
 	auto count (count_impl ());
 	if (!ec)
 	{
-		boost::property_tree::ptree blocks;
-		std::deque<std::shared_ptr<nano::block>> republish_bundle;
-		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction = node.ledger.tx_begin_read ();
-		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end (transaction)); i != n; ++i)
-		{
-			nano::account const & account (i->first);
+		auto republish_bundle = std::make_shared<nano::locked<std::deque<std::shared_ptr<nano::block>>>> ();
+		wallet_sweep_impl (
+		wallet, "blocks", true, [this, count, republish_bundle] (secure::transaction const & block_transaction, nano::account const & account, boost::property_tree::ptree & blocks) {
 			auto latest (node.ledger.any.account_head (block_transaction, account));
 			std::shared_ptr<nano::block> block;
 			std::vector<nano::block_hash> hashes;
@@ -4859,17 +4973,22 @@ void nano::json_handler::wallet_republish ()
 				}
 			}
 			std::reverse (hashes.begin (), hashes.end ());
+			std::deque<std::shared_ptr<nano::block>> account_blocks;
 			for (auto & hash : hashes)
 			{
-				block = node.ledger.any.block_get (block_transaction, hash);
-				republish_bundle.push_back (std::move (block));
+				account_blocks.push_back (node.ledger.any.block_get (block_transaction, hash));
 				boost::property_tree::ptree entry;
 				entry.put ("", hash.to_string ());
 				blocks.push_back (std::make_pair ("", entry));
 			}
-		}
-		node.network.flood_block_many (std::move (republish_bundle), nano::transport::traffic_type::keepalive, 25ms);
-		response_l.add_child ("blocks", blocks);
+			// Blocks of an account are appended together so they are republished in order
+			auto bundle = republish_bundle->lock ();
+			bundle->insert (bundle->end (), account_blocks.begin (), account_blocks.end ());
+		},
+		[this, republish_bundle] () {
+			node.network.flood_block_many (std::move (*republish_bundle->lock ()), nano::transport::traffic_type::keepalive, 25ms);
+		});
+		return;
 	}
 	response_errors ();
 }
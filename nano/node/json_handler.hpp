@@ -21,6 +21,7 @@ namespace ipc
 {
 	class ipc_server;
 }
+class json_writer;
 class node;
 class node_rpc_config;
 
@@ -154,10 +155,12 @@ public:
 	boost::property_tree::ptree request;
 	std::function<void (std::string const &)> response;
 	void response_errors ();
+	void response_errors (nano::json_writer &);
 	std::error_code ec;
 	std::string action;
 	boost::property_tree::ptree response_l;
 	std::shared_ptr<nano::wallet> wallet_impl ();
+	void wallet_sweep_impl (std::shared_ptr<nano::wallet> const &, std::string const & key, bool array, std::function<void (secure::transaction const &, nano::account const &, boost::property_tree::ptree & entries)> entry, std::function<void ()> finish = nullptr);
 	bool wallet_locked_impl (store::transaction const &, std::shared_ptr<nano::wallet> const &);
 	bool wallet_account_impl (store::transaction const &, std::shared_ptr<nano::wallet> const &, nano::account const &);
 	nano::account account_impl (std::string = "", std::error_code = nano::error_common::bad_account_number);
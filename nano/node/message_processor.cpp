@@ -5,37 +5,45 @@
 #include <nano/node/telemetry.hpp>
 #include <nano/secure/vote.hpp>
 
+#include <unordered_map>
+#include <variant>
+
 nano::message_processor::message_processor (message_processor_config const & config_a, nano::node & node_a) :
 	config{ config_a },
 	node{ node_a },
 	stats{ node.stats },
 	logger{ node.logger }
 {
-	queue.max_size_query = [this] (auto const & origin) {
-		return config.max_queue;
-	};
+	for (size_t n = 0; n < std::max<size_t> (config.threads, 1); ++n)
+	{
+		auto & shard = *shards.emplace_back (std::make_unique<message_processor::shard> ());
+
+		shard.queue.max_size_query = [this] (auto const & origin) {
+			return config.max_queue;
+		};
 
-	queue.priority_query = [this] (auto const & origin) {
-		return 1;
-	};
+		shard.queue.priority_query = [this] (auto const & origin) {
+			return 1;
+		};
+	}
 }
 
 nano::message_processor::~message_processor ()
 {
-	debug_assert (threads.empty ());
+	debug_assert (std::none_of (shards.begin (), shards.end (), [] (auto const & shard) { return shard->thread.joinable (); }));
 }
 
 void nano::message_processor::start ()
 {
-	debug_assert (threads.empty ());
-
-	for (int n = 0; n < config.threads; ++n)
+	for (auto & shard_ptr : shards)
 	{
-		threads.emplace_back ([this] () {
+		debug_assert (!shard_ptr->thread.joinable ());
+
+		shard_ptr->thread = std::thread ([this, &shard = *shard_ptr] () {
 			nano::thread_role::set (nano::thread_role::name::message_processing);
 			try
 			{
-				run ();
+				run (shard);
 			}
 			catch (boost::system::error_code & ec)
 			{
@@ -63,20 +71,36 @@ void nano::message_processor::start ()
 
 void nano::message_processor::stop ()
 {
+	for (auto & shard : shards)
 	{
-		nano::lock_guard<nano::mutex> lock{ mutex };
-		stopped = true;
+		{
+			nano::lock_guard<nano::mutex> lock{ shard->mutex };
+			stopped = true;
+		}
+		shard->condition.notify_all ();
 	}
-	condition.notify_all ();
 
-	for (auto & thread : threads)
+	for (auto & shard : shards)
 	{
-		if (thread.joinable ())
+		if (shard->thread.joinable ())
 		{
-			thread.join ();
+			shard->thread.join ();
 		}
 	}
-	threads.clear ();
+}
+
+auto nano::message_processor::select_shard (std::shared_ptr<nano::transport::channel> const & channel) -> shard &
+{
+	return *shards[shard_index (*channel)];
+}
+
+std::size_t nano::message_processor::shard_index (nano::transport::channel const & channel) const
+{
+	// Channels are aligned heap allocations, so the low bits of their addresses are the same for all of them
+	// Fibonacci hashing moves the entropy of the address into the high bits, which are then used to select the shard
+	auto const address = static_cast<uint64_t> (reinterpret_cast<std::uintptr_t> (&channel));
+	auto const mixed = (address * 0x9e3779b97f4a7c15ull) >> 32;
+	return static_cast<std::size_t> (mixed % shards.size ());
 }
 
 bool nano::message_processor::put (std::unique_ptr<nano::message> message, std::shared_ptr<nano::transport::channel> const & channel)
@@ -85,18 +109,19 @@ bool nano::message_processor::put (std::unique_ptr<nano::message> message, std::
 	release_assert (channel != nullptr);
 
 	auto const type = message->type ();
+	auto & shard = select_shard (channel);
 
 	bool added = false;
 	{
-		nano::lock_guard<nano::mutex> guard{ mutex };
-		added = queue.push ({ std::move (message), channel }, { nano::no_value{}, channel });
+		nano::lock_guard<nano::mutex> guard{ shard.mutex };
+		added = shard.queue.push ({ std::move (message), channel }, { nano::no_value{}, channel });
 	}
 	if (added)
 	{
 		stats.inc (nano::stat::type::message_processor, nano::stat::detail::process);
 		stats.inc (nano::stat::type::message_processor_type, to_stat_detail (type));
 
-		condition.notify_all ();
+		shard.condition.notify_one ();
 	}
 	else
 	{
@@ -106,66 +131,194 @@ bool nano::message_processor::put (std::unique_ptr<nano::message> message, std::
 	return added;
 }
 
-void nano::message_processor::run ()
+std::size_t nano::message_processor::put_batch (std::vector<std::unique_ptr<nano::message>> messages, std::shared_ptr<nano::transport::channel> const & channel)
 {
-	nano::unique_lock<nano::mutex> lock{ mutex };
+	release_assert (channel != nullptr);
+
+	auto & shard = select_shard (channel);
+
+	std::vector<std::pair<nano::message_type, bool>> results;
+	results.reserve (messages.size ());
+	{
+		nano::lock_guard<nano::mutex> guard{ shard.mutex };
+		for (auto & message : messages)
+		{
+			release_assert (message != nullptr);
+			auto const type = message->type ();
+			auto const added = shard.queue.push ({ std::move (message), channel }, { nano::no_value{}, channel });
+			results.emplace_back (type, added);
+		}
+	}
+	std::size_t added_count = 0;
+	for (auto const & [type, added] : results)
+	{
+		if (added)
+		{
+			stats.inc (nano::stat::type::message_processor, nano::stat::detail::process);
+			stats.inc (nano::stat::type::message_processor_type, to_stat_detail (type));
+			++added_count;
+		}
+		else
+		{
+			stats.inc (nano::stat::type::message_processor, nano::stat::detail::overfill);
+			stats.inc (nano::stat::type::message_processor_overfill, to_stat_detail (type));
+		}
+	}
+	if (added_count > 0)
+	{
+		shard.condition.notify_one ();
+	}
+	return added_count;
+}
+
+void nano::message_processor::run (shard & shard)
+{
+	nano::unique_lock<nano::mutex> lock{ shard.mutex };
 	while (!stopped)
 	{
 		stats.inc (nano::stat::type::message_processor, nano::stat::detail::loop);
 
-		if (!queue.empty ())
+		if (!shard.queue.empty ())
 		{
-			run_batch (lock);
+			run_batch (shard, lock);
 			debug_assert (!lock.owns_lock ());
 			lock.lock ();
 		}
 		else
 		{
-			condition.wait (lock, [&] {
-				return stopped || !queue.empty ();
+			shard.condition.wait (lock, [&] {
+				return stopped || !shard.queue.empty ();
 			});
 		}
 	}
 }
 
-void nano::message_processor::run_batch (nano::unique_lock<nano::mutex> & lock)
+namespace
 {
-	debug_assert (lock.owns_lock ());
-	debug_assert (!mutex.try_lock ());
-	debug_assert (!queue.empty ());
+/*
+ * Blocks and votes of a batch grouped by channel, so the block and vote processors are locked once per run of consecutive blocks or votes of a channel instead of once per message.
+ * Runs of a channel are queued in the order they were received, other messages of the channel have to be processed after calling flush for it.
+ */
+class bulk_entries final
+{
+public:
+	void add (nano::publish const & message, std::shared_ptr<nano::transport::channel> const & channel)
+	{
+		add_to_run<publishes_t> (&message, channel);
+	}
 
-	nano::timer<std::chrono::milliseconds> timer;
-	timer.start ();
+	void add (nano::confirm_ack const & message, std::shared_ptr<nano::transport::channel> const & channel)
+	{
+		add_to_run<confirm_acks_t> (&message, channel);
+	}
 
-	size_t const max_batch_size = 1024 * 4;
-	auto batch = queue.next_batch (max_batch_size);
+	/** Queues the collected blocks and votes of \p channel */
+	void flush (nano::node & node, std::shared_ptr<nano::transport::channel> const & channel)
+	{
+		auto existing = runs.find (channel);
+		if (existing == runs.end ())
+		{
+			return;
+		}
+		for (auto const & run : existing->second)
+		{
+			if (auto publishes = std::get_if<publishes_t> (&run))
+			{
+				flush (node, channel, *publishes);
+			}
+			else
+			{
+				flush (node, channel, std::get<confirm_acks_t> (run));
+			}
+		}
+		runs.erase (existing);
+	}
 
-	lock.unlock ();
+	/** Queues the collected blocks and votes of all channels, in the order the channels first sent one */
+	void flush (nano::node & node)
+	{
+		for (auto const & channel : order)
+		{
+			flush (node, channel);
+		}
+		debug_assert (runs.empty ());
+		order.clear ();
+	}
 
-	for (auto const & [entry, origin] : batch)
+private:
+	// Messages are owned by the batch being processed
+	using publishes_t = std::vector<nano::publish const *>;
+	using confirm_acks_t = std::vector<nano::confirm_ack const *>;
+	using run_t = std::variant<publishes_t, confirm_acks_t>;
+
+	template <typename Run, typename Message>
+	void add_to_run (Message const * message, std::shared_ptr<nano::transport::channel> const & channel)
 	{
-		auto const & [message, channel] = entry;
-		release_assert (message != nullptr);
-		process (*message, channel);
+		auto [existing, inserted] = runs.try_emplace (channel);
+		if (inserted)
+		{
+			order.push_back (channel);
+		}
+		auto & channel_runs = existing->second;
+		if (channel_runs.empty () || !std::holds_alternative<Run> (channel_runs.back ()))
+		{
+			channel_runs.emplace_back (Run{});
+		}
+		std::get<Run> (channel_runs.back ()).push_back (message);
 	}
 
-	if (timer.since_start () > std::chrono::milliseconds (100))
+	void flush (nano::node & node, std::shared_ptr<nano::transport::channel> const & channel, publishes_t const & messages)
 	{
-		logger.debug (nano::log::type::message_processor, "Processed {} messages in {} milliseconds (rate of {} messages per second)",
-		batch.size (),
-		timer.since_start ().count (),
-		((batch.size () * 1000ULL) / timer.value ().count ()));
+		std::vector<std::pair<std::shared_ptr<nano::block>, nano::block_source>> blocks;
+		blocks.reserve (messages.size ());
+		for (auto const * message : messages)
+		{
+			// Put blocks that are being initially broadcasted in a separate queue, so that they won't have to compete with rebroadcasted blocks
+			// Both queues have the same priority and size, so the potential for exploiting this is limited
+			blocks.emplace_back (message->block, message->is_originator () ? nano::block_source::live_originator : nano::block_source::live);
+		}
+		auto const added = node.block_processor.add_batch (blocks, channel);
+		for (std::size_t i = 0; i < messages.size (); ++i)
+		{
+			if (!added[i])
+			{
+				node.network.filter.clear (messages[i]->digest);
+				node.stats.inc (nano::stat::type::drop, nano::stat::detail::publish, nano::stat::dir::in);
+			}
+		}
 	}
-}
 
-namespace
-{
+	void flush (nano::node & node, std::shared_ptr<nano::transport::channel> const & channel, confirm_acks_t const & messages)
+	{
+		std::vector<std::pair<std::shared_ptr<nano::vote>, nano::vote_source>> votes;
+		votes.reserve (messages.size ());
+		for (auto const * message : messages)
+		{
+			votes.emplace_back (message->vote, message->is_rebroadcasted () ? nano::vote_source::rebroadcast : nano::vote_source::live);
+		}
+		auto const added = node.vote_processor.vote_batch (votes, channel);
+		for (std::size_t i = 0; i < messages.size (); ++i)
+		{
+			if (!added[i])
+			{
+				node.network.filter.clear (messages[i]->digest);
+				node.stats.inc (nano::stat::type::drop, nano::stat::detail::confirm_ack, nano::stat::dir::in);
+			}
+		}
+	}
+
+	std::unordered_map<std::shared_ptr<nano::transport::channel>, std::vector<run_t>> runs;
+	std::vector<std::shared_ptr<nano::transport::channel>> order;
+};
+
 class process_visitor : public nano::message_visitor
 {
 public:
-	process_visitor (nano::node & node_a, std::shared_ptr<nano::transport::channel> const & channel_a) :
+	/** Blocks and votes are collected in \p bulk if set, otherwise they are queued immediately */
+	process_visitor (nano::node & node_a, std::shared_ptr<nano::transport::channel> const & channel_a, bulk_entries * bulk_a = nullptr) :
 		node{ node_a },
-		channel{ channel_a }
+		channel{ channel_a },
+		bulk{ bulk_a }
 	{
 	}
 
@@ -183,6 +336,11 @@ public:
 
 	void publish (nano::publish const & message) override
 	{
+		if (bulk)
+		{
+			bulk->add (message, channel);
+			return;
+		}
 		// Put blocks that are being initially broadcasted in a separate queue, so that they won't have to compete with rebroadcasted blocks
 		// Both queues have the same priority and size, so the potential for exploiting this is limited
 		bool added = node.block_processor.add (message.block, message.is_originator () ? nano::block_source::live_originator : nano::block_source::live, channel);
@@ -214,6 +372,11 @@ public:
 			node.stats.inc (nano::stat::type::drop, nano::stat::detail::confirm_ack_zero_account, nano::stat::dir::in);
 			return;
 		}
+		if (bulk)
+		{
+			bulk->add (message, channel);
+			return;
+		}
 
 		bool added = node.vote_processor.vote (message.vote, channel, message.is_rebroadcasted () ? nano::vote_source::rebroadcast : nano::vote_source::live);
 		if (!added)
@@ -271,29 +434,80 @@ public:
 private:
 	nano::node & node;
 	std::shared_ptr<nano::transport::channel> channel;
+	bulk_entries * bulk;
 };
 }
 
+void nano::message_processor::run_batch (shard & shard, nano::unique_lock<nano::mutex> & lock)
+{
+	debug_assert (lock.owns_lock ());
+	debug_assert (!shard.mutex.try_lock ());
+	debug_assert (!shard.queue.empty ());
+
+	nano::timer<std::chrono::milliseconds> timer;
+	timer.start ();
+
+	size_t const max_batch_size = 1024 * 4;
+	auto batch = shard.queue.next_batch (max_batch_size);
+
+	lock.unlock ();
+
+	bulk_entries bulk;
+	for (auto const & [entry, origin] : batch)
+	{
+		auto const & [message, channel] = entry;
+		release_assert (message != nullptr);
+		release_assert (channel != nullptr);
+
+		// Blocks and votes received before any other message of the channel are queued before it is processed
+		if (message->type () != nano::message_type::publish && message->type () != nano::message_type::confirm_ack)
+		{
+			bulk.flush (node, channel);
+		}
+		process_visitor visitor{ node, channel, &bulk };
+		process (*message, visitor);
+	}
+	bulk.flush (node);
+
+	if (timer.since_start () > std::chrono::milliseconds (100))
+	{
+		logger.debug (nano::log::type::message_processor, "Processed {} messages in {} milliseconds (rate of {} messages per second)",
+		batch.size (),
+		timer.since_start ().count (),
+		((batch.size () * 1000ULL) / timer.value ().count ()));
+	}
+}
+
 void nano::message_processor::process (nano::message const & message, std::shared_ptr<nano::transport::channel> const & channel)
 {
 	release_assert (channel != nullptr);
 
+	process_visitor visitor{ node, channel };
+	process (message, visitor);
+}
+
+void nano::message_processor::process (nano::message const & message, nano::message_visitor & visitor)
+{
 	debug_assert (message.header.network == node.network_params.network.current_network);
 	debug_assert (message.header.version_using >= node.network_params.network.protocol_version_min);
 
 	stats.inc (nano::stat::type::message, to_stat_detail (message.type ()), nano::stat::dir::in);
 	logger.trace (nano::log::type::message, to_log_detail (message.type ()), nano::log::arg{ "message", message });
 
-	process_visitor visitor{ node, channel };
 	message.visit (visitor);
 }
 
 nano::container_info nano::message_processor::container_info () const
 {
-	nano::lock_guard<nano::mutex> guard{ mutex };
-
 	nano::container_info info;
-	info.add ("queue", queue.container_info ());
+	std::size_t total = 0;
+	for (std::size_t n = 0; n < shards.size (); ++n)
+	{
+		nano::lock_guard<nano::mutex> guard{ shards[n]->mutex };
+		total += shards[n]->queue.size ();
+		info.add ("queue_" + std::to_string (n), shards[n]->queue.container_info ());
+	}
+	info.put ("queue", total);
 	return info;
 }
 
@@ -303,7 +517,7 @@ nano::container_info nano::message_processor::container_info () const
 
 nano::error nano::message_processor_config::serialize (nano::tomlconfig & toml) const
 {
-	toml.put ("threads", threads, "Number of threads to use for message processing. \ntype:uint64");
+	toml.put ("threads", threads, "Number of threads to use for message processing, messages of a peer are always processed by the same thread. \ntype:uint64");
 	toml.put ("max_queue", max_queue, "Maximum number of messages per peer to queue for processing. \ntype:uint64");
 
 	return toml.get_error ();
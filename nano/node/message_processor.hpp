@@ -5,6 +5,7 @@
 #include <nano/node/fair_queue.hpp>
 #include <nano/node/fwd.hpp>
 
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -17,12 +18,14 @@ public:
 	nano::error serialize (nano::tomlconfig & toml) const;
 
 public:
-	size_t threads{ std::clamp (nano::hardware_concurrency () / 4, 1u, 2u) };
+	/** Number of shards, each processed by its own thread */
+	size_t threads{ std::clamp (nano::hardware_concurrency () / 4, 1u, 8u) };
 	size_t max_queue{ 64 };
 };
 
 /*
- * If mutex locking is ever a performance bottleneck, using a lock-free queue in front of the priority queue should be considered.
+ * Inbound messages are sharded by channel, so messages of a single peer are always processed by the same thread in the order they were received.
+ * Consecutive blocks and votes of a peer within a processed batch are handed to the block and vote processors in bulk, without reordering them relative to its other messages.
  */
 class message_processor final
 {
@@ -34,13 +37,30 @@ public:
 	void stop ();
 
 	bool put (std::unique_ptr<nano::message>, std::shared_ptr<nano::transport::channel> const &);
+	/** Queues messages received together from a single channel under one lock, returns the number of messages added */
+	std::size_t put_batch (std::vector<std::unique_ptr<nano::message>>, std::shared_ptr<nano::transport::channel> const &);
 	void process (nano::message const &, std::shared_ptr<nano::transport::channel> const &);
+	/** Index of the shard processing the messages of \p channel */
+	std::size_t shard_index (nano::transport::channel const &) const;
 
 	nano::container_info container_info () const;
 
 private:
-	void run ();
-	void run_batch (nano::unique_lock<nano::mutex> &);
+	using entry_t = std::pair<std::unique_ptr<nano::message>, std::shared_ptr<nano::transport::channel>>;
+
+	class shard final
+	{
+	public:
+		nano::fair_queue<entry_t, nano::no_value> queue;
+		mutable nano::mutex mutex;
+		nano::condition_variable condition;
+		std::thread thread;
+	};
+
+	shard & select_shard (std::shared_ptr<nano::transport::channel> const &);
+	void run (shard &);
+	void run_batch (shard &, nano::unique_lock<nano::mutex> &);
+	void process (nano::message const &, nano::message_visitor &);
 
 private: // Dependencies
 	message_processor_config const & config;
@@ -49,12 +69,7 @@ private: // Dependencies
 	nano::logger & logger;
 
 private:
-	using entry_t = std::pair<std::unique_ptr<nano::message>, std::shared_ptr<nano::transport::channel>>;
-	nano::fair_queue<entry_t, nano::no_value> queue;
-
+	std::vector<std::unique_ptr<shard>> shards;
 	std::atomic<bool> stopped{ false };
-	mutable nano::mutex mutex;
-	nano::condition_variable condition;
-	std::vector<std::thread> threads;
 };
 }
\ No newline at end of file
@@ -680,6 +680,11 @@ uint8_t nano::confirm_ack::hash_count (const nano::message_header & header)
 std::size_t nano::confirm_ack::size (const nano::message_header & header)
 {
 	auto const count = hash_count (header);
+	if (is_compact (header))
+	{
+		auto const full = std::min<std::size_t> (compact_full_count (header), count);
+		return nano::vote::size (0) + (count + 7) / 8 + full * sizeof (nano::block_hash) + (count - full) * compact_index_size;
+	}
 	return nano::vote::size (count);
 }
 
@@ -688,6 +693,25 @@ bool nano::confirm_ack::is_rebroadcasted () const
 	return header.flag_test (rebroadcasted_flag);
 }
 
+bool nano::confirm_ack::is_compact (nano::message_header const & header)
+{
+	debug_assert (header.type == nano::message_type::confirm_ack);
+	return header.flag_test (compact_flag);
+}
+
+uint8_t nano::confirm_ack::compact_full_count (nano::message_header const & header)
+{
+	// The block type field is unused by confirm_ack
+	return static_cast<uint8_t> (((header.extensions & nano::message_header::block_type_mask) >> 8).to_ullong ());
+}
+
+void nano::confirm_ack::compact_full_count_set (nano::message_header & header, uint8_t count)
+{
+	debug_assert (count <= compact_max_full);
+	header.extensions &= ~nano::message_header::block_type_mask;
+	header.extensions |= (nano::message_header::extensions_bitset_t{ count } << 8) & nano::message_header::block_type_mask;
+}
+
 void nano::confirm_ack::operator() (nano::object_stream & obs) const
 {
 	nano::message::operator() (obs); // Write common data
@@ -1365,6 +1389,13 @@ bool nano::node_id_handshake::is_v2 () const
 	return is_v2 (header);
 }
 
+bool nano::node_id_handshake::is_compact_votes (nano::message_header const & header)
+{
+	debug_assert (header.type == nano::message_type::node_id_handshake);
+	bool result = header.extensions.test (compact_votes_flag);
+	return result;
+}
+
 void nano::node_id_handshake::visit (nano::message_visitor & visitor_a) const
 {
 	visitor_a.node_id_handshake (*this);
@@ -269,6 +269,14 @@ public: // Logging
  * - [0x0001] Confirm V2 flag
  * - [0x0002] Reserved for V3+ versioning
  * - [0x0004] Rebroadcasted flag
+ * - [0x0008] Compact flag, only sent to peers that advertised support in their handshake query
+ *
+ * Compact format (always uses the V2 count, the block type field holds the number of hashes sent in full):
+ * [32 bytes] Account
+ * [64 bytes] Signature
+ * [8 bytes] Timestamp
+ * [(count + 7) / 8 bytes] Bitmap of the hashes sent in full
+ * [variable] In order, each hash either in full or as 2 byte index into the table of hashes previously sent in full on the connection
  */
 class confirm_ack final : public message
 {
@@ -285,7 +293,14 @@ public:
 	static uint8_t constexpr rebroadcasted_flag = 2; // 0x0004
 	bool is_rebroadcasted () const;
 
-private:
+	static uint8_t constexpr compact_flag = 3; // 0x0008
+	static bool is_compact (nano::message_header const &);
+	/** Number of hashes of a compact confirm_ack that are sent in full */
+	static uint8_t compact_full_count (nano::message_header const &);
+	static void compact_full_count_set (nano::message_header &, uint8_t);
+	static std::size_t constexpr compact_index_size = sizeof (uint16_t);
+	static std::size_t constexpr compact_max_full = 15;
+
 	static uint8_t hash_count (nano::message_header const &);
 
 public: // Payload
@@ -514,11 +529,14 @@ public: // Header
 	static uint8_t constexpr query_flag = 0;
 	static uint8_t constexpr response_flag = 1;
 	static uint8_t constexpr v2_flag = 2;
+	/** Set on queries by nodes able to decode compact confirm_ack messages */
+	static uint8_t constexpr compact_votes_flag = 3;
 
 	static bool is_query (nano::message_header const &);
 	static bool is_response (nano::message_header const &);
 	static bool is_v2 (nano::message_header const &);
 	bool is_v2 () const;
+	static bool is_compact_votes (nano::message_header const &);
 
 public: // Payload
 	std::optional<query_payload> query;
@@ -1,4 +1,3 @@
-#include <nano/crypto_lib/random_pool_shuffle.hpp>
 #include <nano/lib/blocks.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/lib/utility.hpp>
@@ -129,6 +128,11 @@ void nano::network::run_cleanup ()
 			auto const cutoff = std::chrono::steady_clock::now () - node.network_params.network.cleanup_cutoff ();
 			cleanup (cutoff);
 		}
+		else
+		{
+			// Purging refreshes the snapshot otherwise, representative weights may have changed
+			tcp_channels.update_snapshot ();
+		}
 
 		auto const syn_cookie_cutoff = std::chrono::steady_clock::now () - node.network_params.network.syn_cookie_cutoff;
 		syn_cookies.purge (syn_cookie_cutoff);
@@ -249,9 +253,29 @@ void nano::network::send_keepalive_self (std::shared_ptr<nano::transport::channe
 
 void nano::network::flood_message (nano::message const & message, nano::transport::traffic_type type, float scale) const
 {
-	for (auto const & channel : list (fanout (scale)))
+	send_all (message, list (fanout (scale)), type);
+}
+
+void nano::network::send_all (nano::message const & message, std::deque<std::shared_ptr<nano::transport::channel>> const & channels, nano::transport::traffic_type type) const
+{
+	if (channels.empty ())
 	{
-		channel->send (message, type);
+		return;
+	}
+	auto const buffer = message.to_shared_const_buffer ();
+	uint64_t sent = 0;
+	for (auto const & channel : channels)
+	{
+		sent += channel->send_serialized (buffer, type) ? 1 : 0;
+	}
+	auto const detail = nano::to_stat_detail (message.type ());
+	if (sent > 0)
+	{
+		node.stats.add (nano::stat::type::message, detail, nano::stat::dir::out, sent, /* aggregate all */ true);
+	}
+	if (sent < channels.size ())
+	{
+		node.stats.add (nano::stat::type::drop, detail, nano::stat::dir::out, channels.size () - sent, /* aggregate all */ true);
 	}
 }
 
@@ -278,41 +302,28 @@ void nano::network::flood_block (std::shared_ptr<nano::block> const & block, nan
 void nano::network::flood_block_initial (std::shared_ptr<nano::block> const & block) const
 {
 	nano::publish message{ node.network_params.network, block, /* is_originator */ true };
-	for (auto const & rep : node.rep_crawler.principal_representatives ())
-	{
-		rep.channel->send (message, nano::transport::traffic_type::block_broadcast_initial);
-	}
-	for (auto & peer : list_non_pr (fanout (1.0)))
-	{
-		peer->send (message, nano::transport::traffic_type::block_broadcast_initial);
-	}
+	auto channels = list_pr ();
+	auto non_pr = list_non_pr (fanout (1.0));
+	channels.insert (channels.end (), non_pr.begin (), non_pr.end ());
+	send_all (message, channels, nano::transport::traffic_type::block_broadcast_initial);
 }
 
 void nano::network::flood_vote (std::shared_ptr<nano::vote> const & vote, float scale, bool rebroadcasted) const
 {
 	nano::confirm_ack message{ node.network_params.network, vote, rebroadcasted };
-	for (auto & channel : list (fanout (scale)))
-	{
-		channel->send (message, rebroadcasted ? nano::transport::traffic_type::vote_rebroadcast : nano::transport::traffic_type::vote);
-	}
+	send_all (message, list (fanout (scale)), rebroadcasted ? nano::transport::traffic_type::vote_rebroadcast : nano::transport::traffic_type::vote);
 }
 
 void nano::network::flood_vote_non_pr (std::shared_ptr<nano::vote> const & vote, float scale, bool rebroadcasted) const
 {
 	nano::confirm_ack message{ node.network_params.network, vote, rebroadcasted };
-	for (auto & channel : list_non_pr (fanout (scale)))
-	{
-		channel->send (message, rebroadcasted ? nano::transport::traffic_type::vote_rebroadcast : nano::transport::traffic_type::vote);
-	}
+	send_all (message, list_non_pr (fanout (scale)), rebroadcasted ? nano::transport::traffic_type::vote_rebroadcast : nano::transport::traffic_type::vote);
 }
 
 void nano::network::flood_vote_pr (std::shared_ptr<nano::vote> const & vote, bool rebroadcasted) const
 {
 	nano::confirm_ack message{ node.network_params.network, vote, rebroadcasted };
-	for (auto const & channel : node.rep_crawler.principal_representatives ())
-	{
-		channel.channel->send (message, rebroadcasted ? nano::transport::traffic_type::vote_rebroadcast : nano::transport::traffic_type::vote);
-	}
+	send_all (message, list_pr (), rebroadcasted ? nano::transport::traffic_type::vote_rebroadcast : nano::transport::traffic_type::vote);
 }
 
 void nano::network::flood_block_many (std::deque<std::shared_ptr<nano::block>> blocks, nano::transport::traffic_type type, std::chrono::milliseconds delay, std::function<void ()> callback) const
@@ -397,34 +408,48 @@ bool nano::network::track_reachout (nano::endpoint const & endpoint_a)
 	return tcp_channels.track_reachout (endpoint_a);
 }
 
-std::deque<std::shared_ptr<nano::transport::channel>> nano::network::list (std::size_t max_count, uint8_t minimum_version) const
+namespace
+{
+/*
+ * Up to \p max_count channels starting at a random position of the already shuffled \p channels
+ */
+std::deque<std::shared_ptr<nano::transport::channel>> sample_channels (nano::transport::tcp_channels::snapshot::channels_t const & channels, std::size_t max_count, uint8_t minimum_version)
 {
-	auto result = tcp_channels.list (minimum_version);
-	nano::random_pool_shuffle (result.begin (), result.end ()); // Randomize returned peer order
-	if (max_count > 0 && result.size () > max_count)
+	static thread_local nano::random_generator rng;
+
+	std::deque<std::shared_ptr<nano::transport::channel>> result;
+	if (channels.empty () || max_count == 0)
 	{
-		result.resize (max_count, nullptr);
+		return result;
+	}
+	auto const offset = rng.random (channels.size ());
+	for (std::size_t i = 0; i < channels.size () && result.size () < max_count; ++i)
+	{
+		auto const & channel = channels[(offset + i) % channels.size ()];
+		if (channel->get_network_version () >= minimum_version)
+		{
+			result.push_back (channel);
+		}
 	}
 	return result;
 }
+}
 
-std::deque<std::shared_ptr<nano::transport::channel>> nano::network::list_non_pr (std::size_t max_count, uint8_t minimum_version) const
+std::deque<std::shared_ptr<nano::transport::channel>> nano::network::list (std::size_t max_count, uint8_t minimum_version) const
 {
-	auto result = tcp_channels.list (minimum_version);
-
-	auto partition_point = std::partition (result.begin (), result.end (),
-	[this] (std::shared_ptr<nano::transport::channel> const & channel) {
-		return !node.rep_crawler.is_pr (channel);
-	});
-	result.resize (std::distance (result.begin (), partition_point));
+	auto const snapshot = tcp_channels.get_snapshot ();
+	return sample_channels (snapshot->all, max_count > 0 ? max_count : snapshot->all.size (), minimum_version);
+}
 
-	nano::random_pool_shuffle (result.begin (), result.end ()); // Randomize returned peer order
+std::deque<std::shared_ptr<nano::transport::channel>> nano::network::list_non_pr (std::size_t max_count, uint8_t minimum_version) const
+{
+	return sample_channels (tcp_channels.get_snapshot ()->non_principal, max_count, minimum_version);
+}
 
-	if (result.size () > max_count)
-	{
-		result.resize (max_count, nullptr);
-	}
-	return result;
+std::deque<std::shared_ptr<nano::transport::channel>> nano::network::list_pr (uint8_t minimum_version) const
+{
+	auto const snapshot = tcp_channels.get_snapshot ();
+	return sample_channels (snapshot->principal, snapshot->principal.size (), minimum_version);
 }
 
 // Simulating with sqrt_broadcast_simulate shows we only need to broadcast to sqrt(total_peers) random peers in order to successfully publish to everyone with high probability
@@ -93,6 +93,8 @@ public:
 	nano::endpoint endpoint () const;
 
 	void flood_message (nano::message const &, nano::transport::traffic_type, float scale = 1.0f) const;
+	/** Serializes \p message once and sends the shared buffer to all \p channels, sent and dropped messages are counted once for the whole fan-out */
+	void send_all (nano::message const &, std::deque<std::shared_ptr<nano::transport::channel>> const & channels, nano::transport::traffic_type) const;
 	void flood_keepalive (float scale = 1.0f) const;
 	void flood_keepalive_self (float scale = 0.5f) const;
 	void flood_vote (std::shared_ptr<nano::vote> const &, float scale, bool rebroadcasted = false) const;
@@ -120,6 +122,8 @@ public:
 
 	std::deque<std::shared_ptr<nano::transport::channel>> list (std::size_t max_count = 0, uint8_t minimum_version = 0) const;
 	std::deque<std::shared_ptr<nano::transport::channel>> list_non_pr (std::size_t max_count, uint8_t minimum_version = 0) const;
+	// All channels of principal representatives in random order
+	std::deque<std::shared_ptr<nano::transport::channel>> list_pr (uint8_t minimum_version = 0) const;
 
 	// Desired fanout for a given scale
 	std::size_t fanout (float scale = 1.0f) const;
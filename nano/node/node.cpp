@@ -68,6 +68,34 @@ extern std::vector<std::pair<std::string, std::string>> preconfigured_weights_be
 extern uint64_t max_blocks_beta;
 }
 
+namespace
+{
+nano::generate_cache_flags make_generate_cache_flags (nano::node_flags const & flags, std::filesystem::path const & application_path, nano::logger & logger)
+{
+	auto result = flags.generate_cache;
+	if (!flags.disable_ledger_cache_snapshot && result.snapshot.empty ())
+	{
+		result.snapshot = application_path / "ledger_cache.snapshot";
+	}
+	// Inactive nodes write to the store directly, bypassing the ledger cache, a snapshot written by them would not match the database
+	if (flags.inactive_node)
+	{
+		result.snapshot.clear ();
+	}
+	if (!result.progress)
+	{
+		result.progress = [&logger] (std::string_view table, std::size_t completed, std::size_t total) {
+			logger.debug (nano::log::type::ledger, "Generating ledger cache from {} table: {} of {} ranges", table, completed, total);
+			if (completed == total)
+			{
+				logger.info (nano::log::type::ledger, "Generated ledger cache from {} table", table);
+			}
+		};
+	}
+	return result;
+}
+}
+
 /*
  * node
  */
@@ -92,6 +120,8 @@ nano::node::node (std::shared_ptr<boost::asio::io_context> io_ctx_a, std::filesy
 	stats{ *stats_impl },
 	runner_impl{ std::make_unique<nano::thread_runner> (io_ctx_shared, logger, config.io_threads) },
 	runner{ *runner_impl },
+	io_pool_impl{ std::make_unique<nano::io_context_pool> (io_ctx, logger, config.io_shards) },
+	io_pool{ *io_pool_impl },
 	observers_impl{ std::make_unique<nano::node_observers> () },
 	observers{ *observers_impl },
 	workers_impl{ std::make_unique<nano::thread_pool> (config.background_threads, nano::thread_role::name::worker, /* start immediately */ true) },
@@ -113,7 +143,7 @@ nano::node::node (std::shared_ptr<boost::asio::io_context> io_ctx_a, std::filesy
 	wallets_store{ *wallets_store_impl },
 	wallets_impl{ std::make_unique<nano::wallets> (wallets_store.init_error (), *this) },
 	wallets{ *wallets_impl },
-	ledger_impl{ std::make_unique<nano::ledger> (store, stats, network_params.ledger, flags_a.generate_cache, config_a.representative_vote_weight_minimum.number ()) },
+	ledger_impl{ std::make_unique<nano::ledger> (store, stats, network_params.ledger, make_generate_cache_flags (flags_a, application_path_a, logger), config_a.representative_vote_weight_minimum.number ()) },
 	ledger{ *ledger_impl },
 	outbound_limiter_impl{ std::make_unique<nano::bandwidth_limiter> (config) },
 	outbound_limiter{ *outbound_limiter_impl },
@@ -359,6 +389,7 @@ nano::node::node (std::shared_ptr<boost::asio::io_context> io_ctx_a, std::filesy
 			logger.warn (nano::log::type::node, "Work generation is disabled");
 		}
 
+		logger.info (nano::log::type::node, "Network I/O backend: {}", nano::io_backend ());
 		logger.info (nano::log::type::node, "Outbound bandwidth limit: {} bytes/s, burst ratio: {}",
 		config.bandwidth_limit,
 		config.bandwidth_limit_burst_ratio);
@@ -648,6 +679,13 @@ void nano::node::start ()
 	{
 		search_receivable_all ();
 	}
+	if (!flags.disable_ledger_cache_snapshot && !flags.read_only && !flags.inactive_node)
+	{
+		auto this_l (shared ());
+		workers.post_delayed (network_params.node.ledger_cache_snapshot_interval, [this_l] () {
+			this_l->ongoing_ledger_cache_snapshot ();
+		});
+	}
 	// Start port mapping if external address is not defined and TCP ports are enabled
 	if (config.external_address == boost::asio::ip::address_v6::any ().to_string () && tcp_enabled)
 	{
@@ -730,9 +768,17 @@ void nano::node::stop ()
 	election_workers.stop ();
 	workers.stop ();
 
+	// All writers have been stopped, so a snapshot written now stays valid until the next start
+	if (!flags.disable_ledger_cache_snapshot && !flags.read_only && !flags.inactive_node)
+	{
+		ledger.write_cache_snapshot ();
+	}
+
 	// work pool is not stopped on purpose due to testing setup
 
-	// Stop the IO runner last
+	// Stop the IO runners last
+	io_pool.abort ();
+	io_pool.join ();
 	runner.abort ();
 	runner.join ();
 	debug_assert (io_ctx_shared.use_count () == 1); // Node should be the last user of the io_context
@@ -923,6 +969,15 @@ void nano::node::ongoing_ledger_pruning ()
 	});
 }
 
+void nano::node::ongoing_ledger_cache_snapshot ()
+{
+	ledger.write_cache_snapshot ();
+	auto this_l (shared ());
+	workers.post_delayed (network_params.node.ledger_cache_snapshot_interval, [this_l] () {
+		this_l->ongoing_ledger_cache_snapshot ();
+	});
+}
+
 uint64_t nano::node::default_difficulty (nano::work_version const version_a) const
 {
 	uint64_t result{ std::numeric_limits<uint64_t>::max () };
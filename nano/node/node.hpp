@@ -64,6 +64,7 @@ public:
 	bool collect_ledger_pruning_targets (std::deque<nano::block_hash> &, nano::account &, uint64_t const, uint64_t const, uint64_t const);
 	void ledger_pruning (uint64_t const, bool);
 	void ongoing_ledger_pruning ();
+	void ongoing_ledger_cache_snapshot ();
 	// The default difficulty updates to base only when the first epoch_2 block is processed
 	uint64_t default_difficulty (nano::work_version const) const;
 	uint64_t default_receive_difficulty (nano::work_version const) const;
@@ -110,6 +111,9 @@ public:
 	nano::stats & stats;
 	std::unique_ptr<nano::thread_runner> runner_impl;
 	nano::thread_runner & runner;
+	std::unique_ptr<nano::io_context_pool> io_pool_impl;
+	/** io_contexts peer connections are assigned to */
+	nano::io_context_pool & io_pool;
 	std::unique_ptr<nano::node_observers> observers_impl;
 	nano::node_observers & observers;
 	std::unique_ptr<nano::thread_pool> workers_impl;
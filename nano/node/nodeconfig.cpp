@@ -117,7 +117,10 @@ nano::error nano::node_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("online_weight_minimum", online_weight_minimum.to_string_dec (), "When calculating online weight, the node is forced to assume at least this much voting weight is online, thus setting a floor for voting weight to confirm transactions at online_weight_minimum * \"quorum delta\".\ntype:string,amount,raw");
 	toml.put ("representative_vote_weight_minimum", representative_vote_weight_minimum.to_string_dec (), "Minimum vote weight that a representative must have for its vote to be counted.\nAll representatives above this weight will be kept in memory!\ntype:string,amount,raw");
 	toml.put ("password_fanout", password_fanout, "Password fanout factor.\ntype:uint64");
+	toml.put ("kdf_threads", kdf_threads, "Number of wallet password key derivations running concurrently. Each derivation uses 64 MiB of memory on the live network. Defaults to half the number of CPU threads, between 1 and 4.\ntype:uint64");
+	toml.put ("kdf_cache_lifetime", kdf_cache_lifetime.count (), "Time in seconds a derived wallet key is kept in memory so unlocking a wallet again with the same password is immediate. 0 disables caching.\ntype:seconds");
 	toml.put ("io_threads", io_threads, "Number of threads dedicated to I/O operations. Defaults to the number of CPU threads, and at least 4.\ntype:uint64");
+	toml.put ("io_shards", io_shards, "Number of separate I/O contexts, each with its own thread, that peer connections are assigned to round robin. Reduces contention on the shared I/O scheduler with many io_threads. 0 runs peer connections on the io_threads.\ntype:uint64");
 	toml.put ("network_threads", network_threads, "Number of threads dedicated to processing network messages. Defaults to the number of CPU threads, and at least 4.\ntype:uint64");
 	toml.put ("work_threads", work_threads, "Number of threads dedicated to CPU generated work. Defaults to all available CPU threads.\ntype:uint64");
 	toml.put ("background_threads", background_threads, "Number of threads dedicated to background node work, including handling of RPC requests. Defaults to all available CPU threads.\ntype:uint64");
@@ -536,7 +539,12 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 
 		toml.get<unsigned> ("bootstrap_fraction_numerator", bootstrap_fraction_numerator);
 		toml.get<unsigned> ("password_fanout", password_fanout);
+		toml.get<unsigned> ("kdf_threads", kdf_threads);
+		auto kdf_cache_lifetime_l = static_cast<unsigned long> (kdf_cache_lifetime.count ());
+		toml.get ("kdf_cache_lifetime", kdf_cache_lifetime_l);
+		kdf_cache_lifetime = std::chrono::seconds (kdf_cache_lifetime_l);
 		toml.get<unsigned> ("io_threads", io_threads);
+		toml.get<unsigned> ("io_shards", io_shards);
 		toml.get<unsigned> ("work_threads", work_threads);
 		toml.get<unsigned> ("network_threads", network_threads);
 		toml.get<unsigned> ("background_threads", background_threads);
@@ -621,6 +629,10 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		{
 			toml.get_error ().set ("io_threads must be non-zero");
 		}
+		if (kdf_threads == 0)
+		{
+			toml.get_error ().set ("kdf_threads must be non-zero");
+		}
 		if (active_elections.size <= 250 && !network_params.network.is_dev_network ())
 		{
 			toml.get_error ().set ("active_elections.size must be greater than 250");
@@ -82,7 +82,13 @@ public:
 	 */
 	nano::amount representative_vote_weight_minimum{ 10 * nano::nano_ratio };
 	unsigned password_fanout{ 1024 };
+	/** Number of concurrent password key derivations, each holding the kdf work memory of the network */
+	unsigned kdf_threads{ std::clamp (nano::hardware_concurrency () / 2, 1u, 4u) };
+	/** Derived wallet keys are kept for this long so repeated unlocks skip the key derivation, zero disables caching */
+	std::chrono::seconds kdf_cache_lifetime{ 60 };
 	unsigned io_threads{ env_io_threads ().value_or (std::max (4u, nano::hardware_concurrency ())) };
+	/** Number of additional single threaded io_contexts peer connections are spread over, zero runs all connections on the shared io_context */
+	unsigned io_shards{ 0 };
 	unsigned network_threads{ std::max (4u, nano::hardware_concurrency ()) };
 	unsigned work_threads{ std::max (4u, nano::hardware_concurrency ()) };
 	unsigned background_threads{ std::max (4u, nano::hardware_concurrency ()) };
@@ -185,6 +191,7 @@ public:
 	bool disable_max_peers_per_ip{ false }; // For testing only
 	bool disable_max_peers_per_subnetwork{ false }; // For testing only
 	bool disable_search_pending{ false }; // For testing only
+	bool disable_ledger_cache_snapshot{ false };
 	bool enable_pruning{ false };
 	bool fast_bootstrap{ false };
 	bool read_only{ false };
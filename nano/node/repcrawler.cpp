@@ -135,6 +135,10 @@ void nano::rep_crawler::validate_and_process (nano::unique_lock<nano::mutex> & l
 		{
 			logger.warn (nano::log::type::rep_crawler, "Updated representative: {} at: {} (was at: {})", vote->account.to_account (), channel->to_string (), prev_channel->to_string ());
 		}
+		if (inserted || updated)
+		{
+			node.network.tcp_channels.update_snapshot ();
+		}
 	}
 }
 
@@ -465,8 +469,11 @@ std::size_t nano::rep_crawler::representative_count () const
 void nano::rep_crawler::force_add_rep (const nano::account & account, const std::shared_ptr<nano::transport::channel> & channel)
 {
 	release_assert (node.network_params.network.is_dev_network ());
-	nano::lock_guard<nano::mutex> lock{ mutex };
-	reps.emplace (rep_entry{ account, channel });
+	{
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		reps.emplace (rep_entry{ account, channel });
+	}
+	node.network.tcp_channels.update_snapshot ();
 }
 
 // Only for tests
@@ -22,6 +22,11 @@ bool nano::transport::channel::send (nano::message const & message, nano::transp
 	return sent;
 }
 
+bool nano::transport::channel::send_serialized (nano::shared_const_buffer const & buffer, nano::transport::traffic_type traffic_type, callback_t callback)
+{
+	return send_buffer (buffer, traffic_type, std::move (callback));
+}
+
 void nano::transport::channel::set_peering_endpoint (nano::endpoint endpoint)
 {
 	nano::lock_guard<nano::mutex> lock{ mutex };
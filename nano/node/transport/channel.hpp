@@ -17,7 +17,8 @@ enum class transport_type : uint8_t
 	undefined = 0,
 	tcp = 1,
 	loopback = 2,
-	fake = 3
+	fake = 3,
+	simulated = 4
 };
 
 class channel
@@ -31,6 +32,9 @@ public:
 
 	/// @returns true if the message was sent (or queued to be sent), false if it was immediately dropped
 	bool send (nano::message const &, nano::transport::traffic_type, callback_t = nullptr);
+	/// Sends a message already serialized into \p buffer, so a message sent to many channels is serialized once. Stats are left to the caller
+	/// @returns true if the message was sent (or queued to be sent), false if it was immediately dropped
+	bool send_serialized (nano::shared_const_buffer const &, nano::transport::traffic_type, callback_t = nullptr);
 
 	virtual void close () = 0;
 
@@ -0,0 +1,242 @@
+#include <nano/lib/block_type.hpp>
+#include <nano/lib/stream.hpp>
+#include <nano/node/transport/compact_votes.hpp>
+#include <nano/secure/vote.hpp>
+
+#include <algorithm>
+#include <optional>
+
+/*
+ * compact_votes_table
+ */
+
+nano::transport::compact_votes_table::compact_votes_table () :
+	slots (size)
+{
+}
+
+uint16_t nano::transport::compact_votes_table::append (nano::block_hash const & hash)
+{
+	auto const index = static_cast<uint16_t> (appended++ % size);
+	slots[index] = hash;
+	return index;
+}
+
+/*
+ * compact_vote_encoder
+ */
+
+nano::shared_const_buffer nano::transport::compact_vote_encoder::encode (nano::shared_const_buffer const & buffer, bool compact)
+{
+	auto const & raw = *buffer.begin ();
+	auto const data = static_cast<uint8_t const *> (raw.data ());
+	auto const size = raw.size ();
+	if (size < nano::message_header::size)
+	{
+		return buffer;
+	}
+
+	bool error = false;
+	nano::bufferstream header_stream{ data, nano::message_header::size };
+	nano::message_header header{ error, header_stream };
+	if (error || header.type != nano::message_type::confirm_ack || nano::confirm_ack::is_compact (header))
+	{
+		return buffer;
+	}
+	auto const count = nano::confirm_ack::hash_count (header);
+	if (size != nano::message_header::size + nano::vote::size (count))
+	{
+		debug_assert (false);
+		return buffer;
+	}
+
+	uint8_t const * const fixed = data + nano::message_header::size;
+	uint8_t const * const hashes = fixed + nano::vote::size (0);
+	auto hash_at = [hashes] (std::size_t index) {
+		nano::block_hash hash;
+		std::copy_n (hashes + index * sizeof (hash), sizeof (hash), hash.bytes.begin ());
+		return hash;
+	};
+
+	// Indices refer to the table before any hash of this message is appended, the same as when decoding
+	std::vector<std::optional<uint16_t>> encoded (count);
+	std::size_t full = 0;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		auto existing = compact ? indices.find (hash_at (i)) : indices.end ();
+		if (existing != indices.end ())
+		{
+			encoded[i] = existing->second;
+		}
+		else
+		{
+			++full;
+		}
+	}
+
+	auto compact_header = header;
+	std::size_t compact_size = size;
+	if (compact && full <= nano::confirm_ack::compact_max_full)
+	{
+		compact_header.flag_set (nano::confirm_ack::compact_flag);
+		compact_header.confirm_set_v2 (true);
+		compact_header.count_v2_set (count);
+		nano::confirm_ack::compact_full_count_set (compact_header, static_cast<uint8_t> (full));
+		compact_size = nano::message_header::size + nano::confirm_ack::size (compact_header);
+	}
+	if (compact_size >= size)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			insert (hash_at (i));
+		}
+		return buffer;
+	}
+
+	std::vector<uint8_t> result;
+	result.reserve (compact_size);
+	{
+		nano::vectorstream stream{ result };
+		compact_header.serialize (stream);
+	}
+	result.insert (result.end (), fixed, hashes);
+	auto const bitmap = result.size ();
+	result.resize (bitmap + (count + 7) / 8, 0);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (encoded[i])
+		{
+			result.push_back (static_cast<uint8_t> (*encoded[i] >> 8));
+			result.push_back (static_cast<uint8_t> (*encoded[i] & 0xff));
+		}
+		else
+		{
+			result[bitmap + i / 8] |= static_cast<uint8_t> (1 << (i % 8));
+			result.insert (result.end (), hashes + i * sizeof (nano::block_hash), hashes + (i + 1) * sizeof (nano::block_hash));
+		}
+	}
+	debug_assert (result.size () == compact_size);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (!encoded[i])
+		{
+			insert (hash_at (i));
+		}
+	}
+	return nano::shared_const_buffer{ std::move (result) };
+}
+
+void nano::transport::compact_vote_encoder::insert (nano::block_hash const & hash)
+{
+	if (appended >= size)
+	{
+		// The evicted hash is forgotten unless it was appended again since
+		auto const index = static_cast<uint16_t> (appended % size);
+		if (auto existing = indices.find (slots[index]); existing != indices.end () && existing->second == index)
+		{
+			indices.erase (existing);
+		}
+	}
+	indices[hash] = append (hash);
+}
+
+/*
+ * compact_vote_decoder
+ */
+
+bool nano::transport::compact_vote_decoder::decode (nano::message_header & header, uint8_t const * data, std::size_t size, std::vector<uint8_t> & payload)
+{
+	debug_assert (nano::confirm_ack::is_compact (header));
+	if (!header.confirm_is_v2 ())
+	{
+		return true;
+	}
+	auto const count = nano::confirm_ack::hash_count (header);
+	auto const full = nano::confirm_ack::compact_full_count (header);
+	if (full > count || size != nano::confirm_ack::size (header))
+	{
+		return true;
+	}
+
+	uint8_t const * const bitmap = data + nano::vote::size (0);
+	uint8_t const * entry = bitmap + (count + 7) / 8;
+	auto is_full = [bitmap] (std::size_t index) {
+		return ((bitmap[index / 8] >> (index % 8)) & 1) != 0;
+	};
+	auto const filled = std::min<uint64_t> (appended, compact_votes_table::size);
+
+	payload.clear ();
+	payload.reserve (nano::vote::size (count));
+	payload.insert (payload.end (), data, bitmap);
+	std::size_t full_seen = 0;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (is_full (i))
+		{
+			// Bounds the bytes read to the size checked above
+			if (++full_seen > full)
+			{
+				return true;
+			}
+			payload.insert (payload.end (), entry, entry + sizeof (nano::block_hash));
+			entry += sizeof (nano::block_hash);
+		}
+		else
+		{
+			auto const index = static_cast<uint16_t> ((entry[0] << 8) | entry[1]);
+			entry += nano::confirm_ack::compact_index_size;
+			if (index >= filled)
+			{
+				return true;
+			}
+			payload.insert (payload.end (), slots[index].bytes.begin (), slots[index].bytes.end ());
+		}
+	}
+	if (full_seen != full)
+	{
+		return true;
+	}
+
+	uint8_t const * const hashes = payload.data () + nano::vote::size (0);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (is_full (i))
+		{
+			nano::block_hash hash;
+			std::copy_n (hashes + i * sizeof (hash), sizeof (hash), hash.bytes.begin ());
+			append (hash);
+		}
+	}
+
+	// Same header as the regular encoding of the vote
+	header.flag_set (nano::confirm_ack::compact_flag, false);
+	header.block_type_set (nano::block_type::not_a_block);
+	header.extensions &= ~(nano::message_header::count_v2_mask_left | nano::message_header::count_v2_mask_right);
+	if (count >= 16)
+	{
+		header.count_v2_set (count);
+	}
+	else
+	{
+		header.confirm_set_v2 (false);
+		header.count_set (count);
+	}
+	return false;
+}
+
+void nano::transport::compact_vote_decoder::insert (nano::message_header const & header, uint8_t const * data, std::size_t size)
+{
+	debug_assert (!nano::confirm_ack::is_compact (header));
+	auto const count = nano::confirm_ack::hash_count (header);
+	if (size != nano::vote::size (count))
+	{
+		return;
+	}
+	uint8_t const * const hashes = data + nano::vote::size (0);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		nano::block_hash hash;
+		std::copy_n (hashes + i * sizeof (hash), sizeof (hash), hash.bytes.begin ());
+		append (hash);
+	}
+}
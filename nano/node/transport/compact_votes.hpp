@@ -0,0 +1,71 @@
+#pragma once
+
+#include <nano/lib/asio.hpp>
+#include <nano/lib/numbers.hpp>
+#include <nano/lib/numbers_templ.hpp>
+#include <nano/node/messages.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace nano::transport
+{
+/**
+ * Both ends of a connection append every hash sent in full in a confirm_ack to a table of the most recently sent hashes,
+ * in the order the messages are sent. Hashes still in the table are sent as their 2 byte index instead, which is most effective
+ * for representatives voting on the same elections as final votes and replies to requests shortly after their normal votes.
+ */
+class compact_votes_table
+{
+public:
+	static std::size_t constexpr size = 2048;
+	static_assert (size <= std::numeric_limits<uint16_t>::max () + 1);
+
+	compact_votes_table ();
+
+protected:
+	/** @returns the index the hash was stored at */
+	uint16_t append (nano::block_hash const &);
+
+	std::vector<nano::block_hash> slots;
+	/** Total number of hashes appended, the next index is `appended % size` */
+	uint64_t appended{ 0 };
+};
+
+/**
+ * Encodes the confirm_ack messages sent on a connection, must see every message in the order it is written to the socket.
+ */
+class compact_vote_encoder final : public compact_votes_table
+{
+public:
+	/**
+	 * Adds the hashes of a confirm_ack that are sent in full to the table.
+	 * @param compact whether the peer decodes compact votes
+	 * @returns the compact encoding of \p buffer if it is a confirm_ack that got smaller, otherwise \p buffer
+	 */
+	nano::shared_const_buffer encode (nano::shared_const_buffer const & buffer, bool compact);
+
+private:
+	void insert (nano::block_hash const &);
+
+	std::unordered_map<nano::block_hash, uint16_t> indices;
+};
+
+/**
+ * Expands compact confirm_ack messages received on a connection, must see every confirm_ack payload in the order it was received.
+ */
+class compact_vote_decoder final : public compact_votes_table
+{
+public:
+	/**
+	 * Expands a compact confirm_ack into the payload and header of the same vote in the regular format, adding the hashes sent in full to the table.
+	 * Indices are only checked against the filled part of the table, a table out of sync with the peer can still decode to a vote with an invalid signature.
+	 * @returns true on error, in which case the table is no longer in sync with the peer
+	 */
+	bool decode (nano::message_header & header, uint8_t const * data, std::size_t size, std::vector<uint8_t> & payload);
+	/** Adds all hashes of a regular confirm_ack payload to the table */
+	void insert (nano::message_header const & header, uint8_t const * data, std::size_t size);
+};
+}
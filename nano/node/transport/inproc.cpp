@@ -19,43 +19,47 @@ nano::transport::inproc::channel::channel (nano::node & node, nano::node & desti
  * Note that the inbound message visitor will be called before the callback because it is called directly whereas the callback is spawned in the background.
  */
 bool nano::transport::inproc::channel::send_buffer (nano::shared_const_buffer const & buffer, nano::transport::traffic_type traffic_type, nano::transport::channel::callback_t callback)
+{
+	// we create a temporary channel for the reply path, in case the receiver of the message wants to reply
+	nano::transport::inproc::deliver (node, destination, buffer.to_bytes (), std::make_shared<nano::transport::inproc::channel> (destination, node));
+
+	if (callback)
+	{
+		node.io_ctx.post ([callback_l = std::move (callback), buffer_size = buffer.size ()] () {
+			callback_l (boost::system::errc::make_error_code (boost::system::errc::success), buffer_size);
+		});
+	}
+
+	return true;
+}
+
+void nano::transport::inproc::deliver (nano::node & context, nano::node & destination, std::vector<uint8_t> const & buffer, std::shared_ptr<nano::transport::channel> const & channel)
 {
 	std::size_t offset{ 0 };
-	auto const buffer_read_fn = [&offset, buffer_v = buffer.to_bytes ()] (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a) {
-		debug_assert (buffer_v.size () >= (offset + size_a));
-		data_a->resize (size_a);
-		auto const copy_start = buffer_v.begin () + offset;
-		std::copy (copy_start, copy_start + size_a, data_a->data ());
-		offset += size_a;
-		callback_a (boost::system::errc::make_error_code (boost::system::errc::success), size_a);
+	auto const buffer_read_fn = [&offset, &buffer] (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t offset_a, std::size_t min_size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a) {
+		auto const size = std::min (buffer.size () - offset, data_a->size () - offset_a);
+		debug_assert (size >= min_size_a);
+		auto const copy_start = buffer.begin () + offset;
+		std::copy (copy_start, copy_start + size, data_a->data () + offset_a);
+		offset += size;
+		callback_a (boost::system::errc::make_error_code (boost::system::errc::success), size);
 	};
 
-	auto const message_deserializer = std::make_shared<nano::transport::message_deserializer> (node.network_params.network, node.network.filter, node.block_uniquer, node.vote_uniquer, buffer_read_fn);
+	// The buffer holds exactly one message
+	auto const message_deserializer = std::make_shared<nano::transport::message_deserializer> (context.network_params.network, context.network.filter, context.block_uniquer, context.vote_uniquer, buffer_read_fn, buffer.size ());
 	message_deserializer->read (
-	[this] (boost::system::error_code ec_a, std::unique_ptr<nano::message> message_a) {
+	[&context, &destination, &channel] (boost::system::error_code ec_a, std::unique_ptr<nano::message> message_a) {
 		if (ec_a || !message_a)
 		{
 			return;
 		}
 
-		// we create a temporary channel for the reply path, in case the receiver of the message wants to reply
-		auto remote_channel = std::make_shared<nano::transport::inproc::channel> (destination, node);
-
 		// process message
 		{
-			node.stats.inc (nano::stat::type::message, to_stat_detail (message_a->type ()), nano::stat::dir::in);
-			destination.inbound (*message_a, remote_channel);
+			context.stats.inc (nano::stat::type::message, to_stat_detail (message_a->type ()), nano::stat::dir::in);
+			destination.inbound (*message_a, channel);
 		}
 	});
-
-	if (callback)
-	{
-		node.io_ctx.post ([callback_l = std::move (callback), buffer_size = buffer.size ()] () {
-			callback_l (boost::system::errc::make_error_code (boost::system::errc::success), buffer_size);
-		});
-	}
-
-	return true;
 }
 
 std::string nano::transport::inproc::channel::to_string () const
@@ -46,6 +46,12 @@ namespace transport
 			nano::node & destination;
 			nano::endpoint const endpoint;
 		};
+
+		/**
+		 * Deserializes \p buffer, which holds exactly one message, and passes it to \p destination as received over \p channel.
+		 * The network filter, uniquers and stats of \p context are used
+		 */
+		void deliver (nano::node & context, nano::node & destination, std::vector<uint8_t> const & buffer, std::shared_ptr<nano::transport::channel> const & channel);
 	} // namespace inproc
 } // namespace transport
 } // namespace nano
@@ -1,9 +1,12 @@
 #include <nano/lib/enum_util.hpp>
 #include <nano/node/node.hpp>
 #include <nano/node/transport/message_deserializer.hpp>
+#include <nano/secure/vote.hpp>
+
+#include <cstring>
 
 nano::transport::message_deserializer::message_deserializer (nano::network_constants const & network_constants_a, nano::network_filter & network_filter_a, nano::block_uniquer & block_uniquer_a, nano::vote_uniquer & vote_uniquer_a,
-read_query read_op) :
+read_query read_op, std::size_t buffer_size) :
 	read_buffer{ std::make_shared<std::vector<uint8_t>> () },
 	network_constants_m{ network_constants_a },
 	network_filter_m{ network_filter_a },
@@ -12,7 +15,7 @@ read_query read_op) :
 	read_op{ std::move (read_op) }
 {
 	debug_assert (this->read_op);
-	read_buffer->resize (MAX_MESSAGE_SIZE);
+	read_buffer->resize (std::max (buffer_size, HEADER_SIZE));
 }
 
 void nano::transport::message_deserializer::read (const nano::transport::message_deserializer::callback_type && callback)
@@ -22,104 +25,185 @@ void nano::transport::message_deserializer::read (const nano::transport::message
 
 	status = parse_status::none;
 
-	read_op (read_buffer, HEADER_SIZE, [this_l = shared_from_this (), callback = std::move (callback)] (boost::system::error_code const & ec, std::size_t size_a) {
+	await_message ([this_l = shared_from_this (), callback = std::move (callback)] (boost::system::error_code const & ec) {
 		if (ec)
 		{
 			callback (ec, nullptr);
 			return;
 		}
-		if (size_a != HEADER_SIZE)
+		auto message = this_l->parse_message ();
+		callback (boost::system::error_code{}, std::move (message));
+	});
+}
+
+void nano::transport::message_deserializer::read_batch (batch_callback_type callback)
+{
+	debug_assert (callback);
+	debug_assert (read_op);
+
+	status = parse_status::none;
+
+	await_message ([this_l = shared_from_this (), callback = std::move (callback)] (boost::system::error_code const & ec) {
+		if (ec)
 		{
-			callback (boost::asio::error::fault, nullptr);
+			callback (ec, {});
 			return;
 		}
-		this_l->received_header (std::move (callback));
+		std::vector<result> batch;
+		do
+		{
+			auto message = this_l->parse_message ();
+			batch.push_back ({ std::move (message), this_l->status });
+		} while (this_l->message_buffered ());
+		// An invalid header following the batch is reported by the next read
+		this_l->status = batch.back ().status;
+		callback (boost::system::error_code{}, std::move (batch));
 	});
 }
 
-void nano::transport::message_deserializer::received_header (const nano::transport::message_deserializer::callback_type && callback)
+void nano::transport::message_deserializer::enable_compact_votes ()
+{
+	debug_assert (begin == end);
+	compact_decoder.emplace ();
+}
+
+void nano::transport::message_deserializer::await_message (std::function<void (boost::system::error_code)> callback)
+{
+	auto retry = [this_l = shared_from_this (), callback] (boost::system::error_code const & ec) {
+		if (ec)
+		{
+			callback (ec);
+			return;
+		}
+		this_l->await_message (callback);
+	};
+
+	if (end - begin < HEADER_SIZE)
+	{
+		fill (HEADER_SIZE, std::move (retry));
+		return;
+	}
+	auto header = parse_header ();
+	if (!header)
+	{
+		callback (boost::asio::error::fault);
+		return;
+	}
+	auto const size = HEADER_SIZE + header->payload_length_bytes ();
+	if (end - begin < size)
+	{
+		fill (size, std::move (retry));
+		return;
+	}
+	callback (boost::system::error_code{});
+}
+
+void nano::transport::message_deserializer::fill (std::size_t size, std::function<void (boost::system::error_code)> callback)
 {
-	nano::bufferstream stream{ read_buffer->data (), HEADER_SIZE };
+	debug_assert (size <= read_buffer->size ());
+	debug_assert (end - begin < size);
+
+	if (begin == end)
+	{
+		begin = end = 0;
+	}
+	// Unparsed bytes are moved to the front once the message would not fit behind them
+	if (begin + size > read_buffer->size ())
+	{
+		std::memmove (read_buffer->data (), read_buffer->data () + begin, end - begin);
+		end -= begin;
+		begin = 0;
+	}
+
+	auto const missing = size - (end - begin);
+	read_op (read_buffer, end, missing, [this_l = shared_from_this (), missing, callback = std::move (callback)] (boost::system::error_code const & ec, std::size_t size_a) {
+		if (ec)
+		{
+			callback (ec);
+			return;
+		}
+		if (size_a < missing)
+		{
+			callback (boost::asio::error::fault);
+			return;
+		}
+		this_l->end += size_a;
+		debug_assert (this_l->end <= this_l->read_buffer->size ());
+		callback (boost::system::error_code{});
+	});
+}
+
+bool nano::transport::message_deserializer::message_buffered ()
+{
+	if (end - begin < HEADER_SIZE)
+	{
+		return false;
+	}
+	auto header = parse_header ();
+	return header && end - begin >= HEADER_SIZE + header->payload_length_bytes ();
+}
+
+std::optional<nano::message_header> nano::transport::message_deserializer::parse_header ()
+{
+	debug_assert (end - begin >= HEADER_SIZE);
+
+	nano::bufferstream stream{ read_buffer->data () + begin, HEADER_SIZE };
 	auto error = false;
 	nano::message_header header{ error, stream };
 	if (error)
 	{
 		status = parse_status::invalid_header;
-		callback (boost::asio::error::fault, nullptr);
-		return;
+		return std::nullopt;
 	}
 	if (header.network != network_constants_m.current_network)
 	{
 		status = parse_status::invalid_network;
-		callback (boost::asio::error::fault, nullptr);
-		return;
+		return std::nullopt;
 	}
 	if (header.version_using < network_constants_m.protocol_version_min)
 	{
 		status = parse_status::outdated_version;
-		callback (boost::asio::error::fault, nullptr);
-		return;
+		return std::nullopt;
 	}
 	if (!header.is_valid_message_type ())
 	{
 		status = parse_status::invalid_header;
-		callback (boost::asio::error::fault, nullptr);
-		return;
+		return std::nullopt;
 	}
-
 	std::size_t payload_size = header.payload_length_bytes ();
-	if (payload_size > MAX_MESSAGE_SIZE)
+	if (payload_size > MAX_MESSAGE_SIZE || HEADER_SIZE + payload_size > read_buffer->size ())
 	{
 		status = parse_status::message_size_too_big;
-		callback (boost::asio::error::fault, nullptr);
-		return;
-	}
-	debug_assert (payload_size <= read_buffer->capacity ());
-
-	if (payload_size == 0)
-	{
-		// Payload size will be 0 for `bulk_push` & `telemetry_req` message type
-		received_message (header, 0, std::move (callback));
-	}
-	else
-	{
-		debug_assert (read_op);
-		read_op (read_buffer, payload_size, [this_l = shared_from_this (), payload_size, header, callback = std::move (callback)] (boost::system::error_code const & ec, std::size_t size_a) {
-			if (ec)
-			{
-				callback (ec, nullptr);
-				return;
-			}
-			if (size_a != payload_size)
-			{
-				callback (boost::asio::error::fault, nullptr);
-				return;
-			}
-			this_l->received_message (header, size_a, std::move (callback));
-		});
+		return std::nullopt;
 	}
+	return header;
 }
 
-void nano::transport::message_deserializer::received_message (nano::message_header header, std::size_t payload_size, const nano::transport::message_deserializer::callback_type && callback)
+std::unique_ptr<nano::message> nano::transport::message_deserializer::parse_message ()
 {
-	auto message = deserialize (header, payload_size);
+	status = parse_status::none;
+	auto header = parse_header ();
+	release_assert (header);
+	auto const payload_size = header->payload_length_bytes ();
+	release_assert (end - begin >= HEADER_SIZE + payload_size);
+	auto message = deserialize (*header, read_buffer->data () + begin + HEADER_SIZE, payload_size);
+	begin += HEADER_SIZE + payload_size;
 	if (message)
 	{
 		debug_assert (status == parse_status::none);
 		status = parse_status::success;
-		callback (boost::system::error_code{}, std::move (message));
 	}
 	else
 	{
 		debug_assert (status != parse_status::none);
-		callback (boost::system::error_code{}, nullptr);
 	}
+	return message;
 }
 
-std::unique_ptr<nano::message> nano::transport::message_deserializer::deserialize (nano::message_header header, std::size_t payload_size)
+std::unique_ptr<nano::message> nano::transport::message_deserializer::deserialize (nano::message_header header, uint8_t const * data, std::size_t payload_size)
 {
 	release_assert (payload_size <= MAX_MESSAGE_SIZE);
-	nano::bufferstream stream{ read_buffer->data (), payload_size };
+	nano::bufferstream stream{ data, payload_size };
 	switch (header.type)
 	{
 		case nano::message_type::keepalive:
@@ -130,7 +214,7 @@ std::unique_ptr<nano::message> nano::transport::message_deserializer::deserializ
 		{
 			// Early filtering to not waste time deserializing duplicates
 			nano::uint128_t digest;
-			if (!network_filter_m.apply (read_buffer->data (), payload_size, &digest))
+			if (!network_filter_m.apply (data, payload_size, &digest))
 			{
 				return deserialize_publish (stream, header, digest);
 			}
@@ -146,11 +230,35 @@ std::unique_ptr<nano::message> nano::transport::message_deserializer::deserializ
 		}
 		case nano::message_type::confirm_ack:
 		{
-			// Early filtering to not waste time deserializing duplicates
+			bool const compact = nano::confirm_ack::is_compact (header);
+			if (compact)
+			{
+				if (!compact_decoder || compact_decoder->decode (header, data, payload_size, compact_payload))
+				{
+					status = parse_status::invalid_compact_confirm_ack_message;
+					break;
+				}
+				data = compact_payload.data ();
+				payload_size = compact_payload.size ();
+			}
+			else if (compact_decoder)
+			{
+				compact_decoder->insert (header, data, payload_size);
+			}
+			// Early filtering to not waste time deserializing duplicates, compact votes are filtered by their regular payload
 			nano::uint128_t digest;
-			if (!network_filter_m.apply (read_buffer->data (), payload_size, &digest))
+			if (!network_filter_m.apply (data, payload_size, &digest))
 			{
-				return deserialize_confirm_ack (stream, header, digest);
+				nano::bufferstream vote_stream{ data, payload_size };
+				auto message = deserialize_confirm_ack (vote_stream, header, digest);
+				// Once the table wrapped every index decodes, indices into an out of sync table only show as a vote with an invalid signature
+				if (message && compact && message->vote->validate ())
+				{
+					network_filter_m.clear (digest);
+					status = parse_status::invalid_compact_confirm_ack_message;
+					return {};
+				}
+				return message;
 			}
 			else
 			{
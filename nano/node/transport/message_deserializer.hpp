@@ -3,8 +3,10 @@
 #include <nano/lib/network_filter.hpp>
 #include <nano/node/endpoint.hpp>
 #include <nano/node/messages.hpp>
+#include <nano/node/transport/compact_votes.hpp>
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace nano
@@ -22,6 +24,7 @@ namespace transport
 		invalid_publish_message,
 		invalid_confirm_req_message,
 		invalid_confirm_ack_message,
+		invalid_compact_confirm_ack_message,
 		invalid_node_id_handshake_message,
 		invalid_telemetry_req_message,
 		invalid_telemetry_ack_message,
@@ -37,16 +40,32 @@ namespace transport
 		message_size_too_big,
 	};
 
+	/*
+	 * Parses messages out of a per-connection buffer. Each read fetches whatever the connection has available, so a single read
+	 * usually delivers many messages, which are deserialized directly from the buffer without copying them first.
+	 */
 	class message_deserializer : public std::enable_shared_from_this<nano::transport::message_deserializer>
 	{
 	public:
 		using callback_type = std::function<void (boost::system::error_code, std::unique_ptr<nano::message>)>;
 
+		class result final
+		{
+		public:
+			/** Null if the message failed to deserialize, `status` tells why */
+			std::unique_ptr<nano::message> message;
+			parse_status status;
+		};
+		using batch_callback_type = std::function<void (boost::system::error_code, std::vector<result>)>;
+
 		parse_status status{ parse_status::none };
 
-		using read_query = std::function<void (std::shared_ptr<std::vector<uint8_t>> const &, size_t, std::function<void (boost::system::error_code const &, std::size_t)>)>;
+		/*
+		 * Reads into the buffer from `offset` up to its end and completes once at least `min_size` bytes were read.
+		 */
+		using read_query = std::function<void (std::shared_ptr<std::vector<uint8_t>> const &, std::size_t offset, std::size_t min_size, std::function<void (boost::system::error_code const &, std::size_t)>)>;
 
-		message_deserializer (nano::network_constants const &, nano::network_filter &, nano::block_uniquer &, nano::vote_uniquer &, read_query read_op);
+		message_deserializer (nano::network_constants const &, nano::network_filter &, nano::block_uniquer &, nano::vote_uniquer &, read_query read_op, std::size_t buffer_size = default_buffer_size);
 
 		/*
 		 * Asynchronously read next message from the channel_read_fn.
@@ -57,15 +76,35 @@ namespace transport
 		 */
 		void read (callback_type const && callback);
 
+		/*
+		 * Reads until at least one complete message is buffered, then parses all complete messages in the buffer and passes them to callback in order.
+		 * If an irrecoverable error is encountered callback will be called with an error code set and an empty batch.
+		 * Should not be called until the previous invocation finishes and calls the callback.
+		 */
+		void read_batch (batch_callback_type callback);
+
+		/*
+		 * Tracks the hashes of received confirm_ack messages to expand compact ones, must be called before the first read.
+		 * Only enabled when this node advertised support for compact votes, otherwise compact confirm_ack messages are invalid.
+		 */
+		void enable_compact_votes ();
+
 	private:
-		void received_header (callback_type const && callback);
-		void received_message (nano::message_header header, std::size_t payload_size, callback_type const && callback);
+		/** Reads until a complete message is buffered */
+		void await_message (std::function<void (boost::system::error_code)> callback);
+		/** Reads until at least \p size unparsed bytes are buffered */
+		void fill (std::size_t size, std::function<void (boost::system::error_code)> callback);
+		bool message_buffered ();
+		/** Validates the header of the next buffered message, sets `status` if it is invalid */
+		std::optional<nano::message_header> parse_header ();
+		/** Deserializes the next buffered message, which must be complete */
+		std::unique_ptr<nano::message> parse_message ();
 
 		/*
-		 * Deserializes message using data in `read_buffer`.
+		 * Deserializes message from the payload at `data`.
 		 * @return If successful returns non-null message, otherwise sets `status` to error appropriate code and returns nullptr
 		 */
-		std::unique_ptr<nano::message> deserialize (nano::message_header header, std::size_t payload_size);
+		std::unique_ptr<nano::message> deserialize (nano::message_header header, uint8_t const * data, std::size_t payload_size);
 		std::unique_ptr<nano::keepalive> deserialize_keepalive (nano::stream &, nano::message_header const &);
 		std::unique_ptr<nano::publish> deserialize_publish (nano::stream &, nano::message_header const &, nano::network_filter::digest_t const & digest);
 		std::unique_ptr<nano::confirm_req> deserialize_confirm_req (nano::stream &, nano::message_header const &);
@@ -82,11 +121,21 @@ namespace transport
 
 	private:
 		std::shared_ptr<std::vector<uint8_t>> read_buffer;
+		/** Unparsed bytes are [begin, end) of read_buffer */
+		std::size_t begin{ 0 };
+		std::size_t end{ 0 };
+		std::optional<nano::transport::compact_vote_decoder> compact_decoder;
+		/** Regular payload of the last compact confirm_ack */
+		std::vector<uint8_t> compact_payload;
 
 	private: // Constants
 		static constexpr std::size_t HEADER_SIZE = 8;
 		static constexpr std::size_t MAX_MESSAGE_SIZE = 1024 * 65;
 
+	public:
+		static constexpr std::size_t default_buffer_size = 128 * 1024;
+		static_assert (default_buffer_size >= HEADER_SIZE + MAX_MESSAGE_SIZE);
+
 	private: // Dependencies
 		nano::network_constants const & network_constants_m;
 		nano::network_filter & network_filter_m;
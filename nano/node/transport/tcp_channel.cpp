@@ -13,12 +13,17 @@
 nano::transport::tcp_channel::tcp_channel (nano::node & node_a, std::shared_ptr<nano::transport::tcp_socket> socket_a) :
 	channel (node_a),
 	socket{ socket_a },
-	strand{ node_a.io_ctx.get_executor () },
+	strand{ socket_a->executor () },
 	sending_task{ strand }
 {
 	stacktrace = nano::generate_stacktrace ();
 	remote_endpoint = socket_a->remote_endpoint ();
 	local_endpoint = socket_a->local_endpoint ();
+	if (node_a.config.tcp.compact_votes)
+	{
+		// Hashes are tracked from the first vote sent, the peer tracks them from the first vote received
+		compact_encoder.emplace ();
+	}
 	start ();
 }
 
@@ -61,10 +66,10 @@ void nano::transport::tcp_channel::stop ()
 {
 	if (sending_task.joinable ())
 	{
-		// Node context must be running to gracefully stop async tasks
-		debug_assert (!node.io_ctx.stopped ());
+		// Connection context must be running to gracefully stop async tasks
+		debug_assert (!strand.get_inner_executor ().context ().stopped ());
 		// Ensure that we are not trying to await the task while running on the same thread / io_context
-		debug_assert (!node.io_ctx.get_executor ().running_in_this_thread ());
+		debug_assert (!strand.get_inner_executor ().running_in_this_thread ());
 		sending_task.cancel ();
 		sending_task.join ();
 	}
@@ -103,17 +108,16 @@ asio::awaitable<void> nano::transport::tcp_channel::run_sending (nano::async::co
 		debug_assert (strand.running_in_this_thread ());
 
 		auto next_batch = [this] () {
-			const size_t max_batch = 8; // TODO: Make this configurable
+			// A batch fits into the socket queue once the socket is below its max size
+			const size_t max_batch = nano::transport::tcp_socket::default_queue_size;
 			nano::lock_guard<nano::mutex> lock{ mutex };
-			return queue.next_batch (max_batch);
+			return queue.next_batch (max_batch, nano::transport::tcp_socket::max_write_size);
 		};
 
 		if (auto batch = next_batch (); !batch.empty ())
 		{
-			for (auto const & [type, item] : batch)
-			{
-				co_await send_one (type, item);
-			}
+			encode_batch (batch);
+			co_await send_batch (batch);
 		}
 		else
 		{
@@ -122,15 +126,52 @@ asio::awaitable<void> nano::transport::tcp_channel::run_sending (nano::async::co
 	}
 }
 
-asio::awaitable<void> nano::transport::tcp_channel::send_one (traffic_type type, tcp_channel_queue::entry_t const & item)
+void nano::transport::tcp_channel::encode_batch (tcp_channel_queue::batch_t & batch)
 {
 	debug_assert (strand.running_in_this_thread ());
+	if (!compact_encoder)
+	{
+		return;
+	}
+	if (compact_votes_disabled)
+	{
+		// The peer does not decode compact votes, its hashes no longer need to be tracked
+		compact_encoder.reset ();
+		return;
+	}
+	bool const compact = compact_votes;
+	for (auto & [type, entry] : batch)
+	{
+		auto & buffer = entry.first;
+		auto const size = buffer.size ();
+		buffer = compact_encoder->encode (buffer, compact);
+		if (buffer.size () < size)
+		{
+			node.stats.inc (nano::stat::type::tcp_channel, nano::stat::detail::compact_vote, nano::stat::dir::out);
+			node.stats.add (nano::stat::type::tcp_channel, nano::stat::detail::compact_vote_saved_bytes, nano::stat::dir::out, size - buffer.size ());
+		}
+	}
+}
 
-	auto const & [buffer, callback] = item;
-	auto const size = buffer.size ();
+void nano::transport::tcp_channel::set_compact_votes (bool enable)
+{
+	compact_votes = enable;
+	compact_votes_disabled = !enable;
+}
+
+asio::awaitable<void> nano::transport::tcp_channel::send_batch (tcp_channel_queue::batch_t const & batch)
+{
+	debug_assert (strand.running_in_this_thread ());
+
+	// Each entry is charged to the limiter of its own traffic type
+	std::unordered_map<nano::bandwidth_limit_type, size_t> sizes;
+	for (auto const & [type, item] : batch)
+	{
+		sizes[nano::to_bandwidth_limit_type (type)] += item.first.size ();
+	}
 
 	// Wait for socket
-	while (socket->full ())
+	while (socket->max ())
 	{
 		node.stats.inc (nano::stat::type::tcp_channel_wait, nano::stat::detail::wait_socket, nano::stat::dir::out);
 		co_await nano::async::sleep_for (100ms); // TODO: Exponential backoff
@@ -139,40 +180,51 @@ asio::awaitable<void> nano::transport::tcp_channel::send_one (traffic_type type,
 	// Wait for bandwidth
 	// This is somewhat inefficient
 	// The performance impact *should* be mitigated by the fact that we allocate it in larger chunks, so this happens relatively infrequently
-	const size_t bandwidth_chunk = 128 * 1024; // TODO: Make this configurable
-	while (allocated_bandwidth < size)
+	for (auto const & [limit_type, size] : sizes)
 	{
-		// TODO: Consider implementing a subsribe/notification mechanism for bandwidth allocation
-		if (node.outbound_limiter.should_pass (bandwidth_chunk, type)) // Allocate bandwidth in larger chunks
-		{
-			allocated_bandwidth += bandwidth_chunk;
-		}
-		else
+		const size_t bandwidth_chunk = std::max<size_t> (128 * 1024, size); // TODO: Make this configurable
+		auto & allocated = allocated_bandwidth[limit_type];
+		while (allocated < size)
 		{
-			node.stats.inc (nano::stat::type::tcp_channel_wait, nano::stat::detail::wait_bandwidth, nano::stat::dir::out);
-			co_await nano::async::sleep_for (100ms); // TODO: Exponential backoff
+			// TODO: Consider implementing a subsribe/notification mechanism for bandwidth allocation
+			if (node.outbound_limiter.should_pass (bandwidth_chunk, limit_type)) // Allocate bandwidth in larger chunks
+			{
+				allocated += bandwidth_chunk;
+			}
+			else
+			{
+				node.stats.inc (nano::stat::type::tcp_channel_wait, nano::stat::detail::wait_bandwidth, nano::stat::dir::out);
+				co_await nano::async::sleep_for (100ms); // TODO: Exponential backoff
+			}
 		}
+		allocated -= size;
 	}
-	allocated_bandwidth -= size;
 
-	node.stats.inc (nano::stat::type::tcp_channel, nano::stat::detail::send, nano::stat::dir::out);
-	node.stats.inc (nano::stat::type::tcp_channel_send, to_stat_detail (type), nano::stat::dir::out);
+	node.stats.add (nano::stat::type::tcp_channel, nano::stat::detail::send, nano::stat::dir::out, batch.size ());
 
-	socket->async_write (buffer, [this_w = weak_from_this (), callback, type] (boost::system::error_code const & ec, std::size_t size) {
-		if (auto this_l = this_w.lock ())
-		{
-			this_l->node.stats.inc (nano::stat::type::tcp_channel_ec, nano::to_stat_detail (ec), nano::stat::dir::out);
-			if (!ec)
-			{
-				this_l->node.stats.add (nano::stat::type::traffic_tcp_type, to_stat_detail (type), nano::stat::dir::out, size);
-				this_l->set_last_packet_sent (std::chrono::steady_clock::now ());
-			}
-		}
-		if (callback)
-		{
-			callback (ec, size);
-		}
-	});
+	std::vector<nano::transport::socket_queue::entry> entries;
+	entries.reserve (batch.size ());
+	for (auto const & [type, item] : batch)
+	{
+		auto const & [buffer, callback] = item;
+		node.stats.inc (nano::stat::type::tcp_channel_send, to_stat_detail (type), nano::stat::dir::out);
+		entries.push_back ({ buffer, [this_w = weak_from_this (), callback, type] (boost::system::error_code const & ec, std::size_t size) {
+								if (auto this_l = this_w.lock ())
+								{
+									this_l->node.stats.inc (nano::stat::type::tcp_channel_ec, nano::to_stat_detail (ec), nano::stat::dir::out);
+									if (!ec)
+									{
+										this_l->node.stats.add (nano::stat::type::traffic_tcp_type, to_stat_detail (type), nano::stat::dir::out, size);
+										this_l->set_last_packet_sent (std::chrono::steady_clock::now ());
+									}
+								}
+								if (callback)
+								{
+									callback (ec, size);
+								}
+							} });
+	}
+	socket->async_write (std::move (entries));
 }
 
 bool nano::transport::tcp_channel::alive () const
@@ -290,13 +342,15 @@ auto nano::transport::tcp_channel_queue::next () -> value_t
 	return { source, entry };
 }
 
-auto nano::transport::tcp_channel_queue::next_batch (size_t max_count) -> batch_t
+auto nano::transport::tcp_channel_queue::next_batch (size_t max_count, size_t max_bytes) -> batch_t
 {
 	// TODO: Naive implementation, could be optimized
 	std::deque<value_t> result;
-	while (!empty () && result.size () < max_count)
+	size_t bytes = 0;
+	while (!empty () && result.size () < max_count && bytes < max_bytes)
 	{
 		result.emplace_back (next ());
+		bytes += result.back ().second.first.size ();
 	}
 	return result;
 }
@@ -2,10 +2,14 @@
 
 #include <nano/lib/async.hpp>
 #include <nano/lib/enum_util.hpp>
+#include <nano/node/bandwidth_limiter.hpp>
 #include <nano/node/transport/channel.hpp>
+#include <nano/node/transport/compact_votes.hpp>
 #include <nano/node/transport/fwd.hpp>
 #include <nano/node/transport/transport.hpp>
 
+#include <unordered_map>
+
 namespace nano::transport
 {
 class tcp_channel_queue final
@@ -23,7 +27,8 @@ public:
 	size_t size (traffic_type) const;
 	void push (traffic_type, entry_t);
 	value_t next ();
-	batch_t next_batch (size_t max_count);
+	/** Takes entries until \p max_count entries or \p max_bytes bytes are reached, at least one entry is taken if any is queued */
+	batch_t next_batch (size_t max_count, size_t max_bytes = std::numeric_limits<size_t>::max ());
 
 	bool max (traffic_type) const;
 	bool full (traffic_type) const;
@@ -65,6 +70,12 @@ public:
 
 	std::string to_string () const override;
 
+	/**
+	 * Sends compact votes from now on if enabled in the node config, for peers that advertised support in their handshake.
+	 * Called once after the handshake, disabling releases the encoder so compact votes cannot be enabled afterwards.
+	 */
+	void set_compact_votes (bool);
+
 protected:
 	bool send_buffer (nano::shared_const_buffer const &, nano::transport::traffic_type, nano::transport::channel::callback_t) override;
 
@@ -74,7 +85,9 @@ private:
 
 	asio::awaitable<void> start_sending (nano::async::condition &);
 	asio::awaitable<void> run_sending (nano::async::condition &);
-	asio::awaitable<void> send_one (traffic_type, tcp_channel_queue::entry_t const &);
+	asio::awaitable<void> send_batch (tcp_channel_queue::batch_t const &);
+	/** Encodes the votes of a batch taken from the queue, in the order they are written to the socket */
+	void encode_batch (tcp_channel_queue::batch_t &);
 
 public:
 	std::shared_ptr<nano::transport::tcp_socket> socket;
@@ -88,7 +101,13 @@ private:
 
 	mutable nano::mutex mutex;
 	tcp_channel_queue queue;
-	std::atomic<size_t> allocated_bandwidth{ 0 };
+	/** Only used on the strand, bandwidth allocated from each limiter but not used yet */
+	std::unordered_map<nano::bandwidth_limit_type, size_t> allocated_bandwidth;
+	/** Only used on the strand, present if the node config enables compact votes */
+	std::optional<nano::transport::compact_vote_encoder> compact_encoder;
+	std::atomic<bool> compact_votes{ false };
+	/** Set when the peer does not support compact votes, the encoder is then released on the strand */
+	std::atomic<bool> compact_votes_disabled{ false };
 
 	// Debugging
 	std::atomic<bool> closed{ false };
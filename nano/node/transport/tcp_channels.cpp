@@ -1,6 +1,9 @@
+#include <nano/crypto_lib/random_pool_shuffle.hpp>
 #include <nano/node/node.hpp>
 #include <nano/node/transport/tcp_channels.hpp>
 
+#include <utility>
+
 /*
  * tcp_channels
  */
@@ -32,16 +35,19 @@ void nano::transport::tcp_channels::stop ()
 
 void nano::transport::tcp_channels::close ()
 {
-	nano::lock_guard<nano::mutex> lock{ mutex };
-
-	for (auto const & entry : channels)
 	{
-		entry.socket->close ();
-		entry.server->stop ();
-		entry.channel->close ();
-	}
+		nano::lock_guard<nano::mutex> lock{ mutex };
 
-	channels.clear ();
+		for (auto const & entry : channels)
+		{
+			entry.socket->close ();
+			entry.server->stop ();
+			entry.channel->close ();
+		}
+
+		channels.clear ();
+	}
+	update_snapshot ();
 }
 
 bool nano::transport::tcp_channels::check (const nano::tcp_endpoint & endpoint, const nano::account & node_id) const
@@ -122,6 +128,8 @@ std::shared_ptr<nano::transport::tcp_channel> nano::transport::tcp_channels::cre
 
 	lock.unlock ();
 
+	update_snapshot ();
+
 	node.observers.channel_connected.notify (channel);
 
 	return channel;
@@ -129,14 +137,16 @@ std::shared_ptr<nano::transport::tcp_channel> nano::transport::tcp_channels::cre
 
 void nano::transport::tcp_channels::erase (nano::tcp_endpoint const & endpoint_a)
 {
-	nano::lock_guard<nano::mutex> lock{ mutex };
-	channels.get<endpoint_tag> ().erase (endpoint_a);
+	{
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		channels.get<endpoint_tag> ().erase (endpoint_a);
+	}
+	update_snapshot ();
 }
 
 std::size_t nano::transport::tcp_channels::size () const
 {
-	nano::lock_guard<nano::mutex> lock{ mutex };
-	return channels.size ();
+	return get_snapshot ()->all.size ();
 }
 
 std::shared_ptr<nano::transport::tcp_channel> nano::transport::tcp_channels::find_channel (nano::tcp_endpoint const & endpoint_a) const
@@ -153,19 +163,22 @@ std::shared_ptr<nano::transport::tcp_channel> nano::transport::tcp_channels::fin
 
 std::unordered_set<std::shared_ptr<nano::transport::channel>> nano::transport::tcp_channels::random_set (std::size_t count_a, uint8_t min_version) const
 {
+	static thread_local nano::random_generator rng_l;
+
 	std::unordered_set<std::shared_ptr<nano::transport::channel>> result;
 	result.reserve (count_a);
-	nano::lock_guard<nano::mutex> lock{ mutex };
+	auto const snapshot_l = get_snapshot ();
+	auto const & channels_l = snapshot_l->all;
 	// Stop trying to fill result with random samples after this many attempts
 	auto random_cutoff (count_a * 2);
 	// Usually count_a will be much smaller than peers.size()
 	// Otherwise make sure we have a cutoff on attempting to randomly fill
-	if (!channels.empty ())
+	if (!channels_l.empty ())
 	{
 		for (auto i (0); i < random_cutoff && result.size () < count_a; ++i)
 		{
-			auto index = rng.random (channels.size ());
-			auto channel = channels.get<random_access_tag> ()[index].channel;
+			auto index = rng_l.random (channels_l.size ());
+			auto const & channel = channels_l[index];
 			if (!channel->alive ())
 			{
 				continue;
@@ -307,6 +320,13 @@ bool nano::transport::tcp_channels::track_reachout (nano::endpoint const & endpo
 }
 
 void nano::transport::tcp_channels::purge (std::chrono::steady_clock::time_point cutoff_deadline)
+{
+	purge_impl (cutoff_deadline);
+	// Also refreshes which channels belong to principal representatives
+	update_snapshot ();
+}
+
+void nano::transport::tcp_channels::purge_impl (std::chrono::steady_clock::time_point cutoff_deadline)
 {
 	nano::lock_guard<nano::mutex> lock{ mutex };
 
@@ -417,6 +437,51 @@ std::deque<std::shared_ptr<nano::transport::channel>> nano::transport::tcp_chann
 	return result;
 }
 
+std::shared_ptr<nano::transport::tcp_channels::snapshot const> nano::transport::tcp_channels::get_snapshot () const
+{
+	nano::lock_guard<nano::mutex> guard{ current_snapshot_mutex };
+	return current_snapshot;
+}
+
+void nano::transport::tcp_channels::update_snapshot ()
+{
+	nano::lock_guard<nano::mutex> guard{ snapshot_mutex };
+
+	auto result = std::make_shared<snapshot> ();
+	{
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		result->all.reserve (channels.size () + attached.size ());
+		for (auto const & entry : channels)
+		{
+			result->all.push_back (entry.channel);
+		}
+		result->all.insert (result->all.end (), attached.begin (), attached.end ());
+	}
+	nano::random_pool_shuffle (result->all.begin (), result->all.end ());
+
+	// Classified without holding the channel mutex, the rep crawler queries the network while holding its own
+	for (auto const & channel : result->all)
+	{
+		(node.rep_crawler.is_pr (channel) ? result->principal : result->non_principal).push_back (channel);
+	}
+
+	// The previous snapshot may hold the last references to its channels, it is released after the lock
+	std::shared_ptr<snapshot const> previous;
+	{
+		nano::lock_guard<nano::mutex> guard{ current_snapshot_mutex };
+		previous = std::exchange (current_snapshot, std::move (result));
+	}
+}
+
+void nano::transport::tcp_channels::attach (std::shared_ptr<nano::transport::channel> const & channel)
+{
+	{
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		attached.push_back (channel);
+	}
+	update_snapshot ();
+}
+
 bool nano::transport::tcp_channels::start_tcp (nano::endpoint const & endpoint)
 {
 	return node.tcp_listener.connect (endpoint.address (), endpoint.port ());
@@ -429,5 +494,6 @@ nano::container_info nano::transport::tcp_channels::container_info () const
 	nano::container_info info;
 	info.put ("channels", channels.size ());
 	info.put ("attempts", attempts.size ());
+	info.put ("attached", attached.size ());
 	return info;
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include <random>
 #include <thread>
 #include <unordered_set>
+#include <vector>
 
 namespace mi = boost::multi_index;
 
@@ -29,6 +30,23 @@ class tcp_channels final
 	friend class telemetry_simultaneous_requests_Test;
 	friend class network_peer_max_tcp_attempts_subnetwork_Test;
 
+public:
+	/*
+	 * Immutable view of all channels, shuffled once when it is built.
+	 * A new snapshot is published whenever channels are added or removed, on every purge and when representatives change.
+	 * Readers take no lock, which keeps flooding and sampling off the channel mutex.
+	 */
+	class snapshot final
+	{
+	public:
+		using channels_t = std::vector<std::shared_ptr<nano::transport::channel>>;
+
+		channels_t all;
+		/** Channels of principal representatives at the time the snapshot was built */
+		channels_t principal;
+		channels_t non_principal;
+	};
+
 public:
 	explicit tcp_channels (nano::node &);
 	~tcp_channels ();
@@ -52,6 +70,11 @@ public:
 	void purge (std::chrono::steady_clock::time_point cutoff_deadline);
 	std::deque<std::shared_ptr<nano::transport::channel>> list (uint8_t minimum_version = 0) const;
 	std::unordered_set<std::shared_ptr<nano::transport::channel>> random_set (std::size_t max_count, uint8_t minimum_version = 0) const;
+	std::shared_ptr<snapshot const> get_snapshot () const;
+	/** Rebuilds and publishes the snapshot, must not be called while holding the channel mutex */
+	void update_snapshot ();
+	/** Adds a channel that is not backed by a tcp connection, such as a simulated link, to all snapshots. Attached channels are never purged */
+	void attach (std::shared_ptr<nano::transport::channel> const &);
 	void keepalive ();
 	std::optional<nano::keepalive> sample_keepalive ();
 
@@ -66,6 +89,7 @@ private: // Dependencies
 private:
 	void close ();
 	bool check (nano::tcp_endpoint const &, nano::account const & node_id) const;
+	void purge_impl (std::chrono::steady_clock::time_point cutoff_deadline);
 
 private:
 	class channel_entry final
@@ -170,11 +194,19 @@ private:
 	attempts;
 	// clang-format on
 
+	std::vector<std::shared_ptr<nano::transport::channel>> attached;
+
 private:
 	std::atomic<bool> stopped{ false };
 	nano::condition_variable condition;
 	mutable nano::mutex mutex;
 
 	mutable nano::random_generator rng;
+
+	std::shared_ptr<snapshot const> current_snapshot{ std::make_shared<snapshot const> () };
+	// Only guards the current snapshot pointer, held just long enough to copy or replace it
+	mutable nano::mutex current_snapshot_mutex;
+	// Serializes rebuilds so snapshots are published in the order the channels were copied
+	nano::mutex snapshot_mutex;
 };
 }
@@ -10,6 +10,7 @@ nano::error nano::transport::tcp_config::serialize (nano::tomlconfig & toml) con
 	toml.put ("connect_timeout", connect_timeout.count (), "Timeout for establishing TCP connection in seconds. \ntype:uint64");
 	toml.put ("handshake_timeout", handshake_timeout.count (), "Timeout for completing handshake in seconds. \ntype:uint64");
 	toml.put ("io_timeout", io_timeout.count (), "Timeout for TCP I/O operations in seconds. \ntype:uint64");
+	toml.put ("compact_votes", compact_votes, "Encode hashes of votes that were recently sent to a peer as short indices, if the peer supports it. Reduces vote bandwidth at the cost of a small table per connection. \ntype:bool");
 
 	return toml.get_error ();
 }
@@ -24,6 +25,7 @@ nano::error nano::transport::tcp_config::deserialize (nano::tomlconfig & toml)
 	toml.get_duration ("connect_timeout", connect_timeout);
 	toml.get_duration ("handshake_timeout", handshake_timeout);
 	toml.get_duration ("io_timeout", io_timeout);
+	toml.get ("compact_votes", compact_votes);
 
 	return toml.get_error ();
 }
\ No newline at end of file
@@ -34,5 +34,7 @@ public:
 	std::chrono::seconds connect_timeout{ 60 };
 	std::chrono::seconds handshake_timeout{ 30 };
 	std::chrono::seconds io_timeout{ 30 };
+	/** Advertise and use the compact vote encoding, which replaces recently sent hashes of votes with short indices, with peers supporting it */
+	bool compact_votes{ false };
 };
 }
\ No newline at end of file
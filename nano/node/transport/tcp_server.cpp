@@ -16,13 +16,17 @@ nano::transport::tcp_server::tcp_server (std::shared_ptr<nano::transport::tcp_so
 	allow_bootstrap{ allow_bootstrap_a },
 	message_deserializer{
 		std::make_shared<nano::transport::message_deserializer> (node_a->network_params.network, node_a->network.filter, node_a->block_uniquer, node_a->vote_uniquer,
-		[socket_l = socket] (std::shared_ptr<std::vector<uint8_t>> const & data_a, size_t size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a) {
+		[socket_l = socket] (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t offset_a, std::size_t min_size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a) {
 			debug_assert (socket_l != nullptr);
-			socket_l->read_impl (data_a, size_a, callback_a);
+			socket_l->read_impl (data_a, offset_a, min_size_a, callback_a);
 		})
 	}
 {
 	debug_assert (socket != nullptr);
+	if (node_a->config.tcp.compact_votes)
+	{
+		message_deserializer->enable_compact_votes ();
+	}
 }
 
 nano::transport::tcp_server::~tcp_server ()
@@ -73,7 +77,7 @@ void nano::transport::tcp_server::receive_message ()
 		return;
 	}
 
-	message_deserializer->read ([this_l = shared_from_this ()] (boost::system::error_code ec, std::unique_ptr<nano::message> message) {
+	message_deserializer->read_batch ([this_l = shared_from_this ()] (boost::system::error_code ec, std::vector<nano::transport::message_deserializer::result> batch) {
 		auto node = this_l->node.lock ();
 		if (!node)
 		{
@@ -92,17 +96,50 @@ void nano::transport::tcp_server::receive_message ()
 		}
 		else
 		{
-			this_l->received_message (std::move (message));
+			this_l->received_batch (std::move (batch));
 		}
 	});
 }
 
-void nano::transport::tcp_server::received_message (std::unique_ptr<nano::message> message)
+void nano::transport::tcp_server::received_batch (std::vector<nano::transport::message_deserializer::result> batch)
+{
+	process_result result = process_result::progress;
+	for (auto & entry : batch)
+	{
+		result = received_message (std::move (entry.message), entry.status);
+		if (result != process_result::progress)
+		{
+			break;
+		}
+	}
+	flush_realtime ();
+
+	switch (result)
+	{
+		case process_result::progress:
+		{
+			receive_message ();
+		}
+		break;
+		case process_result::abort:
+		{
+			stop ();
+		}
+		break;
+		case process_result::pause:
+		{
+			// Do nothing
+		}
+		break;
+	}
+}
+
+auto nano::transport::tcp_server::received_message (std::unique_ptr<nano::message> message, nano::transport::parse_status status) -> process_result
 {
 	auto node = this->node.lock ();
 	if (!node)
 	{
-		return;
+		return process_result::abort;
 	}
 
 	process_result result = process_result::progress;
@@ -113,11 +150,11 @@ void nano::transport::tcp_server::received_message (std::unique_ptr<nano::messag
 	else
 	{
 		// Error while deserializing message
-		debug_assert (message_deserializer->status != transport::parse_status::success);
+		debug_assert (status != transport::parse_status::success);
 
-		node->stats.inc (nano::stat::type::error, to_stat_detail (message_deserializer->status));
+		node->stats.inc (nano::stat::type::error, to_stat_detail (status));
 
-		switch (message_deserializer->status)
+		switch (status)
 		{
 			// Avoid too much noise about `duplicate_publish_message` errors
 			case nano::transport::parse_status::duplicate_publish_message:
@@ -130,34 +167,23 @@ void nano::transport::tcp_server::received_message (std::unique_ptr<nano::messag
 				node->stats.inc (nano::stat::type::filter, nano::stat::detail::duplicate_confirm_ack_message);
 			}
 			break;
+			// The vote tables of both sides are out of sync, further compact votes cannot be decoded
+			case nano::transport::parse_status::invalid_compact_confirm_ack_message:
+			{
+				node->logger.debug (nano::log::type::tcp_server, "Invalid compact vote, closing connection ({})", fmt::streamed (remote_endpoint));
+				result = process_result::abort;
+			}
+			break;
 			default:
 			{
 				node->logger.debug (nano::log::type::tcp_server, "Error deserializing message: {} ({})",
-				to_string (message_deserializer->status),
+				to_string (status),
 				fmt::streamed (remote_endpoint));
 			}
 			break;
 		}
 	}
-
-	switch (result)
-	{
-		case process_result::progress:
-		{
-			receive_message ();
-		}
-		break;
-		case process_result::abort:
-		{
-			stop ();
-		}
-		break;
-		case process_result::pause:
-		{
-			// Do nothing
-		}
-		break;
-	}
+	return result;
 }
 
 auto nano::transport::tcp_server::process_message (std::unique_ptr<nano::message> message) -> process_result
@@ -251,9 +277,21 @@ auto nano::transport::tcp_server::process_message (std::unique_ptr<nano::message
 
 void nano::transport::tcp_server::queue_realtime (std::unique_ptr<nano::message> message)
 {
+	release_assert (channel != nullptr);
+
+	realtime_batch.push_back (std::move (message));
+}
+
+void nano::transport::tcp_server::flush_realtime ()
+{
+	if (realtime_batch.empty ())
+	{
+		return;
+	}
 	auto node = this->node.lock ();
 	if (!node)
 	{
+		realtime_batch.clear ();
 		return;
 	}
 
@@ -261,8 +299,9 @@ void nano::transport::tcp_server::queue_realtime (std::unique_ptr<nano::message>
 
 	channel->set_last_packet_received (std::chrono::steady_clock::now ());
 
-	bool added = node->message_processor.put (std::move (message), channel);
-	// TODO: Throttle if not added
+	auto added = node->message_processor.put_batch (std::move (realtime_batch), channel);
+	realtime_batch.clear ();
+	// TODO: Throttle if not all added
 }
 
 auto nano::transport::tcp_server::process_handshake (nano::node_id_handshake const & message) -> handshake_status
@@ -304,6 +343,8 @@ auto nano::transport::tcp_server::process_handshake (nano::node_id_handshake con
 
 	if (message.query)
 	{
+		// The query always arrives before the channel is created
+		peer_compact_votes = nano::node_id_handshake::is_compact_votes (message.header);
 		// Sends response + our own query
 		send_handshake_response (*message.query, message.is_v2 ());
 		// Fall through and continue handshake
@@ -347,6 +388,7 @@ void nano::transport::tcp_server::initiate_handshake ()
 
 	auto query = node->network.prepare_handshake_query (nano::transport::map_tcp_to_endpoint (remote_endpoint));
 	nano::node_id_handshake message{ node->network_params.network, query };
+	message.header.flag_set (nano::node_id_handshake::compact_votes_flag, query && node->config.tcp.compact_votes);
 
 	node->logger.debug (nano::log::type::tcp_server, "Initiating handshake query ({})", fmt::streamed (remote_endpoint));
 
@@ -384,6 +426,7 @@ void nano::transport::tcp_server::send_handshake_response (nano::node_id_handsha
 	auto response = node->network.prepare_handshake_response (query, v2);
 	auto own_query = node->network.prepare_handshake_query (nano::transport::map_tcp_to_endpoint (remote_endpoint));
 	nano::node_id_handshake handshake_response{ node->network_params.network, own_query, response };
+	handshake_response.header.flag_set (nano::node_id_handshake::compact_votes_flag, own_query && node->config.tcp.compact_votes);
 
 	node->logger.debug (nano::log::type::tcp_server, "Responding to handshake ({})", fmt::streamed (remote_endpoint));
 
@@ -627,6 +670,7 @@ bool nano::transport::tcp_server::to_realtime_connection (nano::account const &
 		return false;
 	}
 	channel = channel_l;
+	channel->set_compact_votes (peer_compact_votes);
 
 	socket->type_set (nano::transport::socket_type::realtime);
 
@@ -3,6 +3,7 @@
 #include <nano/node/endpoint.hpp>
 #include <nano/node/messages.hpp>
 #include <nano/node/transport/fwd.hpp>
+#include <nano/node/transport/message_deserializer.hpp>
 #include <nano/node/transport/tcp_socket.hpp>
 
 #include <atomic>
@@ -49,9 +50,12 @@ private:
 	};
 
 	void receive_message ();
-	void received_message (std::unique_ptr<nano::message> message);
+	void received_batch (std::vector<nano::transport::message_deserializer::result> batch);
+	process_result received_message (std::unique_ptr<nano::message> message, nano::transport::parse_status status);
 	process_result process_message (std::unique_ptr<nano::message> message);
+	/** Realtime messages are collected while a batch is processed and queued together by `flush_realtime` */
 	void queue_realtime (std::unique_ptr<nano::message> message);
+	void flush_realtime ();
 
 	bool to_bootstrap_connection ();
 	bool to_realtime_connection (nano::account const & node_id);
@@ -74,6 +78,9 @@ private:
 	bool const allow_bootstrap;
 	std::shared_ptr<nano::transport::message_deserializer> message_deserializer;
 	std::optional<nano::keepalive> last_keepalive;
+	std::vector<std::unique_ptr<nano::message>> realtime_batch;
+	/** Whether the handshake query of the peer advertised support for compact votes */
+	bool peer_compact_votes{ false };
 
 	// Every realtime connection must have an associated channel
 	std::shared_ptr<nano::transport::tcp_channel> channel;
@@ -1,6 +1,7 @@
 #include <nano/boost/asio/bind_executor.hpp>
 #include <nano/boost/asio/read.hpp>
 #include <nano/lib/enum_util.hpp>
+#include <nano/lib/thread_runner.hpp>
 #include <nano/node/node.hpp>
 #include <nano/node/transport/tcp_socket.hpp>
 #include <nano/node/transport/transport.hpp>
@@ -12,12 +13,26 @@
 #include <memory>
 #include <utility>
 
+namespace
+{
+/** Executor of the io_context the socket was created on, so all handlers of a connection run on the same io_context */
+boost::asio::io_context::executor_type io_executor (nano::node & node, boost::asio::ip::tcp::socket & socket)
+{
+	if (auto executor = socket.get_executor ().target<boost::asio::io_context::executor_type> ())
+	{
+		return *executor;
+	}
+	// Sockets created on a strand or another executor type
+	return node.io_ctx.get_executor ();
+}
+}
+
 /*
  * socket
  */
 
 nano::transport::tcp_socket::tcp_socket (nano::node & node_a, nano::transport::socket_endpoint endpoint_type_a, size_t queue_size_a) :
-	tcp_socket{ node_a, boost::asio::ip::tcp::socket{ node_a.io_ctx }, {}, {}, endpoint_type_a, queue_size_a }
+	tcp_socket{ node_a, boost::asio::ip::tcp::socket{ node_a.io_pool.next () }, {}, {}, endpoint_type_a, queue_size_a }
 {
 }
 
@@ -25,7 +40,7 @@ nano::transport::tcp_socket::tcp_socket (nano::node & node_a, boost::asio::ip::t
 	queue_size{ queue_size_a },
 	send_queue{ queue_size },
 	node_w{ node_a.shared () },
-	strand{ node_a.io_ctx.get_executor () },
+	strand{ io_executor (node_a, raw_socket_a) },
 	raw_socket{ std::move (raw_socket_a) },
 	remote{ remote_endpoint_a },
 	local{ local_endpoint_a },
@@ -138,6 +153,51 @@ void nano::transport::tcp_socket::async_read (std::shared_ptr<std::vector<uint8_
 	}
 }
 
+void nano::transport::tcp_socket::async_read_some (std::shared_ptr<std::vector<uint8_t>> const & buffer_a, std::size_t offset_a, std::size_t min_size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a)
+{
+	debug_assert (callback_a);
+
+	if (offset_a + min_size_a <= buffer_a->size ())
+	{
+		if (!closed)
+		{
+			set_default_timeout ();
+			boost::asio::post (strand, [this_l = shared_from_this (), buffer_a, callback = std::move (callback_a), offset_a, min_size_a] () mutable {
+				boost::asio::async_read (this_l->raw_socket, boost::asio::buffer (buffer_a->data () + offset_a, buffer_a->size () - offset_a), boost::asio::transfer_at_least (min_size_a),
+				boost::asio::bind_executor (this_l->strand,
+				[this_l, buffer_a, cbk = std::move (callback)] (boost::system::error_code const & ec, std::size_t size_a) {
+					debug_assert (this_l->strand.running_in_this_thread ());
+
+					auto node_l = this_l->node_w.lock ();
+					if (!node_l)
+					{
+						return;
+					}
+
+					if (ec)
+					{
+						node_l->stats.inc (nano::stat::type::tcp, nano::stat::detail::tcp_read_error, nano::stat::dir::in);
+						this_l->close ();
+					}
+					else
+					{
+						node_l->stats.add (nano::stat::type::traffic_tcp, nano::stat::detail::all, nano::stat::dir::in, size_a);
+						this_l->set_last_completion ();
+						this_l->set_last_receive_time ();
+					}
+					cbk (ec, size_a);
+				}));
+			});
+		}
+	}
+	else
+	{
+		debug_assert (false && "nano::transport::tcp_socket::async_read_some called with incorrect buffer size");
+		boost::system::error_code ec_buffer = boost::system::errc::make_error_code (boost::system::errc::no_buffer_space);
+		callback_a (ec_buffer, 0);
+	}
+}
+
 void nano::transport::tcp_socket::async_write (nano::shared_const_buffer const & buffer_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a)
 {
 	auto node_l = node_w.lock ();
@@ -150,7 +210,7 @@ void nano::transport::tcp_socket::async_write (nano::shared_const_buffer const &
 	{
 		if (callback_a)
 		{
-			node_l->io_ctx.post ([callback = std::move (callback_a)] () {
+			boost::asio::post (strand.get_inner_executor (), [callback = std::move (callback_a)] () {
 				callback (boost::system::errc::make_error_code (boost::system::errc::not_supported), 0);
 			});
 		}
@@ -162,7 +222,7 @@ void nano::transport::tcp_socket::async_write (nano::shared_const_buffer const &
 	{
 		if (callback_a)
 		{
-			node_l->io_ctx.post ([callback = std::move (callback_a)] () {
+			boost::asio::post (strand.get_inner_executor (), [callback = std::move (callback_a)] () {
 				callback (boost::system::errc::make_error_code (boost::system::errc::not_supported), 0);
 			});
 		}
@@ -177,6 +237,47 @@ void nano::transport::tcp_socket::async_write (nano::shared_const_buffer const &
 	});
 }
 
+void nano::transport::tcp_socket::async_write (std::vector<nano::transport::socket_queue::entry> entries)
+{
+	auto node_l = node_w.lock ();
+	if (!node_l)
+	{
+		return;
+	}
+
+	auto reject = [this] (nano::transport::socket_queue::entry const & entry) {
+		if (entry.callback)
+		{
+			boost::asio::post (strand.get_inner_executor (), [callback = entry.callback] () {
+				callback (boost::system::errc::make_error_code (boost::system::errc::not_supported), 0);
+			});
+		}
+	};
+
+	bool queued = false;
+	for (auto const & entry : entries)
+	{
+		if (!closed && send_queue.insert (entry.buffer, entry.callback, traffic_type::generic))
+		{
+			queued = true;
+		}
+		else
+		{
+			reject (entry);
+		}
+	}
+
+	if (queued)
+	{
+		boost::asio::post (strand, [this_s = shared_from_this ()] () {
+			if (!this_s->write_in_progress)
+			{
+				this_s->write_queued_messages ();
+			}
+		});
+	}
+}
+
 // Must be called from strand
 void nano::transport::tcp_socket::write_queued_messages ()
 {
@@ -187,18 +288,24 @@ void nano::transport::tcp_socket::write_queued_messages ()
 		return;
 	}
 
-	auto maybe_next = send_queue.pop ();
-	if (!maybe_next)
+	// Everything queued up to the size limit is written with one writev
+	auto batch = std::make_shared<std::vector<socket_queue::entry>> (send_queue.pop_batch (max_write_size));
+	if (batch->empty ())
 	{
 		return;
 	}
-	auto const & [next, type] = *maybe_next;
+	std::vector<boost::asio::const_buffer> buffers;
+	buffers.reserve (batch->size ());
+	for (auto const & entry : *batch)
+	{
+		buffers.insert (buffers.end (), entry.buffer.begin (), entry.buffer.end ());
+	}
 
 	set_default_timeout ();
 
 	write_in_progress = true;
-	nano::async_write (raw_socket, next.buffer,
-	boost::asio::bind_executor (strand, [this_l = shared_from_this (), next /* `next` object keeps buffer in scope */, type] (boost::system::error_code ec, std::size_t size) {
+	nano::unsafe_async_write (raw_socket, buffers,
+	boost::asio::bind_executor (strand, [this_l = shared_from_this (), batch /* keeps buffers in scope */] (boost::system::error_code ec, std::size_t size) {
 		debug_assert (this_l->strand.running_in_this_thread ());
 
 		auto node_l = this_l->node_w.lock ();
@@ -219,9 +326,12 @@ void nano::transport::tcp_socket::write_queued_messages ()
 			this_l->set_last_completion ();
 		}
 
-		if (next.callback)
+		for (auto const & entry : *batch)
 		{
-			next.callback (ec, size);
+			if (entry.callback)
+			{
+				entry.callback (ec, ec ? 0 : entry.buffer.size ());
+			}
 		}
 
 		if (!ec)
@@ -329,7 +439,7 @@ void nano::transport::tcp_socket::ongoing_checkup ()
 	});
 }
 
-void nano::transport::tcp_socket::read_impl (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a)
+void nano::transport::tcp_socket::read_impl (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t offset_a, std::size_t min_size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a)
 {
 	auto node_l = node_w.lock ();
 	if (!node_l)
@@ -340,7 +450,7 @@ void nano::transport::tcp_socket::read_impl (std::shared_ptr<std::vector<uint8_t
 	// Increase timeout to receive TCP header (idle server socket)
 	auto const prev_timeout = get_default_timeout_value ();
 	set_default_timeout_value (node_l->network_params.network.idle_timeout);
-	async_read (data_a, size_a, [callback_l = std::move (callback_a), prev_timeout, this_l = shared_from_this ()] (boost::system::error_code const & ec_a, std::size_t size_a) {
+	async_read_some (data_a, offset_a, min_size_a, [callback_l = std::move (callback_a), prev_timeout, this_l = shared_from_this ()] (boost::system::error_code const & ec_a, std::size_t size_a) {
 		this_l->set_default_timeout_value (prev_timeout);
 		callback_l (ec_a, size_a);
 	});
@@ -469,6 +579,21 @@ auto nano::transport::socket_queue::pop () -> std::optional<result_t>
 	return std::nullopt;
 }
 
+auto nano::transport::socket_queue::pop_batch (std::size_t max_bytes) -> std::vector<entry>
+{
+	nano::lock_guard<nano::mutex> guard{ mutex };
+	std::vector<entry> result;
+	std::size_t bytes = 0;
+	auto & que = queues[nano::transport::traffic_type::generic];
+	while (!que.empty () && (result.empty () || bytes + que.front ().buffer.size () <= max_bytes))
+	{
+		bytes += que.front ().buffer.size ();
+		result.push_back (std::move (que.front ()));
+		que.pop ();
+	}
+	return result;
+}
+
 void nano::transport::socket_queue::clear ()
 {
 	nano::lock_guard<nano::mutex> guard{ mutex };
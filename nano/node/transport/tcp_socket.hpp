@@ -48,6 +48,8 @@ public:
 
 	bool insert (buffer_t const &, callback_t, nano::transport::traffic_type);
 	std::optional<result_t> pop ();
+	/** Pops queued entries until their combined size reaches \p max_bytes, at least one entry is returned if any is queued */
+	std::vector<entry> pop_batch (std::size_t max_bytes);
 	void clear ();
 	std::size_t size (nano::transport::traffic_type) const;
 	bool empty () const;
@@ -68,6 +70,8 @@ class tcp_socket final : public std::enable_shared_from_this<tcp_socket>
 
 public:
 	static size_t constexpr default_queue_size = 16;
+	/** Upper bound for the bytes of queued buffers coalesced into one write */
+	static size_t constexpr max_write_size = 64 * 1024;
 
 public:
 	explicit tcp_socket (nano::node &, nano::transport::socket_endpoint = socket_endpoint::client, size_t queue_size = default_queue_size);
@@ -95,10 +99,20 @@ public:
 	std::size_t size,
 	std::function<void (boost::system::error_code const &, std::size_t)> callback);
 
+	/** Reads whatever is available into \p buffer starting at \p offset, completing once at least \p min_size bytes were read */
+	void async_read_some (
+	std::shared_ptr<std::vector<uint8_t>> const & buffer,
+	std::size_t offset,
+	std::size_t min_size,
+	std::function<void (boost::system::error_code const &, std::size_t)> callback);
+
 	void async_write (
 	nano::shared_const_buffer const &,
 	std::function<void (boost::system::error_code const &, std::size_t)> callback = nullptr);
 
+	/** Queues all \p entries before starting to write, so they go out together in a single scatter/gather write. Each callback receives the size of its own buffer */
+	void async_write (std::vector<nano::transport::socket_queue::entry> entries);
+
 	boost::asio::ip::tcp::endpoint remote_endpoint () const;
 	boost::asio::ip::tcp::endpoint local_endpoint () const;
 
@@ -112,6 +126,12 @@ public:
 	bool max () const;
 	bool full () const;
 
+	/** Executor of the io_context this connection is assigned to, other components of the connection should run on it too */
+	boost::asio::io_context::executor_type executor () const
+	{
+		return strand.get_inner_executor ();
+	}
+
 	nano::transport::socket_type type () const
 	{
 		return type_m;
@@ -194,7 +214,7 @@ protected:
 	void set_last_completion ();
 	void set_last_receive_time ();
 	void ongoing_checkup ();
-	void read_impl (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a);
+	void read_impl (std::shared_ptr<std::vector<uint8_t>> const & data_a, std::size_t offset_a, std::size_t min_size_a, std::function<void (boost::system::error_code const &, std::size_t)> callback_a);
 
 private:
 	socket_endpoint const endpoint_type_m;
@@ -43,34 +43,36 @@ nano::vote_generator::~vote_generator ()
 	debug_assert (!thread.joinable ());
 }
 
-bool nano::vote_generator::should_vote (transaction_variant_t const & transaction_variant, nano::root const & root_a, nano::block_hash const & hash_a) const
+std::shared_ptr<nano::block> nano::vote_generator::should_vote (nano::secure::transaction const & transaction, nano::root const & root_a, nano::block_hash const & hash_a) const
 {
-	bool should_vote = false;
-	std::shared_ptr<nano::block> block;
-	if (is_final)
-	{
-		debug_assert (std::holds_alternative<nano::secure::write_transaction> (transaction_variant));
-		auto const & transaction = std::get<nano::secure::write_transaction> (transaction_variant);
-
-		block = ledger.any.block_get (transaction, hash_a);
-		should_vote = block != nullptr && ledger.dependents_confirmed (transaction, *block) && ledger.store.final_vote.put (transaction, block->qualified_root (), hash_a);
-		debug_assert (block == nullptr || root_a == block->root ());
-	}
-	else
-	{
-		debug_assert (std::holds_alternative<nano::secure::read_transaction> (transaction_variant));
-		auto const & transaction = std::get<nano::secure::read_transaction> (transaction_variant);
-
-		block = ledger.any.block_get (transaction, hash_a);
-		should_vote = block != nullptr && ledger.dependents_confirmed (transaction, *block);
-	}
+	auto block = ledger.any.block_get (transaction, hash_a);
+	bool const should_vote = block != nullptr && ledger.dependents_confirmed (transaction, *block);
+	debug_assert (block == nullptr || root_a == block->root ());
 
 	logger.trace (nano::log::type::vote_generator, nano::log::detail::should_vote,
 	nano::log::arg{ "should_vote", should_vote },
 	nano::log::arg{ "block", block },
 	nano::log::arg{ "is_final", is_final });
 
-	return should_vote;
+	return should_vote ? block : nullptr;
+}
+
+void nano::vote_generator::write_final_votes (std::deque<std::shared_ptr<nano::block>> & verified)
+{
+	debug_assert (is_final);
+
+	auto transaction = ledger.tx_begin_write (nano::store::writer::voting_final);
+	std::erase_if (verified, [this, &transaction] (auto const & block) {
+		transaction.refresh_if_needed ();
+
+		// The block could have been rolled back between the read and the write phase
+		if (!ledger.any.block_exists (transaction, block->hash ()))
+		{
+			return true;
+		}
+		// Fails if a final vote for a different block with the same root was already persisted
+		return !ledger.store.final_vote.put (transaction, block->qualified_root (), block->hash ());
+	});
 }
 
 void nano::vote_generator::start ()
@@ -105,41 +107,36 @@ void nano::vote_generator::add (const root & root, const block_hash & hash)
 
 void nano::vote_generator::process_batch (std::deque<queue_entry_t> & batch)
 {
-	std::deque<candidate_t> verified;
-
-	auto refresh_if_needed = [] (auto && transaction_variant) {
-		std::visit ([&] (auto && transaction) { transaction.refresh_if_needed (); }, transaction_variant);
-	};
+	std::deque<std::shared_ptr<nano::block>> verified;
 
-	auto verify_batch = [this, &verified, &refresh_if_needed] (auto && transaction_variant, auto && batch) {
+	// Dependency checks only need read access, avoid holding the database write lock while doing them
+	{
+		auto transaction = ledger.tx_begin_read ();
 		for (auto & [root, hash] : batch)
 		{
-			refresh_if_needed (transaction_variant);
+			transaction.refresh_if_needed ();
 
-			if (should_vote (transaction_variant, root, hash))
+			if (auto block = should_vote (transaction, root, hash))
 			{
-				verified.emplace_back (root, hash);
+				verified.push_back (block);
 			}
 		}
-	};
-
-	if (is_final)
-	{
-		transaction_variant_t transaction_variant{ ledger.tx_begin_write (nano::store::writer::voting_final) };
-		verify_batch (transaction_variant, batch);
-		// Commit write transaction
 	}
-	else
+
+	// Final votes for the whole batch are persisted together, so the write lock is acquired once and held only for the puts
+	if (is_final && !verified.empty ())
 	{
-		transaction_variant_t transaction_variant{ ledger.tx_begin_read () };
-		verify_batch (transaction_variant, batch);
+		write_final_votes (verified);
 	}
 
 	// Submit verified candidates to the main processing thread
 	if (!verified.empty ())
 	{
 		nano::unique_lock<nano::mutex> lock{ mutex };
-		candidates.insert (candidates.end (), verified.begin (), verified.end ());
+		for (auto const & block : verified)
+		{
+			candidates.emplace_back (block->root (), block->hash ());
+		}
 		if (candidates.size () >= nano::network::confirm_ack_hashes_max)
 		{
 			lock.unlock ();
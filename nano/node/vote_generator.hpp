@@ -18,7 +18,6 @@
 #include <condition_variable>
 #include <deque>
 #include <thread>
-#include <variant>
 
 namespace mi = boost::multi_index;
 
@@ -47,15 +46,16 @@ public:
 	nano::container_info container_info () const;
 
 private:
-	using transaction_variant_t = std::variant<nano::secure::read_transaction, nano::secure::write_transaction>;
-
 	void run ();
 	void broadcast (nano::unique_lock<nano::mutex> &);
 	void reply (nano::unique_lock<nano::mutex> &, request_t &&);
 	void vote (std::vector<nano::block_hash> const &, std::vector<nano::root> const &, std::function<void (std::shared_ptr<nano::vote> const &)> const &);
 	void broadcast_action (std::shared_ptr<nano::vote> const &) const;
 	void process_batch (std::deque<queue_entry_t> & batch);
-	bool should_vote (transaction_variant_t const &, nano::root const &, nano::block_hash const &) const;
+	/** Returns the block if it exists in the ledger and all of its dependencies are confirmed, nullptr otherwise */
+	std::shared_ptr<nano::block> should_vote (nano::secure::transaction const &, nano::root const &, nano::block_hash const &) const;
+	/** Persists final votes for all verified blocks in a single write transaction, removing blocks that can no longer be final voted */
+	void write_final_votes (std::deque<std::shared_ptr<nano::block>> & verified);
 	bool broadcast_predicate () const;
 
 private: // Dependencies
@@ -127,6 +127,49 @@ bool nano::vote_processor::vote (std::shared_ptr<nano::vote> const & vote, std::
 	return added;
 }
 
+std::vector<bool> nano::vote_processor::vote_batch (std::vector<std::pair<std::shared_ptr<nano::vote>, nano::vote_source>> const & votes, std::shared_ptr<nano::transport::channel> const & channel)
+{
+	debug_assert (channel != nullptr);
+
+	std::vector<nano::rep_tier> tiers;
+	tiers.reserve (votes.size ());
+	for (auto const & [vote, source] : votes)
+	{
+		tiers.push_back (rep_tiers.tier (vote->account));
+	}
+
+	std::vector<bool> result;
+	result.reserve (votes.size ());
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		for (std::size_t i = 0; i < votes.size (); ++i)
+		{
+			result.push_back (queue.push ({ votes[i].first, votes[i].second }, { tiers[i], channel }));
+		}
+	}
+
+	bool any_added = false;
+	for (std::size_t i = 0; i < votes.size (); ++i)
+	{
+		if (result[i])
+		{
+			stats.inc (nano::stat::type::vote_processor, nano::stat::detail::process);
+			stats.inc (nano::stat::type::vote_processor_tier, to_stat_detail (tiers[i]));
+			any_added = true;
+		}
+		else
+		{
+			stats.inc (nano::stat::type::vote_processor, nano::stat::detail::overfill);
+			stats.inc (nano::stat::type::vote_processor_overfill, to_stat_detail (tiers[i]));
+		}
+	}
+	if (any_added)
+	{
+		condition.notify_all ();
+	}
+	return result;
+}
+
 void nano::vote_processor::run ()
 {
 	nano::unique_lock<nano::mutex> lock{ mutex };
@@ -44,6 +44,8 @@ public:
 
 	/** Queue vote for processing. @returns true if the vote was queued */
 	bool vote (std::shared_ptr<nano::vote> const &, std::shared_ptr<nano::transport::channel> const &, nano::vote_source = nano::vote_source::live);
+	/** Queue votes received from the same channel under a single lock. @returns for each vote whether it was queued */
+	std::vector<bool> vote_batch (std::vector<std::pair<std::shared_ptr<nano::vote>, nano::vote_source>> const &, std::shared_ptr<nano::transport::channel> const &);
 	nano::vote_code vote_blocking (std::shared_ptr<nano::vote> const &, std::shared_ptr<nano::transport::channel> const &, nano::vote_source = nano::vote_source::live);
 
 	/** Queue hash for vote cache lookup and processing. */
@@ -19,6 +19,7 @@
 #include <boost/property_tree/json_parser.hpp>
 
 #include <future>
+#include <latch>
 
 #include <argon2.h>
 
@@ -153,13 +154,18 @@ bool nano::wallet_store::valid_password (store::transaction const & transaction_
 }
 
 bool nano::wallet_store::attempt_password (store::transaction const & transaction_a, std::string const & password_a)
+{
+	nano::raw_key password_l;
+	derive_key (password_l, transaction_a, password_a);
+	return attempt_password_key (transaction_a, password_l);
+}
+
+bool nano::wallet_store::attempt_password_key (store::transaction const & transaction_a, nano::raw_key const & password_key_a)
 {
 	bool result = false;
 	{
 		nano::lock_guard<std::recursive_mutex> lock{ mutex };
-		nano::raw_key password_l;
-		derive_key (password_l, transaction_a, password_a);
-		password.value_set (password_l);
+		password.value_set (password_key_a);
 		result = !valid_password (transaction_a);
 	}
 	if (!result)
@@ -665,12 +671,110 @@ void nano::wallet_store::version_put (store::transaction const & transaction_a,
 	entry_put_raw (transaction_a, nano::wallet_store::version_special, nano::wallet_value (entry, 0));
 }
 
+/*
+ * kdf
+ */
+
+namespace
+{
+nano::raw_key random_key ()
+{
+	nano::raw_key result;
+	nano::random_pool::generate_block (result.bytes.data (), result.bytes.size ());
+	return result;
+}
+}
+
+nano::kdf::kdf (unsigned & kdf_work_a, unsigned max_concurrent_a, std::chrono::seconds cache_lifetime_a) :
+	kdf_work{ kdf_work_a },
+	max_concurrent{ std::max (max_concurrent_a, 1u) },
+	cache_lifetime{ cache_lifetime_a },
+	cache_secret{ random_key (), cache_fanout }
+{
+}
+
 void nano::kdf::phs (nano::raw_key & result_a, std::string const & password_a, nano::uint256_union const & salt_a)
 {
-	nano::lock_guard<nano::mutex> lock{ mutex };
+	auto const caching = cache_lifetime.count () > 0;
+	nano::uint256_union key;
+	if (caching)
+	{
+		key = cache_key (password_a, salt_a);
+		if (!cache_get (key, result_a))
+		{
+			return;
+		}
+	}
+	{
+		nano::unique_lock<nano::mutex> lock{ mutex };
+		condition.wait (lock, [this] () { return running < max_concurrent; });
+		++running;
+	}
 	auto success (argon2_hash (1, kdf_work, 1, password_a.data (), password_a.size (), salt_a.bytes.data (), salt_a.bytes.size (), result_a.bytes.data (), result_a.bytes.size (), NULL, 0, Argon2_d, 0x10));
 	debug_assert (success == 0);
 	(void)success;
+	{
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		--running;
+	}
+	condition.notify_one ();
+	if (caching)
+	{
+		cache_put (key, result_a);
+	}
+}
+
+nano::uint256_union nano::kdf::cache_key (std::string const & password_a, nano::uint256_union const & salt_a)
+{
+	nano::raw_key secret;
+	cache_secret.value (secret);
+	nano::uint256_union result;
+	blake2b_state state;
+	blake2b_init (&state, sizeof (result.bytes));
+	blake2b_update (&state, secret.bytes.data (), secret.bytes.size ());
+	blake2b_update (&state, salt_a.bytes.data (), salt_a.bytes.size ());
+	blake2b_update (&state, password_a.data (), password_a.size ());
+	blake2b_final (&state, result.bytes.data (), sizeof (result.bytes));
+	return result;
+}
+
+bool nano::kdf::cache_get (nano::uint256_union const & key_a, nano::raw_key & result_a)
+{
+	auto const now = std::chrono::steady_clock::now ();
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	auto existing = cache.find (key_a);
+	if (existing != cache.end () && existing->second.expiry > now)
+	{
+		existing->second.key->value (result_a);
+		return false;
+	}
+	return true;
+}
+
+void nano::kdf::cache_put (nano::uint256_union const & key_a, nano::raw_key const & value_a)
+{
+	auto const expiry = std::chrono::steady_clock::now () + cache_lifetime;
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	cache.insert_or_assign (key_a, entry{ std::make_unique<nano::fan> (value_a, cache_fanout), expiry });
+}
+
+void nano::kdf::cache_purge ()
+{
+	auto const now = std::chrono::steady_clock::now ();
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	std::erase_if (cache, [now] (auto const & item) { return item.second.expiry <= now; });
+}
+
+void nano::kdf::cache_clear ()
+{
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	cache.clear ();
+}
+
+std::size_t nano::kdf::cache_size () const
+{
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	return cache.size ();
 }
 
 /*
@@ -702,22 +806,57 @@ void nano::wallet::enter_initial_password ()
 	}
 	if (password_l.is_zero ())
 	{
-		auto transaction (wallets.tx_begin_write ());
-		if (store.valid_password (transaction))
+		bool new_wallet;
+		nano::uint256_union salt_l;
+		{
+			auto transaction (wallets.tx_begin_read ());
+			new_wallet = store.valid_password (transaction);
+			salt_l = store.salt (transaction);
+		}
+		if (new_wallet)
 		{
 			// Newly created wallets have a zero key
+			auto transaction (wallets.tx_begin_write ());
 			store.rekey (transaction, "");
 		}
 		else
 		{
-			enter_password (transaction, "");
+			// Derived without holding a transaction so wallets can be unlocked concurrently
+			nano::raw_key password_key;
+			store.kdf.phs (password_key, "", salt_l);
+			enter_password_key (wallets.tx_begin_read (), password_key, true);
 		}
 	}
 }
 
 bool nano::wallet::enter_password (store::transaction const & transaction_a, std::string const & password_a)
 {
-	auto result (store.attempt_password (transaction_a, password_a));
+	nano::raw_key password_key;
+	store.derive_key (password_key, transaction_a, password_a);
+	return enter_password_key (transaction_a, password_key, password_a.empty ());
+}
+
+void nano::wallet::enter_password_async (std::string const & password_a, std::function<void (bool)> callback_a)
+{
+	wallets.kdf_workers.post ([this_l = shared_from_this (), password_a, callback_a] () {
+		nano::uint256_union salt_l;
+		{
+			auto transaction (this_l->wallets.tx_begin_read ());
+			salt_l = this_l->store.salt (transaction);
+		}
+		nano::raw_key password_key;
+		this_l->store.kdf.phs (password_key, password_a, salt_l);
+		auto result = this_l->enter_password_key (this_l->wallets.tx_begin_read (), password_key, password_a.empty ());
+		if (callback_a)
+		{
+			callback_a (result);
+		}
+	});
+}
+
+bool nano::wallet::enter_password_key (store::transaction const & transaction_a, nano::raw_key const & password_key_a, bool empty_password_a)
+{
+	auto result (store.attempt_password_key (transaction_a, password_key_a));
 	if (!result)
 	{
 		logger.info (nano::log::type::wallet, "Wallet unlocked");
@@ -732,7 +871,7 @@ bool nano::wallet::enter_password (store::transaction const & transaction_a, std
 	{
 		logger.warn (nano::log::type::wallet, "Invalid password, wallet locked");
 	}
-	lock_observer (result, password_a.empty ());
+	lock_observer (result, empty_password_a);
 	return result;
 }
 
@@ -1247,44 +1386,64 @@ bool nano::wallet::search_receivable (store::transaction const & wallet_transact
 	{
 		logger.info (nano::log::type::wallet, "Beginning receivable block search");
 
+		std::vector<nano::account> accounts;
 		for (auto i (store.begin (wallet_transaction_a)), n (store.end (wallet_transaction_a)); i != n; ++i)
 		{
-			auto block_transaction = wallets.node.ledger.tx_begin_read ();
-			nano::account const & account (i->first);
 			// Don't search pending for watch-only accounts
 			if (!nano::wallet_value (i->second).key.is_zero ())
 			{
-				for (auto j (wallets.node.store.pending.begin (block_transaction, nano::pending_key (account, 0))), k (wallets.node.store.pending.end (block_transaction)); j != k && nano::pending_key (j->first).account == account; ++j)
+				accounts.push_back (i->first);
+			}
+		}
+		std::sort (accounts.begin (), accounts.end ());
+		auto const representative = store.representative (wallet_transaction_a);
+		auto const total = accounts.size ();
+		auto this_l = shared_from_this ();
+		wallets.sweep (
+		std::move (accounts),
+		[this_l, representative] (secure::transaction const & block_transaction, std::size_t, auto begin, auto end) {
+			auto & node = this_l->wallets.node;
+			node.ledger.receivable_for_each (block_transaction, std::vector<nano::account> (begin, end), true, [&] (nano::pending_key const & key, nano::pending_info const & pending, bool confirmed) {
+				auto hash (key.hash);
+				auto amount (pending.amount.number ());
+				if (node.config.receive_minimum.number () <= amount)
 				{
-					nano::pending_key key (j->first);
-					auto hash (key.hash);
-					nano::pending_info pending (j->second);
-					auto amount (pending.amount.number ());
-					if (wallets.node.config.receive_minimum.number () <= amount)
-					{
-						logger.info (nano::log::type::wallet, "Found a receivable block {} for account {}", hash.to_string (), pending.source.to_account ());
+					this_l->logger.info (nano::log::type::wallet, "Found a receivable block {} for account {}", hash.to_string (), pending.source.to_account ());
 
-						if (wallets.node.ledger.confirmed.block_exists_or_pruned (block_transaction, hash))
-						{
-							auto representative = store.representative (wallet_transaction_a);
-							// Receive confirmed block
-							receive_async (hash, representative, amount, account, [] (std::shared_ptr<nano::block> const &) {});
-						}
-						else if (!wallets.node.confirming_set.contains (hash))
+					if (confirmed)
+					{
+						// Receive confirmed block
+						this_l->receive_async (hash, representative, amount, key.account, [] (std::shared_ptr<nano::block> const &) {});
+					}
+					else if (!node.confirming_set.contains (hash))
+					{
+						auto block = node.ledger.any.block_get (block_transaction, hash);
+						if (block)
 						{
-							auto block = wallets.node.ledger.any.block_get (block_transaction, hash);
-							if (block)
-							{
-								// Request confirmation for block which is not being processed yet
-								wallets.node.start_election (block);
-							}
+							// Request confirmation for block which is not being processed yet
+							node.start_election (block);
 						}
 					}
 				}
+				return true;
+			});
+		},
+		[this_l, total] (std::size_t shard) {
+			if ((shard + 1) % 64 == 0)
+			{
+				this_l->logger.debug (nano::log::type::wallet, "Receivable block search progress: {} of {} accounts", (shard + 1) * nano::wallet_sweep::default_shard_size, total);
 			}
-		}
-
-		logger.info (nano::log::type::wallet, "Receivable block search phase complete");
+		},
+		[this_l, total] (bool cancelled) {
+			if (cancelled)
+			{
+				this_l->logger.warn (nano::log::type::wallet, "Receivable block search cancelled");
+			}
+			else
+			{
+				this_l->logger.info (nano::log::type::wallet, "Receivable block search phase complete ({} accounts)", total);
+			}
+		});
 	}
 	else
 	{
@@ -1425,7 +1584,8 @@ void nano::wallets::do_wallet_actions ()
 nano::wallets::wallets (bool error_a, nano::node & node_a) :
 	network_params{ node_a.config.network_params },
 	observer ([] (bool) {}),
-	kdf{ node_a.config.network_params.kdf_work },
+	kdf{ node_a.config.network_params.kdf_work, node_a.config.kdf_threads, node_a.config.kdf_cache_lifetime },
+	kdf_workers{ node_a.config.kdf_threads, nano::thread_role::name::wallet_kdf, /* start immediately */ true },
 	node (node_a),
 	logger (node_a.logger),
 	env (boost::polymorphic_downcast<nano::mdb_wallets_store *> (node_a.wallets_store_impl.get ())->environment),
@@ -1483,10 +1643,16 @@ nano::wallets::wallets (bool error_a, nano::node & node_a) :
 		std::filesystem::path const path (store_path);
 		nano::store::lmdb::component::create_backup_file (env, path, node_a.logger);
 	}
+	// Key derivation dominates startup with many wallets, they are unlocked concurrently on the kdf workers
+	std::latch unlocked{ static_cast<std::ptrdiff_t> (items.size ()) };
 	for (auto & item : items)
 	{
-		item.second->enter_initial_password ();
+		kdf_workers.post ([wallet = item.second, &unlocked] () {
+			wallet->enter_initial_password ();
+			unlocked.count_down ();
+		});
 	}
+	unlocked.wait ();
 }
 
 nano::wallets::~wallets ()
@@ -1505,6 +1671,10 @@ void nano::wallets::start ()
 	{
 		ongoing_compute_reps ();
 	}
+	if (node.config.kdf_cache_lifetime.count () > 0)
+	{
+		ongoing_kdf_cache_purge ();
+	}
 }
 
 void nano::wallets::stop ()
@@ -1514,11 +1684,25 @@ void nano::wallets::stop ()
 		stopped = true;
 		actions.clear ();
 	}
+	{
+		nano::lock_guard<nano::mutex> sweeps_lock{ sweeps_mutex };
+		for (auto const & sweep : sweeps)
+		{
+			if (auto sweep_l = sweep.lock ())
+			{
+				sweep_l->cancel ();
+			}
+		}
+		sweeps.clear ();
+	}
 	condition.notify_all ();
 	if (thread.joinable ())
 	{
 		thread.join ();
 	}
+	kdf_workers.stop ();
+	// Derived keys must not outlive the wallets in memory
+	kdf.cache_clear ();
 }
 
 std::shared_ptr<nano::wallet> nano::wallets::open (nano::wallet_id const & id_a)
@@ -1573,6 +1757,22 @@ void nano::wallets::search_receivable_all ()
 	}
 }
 
+std::shared_ptr<nano::wallet_sweep> nano::wallets::sweep (std::vector<nano::account> accounts_a, nano::wallet_sweep::action_t action_a, nano::wallet_sweep::deliver_t deliver_a, std::function<void (bool)> done_a)
+{
+	auto result = std::make_shared<nano::wallet_sweep> (node.workers, node.ledger, std::move (accounts_a), std::move (action_a), std::move (deliver_a), std::max (node.config.background_threads / 2, 1u));
+	{
+		nano::lock_guard<nano::mutex> sweeps_lock{ sweeps_mutex };
+		std::erase_if (sweeps, [] (auto const & sweep) { return sweep.expired (); });
+		sweeps.push_back (result);
+		if (stopped)
+		{
+			result->cancel ();
+		}
+	}
+	result->start (std::move (done_a));
+	return result;
+}
+
 void nano::wallets::destroy (nano::wallet_id const & id_a)
 {
 	nano::lock_guard<nano::mutex> lock{ mutex };
@@ -1794,6 +1994,20 @@ void nano::wallets::ongoing_compute_reps ()
 	});
 }
 
+void nano::wallets::ongoing_kdf_cache_purge ()
+{
+	if (stopped)
+	{
+		return;
+	}
+	kdf.cache_purge ();
+	auto & node_l (node);
+	// Expired keys are removed from memory at the latest one lifetime after they expired
+	node.workers.post_delayed (node.config.kdf_cache_lifetime, [&node_l] () {
+		node_l.wallets.ongoing_kdf_cache_purge ();
+	});
+}
+
 void nano::wallets::receive_confirmed (nano::block_hash const & hash_a, nano::account const & destination_a)
 {
 	nano::unique_lock<nano::mutex> lk{ mutex };
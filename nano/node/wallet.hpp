@@ -3,8 +3,11 @@
 #include <nano/lib/id_dispenser.hpp>
 #include <nano/lib/lmdbconfig.hpp>
 #include <nano/lib/locks.hpp>
+#include <nano/lib/numbers_templ.hpp>
+#include <nano/lib/thread_pool.hpp>
 #include <nano/lib/work.hpp>
 #include <nano/node/openclwork.hpp>
+#include <nano/node/wallet_sweep.hpp>
 #include <nano/secure/common.hpp>
 #include <nano/store/component.hpp>
 #include <nano/store/lmdb/lmdb.hpp>
@@ -12,6 +15,7 @@
 #include <nano/store/typed_iterator.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <thread>
 #include <unordered_set>
@@ -36,16 +40,44 @@ private:
 	void value_get (nano::raw_key &);
 };
 
+/**
+ * Derives wallet keys from passwords with Argon2, each derivation holds kdf_work KiB of memory.
+ * At most max_concurrent derivations run at the same time, further callers wait for one to finish.
+ * Keys derived within cache_lifetime are reused so repeated unlocks skip the derivation. Entries are found by a hash of password and salt,
+ * keyed with a random secret, and the keys themselves are held in a nano::fan. Expired entries are never used and removed by cache_purge.
+ */
 class kdf final
 {
 public:
-	kdf (unsigned & kdf_work) :
-		kdf_work{ kdf_work }
-	{
-	}
+	kdf (unsigned & kdf_work, unsigned max_concurrent = 1, std::chrono::seconds cache_lifetime = std::chrono::seconds{ 0 });
 	void phs (nano::raw_key &, std::string const &, nano::uint256_union const &);
-	nano::mutex mutex;
+	/** Removes expired entries */
+	void cache_purge ();
+	void cache_clear ();
+	std::size_t cache_size () const;
 	unsigned & kdf_work;
+
+private:
+	nano::uint256_union cache_key (std::string const &, nano::uint256_union const &);
+	bool cache_get (nano::uint256_union const &, nano::raw_key &);
+	void cache_put (nano::uint256_union const &, nano::raw_key const &);
+
+	class entry final
+	{
+	public:
+		std::unique_ptr<nano::fan> key;
+		std::chrono::steady_clock::time_point expiry;
+	};
+
+	unsigned const max_concurrent;
+	std::chrono::seconds const cache_lifetime;
+	nano::fan cache_secret;
+	mutable nano::mutex mutex;
+	nano::condition_variable condition;
+	unsigned running{ 0 };
+	std::unordered_map<nano::uint256_union, entry> cache;
+
+	static std::size_t constexpr cache_fanout = 16;
 };
 
 enum class key_type
@@ -71,6 +103,7 @@ public:
 	bool valid_password (store::transaction const &);
 	bool valid_public_key (nano::public_key const &);
 	bool attempt_password (store::transaction const &, std::string const &);
+	bool attempt_password_key (store::transaction const &, nano::raw_key const &);
 	void wallet_key (nano::raw_key &, store::transaction const &);
 	void seed (nano::raw_key &, store::transaction const &);
 	void seed_set (store::transaction const &, nano::raw_key const &);
@@ -143,6 +176,9 @@ public:
 	wallet (bool &, store::transaction &, nano::wallets &, std::string const &, std::string const &);
 	void enter_initial_password ();
 	bool enter_password (store::transaction const &, std::string const &);
+	/** Derives the key on the kdf workers without holding a transaction and calls \p callback with true if the password was wrong */
+	void enter_password_async (std::string const &, std::function<void (bool)> callback);
+	bool enter_password_key (store::transaction const &, nano::raw_key const & password_key, bool empty_password);
 	nano::public_key insert_adhoc (nano::raw_key const &, bool = true);
 	bool insert_watch (store::transaction const &, nano::public_key const &);
 	nano::public_key deterministic_insert (store::transaction const &, bool = true);
@@ -227,8 +263,14 @@ public:
 	bool check_rep (nano::account const &, nano::uint128_t const &, bool const = true);
 	void compute_reps ();
 	void ongoing_compute_reps ();
+	void ongoing_kdf_cache_purge ();
 	void receive_confirmed (nano::block_hash const & hash_a, nano::account const & destination_a);
 	std::unordered_map<nano::wallet_id, std::shared_ptr<nano::wallet>> get_wallets ();
+	/**
+	 * Starts a sweep over \p accounts on the node workers, using at most half of the background threads.
+	 * Sweeps still running are cancelled when the wallets are stopped
+	 */
+	std::shared_ptr<nano::wallet_sweep> sweep (std::vector<nano::account> accounts, nano::wallet_sweep::action_t action, nano::wallet_sweep::deliver_t deliver = nullptr, std::function<void (bool cancelled)> done = nullptr);
 	nano::container_info container_info () const;
 
 	nano::network_params & network_params;
@@ -240,6 +282,8 @@ public:
 	mutable nano::mutex action_mutex;
 	nano::condition_variable condition;
 	nano::kdf kdf;
+	/** Runs key derivations of asynchronous unlocks, sized like the kdf concurrency limit */
+	nano::thread_pool kdf_workers;
 	MDB_dbi handle;
 	MDB_dbi send_action_ids;
 	nano::node & node;
@@ -258,6 +302,8 @@ public:
 private:
 	mutable nano::mutex reps_cache_mutex;
 	nano::wallet_representatives representatives;
+	nano::mutex sweeps_mutex;
+	std::vector<std::weak_ptr<nano::wallet_sweep>> sweeps;
 };
 
 class wallets_store
@@ -0,0 +1,93 @@
+#include <nano/lib/thread_pool.hpp>
+#include <nano/node/wallet_sweep.hpp>
+#include <nano/secure/ledger.hpp>
+
+nano::wallet_sweep::wallet_sweep (nano::thread_pool & workers_a, nano::ledger & ledger_a, accounts_t accounts_a, action_t action_a, deliver_t deliver_a, unsigned parallelism_a, std::size_t shard_size_a) :
+	workers{ workers_a },
+	ledger{ ledger_a },
+	accounts{ std::move (accounts_a) },
+	action{ std::move (action_a) },
+	deliver{ std::move (deliver_a) },
+	parallelism{ std::max (parallelism_a, 1u) },
+	shard_size{ std::max<std::size_t> (shard_size_a, 1) }
+{
+	completed.resize (shard_count (), false);
+}
+
+void nano::wallet_sweep::start (std::function<void (bool)> done_a)
+{
+	done = std::move (done_a);
+	auto const tasks = std::max<std::size_t> (std::min<std::size_t> (parallelism, shard_count ()), 1);
+	running = static_cast<unsigned> (tasks);
+	for (std::size_t i = 0; i < tasks; ++i)
+	{
+		workers.post ([this_l = shared_from_this ()] () {
+			this_l->run ();
+		});
+	}
+}
+
+void nano::wallet_sweep::run ()
+{
+	auto const shard = next_shard.fetch_add (1);
+	if (shard < shard_count () && !cancelled ())
+	{
+		auto const begin = accounts.begin () + shard * shard_size;
+		auto const end = accounts.begin () + std::min (accounts.size (), (shard + 1) * shard_size);
+		{
+			auto transaction = ledger.tx_begin_read ();
+			action (transaction, shard, begin, end);
+		}
+		complete (shard);
+		// Reposted instead of looping so other work queued on the pool is not starved by a large wallet
+		workers.post ([this_l = shared_from_this ()] () {
+			this_l->run ();
+		});
+		return;
+	}
+	if (--running == 0 && done)
+	{
+		done (cancelled ());
+	}
+}
+
+void nano::wallet_sweep::complete (std::size_t shard)
+{
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	completed[shard] = true;
+	while (delivered < completed.size () && completed[delivered])
+	{
+		if (deliver)
+		{
+			deliver (delivered);
+		}
+		progress_m += std::min (accounts.size (), (delivered + 1) * shard_size) - delivered * shard_size;
+		++delivered;
+	}
+}
+
+void nano::wallet_sweep::cancel ()
+{
+	cancelled_m = true;
+}
+
+bool nano::wallet_sweep::cancelled () const
+{
+	return cancelled_m;
+}
+
+std::size_t nano::wallet_sweep::progress () const
+{
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	return progress_m;
+}
+
+std::size_t nano::wallet_sweep::size () const
+{
+	return accounts.size ();
+}
+
+std::size_t nano::wallet_sweep::shard_count () const
+{
+	return (accounts.size () + shard_size - 1) / shard_size;
+}
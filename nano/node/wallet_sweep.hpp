@@ -0,0 +1,68 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+#include <nano/lib/numbers.hpp>
+#include <nano/secure/transaction.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace nano
+{
+class ledger;
+class thread_pool;
+
+/**
+ * Runs a wallet wide operation over a snapshot of accounts split into shards of consecutive accounts.
+ * Shards are processed by a bounded number of tasks on a worker pool, each shard with its own ledger read transaction, so neither
+ * wallet locks nor a single long lived transaction are held for the whole wallet.
+ * Shards complete in any order, they are delivered in account order as soon as all preceding shards are done.
+ */
+class wallet_sweep final : public std::enable_shared_from_this<wallet_sweep>
+{
+public:
+	using accounts_t = std::vector<nano::account>;
+	/** Processes accounts [begin, end) of shard \p shard, called concurrently for different shards */
+	using action_t = std::function<void (secure::transaction const &, std::size_t shard, accounts_t::const_iterator begin, accounts_t::const_iterator end)>;
+	/** Called serially and in order for every completed shard */
+	using deliver_t = std::function<void (std::size_t shard)>;
+
+	wallet_sweep (nano::thread_pool &, nano::ledger &, accounts_t accounts, action_t action, deliver_t deliver = nullptr, unsigned parallelism = 1, std::size_t shard_size = default_shard_size);
+
+	/** Posts the sweep to the worker pool, \p done is called once all shards were delivered or, if cancelled, once running shards finished */
+	void start (std::function<void (bool cancelled)> done = nullptr);
+	/** Stops starting new shards, shards already running are completed and delivered */
+	void cancel ();
+	bool cancelled () const;
+	/** Number of accounts in delivered shards */
+	std::size_t progress () const;
+	std::size_t size () const;
+	std::size_t shard_count () const;
+
+	static std::size_t constexpr default_shard_size = 1024;
+
+private:
+	void run ();
+	void complete (std::size_t shard);
+
+	nano::thread_pool & workers;
+	nano::ledger & ledger;
+	accounts_t const accounts;
+	action_t const action;
+	deliver_t const deliver;
+	unsigned const parallelism;
+	std::size_t const shard_size;
+	std::function<void (bool)> done;
+
+	std::atomic<std::size_t> next_shard{ 0 };
+	std::atomic<unsigned> running{ 0 };
+	std::atomic<bool> cancelled_m{ false };
+
+	mutable nano::mutex mutex;
+	std::vector<bool> completed;
+	std::size_t delivered{ 0 };
+	std::size_t progress_m{ 0 };
+};
+}
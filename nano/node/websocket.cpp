@@ -3,6 +3,7 @@
 #include <nano/boost/asio/strand.hpp>
 #include <nano/lib/block_type.hpp>
 #include <nano/lib/blocks.hpp>
+#include <nano/lib/json_writer.hpp>
 #include <nano/lib/jsonconfig.hpp>
 #include <nano/lib/logging.hpp>
 #include <nano/lib/work.hpp>
@@ -19,6 +20,7 @@
 #include <boost/property_tree/json_parser.hpp>
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 
 nano::websocket::confirmation_options::confirmation_options (nano::wallets & wallets_a, nano::logger & logger_a) :
@@ -82,8 +84,7 @@ nano::websocket::confirmation_options::confirmation_options (boost::property_tre
 			nano::account result_l{};
 			if (!result_l.decode_account (account_l.second.data ()))
 			{
-				// Do not insert the given raw data to keep old prefix support
-				accounts.insert (result_l.to_account ());
+				accounts.insert (result_l);
 			}
 			else
 			{
@@ -101,43 +102,29 @@ nano::websocket::confirmation_options::confirmation_options (boost::property_tre
 
 bool nano::websocket::confirmation_options::should_filter (nano::websocket::message const & message_a) const
 {
-	bool should_filter_conf_type_l (true);
-
-	auto type_text_l (message_a.contents.get<std::string> ("message.confirmation_type"));
-	if (type_text_l == "active_quorum" && confirmation_types & type_active_quorum)
-	{
-		should_filter_conf_type_l = false;
-	}
-	else if (type_text_l == "active_confirmation_height" && confirmation_types & type_active_confirmation_height)
+	debug_assert (message_a.confirmation);
+	if (!message_a.confirmation)
 	{
-		should_filter_conf_type_l = false;
-	}
-	else if (type_text_l == "inactive" && confirmation_types & type_inactive)
-	{
-		should_filter_conf_type_l = false;
+		return true;
 	}
+	auto const & confirmation_l = *message_a.confirmation;
+
+	bool should_filter_conf_type_l = (confirmation_l.type & confirmation_types) == 0;
 
 	bool should_filter_account (has_account_filtering_options);
-	auto destination_opt_l (message_a.contents.get_optional<std::string> ("message.block.link_as_account"));
-	if (destination_opt_l)
+	if (confirmation_l.destination)
 	{
-		auto source_text_l (message_a.contents.get<std::string> ("message.account"));
+		auto const & source_l = confirmation_l.account;
+		auto const & destination_l = *confirmation_l.destination;
 		if (all_local_accounts)
 		{
 			auto transaction_l (wallets.tx_begin_read ());
-			nano::account source_l{};
-			nano::account destination_l{};
-			auto decode_source_ok_l (!source_l.decode_account (source_text_l));
-			auto decode_destination_ok_l (!destination_l.decode_account (destination_opt_l.get ()));
-			(void)decode_source_ok_l;
-			(void)decode_destination_ok_l;
-			debug_assert (decode_source_ok_l && decode_destination_ok_l);
 			if (wallets.exists (transaction_l, source_l) || wallets.exists (transaction_l, destination_l))
 			{
 				should_filter_account = false;
 			}
 		}
-		if (accounts.find (source_text_l) != accounts.end () || accounts.find (destination_opt_l.get ()) != accounts.end ())
+		if (accounts.find (source_l) != accounts.end () || accounts.find (destination_l) != accounts.end ())
 		{
 			should_filter_account = false;
 		}
@@ -155,15 +142,13 @@ bool nano::websocket::confirmation_options::update (boost::property_tree::ptree
 			nano::account result_l{};
 			if (!result_l.decode_account (account_l.second.data ()))
 			{
-				// Re-encode to keep old prefix support
-				auto encoded_l (result_l.to_account ());
 				if (insert_a)
 				{
-					this->accounts.insert (encoded_l);
+					this->accounts.insert (result_l);
 				}
 				else
 				{
-					this->accounts.erase (encoded_l);
+					this->accounts.erase (result_l);
 				}
 			}
 			else
@@ -212,8 +197,7 @@ nano::websocket::vote_options::vote_options (boost::property_tree::ptree const &
 			nano::account result_l{};
 			if (!result_l.decode_account (representative_l.second.data ()))
 			{
-				// Do not insert the given raw data to keep old prefix support
-				representatives.insert (result_l.to_account ());
+				representatives.insert (result_l);
 			}
 			else
 			{
@@ -230,12 +214,17 @@ nano::websocket::vote_options::vote_options (boost::property_tree::ptree const &
 
 bool nano::websocket::vote_options::should_filter (nano::websocket::message const & message_a) const
 {
-	auto type (message_a.contents.get<std::string> ("message.type"));
-	bool should_filter_l = (!include_replays && type == "replay") || (!include_indeterminate && type == "indeterminate");
+	debug_assert (message_a.vote);
+	if (!message_a.vote)
+	{
+		return true;
+	}
+	auto const & vote_l = *message_a.vote;
+
+	bool should_filter_l = (!include_replays && vote_l.code == nano::vote_code::replay) || (!include_indeterminate && vote_l.code == nano::vote_code::indeterminate);
 	if (!should_filter_l && !representatives.empty ())
 	{
-		auto representative_text_l (message_a.contents.get<std::string> ("message.account"));
-		if (representatives.find (representative_text_l) == representatives.end ())
+		if (representatives.find (vote_l.representative) == representatives.end ())
 		{
 			should_filter_l = true;
 		}
@@ -275,6 +264,10 @@ nano::websocket::session::~session ()
 		nano::unique_lock<nano::mutex> lk (subscriptions_mutex);
 		for (auto & subscription : subscriptions)
 		{
+			if (subscription.first == nano::websocket::topic::confirmation)
+			{
+				ws_listener.unindex_confirmation_subscription (*this, *subscription.second);
+			}
 			ws_listener.decrease_subscriber_count (subscription.first);
 		}
 	}
@@ -311,32 +304,41 @@ void nano::websocket::session::close ()
 	});
 }
 
-void nano::websocket::session::write (nano::websocket::message message_a)
+bool nano::websocket::session::should_write (nano::websocket::message const & message_a)
 {
-	nano::unique_lock<nano::mutex> lk (subscriptions_mutex);
+	nano::lock_guard<nano::mutex> lk (subscriptions_mutex);
 	auto subscription (subscriptions.find (message_a.topic));
-	if (message_a.topic == nano::websocket::topic::ack || (subscription != subscriptions.end () && !subscription->second->should_filter (message_a)))
-	{
-		lk.unlock ();
-		auto this_l (shared_from_this ());
-		boost::asio::post (ws.get_strand (),
-		[message_a, this_l] () {
-			bool write_in_progress = !this_l->send_queue.empty ();
-			this_l->send_queue.emplace_back (message_a);
-			if (!write_in_progress)
-			{
-				this_l->write_queued_messages ();
-			}
-		});
+	return message_a.topic == nano::websocket::topic::ack || (subscription != subscriptions.end () && !subscription->second->should_filter (message_a));
+}
+
+void nano::websocket::session::write (nano::websocket::message const & message_a)
+{
+	if (should_write (message_a))
+	{
+		write (message_a.to_buffer ());
 	}
 }
 
+void nano::websocket::session::write (nano::shared_const_buffer const & buffer_a)
+{
+	auto this_l (shared_from_this ());
+	boost::asio::post (ws.get_strand (),
+	[buffer_a, this_l] () {
+		bool write_in_progress = !this_l->send_queue.empty ();
+		this_l->send_queue.emplace_back (buffer_a);
+		if (!write_in_progress)
+		{
+			this_l->write_queued_messages ();
+		}
+	});
+}
+
 void nano::websocket::session::write_queued_messages ()
 {
-	auto msg (send_queue.front ().to_string ());
 	auto this_l (shared_from_this ());
 
-	ws.async_write (nano::shared_const_buffer (msg),
+	// The buffer is kept alive by the queue until the write completes
+	ws.async_write (send_queue.front (),
 	[this_l] (boost::system::error_code ec, std::size_t bytes_transferred) {
 		this_l->send_queue.pop_front ();
 		if (!ec)
@@ -477,13 +479,14 @@ std::string from_topic (nano::websocket::topic topic_a)
 void nano::websocket::session::send_ack (std::string action_a, std::string id_a)
 {
 	nano::websocket::message msg (nano::websocket::topic::ack);
-	boost::property_tree::ptree & message_l = msg.contents;
-	message_l.add ("ack", action_a);
-	message_l.add ("time", std::to_string (nano::milliseconds_since_epoch ()));
+	nano::json_writer writer;
+	writer.put ("ack", action_a);
+	writer.put ("time", std::to_string (nano::milliseconds_since_epoch ()));
 	if (!id_a.empty ())
 	{
-		message_l.add ("id", id_a);
+		writer.put ("id", id_a);
 	}
+	msg.contents = writer.finish ();
 	write (msg);
 }
 
@@ -516,15 +519,23 @@ void nano::websocket::session::handle_message (boost::property_tree::ptree const
 		{
 			logger.info (nano::log::type::websocket, "Updated subscription to topic: {} ({})", from_topic (topic_l), nano::util::to_str (remote));
 
+			if (topic_l == nano::websocket::topic::confirmation)
+			{
+				ws_listener.unindex_confirmation_subscription (*this, *existing->second);
+			}
 			existing->second = std::move (options_l);
 		}
 		else
 		{
 			logger.info (nano::log::type::websocket, "New subscription to topic: {} ({})", from_topic (topic_l), nano::util::to_str (remote));
 
-			subscriptions.emplace (topic_l, std::move (options_l));
+			existing = subscriptions.emplace (topic_l, std::move (options_l)).first;
 			ws_listener.increase_subscriber_count (topic_l);
 		}
+		if (topic_l == nano::websocket::topic::confirmation)
+		{
+			ws_listener.index_confirmation_subscription (shared_from_this (), *existing->second);
+		}
 		action_succeeded = true;
 	}
 	else if (action == "update")
@@ -534,17 +545,37 @@ void nano::websocket::session::handle_message (boost::property_tree::ptree const
 		if (existing != subscriptions.end ())
 		{
 			auto options_text_l (message_a.get_child_optional ("options"));
-			if (options_text_l.is_initialized () && !existing->second->update (*options_text_l))
+			if (options_text_l.is_initialized ())
 			{
-				action_succeeded = true;
+				// Updates can change the accounts a confirmation subscription is indexed by
+				bool const reindex = topic_l == nano::websocket::topic::confirmation;
+				if (reindex)
+				{
+					ws_listener.unindex_confirmation_subscription (*this, *existing->second);
+				}
+				if (!existing->second->update (*options_text_l))
+				{
+					action_succeeded = true;
+				}
+				if (reindex)
+				{
+					ws_listener.index_confirmation_subscription (shared_from_this (), *existing->second);
+				}
 			}
 		}
 	}
 	else if (action == "unsubscribe" && topic_l != nano::websocket::topic::invalid)
 	{
 		nano::lock_guard<nano::mutex> lk (subscriptions_mutex);
-		if (subscriptions.erase (topic_l))
+		auto existing (subscriptions.find (topic_l));
+		if (existing != subscriptions.end ())
 		{
+			if (topic_l == nano::websocket::topic::confirmation)
+			{
+				ws_listener.unindex_confirmation_subscription (*this, *existing->second);
+			}
+			subscriptions.erase (existing);
+
 			logger.info (nano::log::type::websocket, "Removed subscription to topic: {} ({})", from_topic (topic_l), nano::util::to_str (remote));
 
 			ws_listener.decrease_subscriber_count (topic_l);
@@ -651,54 +682,154 @@ void nano::websocket::listener::on_accept (boost::system::error_code ec)
 void nano::websocket::listener::broadcast_confirmation (std::shared_ptr<nano::block> const & block_a, nano::account const & account_a, nano::amount const & amount_a, std::string const & subtype, nano::election_status const & election_status_a, std::vector<nano::vote_with_weight_info> const & election_votes_a)
 {
 	nano::websocket::message_builder builder;
+	nano::websocket::confirmation_options default_options (wallets, logger);
 
-	nano::lock_guard<nano::mutex> lk (sessions_mutex);
-	boost::optional<nano::websocket::message> msg_with_block;
-	boost::optional<nano::websocket::message> msg_without_block;
-	for (auto & weak_session : sessions)
+	// Messages only differ by the content options of each session, every variant is built and serialized at most once
+	std::array<std::optional<std::pair<nano::websocket::message, nano::shared_const_buffer>>, nano::websocket::confirmation_options::content_variants> variants;
+
+	// Only state blocks can pass an account filter
+	std::optional<nano::account> destination_l;
+	if (block_a->type () == nano::block_type::state)
 	{
-		auto session_ptr (weak_session.lock ());
-		if (session_ptr)
+		destination_l = block_a->link_field ().value ().as_account ();
+	}
+
+	for (auto const & session_ptr : confirmation_subscribers (account_a, destination_l))
+	{
+		nano::unique_lock<nano::mutex> subscriptions_lock (session_ptr->subscriptions_mutex);
+		auto subscription (session_ptr->subscriptions.find (nano::websocket::topic::confirmation));
+		if (subscription != session_ptr->subscriptions.end ())
 		{
-			auto subscription (session_ptr->subscriptions.find (nano::websocket::topic::confirmation));
-			if (subscription != session_ptr->subscriptions.end ())
+			auto conf_options (dynamic_cast<nano::websocket::confirmation_options *> (subscription->second.get ()));
+			auto const & content_options (conf_options != nullptr ? *conf_options : default_options);
+
+			auto & variant (variants[content_options.content_variant ()]);
+			if (!variant)
 			{
-				nano::websocket::confirmation_options default_options (wallets, logger);
-				auto conf_options (dynamic_cast<nano::websocket::confirmation_options *> (subscription->second.get ()));
-				if (conf_options == nullptr)
-				{
-					conf_options = &default_options;
-				}
-				auto include_block (conf_options == nullptr ? true : conf_options->get_include_block ());
+				auto message_l = builder.block_confirmed (block_a, account_a, amount_a, subtype, content_options.get_include_block (), election_status_a, election_votes_a, content_options);
+				auto buffer_l = message_l.to_buffer ();
+				variant.emplace (std::move (message_l), std::move (buffer_l));
+			}
 
-				if (include_block && !msg_with_block)
-				{
-					msg_with_block = builder.block_confirmed (block_a, account_a, amount_a, subtype, include_block, election_status_a, election_votes_a, *conf_options);
-				}
-				else if (!include_block && !msg_without_block)
+			// Subscriptions without options receive every confirmation
+			if (conf_options == nullptr || !conf_options->should_filter (variant->first))
+			{
+				subscriptions_lock.unlock ();
+				session_ptr->write (variant->second);
+			}
+		}
+	}
+}
+
+void nano::websocket::listener::index_confirmation_subscription (std::shared_ptr<session> const & session_a, nano::websocket::options const & options_a)
+{
+	nano::lock_guard<nano::mutex> lk (confirmation_index_mutex);
+	auto conf_options (dynamic_cast<nano::websocket::confirmation_options const *> (&options_a));
+	if (conf_options != nullptr && conf_options->filters_by_accounts_only ())
+	{
+		for (auto const & account_l : conf_options->get_accounts ())
+		{
+			confirmation_accounts_index[account_l].emplace (session_a.get (), session_a);
+		}
+	}
+	else
+	{
+		confirmation_unindexed.emplace (session_a.get (), session_a);
+	}
+}
+
+void nano::websocket::listener::unindex_confirmation_subscription (session const & session_a, nano::websocket::options const & options_a)
+{
+	nano::lock_guard<nano::mutex> lk (confirmation_index_mutex);
+	auto conf_options (dynamic_cast<nano::websocket::confirmation_options const *> (&options_a));
+	if (conf_options != nullptr && conf_options->filters_by_accounts_only ())
+	{
+		for (auto const & account_l : conf_options->get_accounts ())
+		{
+			auto existing (confirmation_accounts_index.find (account_l));
+			if (existing != confirmation_accounts_index.end ())
+			{
+				existing->second.erase (&session_a);
+				if (existing->second.empty ())
 				{
-					msg_without_block = builder.block_confirmed (block_a, account_a, amount_a, subtype, include_block, election_status_a, election_votes_a, *conf_options);
+					confirmation_accounts_index.erase (existing);
 				}
+			}
+		}
+	}
+	else
+	{
+		confirmation_unindexed.erase (&session_a);
+	}
+}
 
-				session_ptr->write (include_block ? msg_with_block.get () : msg_without_block.get ());
+std::vector<std::shared_ptr<nano::websocket::session>> nano::websocket::listener::confirmation_subscribers (nano::account const & account_a, std::optional<nano::account> const & destination_a)
+{
+	std::vector<std::shared_ptr<nano::websocket::session>> result;
+
+	nano::lock_guard<nano::mutex> lk (confirmation_index_mutex);
+	auto collect = [&result] (session_set const & sessions_a) {
+		for (auto const & [session_l, weak_session] : sessions_a)
+		{
+			if (auto session_ptr = weak_session.lock ())
+			{
+				result.push_back (std::move (session_ptr));
+			}
+		}
+	};
+
+	collect (confirmation_unindexed);
+	if (destination_a)
+	{
+		auto const indexed_begin = result.size ();
+		for (auto const & account_l : { account_a, *destination_a })
+		{
+			auto existing (confirmation_accounts_index.find (account_l));
+			if (existing != confirmation_accounts_index.end ())
+			{
+				collect (existing->second);
 			}
 		}
+		// A session subscribed to both the source and destination accounts must only be visited once
+		std::sort (result.begin () + indexed_begin, result.end ());
+		result.erase (std::unique (result.begin () + indexed_begin, result.end ()), result.end ());
 	}
+	return result;
 }
 
-void nano::websocket::listener::broadcast (nano::websocket::message message_a)
+void nano::websocket::listener::broadcast (nano::websocket::message const & message_a)
 {
+	// Serialized lazily, only if at least one session is interested in the message
+	std::optional<nano::shared_const_buffer> buffer;
+
 	nano::lock_guard<nano::mutex> lk (sessions_mutex);
 	for (auto & weak_session : sessions)
 	{
 		auto session_ptr (weak_session.lock ());
-		if (session_ptr)
+		if (session_ptr && session_ptr->should_write (message_a))
 		{
-			session_ptr->write (message_a);
+			if (!buffer)
+			{
+				buffer = message_a.to_buffer ();
+			}
+			session_ptr->write (*buffer);
 		}
 	}
 }
 
+std::size_t nano::websocket::listener::confirmation_indexed_count (nano::account const & account_a) const
+{
+	nano::lock_guard<nano::mutex> lk (confirmation_index_mutex);
+	auto existing (confirmation_accounts_index.find (account_a));
+	return existing != confirmation_accounts_index.end () ? existing->second.size () : 0;
+}
+
+std::size_t nano::websocket::listener::confirmation_unindexed_count () const
+{
+	nano::lock_guard<nano::mutex> lk (confirmation_index_mutex);
+	return confirmation_unindexed.size ();
+}
+
 void nano::websocket::listener::increase_subscriber_count (nano::websocket::topic const & topic_a)
 {
 	topic_subscriber_count[static_cast<std::size_t> (topic_a)] += 1;
@@ -714,110 +845,133 @@ void nano::websocket::listener::decrease_subscriber_count (nano::websocket::topi
 nano::websocket::message nano::websocket::message_builder::started_election (nano::block_hash const & hash_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::started_election);
-	set_common_fields (message_l);
+	nano::json_writer writer;
+	set_common_fields (message_l, writer);
 
-	boost::property_tree::ptree message_node_l;
-	message_node_l.add ("hash", hash_a.to_string ());
-	message_l.contents.add_child ("message", message_node_l);
+	writer.begin_object ("message");
+	writer.put ("hash", hash_a.to_string ());
+	writer.end ();
 
+	message_l.contents = writer.finish ();
 	return message_l;
 }
 
 nano::websocket::message nano::websocket::message_builder::stopped_election (nano::block_hash const & hash_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::stopped_election);
-	set_common_fields (message_l);
+	nano::json_writer writer;
+	set_common_fields (message_l, writer);
 
-	boost::property_tree::ptree message_node_l;
-	message_node_l.add ("hash", hash_a.to_string ());
-	message_l.contents.add_child ("message", message_node_l);
+	writer.begin_object ("message");
+	writer.put ("hash", hash_a.to_string ());
+	writer.end ();
 
+	message_l.contents = writer.finish ();
 	return message_l;
 }
 
 nano::websocket::message nano::websocket::message_builder::block_confirmed (std::shared_ptr<nano::block> const & block_a, nano::account const & account_a, nano::amount const & amount_a, std::string subtype, bool include_block_a, nano::election_status const & election_status_a, std::vector<nano::vote_with_weight_info> const & election_votes_a, nano::websocket::confirmation_options const & options_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::confirmation);
-	set_common_fields (message_l);
+	nano::json_writer writer;
+	set_common_fields (message_l, writer);
 
 	// Block confirmation properties
-	boost::property_tree::ptree message_node_l;
-	message_node_l.add ("account", account_a.to_account ());
-	message_node_l.add ("amount", amount_a.to_string_dec ());
-	message_node_l.add ("hash", block_a->hash ().to_string ());
+	writer.begin_object ("message");
+	writer.put ("account", account_a.to_account ());
+	writer.put ("amount", amount_a.to_string_dec ());
+	writer.put ("hash", block_a->hash ().to_string ());
 
 	std::string confirmation_type = "unknown";
+	uint8_t confirmation_type_flag = 0;
 	switch (election_status_a.type)
 	{
 		case nano::election_status_type::active_confirmed_quorum:
 			confirmation_type = "active_quorum";
+			confirmation_type_flag = nano::websocket::confirmation_options::type_active_quorum;
 			break;
 		case nano::election_status_type::active_confirmation_height:
 			confirmation_type = "active_confirmation_height";
+			confirmation_type_flag = nano::websocket::confirmation_options::type_active_confirmation_height;
 			break;
 		case nano::election_status_type::inactive_confirmation_height:
 			confirmation_type = "inactive";
+			confirmation_type_flag = nano::websocket::confirmation_options::type_inactive;
 			break;
 		default:
 			break;
 	};
-	message_node_l.add ("confirmation_type", confirmation_type);
+	writer.put ("confirmation_type", confirmation_type);
+
+	nano::websocket::message::confirmation_info confirmation_l;
+	confirmation_l.type = confirmation_type_flag;
+	confirmation_l.account = account_a;
+	if (include_block_a && block_a->type () == nano::block_type::state)
+	{
+		confirmation_l.destination = block_a->link_field ().value ().as_account ();
+	}
+	message_l.confirmation = confirmation_l;
 
 	if (options_a.get_include_election_info () || options_a.get_include_election_info_with_votes ())
 	{
-		boost::property_tree::ptree election_node_l;
-		election_node_l.add ("duration", election_status_a.election_duration.count ());
-		election_node_l.add ("time", election_status_a.election_end.count ());
-		election_node_l.add ("tally", election_status_a.tally.to_string_dec ());
-		election_node_l.add ("final", election_status_a.final_tally.to_string_dec ());
-		election_node_l.add ("blocks", std::to_string (election_status_a.block_count));
-		election_node_l.add ("voters", std::to_string (election_status_a.voter_count));
-		election_node_l.add ("request_count", std::to_string (election_status_a.confirmation_request_count));
+		writer.begin_object ("election_info");
+		writer.put ("duration", std::to_string (election_status_a.election_duration.count ()));
+		writer.put ("time", std::to_string (election_status_a.election_end.count ()));
+		writer.put ("tally", election_status_a.tally.to_string_dec ());
+		writer.put ("final", election_status_a.final_tally.to_string_dec ());
+		writer.put ("blocks", std::to_string (election_status_a.block_count));
+		writer.put ("voters", std::to_string (election_status_a.voter_count));
+		writer.put ("request_count", std::to_string (election_status_a.confirmation_request_count));
 		if (options_a.get_include_election_info_with_votes ())
 		{
-			boost::property_tree::ptree election_votes_l;
+			writer.begin_array ("votes");
 			for (auto const & vote_l : election_votes_a)
 			{
-				boost::property_tree::ptree entry;
-				entry.put ("representative", vote_l.representative.to_account ());
-				entry.put ("timestamp", vote_l.timestamp);
-				entry.put ("hash", vote_l.hash.to_string ());
-				entry.put ("weight", vote_l.weight.convert_to<std::string> ());
-				election_votes_l.push_back (std::make_pair ("", entry));
+				writer.begin_object ();
+				writer.put ("representative", vote_l.representative.to_account ());
+				writer.put ("timestamp", std::to_string (vote_l.timestamp));
+				writer.put ("hash", vote_l.hash.to_string ());
+				writer.put ("weight", vote_l.weight.convert_to<std::string> ());
+				writer.end ();
 			}
-			election_node_l.add_child ("votes", election_votes_l);
+			writer.end ();
 		}
-		message_node_l.add_child ("election_info", election_node_l);
+		writer.end ();
 	}
 
 	if (include_block_a)
 	{
+		// Blocks only serialize into a ptree, its fields are copied into the document
 		boost::property_tree::ptree block_node_l;
 		block_a->serialize_json (block_node_l);
+		writer.begin_object ("block");
+		writer.put_children (block_node_l);
 		if (!subtype.empty ())
 		{
-			block_node_l.add ("subtype", subtype);
+			writer.put ("subtype", subtype);
 		}
-		message_node_l.add_child ("block", block_node_l);
+		writer.end ();
 	}
 
 	if (options_a.get_include_sideband_info ())
 	{
-		boost::property_tree::ptree sideband_node_l;
-		sideband_node_l.add ("height", std::to_string (block_a->sideband ().height));
-		sideband_node_l.add ("local_timestamp", std::to_string (block_a->sideband ().timestamp));
-		message_node_l.add_child ("sideband", sideband_node_l);
+		writer.begin_object ("sideband");
+		writer.put ("height", std::to_string (block_a->sideband ().height));
+		writer.put ("local_timestamp", std::to_string (block_a->sideband ().timestamp));
+		writer.end ();
 	}
 
-	message_l.contents.add_child ("message", message_node_l);
+	writer.end ();
 
+	message_l.contents = writer.finish ();
 	return message_l;
 }
 
 nano::websocket::message nano::websocket::message_builder::vote_received (std::shared_ptr<nano::vote> const & vote_a, nano::vote_code code_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::vote);
-	set_common_fields (message_l);
+	nano::json_writer writer;
+	set_common_fields (message_l, writer);
 
 	// Vote information
 	boost::property_tree::ptree vote_node_l;
@@ -843,53 +997,57 @@ nano::websocket::message nano::websocket::message_builder::vote_received (std::s
 			debug_assert (false);
 			break;
 	}
-	vote_node_l.put ("type", vote_type);
-	message_l.contents.add_child ("message", vote_node_l);
+	writer.begin_object ("message");
+	writer.put_children (vote_node_l);
+	writer.put ("type", vote_type);
+	writer.end ();
+	message_l.contents = writer.finish ();
+	message_l.vote = nano::websocket::message::vote_info{ vote_a->account, code_a };
 	return message_l;
 }
 
 nano::websocket::message nano::websocket::message_builder::work_generation (nano::work_version const version_a, nano::block_hash const & root_a, uint64_t work_a, uint64_t difficulty_a, uint64_t publish_threshold_a, std::chrono::milliseconds const & duration_a, std::string const & peer_a, std::vector<std::string> const & bad_peers_a, bool completed_a, bool cancelled_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::work);
-	set_common_fields (message_l);
+	nano::json_writer writer;
+	set_common_fields (message_l, writer);
 
 	// Active difficulty information
-	boost::property_tree::ptree work_l;
-	work_l.put ("success", completed_a ? "true" : "false");
-	work_l.put ("reason", completed_a ? "" : cancelled_a ? "cancelled"
+	writer.begin_object ("message");
+	writer.put ("success", completed_a ? "true" : "false");
+	writer.put ("reason", completed_a ? "" : cancelled_a ? "cancelled"
 														 : "failure");
-	work_l.put ("duration", duration_a.count ());
+	writer.put ("duration", std::to_string (duration_a.count ()));
 
-	boost::property_tree::ptree request_l;
-	request_l.put ("version", nano::to_string (version_a));
-	request_l.put ("hash", root_a.to_string ());
-	request_l.put ("difficulty", nano::to_string_hex (difficulty_a));
+	writer.begin_object ("request");
+	writer.put ("version", nano::to_string (version_a));
+	writer.put ("hash", root_a.to_string ());
+	writer.put ("difficulty", nano::to_string_hex (difficulty_a));
 	auto request_multiplier_l (nano::difficulty::to_multiplier (difficulty_a, publish_threshold_a));
-	request_l.put ("multiplier", nano::to_string (request_multiplier_l));
-	work_l.add_child ("request", request_l);
+	writer.put ("multiplier", nano::to_string (request_multiplier_l));
+	writer.end ();
 
 	if (completed_a)
 	{
-		boost::property_tree::ptree result_l;
-		result_l.put ("source", peer_a);
-		result_l.put ("work", nano::to_string_hex (work_a));
+		writer.begin_object ("result");
+		writer.put ("source", peer_a);
+		writer.put ("work", nano::to_string_hex (work_a));
 		auto result_difficulty_l (nano::dev::network_params.work.difficulty (version_a, root_a, work_a));
-		result_l.put ("difficulty", nano::to_string_hex (result_difficulty_l));
+		writer.put ("difficulty", nano::to_string_hex (result_difficulty_l));
 		auto result_multiplier_l (nano::difficulty::to_multiplier (result_difficulty_l, publish_threshold_a));
-		result_l.put ("multiplier", nano::to_string (result_multiplier_l));
-		work_l.add_child ("result", result_l);
+		writer.put ("multiplier", nano::to_string (result_multiplier_l));
+		writer.end ();
 	}
 
-	boost::property_tree::ptree bad_peers_l;
+	writer.begin_array ("bad_peers");
 	for (auto & peer_text : bad_peers_a)
 	{
-		boost::property_tree::ptree entry;
-		entry.put ("", peer_text);
-		bad_peers_l.push_back (std::make_pair ("", entry));
+		writer.push (peer_text);
 	}
-	work_l.add_child ("bad_peers", bad_peers_l);
+	writer.end ();
+	writer.end ();
 
-	message_l.contents.add_child ("message", work_l);
+	message_l.contents = writer.finish ();
 	return message_l;
 }
 
@@ -906,39 +1064,44 @@ nano::websocket::message nano::websocket::message_builder::work_failed (nano::wo
 nano::websocket::message nano::websocket::message_builder::bootstrap_started (std::string const & id_a, std::string const & mode_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::bootstrap);
-	set_common_fields (message_l);
+	nano::json_writer writer;
+	set_common_fields (message_l, writer);
 
 	// Bootstrap information
-	boost::property_tree::ptree bootstrap_l;
-	bootstrap_l.put ("reason", "started");
-	bootstrap_l.put ("id", id_a);
-	bootstrap_l.put ("mode", mode_a);
+	writer.begin_object ("message");
+	writer.put ("reason", "started");
+	writer.put ("id", id_a);
+	writer.put ("mode", mode_a);
+	writer.end ();
 
-	message_l.contents.add_child ("message", bootstrap_l);
+	message_l.contents = writer.finish ();
 	return message_l;
 }
 
 nano::websocket::message nano::websocket::message_builder::bootstrap_exited (std::string const & id_a, std::string const & mode_a, std::chrono::steady_clock::time_point const start_time_a, uint64_t const total_blocks_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::bootstrap);
-	set_common_fields (message_l);
+	nano::json_writer writer;
+	set_common_fields (message_l, writer);
 
 	// Bootstrap information
-	boost::property_tree::ptree bootstrap_l;
-	bootstrap_l.put ("reason", "exited");
-	bootstrap_l.put ("id", id_a);
-	bootstrap_l.put ("mode", mode_a);
-	bootstrap_l.put ("total_blocks", total_blocks_a);
-	bootstrap_l.put ("duration", std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now () - start_time_a).count ());
-
-	message_l.contents.add_child ("message", bootstrap_l);
+	writer.begin_object ("message");
+	writer.put ("reason", "exited");
+	writer.put ("id", id_a);
+	writer.put ("mode", mode_a);
+	writer.put ("total_blocks", std::to_string (total_blocks_a));
+	writer.put ("duration", std::to_string (std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now () - start_time_a).count ()));
+	writer.end ();
+
+	message_l.contents = writer.finish ();
 	return message_l;
 }
 
 nano::websocket::message nano::websocket::message_builder::telemetry_received (nano::telemetry_data const & telemetry_data_a, nano::endpoint const & endpoint_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::telemetry);
-	set_common_fields (message_l);
+	nano::json_writer writer;
+	set_common_fields (message_l, writer);
 
 	// Telemetry information
 	nano::jsonconfig telemetry_l;
@@ -946,39 +1109,49 @@ nano::websocket::message nano::websocket::message_builder::telemetry_received (n
 	telemetry_l.put ("address", endpoint_a.address ());
 	telemetry_l.put ("port", endpoint_a.port ());
 
-	message_l.contents.add_child ("message", telemetry_l.get_tree ());
+	writer.begin_object ("message");
+	writer.put_children (telemetry_l.get_tree ());
+	writer.end ();
+
+	message_l.contents = writer.finish ();
 	return message_l;
 }
 
 nano::websocket::message nano::websocket::message_builder::new_block_arrived (nano::block const & block_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::new_unconfirmed_block);
-	set_common_fields (message_l);
+	nano::json_writer writer;
+	set_common_fields (message_l, writer);
 
 	boost::property_tree::ptree block_l;
 	block_a.serialize_json (block_l);
 	auto subtype (nano::state_subtype (block_a.sideband ().details));
-	block_l.put ("subtype", subtype);
 
-	message_l.contents.put ("hash", block_a.hash ().to_string ());
-	message_l.contents.add_child ("message", block_l);
+	writer.put ("hash", block_a.hash ().to_string ());
+	writer.begin_object ("message");
+	writer.put_children (block_l);
+	writer.put ("subtype", subtype);
+	writer.end ();
 
+	message_l.contents = writer.finish ();
 	return message_l;
 }
 
-void nano::websocket::message_builder::set_common_fields (nano::websocket::message & message_a)
+void nano::websocket::message_builder::set_common_fields (nano::websocket::message const & message_a, nano::json_writer & writer_a)
 {
 	// Common message information
-	message_a.contents.add ("topic", from_topic (message_a.topic));
-	message_a.contents.add ("time", std::to_string (nano::milliseconds_since_epoch ()));
+	writer_a.put ("topic", from_topic (message_a.topic));
+	writer_a.put ("time", std::to_string (nano::milliseconds_since_epoch ()));
 }
 
 std::string nano::websocket::message::to_string () const
 {
-	std::ostringstream ostream;
-	boost::property_tree::write_json (ostream, contents);
-	ostream.flush ();
-	return ostream.str ();
+	return contents;
+}
+
+nano::shared_const_buffer nano::websocket::message::to_buffer () const
+{
+	return nano::shared_const_buffer{ to_string () };
 }
 
 /*
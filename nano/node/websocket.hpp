@@ -1,6 +1,8 @@
 #pragma once
 
+#include <nano/lib/asio.hpp>
 #include <nano/lib/numbers.hpp>
+#include <nano/lib/numbers_templ.hpp>
 #include <nano/lib/work.hpp>
 #include <nano/node/endpoint.hpp>
 #include <nano/node/vote_with_weight_info.hpp>
@@ -12,6 +14,7 @@
 
 #include <deque>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -22,6 +25,7 @@ namespace nano
 class block;
 class election_status;
 enum class election_status_type : uint8_t;
+class json_writer;
 class ledger;
 class logger;
 class node_observers;
@@ -74,14 +78,33 @@ namespace websocket
 			topic (topic_a)
 		{
 		}
-		message (nano::websocket::topic topic_a, boost::property_tree::ptree & tree_a) :
-			topic (topic_a), contents (tree_a)
-		{
-		}
 
 		std::string to_string () const;
+		/** Serializes the contents into an immutable buffer which can be shared by all sessions the message is written to */
+		nano::shared_const_buffer to_buffer () const;
+
 		nano::websocket::topic topic;
-		boost::property_tree::ptree contents;
+		/** JSON document, written directly by the message builder without an intermediate ptree */
+		std::string contents;
+
+		/** Fields of a confirmation message needed for filtering, decoded once when the message is built */
+		struct confirmation_info
+		{
+			/** One of the confirmation_options::type_* flags, zero if unknown */
+			uint8_t type{ 0 };
+			nano::account account{};
+			/** Only set for state blocks when block contents are included */
+			std::optional<nano::account> destination;
+		};
+		std::optional<confirmation_info> confirmation;
+
+		/** Fields of a vote message needed for filtering, decoded once when the message is built */
+		struct vote_info
+		{
+			nano::account representative{};
+			nano::vote_code code;
+		};
+		std::optional<vote_info> vote;
 	};
 
 	/** Message builder. This is expanded with new builder functions are necessary. */
@@ -102,7 +125,7 @@ namespace websocket
 
 	private:
 		/** Set the common fields for messages: timestamp and topic. */
-		void set_common_fields (message & message_a);
+		void set_common_fields (message const & message_a, nano::json_writer & writer_a);
 	};
 
 	/** Options for subscriptions */
@@ -189,6 +212,27 @@ namespace websocket
 			return include_sideband_info;
 		}
 
+		/**
+		 * Returns a bitmask of the options affecting message contents.
+		 * Sessions with the same variant receive identical messages, which allows building and serializing them only once.
+		 */
+		uint8_t content_variant () const
+		{
+			return (include_block ? 1 : 0) | (include_election_info ? 2 : 0) | (include_election_info_with_votes ? 4 : 0) | (include_sideband_info ? 8 : 0);
+		}
+		static constexpr std::size_t content_variants = 16;
+
+		/** Returns true if only confirmations involving one of get_accounts () can pass the filter */
+		bool filters_by_accounts_only () const
+		{
+			return has_account_filtering_options && !all_local_accounts;
+		}
+
+		std::unordered_set<nano::account> const & get_accounts () const
+		{
+			return accounts;
+		}
+
 		static constexpr uint8_t const type_active_quorum = 1;
 		static constexpr uint8_t const type_active_confirmation_height = 2;
 		static constexpr uint8_t const type_inactive = 4;
@@ -208,7 +252,7 @@ namespace websocket
 		bool has_account_filtering_options{ false };
 		bool all_local_accounts{ false };
 		uint8_t confirmation_types{ type_all };
-		std::unordered_set<std::string> accounts;
+		std::unordered_set<nano::account> accounts;
 	};
 
 	/**
@@ -229,7 +273,7 @@ namespace websocket
 		bool should_filter (message const & message_a) const override;
 
 	private:
-		std::unordered_set<std::string> representatives;
+		std::unordered_set<nano::account> representatives;
 		bool include_replays{ false };
 		bool include_indeterminate{ false };
 	};
@@ -259,7 +303,7 @@ namespace websocket
 		void read ();
 
 		/** Enqueue \p message_a for writing to the websockets */
-		void write (nano::websocket::message message_a);
+		void write (nano::websocket::message const & message_a);
 
 	private:
 		/** The owning listener */
@@ -270,8 +314,8 @@ namespace websocket
 
 		/** Buffer for received messages */
 		boost::beast::multi_buffer read_buffer;
-		/** Outgoing messages. The send queue is protected by accessing it only through the strand */
-		std::deque<message> send_queue;
+		/** Outgoing serialized messages. The send queue is protected by accessing it only through the strand */
+		std::deque<nano::shared_const_buffer> send_queue;
 
 		/** Cache remote & local endpoints to make them available after the socket is closed */
 		socket_type::endpoint_type remote;
@@ -294,6 +338,10 @@ namespace websocket
 		void handle_message (boost::property_tree::ptree const & message_a);
 		/** Acknowledge incoming message */
 		void send_ack (std::string action_a, std::string id_a);
+		/** Returns true if the session subscribes to the message topic and the message is not filtered by the subscription options */
+		bool should_write (nano::websocket::message const & message_a);
+		/** Enqueue an already serialized message for writing */
+		void write (nano::shared_const_buffer const & buffer_a);
 		/** Send all queued messages. This must be called from the write strand. */
 		void write_queued_messages ();
 	};
@@ -315,8 +363,8 @@ namespace websocket
 		/** Broadcast block confirmation. The content of the message depends on subscription options (such as "include_block") */
 		void broadcast_confirmation (std::shared_ptr<nano::block> const & block_a, nano::account const & account_a, nano::amount const & amount_a, std::string const & subtype, nano::election_status const & election_status_a, std::vector<nano::vote_with_weight_info> const & election_votes_a);
 
-		/** Broadcast \p message to all session subscribing to the message topic. */
-		void broadcast (nano::websocket::message message_a);
+		/** Broadcast \p message to all session subscribing to the message topic. The message is serialized at most once. */
+		void broadcast (nano::websocket::message const & message_a);
 
 		std::uint16_t listening_port ()
 		{
@@ -341,6 +389,10 @@ namespace websocket
 		{
 			return topic_subscriber_count[static_cast<std::size_t> (topic_a)];
 		}
+		/** Number of confirmation subscriptions indexed by \p account_a */
+		std::size_t confirmation_indexed_count (nano::account const & account_a) const;
+		/** Number of confirmation subscriptions checked for every confirmation */
+		std::size_t confirmation_unindexed_count () const;
 
 	private:
 		/** A websocket session can increase and decrease subscription counts. */
@@ -351,6 +403,13 @@ namespace websocket
 		/** Removes from subscription count of a specific topic*/
 		void decrease_subscriber_count (nano::websocket::topic const & topic_a);
 
+		/** Adds a confirmation subscription to the routing index. Subscriptions filtering by explicit accounts only are indexed by those accounts. */
+		void index_confirmation_subscription (std::shared_ptr<session> const & session_a, nano::websocket::options const & options_a);
+		/** Removes a confirmation subscription from the routing index, \p options_a must be the same as when it was indexed */
+		void unindex_confirmation_subscription (session const & session_a, nano::websocket::options const & options_a);
+		/** Sessions that may be interested in a confirmation involving \p account_a or \p destination_a */
+		std::vector<std::shared_ptr<session>> confirmation_subscribers (nano::account const & account_a, std::optional<nano::account> const & destination_a);
+
 		nano::logger & logger;
 		nano::wallets & wallets;
 		boost::asio::ip::tcp::acceptor acceptor;
@@ -359,6 +418,13 @@ namespace websocket
 		std::vector<std::weak_ptr<session>> sessions;
 		std::array<std::atomic<std::size_t>, number_topics> topic_subscriber_count;
 		std::atomic<bool> stopped{ false };
+
+		using session_set = std::unordered_map<session const *, std::weak_ptr<session>>;
+		mutable nano::mutex confirmation_index_mutex;
+		/** Confirmation subscribers filtering by explicit accounts only, indexed by each of those accounts */
+		std::unordered_map<nano::account, session_set> confirmation_accounts_index;
+		/** Confirmation subscribers that have to be checked for every confirmation */
+		session_set confirmation_unindexed;
 	};
 }
 
@@ -1,29 +1,24 @@
 #include <nano/lib/asio.hpp>
 #include <nano/lib/json_error_response.hpp>
-#include <nano/lib/thread_roles.hpp>
 #include <nano/rpc/rpc_request_processor.hpp>
 
 #include <boost/endian/conversion.hpp>
 
+#include <algorithm>
+
 nano::rpc_request_processor::rpc_request_processor (boost::asio::io_context & io_ctx, nano::rpc_config & rpc_config, std::uint16_t ipc_port_a) :
+	io_ctx (io_ctx),
 	ipc_address (rpc_config.rpc_process.ipc_address),
 	ipc_port (ipc_port_a),
-	thread ([this] () {
-		nano::thread_role::set (nano::thread_role::name::rpc_request_processor);
-		this->run ();
-	})
-{
-	nano::lock_guard<nano::mutex> lk{ this->request_mutex };
-	this->connections.reserve (rpc_config.rpc_process.num_ipc_connections);
-	for (auto i = 0u; i < rpc_config.rpc_process.num_ipc_connections; ++i)
+	min_connections (std::max (rpc_config.rpc_process.num_ipc_connections, 1u)),
+	max_connections (std::max (rpc_config.rpc_process.max_ipc_connections, rpc_config.rpc_process.num_ipc_connections)),
+	pipeline_depth (std::max (rpc_config.rpc_process.ipc_pipeline_depth, 1u))
+{
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	connections.reserve (max_connections);
+	for (auto i = 0u; i < min_connections; ++i)
 	{
-		connections.push_back (std::make_shared<nano::ipc_connection> (nano::ipc::ipc_client (io_ctx), false));
-		auto connection = this->connections.back ();
-		connection->client.async_connect (ipc_address, ipc_port,
-		[connection] (nano::error err) {
-			// Even if there is an error this needs to be set so that another attempt can be made to connect with the ipc connection
-			connection->is_available = true;
-		});
+		connect (create_connection ());
 	}
 }
 
@@ -39,147 +34,270 @@ nano::rpc_request_processor::~rpc_request_processor ()
 
 void nano::rpc_request_processor::stop ()
 {
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	stopped = true;
+	requests.clear ();
+}
+
+void nano::rpc_request_processor::add (std::shared_ptr<rpc_request> const & request)
+{
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	if (!stopped)
 	{
-		nano::lock_guard<nano::mutex> lock{ request_mutex };
-		stopped = true;
+		requests.push_back (request);
+		dispatch ();
 	}
-	condition.notify_one ();
-	if (thread.joinable ())
+}
+
+std::size_t nano::rpc_request_processor::connection_count () const
+{
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	return connections.size ();
+}
+
+std::unordered_map<std::string, nano::rpc_request_processor::queue_time> nano::rpc_request_processor::queue_times () const
+{
+	nano::lock_guard<nano::mutex> lock{ mutex };
+	return queue_times_m;
+}
+
+// Hands queued requests to connections with spare pipeline capacity, must be called with the mutex held
+void nano::rpc_request_processor::dispatch ()
+{
+	while (!stopped && !requests.empty ())
 	{
-		thread.join ();
+		auto connection = select_connection ();
+		if (connection == nullptr)
+		{
+			// Every connection is at its pipeline depth, responses being read will dispatch the rest
+			break;
+		}
+		auto rpc_request = requests.front ();
+		requests.pop_front ();
+
+		// Requests requeued after a connection failure were already counted when first dispatched
+		if (!rpc_request->retried)
+		{
+			auto waited = std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - rpc_request->created);
+			auto & stats = queue_times_m[rpc_request->action.empty () ? "unknown" : rpc_request->action];
+			++stats.count;
+			stats.total += waited;
+			stats.max = std::max (stats.max, waited);
+		}
+
+		connection->in_flight.push_back (rpc_request);
+		switch (connection->status)
+		{
+			case nano::ipc_connection::state::disconnected:
+				connect (connection);
+				break;
+			case nano::ipc_connection::state::connecting:
+				// Written once the connection has been established
+				break;
+			case nano::ipc_connection::state::connected:
+				write (connection, rpc_request);
+				read_response (connection);
+				break;
+		}
 	}
 }
 
-void nano::rpc_request_processor::add (std::shared_ptr<rpc_request> const & request)
+std::shared_ptr<nano::ipc_connection> nano::rpc_request_processor::select_connection ()
 {
+	auto least_loaded = std::min_element (connections.begin (), connections.end (), [] (auto const & lhs, auto const & rhs) {
+		return lhs->in_flight.size () < rhs->in_flight.size ();
+	});
+	debug_assert (least_loaded != connections.end ());
+	if ((*least_loaded)->in_flight.empty ())
 	{
-		nano::lock_guard<nano::mutex> lk{ request_mutex };
-		requests.push_back (request);
+		return *least_loaded;
+	}
+	// Prefer opening another connection over pipelining behind requests which are already being processed
+	if (connections.size () < max_connections)
+	{
+		return create_connection ();
+	}
+	if ((*least_loaded)->in_flight.size () < pipeline_depth)
+	{
+		return *least_loaded;
 	}
-	condition.notify_one ();
+	return nullptr;
 }
 
-void nano::rpc_request_processor::read_payload (std::shared_ptr<nano::ipc_connection> const & connection, std::shared_ptr<std::vector<uint8_t>> const & res, std::shared_ptr<nano::rpc_request> const & rpc_request)
+std::shared_ptr<nano::ipc_connection> nano::rpc_request_processor::create_connection ()
 {
-	uint32_t payload_size_l = boost::endian::big_to_native (*reinterpret_cast<uint32_t *> (res->data ()));
-	res->resize (payload_size_l);
-	// Read JSON payload
-	connection->client.async_read (res, payload_size_l, [this, connection, res, rpc_request] (nano::error err_read_a, size_t size_read_a) {
-		// We need 2 sequential reads to get both the header and payload, so only allow other writes
-		// when they have both been read.
-		make_available (*connection);
-		if (!err_read_a && size_read_a != 0)
+	return connections.emplace_back (std::make_shared<nano::ipc_connection> (nano::ipc::ipc_client (io_ctx)));
+}
+
+void nano::rpc_request_processor::connect (std::shared_ptr<nano::ipc_connection> const & connection)
+{
+	connection->status = nano::ipc_connection::state::connecting;
+	auto generation = ++connection->generation;
+	connection->client.async_connect (ipc_address, ipc_port, [this, connection, generation] (nano::error err) {
+		failures_t failures;
 		{
-			rpc_request->response (std::string (res->begin (), res->end ()));
-			if (rpc_request->action == "stop")
+			nano::lock_guard<nano::mutex> lock{ mutex };
+			if (connection->generation != generation)
+			{
+				return;
+			}
+			if (!err)
+			{
+				connection->status = nano::ipc_connection::state::connected;
+				for (auto const & rpc_request : connection->in_flight)
+				{
+					write (connection, rpc_request);
+				}
+				read_response (connection);
+			}
+			else
 			{
-				this->stop_callback ();
+				connection_failed (connection, generation, "There is a problem connecting to the node. Make sure ipc->tcp is enabled in the node config, ipc ports match and ipc_address is the ip where the node is located", failures);
 			}
 		}
-		else
+		respond (failures);
+	});
+}
+
+void nano::rpc_request_processor::write (std::shared_ptr<nano::ipc_connection> const & connection, std::shared_ptr<nano::rpc_request> const & rpc_request)
+{
+	auto encoding (rpc_request->rpc_api_version == 1 ? nano::ipc::payload_encoding::json_v1 : nano::ipc::payload_encoding::flatbuffers_json);
+	auto req (nano::ipc::prepare_request (encoding, rpc_request->body));
+	connection->client.async_write (req, [this, connection, generation = connection->generation] (nano::error err_a, size_t size_a) {
+		if (err_a || size_a == 0)
 		{
-			json_error_response (rpc_request->response, "Failed to read payload");
+			failures_t failures;
+			{
+				nano::lock_guard<nano::mutex> lock{ mutex };
+				connection_failed (connection, generation, "Cannot write to the node", failures);
+			}
+			respond (failures);
 		}
 	});
 }
 
-void nano::rpc_request_processor::make_available (nano::ipc_connection & connection)
+// Reads the response for the oldest request in flight, responses arrive in the order the requests were written
+void nano::rpc_request_processor::read_response (std::shared_ptr<nano::ipc_connection> const & connection)
 {
-	connection.is_available = true; // Allow people to use it now
+	if (connection->reading || connection->in_flight.empty ())
+	{
+		return;
+	}
+	connection->reading = true;
+	auto res (std::make_shared<std::vector<uint8_t>> ());
+	// Read length
+	connection->client.async_read (res, sizeof (uint32_t), [this, connection, generation = connection->generation, res] (nano::error err_read_a, size_t size_read_a) {
+		if (size_read_a != 0 && !err_read_a)
+		{
+			this->read_payload (connection, generation, res);
+		}
+		else
+		{
+			failures_t failures;
+			{
+				nano::lock_guard<nano::mutex> lock{ mutex };
+				connection_failed (connection, generation, "Connection to node has failed", failures);
+			}
+			respond (failures);
+		}
+	});
 }
 
-// Connection does not exist or has been closed, try to connect to it again and then resend IPC request
-void nano::rpc_request_processor::try_reconnect_and_execute_request (std::shared_ptr<nano::ipc_connection> const & connection, nano::shared_const_buffer const & req, std::shared_ptr<std::vector<uint8_t>> const & res, std::shared_ptr<nano::rpc_request> const & rpc_request)
+void nano::rpc_request_processor::read_payload (std::shared_ptr<nano::ipc_connection> const & connection, uint64_t generation, std::shared_ptr<std::vector<uint8_t>> const & res)
 {
-	connection->client.async_connect (ipc_address, ipc_port, [this, connection, req, res, rpc_request] (nano::error err) {
-		if (!err)
+	uint32_t payload_size_l = boost::endian::big_to_native (*reinterpret_cast<uint32_t *> (res->data ()));
+	res->resize (payload_size_l);
+	// Read JSON payload
+	connection->client.async_read (res, payload_size_l, [this, connection, generation, res] (nano::error err_read_a, size_t size_read_a) {
+		if (!err_read_a && size_read_a != 0)
 		{
-			connection->client.async_write (req, [this, connection, res, rpc_request] (nano::error err_a, size_t size_a) {
-				if (size_a != 0 && !err_a)
-				{
-					// Read length
-					connection->client.async_read (res, sizeof (uint32_t), [this, connection, res, rpc_request] (nano::error err_read_a, size_t size_read_a) {
-						if (size_read_a != 0 && !err_read_a)
-						{
-							this->read_payload (connection, res, rpc_request);
-						}
-						else
-						{
-							json_error_response (rpc_request->response, "Connection to node has failed");
-							make_available (*connection);
-						}
-					});
-				}
-				else
-				{
-					json_error_response (rpc_request->response, "Cannot write to the node");
-					make_available (*connection);
-				}
-			});
+			this->response_received (connection, generation, res);
 		}
 		else
 		{
-			json_error_response (rpc_request->response, "There is a problem connecting to the node. Make sure ipc->tcp is enabled in the node config, ipc ports match and ipc_address is the ip where the node is located");
-			make_available (*connection);
+			failures_t failures;
+			{
+				nano::lock_guard<nano::mutex> lock{ mutex };
+				connection_failed (connection, generation, "Failed to read payload", failures);
+			}
+			respond (failures);
 		}
 	});
 }
 
-void nano::rpc_request_processor::run ()
+void nano::rpc_request_processor::response_received (std::shared_ptr<nano::ipc_connection> const & connection, uint64_t generation, std::shared_ptr<std::vector<uint8_t>> const & res)
 {
-	// This should be a conditioned wait
-	nano::unique_lock<nano::mutex> lk (request_mutex);
-	while (!stopped)
+	std::shared_ptr<nano::rpc_request> rpc_request;
 	{
-		if (!requests.empty ())
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		if (connection->generation != generation)
 		{
-			lk.unlock ();
-			nano::unique_lock<nano::mutex> conditions_lk (connections_mutex);
-			// Find the first free ipc_client
-			auto it = std::find_if (connections.begin (), connections.end (), [] (auto connection) -> bool {
-				return connection->is_available;
-			});
-
-			if (it != connections.cend ())
-			{
-				// Successfully found one
-				lk.lock ();
-				auto rpc_request = requests.front ();
-				requests.pop_front ();
-				lk.unlock ();
-				auto connection = *it;
-				connection->is_available = false; // Make sure no one else can take it
-				conditions_lk.unlock ();
-				auto encoding (rpc_request->rpc_api_version == 1 ? nano::ipc::payload_encoding::json_v1 : nano::ipc::payload_encoding::flatbuffers_json);
-				auto req (nano::ipc::prepare_request (encoding, rpc_request->body));
-				auto res (std::make_shared<std::vector<uint8_t>> ());
-
-				// Have we tried to connect yet?
-				connection->client.async_write (req, [this, connection, req, res, rpc_request] (nano::error err_a, size_t size_a) {
-					if (!err_a)
-					{
-						connection->client.async_read (res, sizeof (uint32_t), [this, connection, req, res, rpc_request] (nano::error err_read_a, size_t size_read_a) {
-							if (size_read_a != 0 && !err_read_a)
-							{
-								this->read_payload (connection, res, rpc_request);
-							}
-							else
-							{
-								this->try_reconnect_and_execute_request (connection, req, res, rpc_request);
-							}
-						});
-					}
-					else
-					{
-						try_reconnect_and_execute_request (connection, req, res, rpc_request);
-					}
-				});
-			}
-			lk.lock ();
+			return;
+		}
+		debug_assert (connection->reading && !connection->in_flight.empty ());
+		rpc_request = connection->in_flight.front ();
+		connection->in_flight.pop_front ();
+		connection->reading = false;
+		read_response (connection);
+		shrink (connection);
+		dispatch ();
+	}
+	rpc_request->response (std::string (res->begin (), res->end ()));
+	if (rpc_request->action == "stop")
+	{
+		this->stop_callback ();
+	}
+}
+
+// Requests in flight on a failed connection are resent once, requests which already have been are answered with \p message
+void nano::rpc_request_processor::connection_failed (std::shared_ptr<nano::ipc_connection> const & connection, uint64_t generation, char const * message, failures_t & failures)
+{
+	if (connection->generation != generation)
+	{
+		// Already handled, a write and a read on the same connection may both fail
+		return;
+	}
+	++connection->generation;
+	connection->status = nano::ipc_connection::state::disconnected;
+	connection->reading = false;
+	for (auto i = connection->in_flight.rbegin (), n = connection->in_flight.rend (); i != n; ++i)
+	{
+		auto const & rpc_request = *i;
+		if (!rpc_request->retried && !stopped)
+		{
+			rpc_request->retried = true;
+			requests.push_front (rpc_request);
 		}
 		else
 		{
-			condition.wait (lk);
+			failures.emplace_back (rpc_request, message);
 		}
 	}
+	connection->in_flight.clear ();
+	dispatch ();
+}
+
+// Closes \p connection if it is idle and the pool has grown beyond its minimum while other connections are idle as well
+void nano::rpc_request_processor::shrink (std::shared_ptr<nano::ipc_connection> const & connection)
+{
+	if (!connection->in_flight.empty () || connections.size () <= min_connections || !requests.empty ())
+	{
+		return;
+	}
+	auto other_idle = std::any_of (connections.begin (), connections.end (), [&connection] (auto const & other) {
+		return other != connection && other->in_flight.empty ();
+	});
+	if (other_idle)
+	{
+		++connection->generation;
+		std::erase (connections, connection);
+	}
+}
+
+void nano::rpc_request_processor::respond (failures_t const & failures)
+{
+	for (auto const & [rpc_request, message] : failures)
+	{
+		json_error_response (rpc_request->response, message);
+	}
 }
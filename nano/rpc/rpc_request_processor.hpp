@@ -1,24 +1,41 @@
 #pragma once
 
 #include <nano/lib/ipc_client.hpp>
+#include <nano/lib/locks.hpp>
 #include <nano/lib/rpc_handler_interface.hpp>
 #include <nano/lib/rpcconfig.hpp>
 #include <nano/rpc/rpc.hpp>
 
-#include <atomic>
+#include <chrono>
 #include <deque>
+#include <unordered_map>
+#include <vector>
 
 namespace nano
 {
+struct rpc_request;
+
 struct ipc_connection
 {
-	ipc_connection (nano::ipc::ipc_client && client_a, bool is_available_a) :
-		client (std::move (client_a)), is_available (is_available_a)
+	enum class state
+	{
+		disconnected,
+		connecting,
+		connected
+	};
+
+	explicit ipc_connection (nano::ipc::ipc_client && client_a) :
+		client (std::move (client_a))
 	{
 	}
 
 	nano::ipc::ipc_client client;
-	std::atomic<bool> is_available{ false };
+	state status{ state::disconnected };
+	/** Incremented on every connection attempt so completions from a previous socket can be recognized */
+	uint64_t generation{ 0 };
+	/** Requests written (or waiting to be written) to this connection, the node answers them in order */
+	std::deque<std::shared_ptr<nano::rpc_request>> in_flight;
+	bool reading{ false };
 };
 
 struct rpc_request
@@ -42,33 +59,63 @@ struct rpc_request
 	std::string action;
 	std::string body;
 	std::function<void (std::string const &)> response;
+	std::chrono::steady_clock::time_point const created{ std::chrono::steady_clock::now () };
+	/** Requests are resent once on a new connection if the connection they were written to fails */
+	bool retried{ false };
 };
 
+/**
+ * Forwards RPC requests to the node over a pool of IPC connections.
+ * Requests are dispatched as they arrive to the least loaded connection and pipelined up to ipc_pipeline_depth per connection.
+ * The pool grows up to max_ipc_connections while all connections are busy and shrinks back to num_ipc_connections when idle.
+ */
 class rpc_request_processor
 {
 public:
+	/** Time requests for an action spent waiting for a connection */
+	class queue_time final
+	{
+	public:
+		uint64_t count{ 0 };
+		std::chrono::microseconds total{ 0 };
+		std::chrono::microseconds max{ 0 };
+	};
+
 	rpc_request_processor (boost::asio::io_context & io_ctx, nano::rpc_config & rpc_config);
 	rpc_request_processor (boost::asio::io_context & io_ctx, nano::rpc_config & rpc_config, std::uint16_t ipc_port_a);
 	~rpc_request_processor ();
 	void stop ();
 	void add (std::shared_ptr<rpc_request> const & request);
+	std::size_t connection_count () const;
+	std::unordered_map<std::string, queue_time> queue_times () const;
 	std::function<void ()> stop_callback;
 
 private:
-	void run ();
-	void read_payload (std::shared_ptr<nano::ipc_connection> const & connection, std::shared_ptr<std::vector<uint8_t>> const & res, std::shared_ptr<nano::rpc_request> const & rpc_request);
-	void try_reconnect_and_execute_request (std::shared_ptr<nano::ipc_connection> const & connection, nano::shared_const_buffer const & req, std::shared_ptr<std::vector<uint8_t>> const & res, std::shared_ptr<nano::rpc_request> const & rpc_request);
-	void make_available (nano::ipc_connection & connection);
-
+	using failures_t = std::vector<std::pair<std::shared_ptr<nano::rpc_request>, char const *>>;
+
+	void dispatch ();
+	std::shared_ptr<nano::ipc_connection> select_connection ();
+	std::shared_ptr<nano::ipc_connection> create_connection ();
+	void connect (std::shared_ptr<nano::ipc_connection> const & connection);
+	void write (std::shared_ptr<nano::ipc_connection> const & connection, std::shared_ptr<nano::rpc_request> const & rpc_request);
+	void read_response (std::shared_ptr<nano::ipc_connection> const & connection);
+	void read_payload (std::shared_ptr<nano::ipc_connection> const & connection, uint64_t generation, std::shared_ptr<std::vector<uint8_t>> const & res);
+	void response_received (std::shared_ptr<nano::ipc_connection> const & connection, uint64_t generation, std::shared_ptr<std::vector<uint8_t>> const & res);
+	void connection_failed (std::shared_ptr<nano::ipc_connection> const & connection, uint64_t generation, char const * message, failures_t & failures);
+	void shrink (std::shared_ptr<nano::ipc_connection> const & connection);
+	static void respond (failures_t const & failures);
+
+	boost::asio::io_context & io_ctx;
 	std::vector<std::shared_ptr<nano::ipc_connection>> connections;
-	nano::mutex request_mutex;
-	nano::mutex connections_mutex;
+	mutable nano::mutex mutex;
 	bool stopped{ false };
 	std::deque<std::shared_ptr<nano::rpc_request>> requests;
-	nano::condition_variable condition;
+	std::unordered_map<std::string, queue_time> queue_times_m;
 	std::string const ipc_address;
 	uint16_t const ipc_port;
-	std::thread thread;
+	std::size_t const min_connections;
+	std::size_t const max_connections;
+	std::size_t const pipeline_depth;
 };
 
 class ipc_rpc_processor final : public nano::rpc_handler_interface
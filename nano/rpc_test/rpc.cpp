@@ -4121,6 +4121,145 @@ TEST (rpc, blocks_info_receive_hash)
 	ASSERT_EQ (send_recv_map.size (), 0);
 }
 
+// Streamed responses of all streaming handlers are valid JSON, formatted the same as write_json formats them
+TEST (rpc, blocks_info_streamed_format)
+{
+	nano::test::system system;
+	auto & node = *add_ipc_enabled_node (system);
+	nano::node_rpc_config node_rpc_config;
+	auto legacy_account = nano::dev::genesis_key.pub.to_account ();
+	legacy_account.replace (0, 5, "xrb-");
+	std::vector<std::string> requests{
+		R"({"action": "blocks_info", "json_block": "true", "include_not_found": "true", "hashes": [")" + nano::dev::genesis->hash ().to_string () + R"(", ")" + nano::block_hash{ 1 }.to_string () + R"("]})",
+		R"({"action": "blocks_info", "source": "true", "receivable": "true", "receive_hash": "true", "hashes": [")" + nano::dev::genesis->hash ().to_string () + R"("]})",
+		R"({"action": "accounts_balances", "accounts": [")" + legacy_account + R"(", "bad", ")" + nano::dev::genesis_key.pub.to_account () + R"(", ")" + nano::dev::genesis_key.pub.to_account () + R"("]})",
+		R"({"action": "history", "hash": ")" + nano::dev::genesis->hash ().to_string () + R"(", "count": "10"})",
+		R"({"action": "account_history", "raw": "true", "account": ")" + nano::dev::genesis_key.pub.to_account () + R"(", "count": "10"})",
+		R"({"action": "pending", "account": ")" + nano::dev::genesis_key.pub.to_account () + R"("})",
+		R"({"action": "receivable", "source": "true", "sorting": "true", "account": ")" + nano::dev::genesis_key.pub.to_account () + R"("})"
+	};
+	for (auto const & request : requests)
+	{
+		std::string response;
+		auto handler (std::make_shared<nano::json_handler> (node, node_rpc_config, request, [&response] (std::string const & response_a) {
+			response = response_a;
+		}));
+		handler->process_request ();
+		ASSERT_FALSE (response.empty ()) << request;
+		std::stringstream istream (response);
+		boost::property_tree::ptree tree;
+		ASSERT_NO_THROW (boost::property_tree::read_json (istream, tree));
+		ASSERT_EQ (0, tree.count ("error")) << response;
+		std::stringstream ostream;
+		boost::property_tree::write_json (ostream, tree);
+		ASSERT_EQ (ostream.str (), response);
+	}
+}
+
+// Streamed responses must match the responses of the previous handlers, which built a ptree and wrote it with write_json
+TEST (rpc, streamed_responses_match_ptree)
+{
+	nano::test::system system;
+	auto & node = *add_ipc_enabled_node (system);
+	nano::node_rpc_config node_rpc_config;
+	nano::keypair key;
+	auto send = nano::state_block_builder ()
+				.account (nano::dev::genesis_key.pub)
+				.previous (nano::dev::genesis->hash ())
+				.representative (nano::dev::genesis_key.pub)
+				.link (key.pub)
+				.balance (nano::dev::constants.genesis_amount - nano::Knano_ratio)
+				.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				.work (*system.work.generate (nano::dev::genesis->hash ()))
+				.build ();
+	ASSERT_EQ (nano::block_status::progress, node.process (send));
+	nano::test::confirm (node.ledger, send);
+
+	auto call = [&] (std::string const & request) {
+		std::string response;
+		auto handler (std::make_shared<nano::json_handler> (node, node_rpc_config, request, [&response] (std::string const & response_a) {
+			response = response_a;
+		}));
+		handler->process_request ();
+		return response;
+	};
+	auto to_json = [] (boost::property_tree::ptree const & tree) {
+		std::stringstream ostream;
+		boost::property_tree::write_json (ostream, tree);
+		return ostream.str ();
+	};
+
+	// blocks_info
+	{
+		boost::property_tree::ptree entry;
+		entry.put ("block_account", nano::dev::genesis_key.pub.to_account ());
+		entry.put ("amount", nano::Knano_ratio.convert_to<std::string> ());
+		entry.put ("balance", send->balance ().number ().convert_to<std::string> ());
+		entry.put ("height", std::to_string (send->sideband ().height));
+		entry.put ("local_timestamp", std::to_string (send->sideband ().timestamp));
+		entry.put ("successor", send->sideband ().successor.to_string ());
+		entry.put ("confirmed", true);
+		boost::property_tree::ptree contents;
+		send->serialize_json (contents);
+		entry.add_child ("contents", contents);
+		entry.put ("subtype", "send");
+		entry.put ("pending", "1");
+		entry.put ("receivable", "1");
+		entry.put ("receive_hash", nano::block_hash (0).to_string ());
+		entry.put ("source_account", "0");
+		boost::property_tree::ptree blocks;
+		blocks.push_back (std::make_pair (send->hash ().to_string (), entry));
+		boost::property_tree::ptree not_found_entry;
+		not_found_entry.put ("", nano::block_hash{ 1 }.to_string ());
+		boost::property_tree::ptree blocks_not_found;
+		blocks_not_found.push_back (std::make_pair ("", not_found_entry));
+		boost::property_tree::ptree expected;
+		expected.add_child ("blocks", blocks);
+		expected.add_child ("blocks_not_found", blocks_not_found);
+		ASSERT_EQ (to_json (expected), call (R"({"action": "blocks_info", "json_block": "true", "include_not_found": "true", "source": "true", "receivable": "true", "receive_hash": "true", "hashes": [")" + send->hash ().to_string () + R"(", ")" + nano::block_hash{ 1 }.to_string () + R"("]})"));
+	}
+
+	// accounts_balances, repeated accounts keep the position of their first occurrence
+	{
+		auto balance_entry = [] (nano::uint128_t const & balance, nano::uint128_t const & receivable) {
+			boost::property_tree::ptree entry;
+			entry.put ("balance", balance.convert_to<std::string> ());
+			entry.put ("pending", receivable.convert_to<std::string> ());
+			entry.put ("receivable", receivable.convert_to<std::string> ());
+			return entry;
+		};
+		boost::property_tree::ptree balances;
+		balances.put_child (nano::dev::genesis_key.pub.to_account (), balance_entry (nano::dev::constants.genesis_amount - nano::Knano_ratio, 0));
+		balances.put_child (key.pub.to_account (), balance_entry (0, nano::Knano_ratio));
+		boost::property_tree::ptree errors;
+		errors.put ("bad", std::error_code (nano::error_common::bad_account_number).message ());
+		boost::property_tree::ptree expected;
+		expected.add_child ("balances", balances);
+		expected.add_child ("errors", errors);
+		ASSERT_EQ (to_json (expected), call (R"({"action": "accounts_balances", "accounts": [")" + nano::dev::genesis_key.pub.to_account () + R"(", "bad", ")" + key.pub.to_account () + R"(", ")" + nano::dev::genesis_key.pub.to_account () + R"("]})"));
+	}
+
+	// receivable, as a list of hashes and with the amount and source of each block
+	{
+		boost::property_tree::ptree hash_entry;
+		hash_entry.put ("", send->hash ().to_string ());
+		boost::property_tree::ptree hashes;
+		hashes.push_back (std::make_pair ("", hash_entry));
+		boost::property_tree::ptree expected;
+		expected.add_child ("blocks", hashes);
+		ASSERT_EQ (to_json (expected), call (R"({"action": "receivable", "account": ")" + key.pub.to_account () + R"("})"));
+
+		boost::property_tree::ptree pending_tree;
+		pending_tree.put ("amount", nano::Knano_ratio.convert_to<std::string> ());
+		pending_tree.put ("source", nano::dev::genesis_key.pub.to_account ());
+		boost::property_tree::ptree blocks;
+		blocks.add_child (send->hash ().to_string (), pending_tree);
+		boost::property_tree::ptree expected_source;
+		expected_source.add_child ("blocks", blocks);
+		ASSERT_EQ (to_json (expected_source), call (R"({"action": "receivable", "source": "true", "account": ")" + key.pub.to_account () + R"("})"));
+	}
+}
+
 TEST (rpc, blocks_info_subtype)
 {
 	nano::test::system system;
@@ -6049,6 +6188,57 @@ TEST (rpc, simultaneous_calls)
 	}
 }
 
+// Requests arriving faster than a single IPC connection answers them grow the connection pool, which shrinks back once idle
+TEST (rpc, ipc_connection_pool)
+{
+	nano::test::system system;
+	auto node = add_ipc_enabled_node (system);
+
+	nano::node_rpc_config node_rpc_config;
+	nano::ipc::ipc_server ipc_server (*node, node_rpc_config);
+	nano::rpc_config rpc_config{ nano::dev::network_params.network, system.get_available_port (), true };
+	const auto ipc_tcp_port = ipc_server.listening_tcp_port ();
+	ASSERT_TRUE (ipc_tcp_port.has_value ());
+	rpc_config.rpc_process.num_ipc_connections = 1;
+	rpc_config.rpc_process.max_ipc_connections = 4;
+	rpc_config.rpc_process.ipc_pipeline_depth = 2;
+	nano::rpc_request_processor processor (*system.io_ctx, rpc_config, ipc_tcp_port.value ());
+	ASSERT_EQ (1, processor.connection_count ());
+
+	boost::property_tree::ptree request;
+	request.put ("action", "account_block_count");
+	request.put ("account", nano::dev::genesis_key.pub.to_account ());
+	std::stringstream ostream;
+	boost::property_tree::write_json (ostream, request);
+
+	constexpr auto num = 50;
+	std::atomic<int> responses{ 0 };
+	std::atomic<int> errors{ 0 };
+	for (int i = 0; i < num; ++i)
+	{
+		processor.add (std::make_shared<nano::rpc_request> ("account_block_count", ostream.str (), [&responses, &errors] (std::string const & response_a) {
+			std::stringstream istream (response_a);
+			boost::property_tree::ptree json;
+			boost::property_tree::read_json (istream, json);
+			if (json.get<std::string> ("block_count", "") != "1")
+			{
+				++errors;
+			}
+			++responses;
+		}));
+	}
+	ASSERT_LE (processor.connection_count (), 4);
+	ASSERT_TIMELY_EQ (10s, responses, num);
+	ASSERT_EQ (0, errors);
+	ASSERT_TIMELY_EQ (5s, processor.connection_count (), 1);
+
+	auto queue_times = processor.queue_times ();
+	ASSERT_EQ (1, queue_times.size ());
+	ASSERT_EQ (num, queue_times["account_block_count"].count);
+	ASSERT_GE (queue_times["account_block_count"].total, queue_times["account_block_count"].max);
+	processor.stop ();
+}
+
 // This tests that the inprocess RPC (i.e without using IPC) works correctly
 TEST (rpc, in_process)
 {
@@ -0,0 +1,205 @@
+#include <nano/lib/blockbuilders.hpp>
+#include <nano/lib/blocks.hpp>
+#include <nano/lib/work.hpp>
+#include <nano/secure/block_corpus.hpp>
+#include <nano/secure/common.hpp>
+
+#include <array>
+#include <fstream>
+
+namespace
+{
+std::array<uint8_t, 8> constexpr corpus_magic{ 'n', 'a', 'n', 'o', 'c', 'o', 'r', 'p' };
+// Magic, version, genesis hash, seed, four topology fields and the two block counts
+std::size_t constexpr corpus_header_size = sizeof (corpus_magic) + sizeof (uint8_t) + 2 * sizeof (nano::uint256_union) + 4 * sizeof (uint32_t) + 2 * sizeof (uint64_t);
+// Chunk written to the file at once, progress is reported per chunk
+std::size_t constexpr corpus_chunk_size = 1024 * 1024;
+
+class corpus_account final
+{
+public:
+	nano::keypair key;
+	nano::block_hash frontier{ 0 };
+	nano::uint128_t balance{ 0 };
+	// Previous and link of the frontier block, a fork is the frontier block with a different representative
+	nano::block_hash previous{ 0 };
+	nano::link link{ 0 };
+};
+}
+
+uint64_t nano::block_corpus_topology::block_count () const
+{
+	// A send from genesis and an open per account, followed by a send and a receive per account and round
+	return 2 * uint64_t{ accounts } * (1 + uint64_t{ depth });
+}
+
+bool nano::generate_block_corpus (std::filesystem::path const & path, nano::block_corpus_topology const & topology, nano::work_pool & work, std::function<void (uint64_t generated, uint64_t total)> const & progress)
+{
+	std::ofstream file (path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		return true;
+	}
+	uint64_t const fork_count = std::min (topology.forks, topology.accounts);
+	uint64_t const total = topology.block_count () + fork_count;
+	uint64_t generated{ 0 };
+	std::vector<uint8_t> buffer;
+	auto flush = [&] () {
+		file.write (reinterpret_cast<char const *> (buffer.data ()), buffer.size ());
+		buffer.clear ();
+		if (progress)
+		{
+			progress (generated, total);
+		}
+	};
+	{
+		nano::vectorstream stream (buffer);
+		nano::write (stream, corpus_magic);
+		nano::write (stream, nano::block_corpus::version);
+		nano::write (stream, nano::dev::genesis->hash ().bytes);
+		nano::write (stream, topology.seed.bytes);
+		nano::write_big_endian (stream, topology.accounts);
+		nano::write_big_endian (stream, topology.depth);
+		nano::write_big_endian (stream, topology.fanout);
+		nano::write_big_endian (stream, topology.forks);
+		nano::write_big_endian (stream, topology.block_count ());
+		nano::write_big_endian (stream, fork_count);
+	}
+
+	nano::state_block_builder builder;
+	bool error (false);
+	// Appends the next block of \p account, advancing its frontier
+	auto append = [&] (corpus_account & account, nano::account const & representative, nano::link const & link, nano::uint128_t const & balance) -> std::shared_ptr<nano::block> {
+		auto work_l = work.generate (account.frontier.is_zero () ? nano::root{ account.key.pub } : nano::root{ account.frontier });
+		if (!work_l)
+		{
+			// Work generation was cancelled
+			error = true;
+			return nullptr;
+		}
+		auto block = builder.make_block ()
+					 .account (account.key.pub)
+					 .previous (account.frontier)
+					 .representative (representative)
+					 .link (link)
+					 .balance (balance)
+					 .sign (account.key.prv, account.key.pub)
+					 .work (*work_l)
+					 .build ();
+		account.previous = account.frontier;
+		account.link = link;
+		account.frontier = block->hash ();
+		account.balance = balance;
+		{
+			nano::vectorstream stream (buffer);
+			nano::serialize_block (stream, *block);
+		}
+		++generated;
+		if (buffer.size () >= corpus_chunk_size)
+		{
+			flush ();
+		}
+		return block;
+	};
+
+	corpus_account genesis{ nano::dev::genesis_key, nano::dev::genesis->hash (), nano::dev::constants.genesis_amount };
+	std::vector<corpus_account> accounts;
+	accounts.reserve (topology.accounts);
+	for (uint32_t i = 0; i < topology.accounts; ++i)
+	{
+		accounts.push_back ({ nano::keypair{ nano::deterministic_key (topology.seed, i) } });
+	}
+	for (auto i = accounts.begin (), n = accounts.end (); i != n && !error; ++i)
+	{
+		auto send = append (genesis, genesis.key.pub, i->key.pub, genesis.balance - nano::nano_ratio);
+		if (send)
+		{
+			append (*i, i->key.pub, send->hash (), nano::nano_ratio);
+		}
+	}
+	auto const fanout = std::max (topology.fanout, 1u);
+	for (uint32_t round = 0; round < topology.depth && !error; ++round)
+	{
+		for (std::size_t i = 0; i < accounts.size () && !error; ++i)
+		{
+			auto & source = accounts[i];
+			auto & destination = accounts[(i + 1 + round % fanout) % accounts.size ()];
+			auto send = append (source, source.key.pub, destination.key.pub, source.balance - 1);
+			if (send)
+			{
+				append (destination, destination.key.pub, send->hash (), destination.balance + 1);
+			}
+		}
+	}
+	for (uint64_t i = 0; i < fork_count && !error; ++i)
+	{
+		// Rebuilds the frontier block on a copy of the account, voting for genesis instead of itself
+		auto fork = accounts[i];
+		fork.frontier = fork.previous;
+		append (fork, nano::dev::genesis_key.pub, fork.link, fork.balance);
+	}
+	if (!error)
+	{
+		flush ();
+		file.close ();
+		error = !file;
+	}
+	return error;
+}
+
+nano::block_corpus::block_corpus (std::filesystem::path const & path) :
+	file{ path.string () }
+{
+	if (file.size () < corpus_header_size)
+	{
+		throw std::runtime_error ("Corpus is truncated: " + path.string ());
+	}
+	stream = std::make_unique<nano::bufferstream> (reinterpret_cast<uint8_t const *> (file.data ()), file.size ());
+	std::array<uint8_t, 8> magic;
+	uint8_t version_l;
+	nano::block_hash genesis;
+	nano::read (*stream, magic);
+	nano::read (*stream, version_l);
+	nano::read (*stream, genesis.bytes);
+	if (magic != corpus_magic || version_l != version)
+	{
+		throw std::runtime_error ("Not a block corpus of a supported version: " + path.string ());
+	}
+	if (genesis != nano::dev::genesis->hash ())
+	{
+		throw std::runtime_error ("Corpus was generated for a different genesis: " + path.string ());
+	}
+	nano::read (*stream, topology.seed.bytes);
+	nano::read_big_endian (*stream, topology.accounts);
+	nano::read_big_endian (*stream, topology.depth);
+	nano::read_big_endian (*stream, topology.fanout);
+	nano::read_big_endian (*stream, topology.forks);
+	nano::read_big_endian (*stream, block_count);
+	nano::read_big_endian (*stream, fork_count);
+}
+
+std::shared_ptr<nano::block> nano::block_corpus::next ()
+{
+	if (read >= block_count + fork_count)
+	{
+		return nullptr;
+	}
+	auto block = nano::deserialize_block (*stream);
+	if (block == nullptr)
+	{
+		throw std::runtime_error ("Corpus is truncated");
+	}
+	++read;
+	return block;
+}
+
+void nano::block_corpus::rewind ()
+{
+	stream = std::make_unique<nano::bufferstream> (reinterpret_cast<uint8_t const *> (file.data ()) + corpus_header_size, file.size () - corpus_header_size);
+	read = 0;
+}
+
+uint64_t nano::block_corpus::position () const
+{
+	return read;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+#include <nano/lib/stream.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+
+namespace nano
+{
+class block;
+class work_pool;
+
+/** Shape of the ledger generated into a block corpus */
+class block_corpus_topology final
+{
+public:
+	/** Seed the keys of all accounts are derived from */
+	nano::raw_key seed{ 0 };
+	/** Number of accounts opened by sends from the dev genesis account */
+	uint32_t accounts{ 1000 };
+	/** Number of rounds after opening in which each account sends to another account which immediately receives */
+	uint32_t depth{ 0 };
+	/** Number of distinct accounts each account sends to in turn */
+	uint32_t fanout{ 1 };
+	/** Number of accounts for which a block competing with their frontier is generated */
+	uint32_t forks{ 0 };
+
+	/** Number of blocks in processing order, not including forks */
+	uint64_t block_count () const;
+};
+
+/**
+ * Generates the blocks of \p topology on top of the dev genesis and writes them to \p path.
+ * Blocks are written in an order in which they can be processed, followed by the forks.
+ * All blocks are signed and carry work for the base threshold, generating a corpus once makes large scenarios cheap to set up.
+ * @returns true on error
+ */
+bool generate_block_corpus (std::filesystem::path const & path, nano::block_corpus_topology const & topology, nano::work_pool & work, std::function<void (uint64_t generated, uint64_t total)> const & progress = nullptr);
+
+/**
+ * Streams the blocks of a corpus file from a read only memory mapping, only the block currently read is held in memory
+ */
+class block_corpus final
+{
+public:
+	/** Throws std::runtime_error if \p path is not a corpus built on the dev genesis */
+	explicit block_corpus (std::filesystem::path const & path);
+
+	/** Next block in processing order, followed by the forks. Returns nullptr once all blocks have been read */
+	std::shared_ptr<nano::block> next ();
+	/** Continues reading from the first block */
+	void rewind ();
+	/** Number of blocks including forks read so far */
+	uint64_t position () const;
+
+	nano::block_corpus_topology topology;
+	uint64_t block_count{ 0 };
+	uint64_t fork_count{ 0 };
+
+private:
+	boost::iostreams::mapped_file_source file;
+	std::unique_ptr<nano::bufferstream> stream;
+	uint64_t read{ 0 };
+
+public:
+	static uint8_t constexpr version{ 1 };
+};
+}
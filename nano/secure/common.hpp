@@ -210,6 +210,8 @@ public:
 	std::chrono::seconds search_pending_interval;
 	std::chrono::minutes unchecked_cleaning_interval;
 	std::chrono::milliseconds process_confirmed_interval;
+	/** Time between ledger cache snapshots, these are only used at startup if the database has not been written since */
+	std::chrono::minutes ledger_cache_snapshot_interval;
 
 	/** Time between collecting online representative samples */
 	std::chrono::seconds weight_interval;
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <filesystem>
+#include <functional>
+#include <string_view>
+
 namespace nano
 {
 /* Holds flags for various cacheable data. For most CLI operations caching is unnecessary
@@ -12,6 +16,14 @@ public:
 	bool unchecked_count = true;
 	bool account_count = true;
 	bool block_count = true;
+	/** Sums of receivable amounts per account, off by default as it holds an entry for every account with receivable blocks */
+	bool receivable = false;
+	/** Number of threads used to generate the caches, 0 selects a count based on hardware concurrency */
+	unsigned threads = 0;
+	/** Snapshot file the caches are loaded from when it matches the database, the caches are only generated when it does not. Empty disables snapshots */
+	std::filesystem::path snapshot;
+	/** Called from the generating threads after each range of a table was traversed, with the number of completed and total ranges */
+	std::function<void (std::string_view table, std::size_t completed, std::size_t total)> progress;
 
 	void enable_all ();
 };
@@ -1,3 +1,4 @@
+#include <nano/crypto/blake2/blake2.h>
 #include <nano/lib/block_type.hpp>
 #include <nano/lib/blocks.hpp>
 #include <nano/lib/files.hpp>
@@ -11,6 +12,7 @@
 #include <nano/secure/ledger.hpp>
 #include <nano/secure/ledger_set_any.hpp>
 #include <nano/secure/ledger_set_confirmed.hpp>
+#include <nano/secure/parallel_traversal.hpp>
 #include <nano/secure/rep_weights.hpp>
 #include <nano/store/account.hpp>
 #include <nano/store/block.hpp>
@@ -22,8 +24,13 @@
 #include <nano/store/pending.hpp>
 #include <nano/store/pruned.hpp>
 #include <nano/store/rep_weight.hpp>
+#include <nano/store/rocksdb/db_val.hpp>
+#include <nano/store/rocksdb/rocksdb.hpp>
 #include <nano/store/version.hpp>
 
+#include <boost/property_tree/json_parser.hpp>
+
+#include <fstream>
 #include <stack>
 
 #include <cryptopp/words.h>
@@ -57,7 +64,7 @@ public:
 		{
 			auto info = ledger.any.account_get (transaction, pending.value ().source);
 			debug_assert (info);
-			ledger.store.pending.del (transaction, key);
+			ledger.pending_del (transaction, key);
 			ledger.cache.rep_weights.representation_add (transaction, info->representative, pending.value ().amount.number ());
 			nano::account_info new_info (block_a.hashables.previous, info->representative, info->open_block, ledger.any.block_balance (transaction, block_a.hashables.previous).value (), nano::seconds_since_epoch (), info->block_count - 1, nano::epoch::epoch_0);
 			ledger.update_account (transaction, pending.value ().source, *info, new_info);
@@ -79,7 +86,7 @@ public:
 		nano::account_info new_info (block_a.hashables.previous, info->representative, info->open_block, ledger.any.block_balance (transaction, block_a.hashables.previous).value (), nano::seconds_since_epoch (), info->block_count - 1, nano::epoch::epoch_0);
 		ledger.update_account (transaction, destination_account, *info, new_info);
 		ledger.store.block.del (transaction, hash);
-		ledger.store.pending.put (transaction, nano::pending_key (destination_account, block_a.hashables.source), { source_account.value_or (0), amount, nano::epoch::epoch_0 });
+		ledger.pending_put (transaction, nano::pending_key (destination_account, block_a.hashables.source), { source_account.value_or (0), amount, nano::epoch::epoch_0 });
 		ledger.store.block.successor_clear (transaction, block_a.hashables.previous);
 		ledger.stats.inc (nano::stat::type::rollback, nano::stat::detail::receive);
 	}
@@ -93,7 +100,7 @@ public:
 		nano::account_info new_info;
 		ledger.update_account (transaction, destination_account, new_info, new_info);
 		ledger.store.block.del (transaction, hash);
-		ledger.store.pending.put (transaction, nano::pending_key (destination_account, block_a.hashables.source), { source_account.value_or (0), amount, nano::epoch::epoch_0 });
+		ledger.pending_put (transaction, nano::pending_key (destination_account, block_a.hashables.source), { source_account.value_or (0), amount, nano::epoch::epoch_0 });
 		ledger.stats.inc (nano::stat::type::rollback, nano::stat::detail::open);
 	}
 	void change_block (nano::change_block const & block_a) override
@@ -149,7 +156,7 @@ public:
 			{
 				error = ledger.rollback (transaction, ledger.any.account_head (transaction, block_a.hashables.link.as_account ()), list);
 			}
-			ledger.store.pending.del (transaction, key);
+			ledger.pending_del (transaction, key);
 			ledger.stats.inc (nano::stat::type::rollback, nano::stat::detail::send);
 		}
 		else if (!block_a.hashables.link.is_zero () && !ledger.is_epoch_link (block_a.hashables.link))
@@ -157,7 +164,7 @@ public:
 			// Pending account entry can be incorrect if source block was pruned. But it's not affecting correct ledger processing
 			auto source_account = ledger.any.block_account (transaction, block_a.hashables.link.as_block_hash ());
 			nano::pending_info pending_info (source_account.value_or (0), block_a.hashables.balance.number () - balance, block_a.sideband ().source_epoch);
-			ledger.store.pending.put (transaction, nano::pending_key (block_a.hashables.account, block_a.hashables.link.as_block_hash ()), pending_info);
+			ledger.pending_put (transaction, nano::pending_key (block_a.hashables.account, block_a.hashables.link.as_block_hash ()), pending_info);
 			ledger.stats.inc (nano::stat::type::rollback, nano::stat::detail::receive);
 		}
 
@@ -354,11 +361,11 @@ void ledger_processor::state_block_impl (nano::state_block & block_a)
 						{
 							nano::pending_key key (block_a.hashables.link.as_account (), hash);
 							nano::pending_info info (block_a.hashables.account, amount.number (), epoch);
-							ledger.store.pending.put (transaction, key, info);
+							ledger.pending_put (transaction, key, info);
 						}
 						else if (!block_a.hashables.link.is_zero ())
 						{
-							ledger.store.pending.del (transaction, nano::pending_key (block_a.hashables.account, block_a.hashables.link.as_block_hash ()));
+							ledger.pending_del (transaction, nano::pending_key (block_a.hashables.account, block_a.hashables.link.as_block_hash ()));
 						}
 
 						nano::account_info new_info (hash, block_a.hashables.representative, info.open_block.is_zero () ? hash : info.open_block, block_a.hashables.balance, nano::seconds_since_epoch (), info.block_count + 1, epoch);
@@ -520,7 +527,7 @@ void ledger_processor::send_block (nano::send_block & block_a)
 								ledger.store.block.put (transaction, hash, block_a);
 								nano::account_info new_info (hash, info->representative, info->open_block, block_a.hashables.balance, nano::seconds_since_epoch (), info->block_count + 1, nano::epoch::epoch_0);
 								ledger.update_account (transaction, account, *info, new_info);
-								ledger.store.pending.put (transaction, nano::pending_key (block_a.hashables.destination, hash), { account, amount, nano::epoch::epoch_0 });
+								ledger.pending_put (transaction, nano::pending_key (block_a.hashables.destination, hash), { account, amount, nano::epoch::epoch_0 });
 								ledger.stats.inc (nano::stat::type::ledger, nano::stat::detail::send);
 							}
 						}
@@ -574,7 +581,7 @@ void ledger_processor::receive_block (nano::receive_block & block_a)
 										if (result == nano::block_status::progress)
 										{
 											auto new_balance (info->balance.number () + pending.value ().amount.number ());
-											ledger.store.pending.del (transaction, key);
+											ledger.pending_del (transaction, key);
 											block_a.sideband_set (nano::block_sideband (account, 0, new_balance, info->block_count + 1, nano::seconds_since_epoch (), block_details, nano::epoch::epoch_0 /* unused */));
 											ledger.store.block.put (transaction, hash, block_a);
 											nano::account_info new_info (hash, info->representative, info->open_block, new_balance, nano::seconds_since_epoch (), info->block_count + 1, nano::epoch::epoch_0);
@@ -626,7 +633,7 @@ void ledger_processor::open_block (nano::open_block & block_a)
 								result = ledger.constants.work.difficulty (block_a) >= ledger.constants.work.threshold (block_a.work_version (), block_details) ? nano::block_status::progress : nano::block_status::insufficient_work; // Does this block have sufficient work? (Malformed)
 								if (result == nano::block_status::progress)
 								{
-									ledger.store.pending.del (transaction, key);
+									ledger.pending_del (transaction, key);
 									block_a.sideband_set (nano::block_sideband (block_a.hashables.account, 0, pending.value ().amount, 1, nano::seconds_since_epoch (), block_details, nano::epoch::epoch_0 /* unused */));
 									ledger.store.block.put (transaction, hash, block_a);
 									nano::account_info new_info (hash, block_a.representative_field ().value (), hash, pending.value ().amount.number (), nano::seconds_since_epoch (), 1, nano::epoch::epoch_0);
@@ -719,6 +726,7 @@ nano::ledger::ledger (nano::store::component & store_a, nano::stats & stat_a, na
 	cache{ store_a.rep_weight, min_rep_weight_a },
 	stats{ stat_a },
 	check_bootstrap_weights{ true },
+	cache_snapshot{ generate_cache_flags_a.snapshot },
 	any_impl{ std::make_unique<ledger_set_any> (*this) },
 	confirmed_impl{ std::make_unique<ledger_set_confirmed> (*this) },
 	any{ *any_impl },
@@ -726,7 +734,14 @@ nano::ledger::ledger (nano::store::component & store_a, nano::stats & stat_a, na
 {
 	if (!store.init_error ())
 	{
-		initialize (generate_cache_flags_a);
+		if (cache_snapshot.empty () || read_cache_snapshot ())
+		{
+			initialize (generate_cache_flags_a);
+		}
+		if (generate_cache_flags_a.receivable)
+		{
+			initialize_receivable_sums ();
+		}
 	}
 }
 
@@ -748,48 +763,244 @@ auto nano::ledger::tx_begin_read () const -> secure::read_transaction
 
 void nano::ledger::initialize (nano::generate_cache_flags const & generate_cache_flags_a)
 {
+	nano::parallel_traversal_config traversal_config;
+	traversal_config.threads = generate_cache_flags_a.threads;
+	auto const thread_count = traversal_config.thread_count ();
+	// Progress of each traversal is reported with the name of the table it traverses
+	auto report_progress = [&traversal_config, &generate_cache_flags_a] (std::string_view table) {
+		traversal_config.progress = nullptr;
+		if (generate_cache_flags_a.progress)
+		{
+			traversal_config.progress = [&progress = generate_cache_flags_a.progress, table] (std::size_t completed, std::size_t total) {
+				progress (table, completed, total);
+			};
+		}
+	};
+
+	// Results are accumulated per traversal thread and merged into the cache once all ranges have been traversed
 	if (generate_cache_flags_a.reps || generate_cache_flags_a.account_count || generate_cache_flags_a.block_count)
 	{
-		store.account.for_each_par (
-		[this] (store::read_transaction const & /*unused*/, auto i, auto n) {
+		std::vector<std::pair<uint64_t, uint64_t>> account_counts (thread_count);
+		report_progress ("account");
+		parallel_traversal<nano::uint256_t> (traversal_config,
+		[this, &account_counts] (nano::uint256_t const & start, nano::uint256_t const & end, bool const is_last, unsigned const thread) {
+			auto transaction = this->store.tx_begin_read ();
 			uint64_t block_count_l{ 0 };
 			uint64_t account_count_l{ 0 };
-			for (; i != n; ++i)
+			for (auto i = this->store.account.begin (transaction, start), n = !is_last ? this->store.account.begin (transaction, end) : this->store.account.end (transaction); i != n; ++i)
 			{
 				nano::account_info const & info (i->second);
 				block_count_l += info.block_count;
 				++account_count_l;
 			}
-			this->cache.block_count += block_count_l;
-			this->cache.account_count += account_count_l;
+			account_counts[thread].first += block_count_l;
+			account_counts[thread].second += account_count_l;
 		});
+		for (auto const & [block_count_l, account_count_l] : account_counts)
+		{
+			cache.block_count += block_count_l;
+			cache.account_count += account_count_l;
+		}
 
-		store.rep_weight.for_each_par (
-		[this] (store::read_transaction const & /*unused*/, auto i, auto n) {
-			nano::rep_weights rep_weights_l{ this->store.rep_weight };
-			for (; i != n; ++i)
+		std::deque<nano::rep_weights> rep_weights_l;
+		for (unsigned thread = 0; thread < thread_count; ++thread)
+		{
+			rep_weights_l.emplace_back (store.rep_weight);
+		}
+		report_progress ("rep_weight");
+		parallel_traversal<nano::uint256_t> (traversal_config,
+		[this, &rep_weights_l] (nano::uint256_t const & start, nano::uint256_t const & end, bool const is_last, unsigned const thread) {
+			auto transaction = this->store.tx_begin_read ();
+			for (auto i = this->store.rep_weight.begin (transaction, start), n = !is_last ? this->store.rep_weight.begin (transaction, end) : this->store.rep_weight.end (transaction); i != n; ++i)
 			{
-				rep_weights_l.representation_put (i->first, i->second.number ());
+				rep_weights_l[thread].representation_put (i->first, i->second.number ());
 			}
-			this->cache.rep_weights.copy_from (rep_weights_l);
 		});
+		for (auto & rep_weights_thread : rep_weights_l)
+		{
+			cache.rep_weights.copy_from (rep_weights_thread);
+		}
 	}
 
 	if (generate_cache_flags_a.cemented_count)
 	{
-		store.confirmation_height.for_each_par (
-		[this] (store::read_transaction const & /*unused*/, auto i, auto n) {
+		std::vector<uint64_t> cemented_counts (thread_count);
+		report_progress ("confirmation_height");
+		parallel_traversal<nano::uint256_t> (traversal_config,
+		[this, &cemented_counts] (nano::uint256_t const & start, nano::uint256_t const & end, bool const is_last, unsigned const thread) {
+			auto transaction = this->store.tx_begin_read ();
 			uint64_t cemented_count_l (0);
-			for (; i != n; ++i)
+			for (auto i = this->store.confirmation_height.begin (transaction, start), n = !is_last ? this->store.confirmation_height.begin (transaction, end) : this->store.confirmation_height.end (transaction); i != n; ++i)
 			{
 				cemented_count_l += i->second.height;
 			}
-			this->cache.cemented_count += cemented_count_l;
+			cemented_counts[thread] += cemented_count_l;
 		});
+		for (auto cemented_count_l : cemented_counts)
+		{
+			cache.cemented_count += cemented_count_l;
+		}
 	}
 
 	auto transaction (store.tx_begin_read ());
 	cache.pruned_count = store.pruned.count (transaction);
+
+	cache_complete = generate_cache_flags_a.reps && generate_cache_flags_a.account_count && generate_cache_flags_a.block_count && generate_cache_flags_a.cemented_count;
+}
+
+void nano::ledger::pending_put (secure::write_transaction const & transaction, nano::pending_key const & key, nano::pending_info const & info)
+{
+	store.pending.put (transaction, key, info);
+	cache.receivable_sums.add (key.account, info.amount.number ());
+}
+
+void nano::ledger::pending_del (secure::write_transaction const & transaction, nano::pending_key const & key)
+{
+	if (cache.receivable_sums.enabled ())
+	{
+		auto existing = store.pending.get (transaction, key);
+		debug_assert (existing);
+		if (existing)
+		{
+			cache.receivable_sums.subtract (key.account, existing->amount.number ());
+		}
+	}
+	store.pending.del (transaction, key);
+}
+
+void nano::ledger::initialize_receivable_sums ()
+{
+	store.pending.for_each_par (
+	[this] (store::read_transaction const &, auto i, auto n) {
+		std::unordered_map<nano::account, nano::uint128_t> sums;
+		for (; i != n; ++i)
+		{
+			sums[i->first.account] += i->second.amount.number ();
+		}
+		cache.receivable_sums.merge (sums);
+	});
+	cache.receivable_sums.enable ();
+}
+
+/*
+ * Snapshot layout, in native byte order: version, genesis hash, store identity, store commit sequence, ledger cache, followed by the checksum of everything before it
+ */
+bool nano::ledger::write_cache_snapshot ()
+{
+	if (cache_snapshot.empty () || !cache_complete)
+	{
+		return true;
+	}
+	std::vector<uint8_t> payload;
+	{
+		// Holding the write transaction waits for pending writers and keeps new ones out, its commit does not advance the sequence as nothing is written
+		auto transaction = tx_begin_write ();
+		// Commit sequences restart in compacted or copied databases, the identity tells them apart from the database the snapshot was taken from
+		auto identity = store.version.identity_get (transaction);
+		if (identity.is_zero ())
+		{
+			identity = nano::random_pool::generate<nano::uint256_union> ();
+			store.version.identity_put (transaction, identity);
+			transaction.commit ();
+			transaction.renew ();
+		}
+		nano::vectorstream stream{ payload };
+		nano::write (stream, cache_snapshot_version);
+		nano::write (stream, constants.genesis->hash ());
+		nano::write (stream, identity);
+		nano::write (stream, store.commit_sequence ());
+		cache.serialize (stream);
+	}
+	auto const checksum = cache_snapshot_checksum (payload);
+
+	// Written to a temporary file first so a crash while writing cannot leave a truncated snapshot behind
+	auto temporary = cache_snapshot;
+	temporary += ".tmp";
+	{
+		std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+		file.write (reinterpret_cast<char const *> (payload.data ()), payload.size ());
+		file.write (reinterpret_cast<char const *> (checksum.bytes.data ()), checksum.bytes.size ());
+		if (!file.good ())
+		{
+			return true;
+		}
+	}
+	std::error_code ec;
+	std::filesystem::rename (temporary, cache_snapshot, ec);
+	if (ec)
+	{
+		return true;
+	}
+	stats.inc (nano::stat::type::ledger, nano::stat::detail::snapshot_written);
+	return false;
+}
+
+bool nano::ledger::read_cache_snapshot ()
+{
+	std::ifstream file{ cache_snapshot, std::ios::binary };
+	if (!file.is_open ())
+	{
+		stats.inc (nano::stat::type::ledger, nano::stat::detail::snapshot_missing);
+		return true;
+	}
+	std::vector<uint8_t> payload{ std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> () };
+	nano::uint256_union checksum;
+	if (payload.size () < checksum.bytes.size ())
+	{
+		stats.inc (nano::stat::type::ledger, nano::stat::detail::snapshot_invalid);
+		return true;
+	}
+	std::copy (payload.end () - checksum.bytes.size (), payload.end (), checksum.bytes.begin ());
+	payload.resize (payload.size () - checksum.bytes.size ());
+	if (checksum != cache_snapshot_checksum (payload))
+	{
+		stats.inc (nano::stat::type::ledger, nano::stat::detail::snapshot_invalid);
+		return true;
+	}
+	try
+	{
+		nano::bufferstream stream{ payload.data (), payload.size () };
+		uint8_t version;
+		nano::block_hash genesis;
+		nano::uint256_union identity;
+		uint64_t commit_sequence;
+		nano::read (stream, version);
+		nano::read (stream, genesis);
+		nano::read (stream, identity);
+		nano::read (stream, commit_sequence);
+		if (version != cache_snapshot_version || genesis != constants.genesis->hash ())
+		{
+			stats.inc (nano::stat::type::ledger, nano::stat::detail::snapshot_invalid);
+			return true;
+		}
+		// Any commit since the snapshot was taken, including upgrades or writes lost in a crash, makes it stale
+		if (identity != store.version.identity_get (store.tx_begin_read ()) || commit_sequence != store.commit_sequence ())
+		{
+			stats.inc (nano::stat::type::ledger, nano::stat::detail::snapshot_stale);
+			return true;
+		}
+		cache.deserialize (stream);
+	}
+	catch (std::runtime_error const &)
+	{
+		stats.inc (nano::stat::type::ledger, nano::stat::detail::snapshot_invalid);
+		return true;
+	}
+	cache_complete = true;
+	stats.inc (nano::stat::type::ledger, nano::stat::detail::snapshot_loaded);
+	return false;
+}
+
+nano::uint256_union nano::ledger::cache_snapshot_checksum (std::vector<uint8_t> const & payload) const
+{
+	nano::uint256_union result;
+	auto const vendor = store.vendor_get ();
+	blake2b_state state;
+	blake2b_init (&state, sizeof (result.bytes));
+	blake2b_update (&state, vendor.data (), vendor.size ());
+	blake2b_update (&state, payload.data (), payload.size ());
+	blake2b_final (&state, result.bytes.data (), sizeof (result.bytes));
+	return result;
 }
 
 bool nano::ledger::unconfirmed_exists (secure::transaction const & transaction, nano::block_hash const & hash)
@@ -799,6 +1010,11 @@ bool nano::ledger::unconfirmed_exists (secure::transaction const & transaction,
 
 nano::uint128_t nano::ledger::account_receivable (secure::transaction const & transaction_a, nano::account const & account_a, bool only_confirmed_a)
 {
+	auto cached = cache.receivable_sums.get (account_a);
+	if (cached && (!only_confirmed_a || cached.value () == 0))
+	{
+		return cached.value ();
+	}
 	nano::uint128_t result (0);
 	nano::account end (account_a.number () + 1);
 	for (auto i (store.pending.begin (transaction_a, nano::pending_key (account_a, 0))), n (store.pending.begin (transaction_a, nano::pending_key (end, 0))); i != n; ++i)
@@ -819,6 +1035,63 @@ nano::uint128_t nano::ledger::account_receivable (secure::transaction const & tr
 	return result;
 }
 
+void nano::ledger::receivable_for_each (secure::transaction const & transaction, std::vector<nano::account> const & accounts, bool check_confirmation, std::function<bool (nano::pending_key const &, nano::pending_info const &, bool confirmed)> const & action) const
+{
+	debug_assert (std::is_sorted (accounts.begin (), accounts.end ()));
+	// Whether all blocks of a source account are confirmed and its confirmation height, looked up on first use
+	std::unordered_map<nano::account, std::pair<bool, uint64_t>> sources;
+	auto is_confirmed = [&] (nano::pending_key const & key, nano::pending_info const & info) {
+		if (info.source.is_zero ())
+		{
+			// Source account is unknown if the send was pruned
+			return confirmed.block_exists_or_pruned (transaction, key.hash);
+		}
+		auto existing = sources.find (info.source);
+		if (existing == sources.end ())
+		{
+			auto const height = store.confirmation_height.get (transaction, info.source).value_or (nano::confirmation_height_info{}).height;
+			auto const account_info = any.account_get (transaction, info.source);
+			existing = sources.emplace (info.source, std::make_pair (account_info && account_info->block_count == height, height)).first;
+		}
+		if (existing->second.first)
+		{
+			return true;
+		}
+		auto block = store.block.get (transaction, key.hash);
+		if (block == nullptr)
+		{
+			return store.pruned.exists (transaction, key.hash);
+		}
+		return block->sideband ().height <= existing->second.second;
+	};
+	auto const end = store.pending.end (transaction);
+	auto i = store.pending.end (transaction);
+	bool positioned{ false };
+	for (auto const & account : accounts)
+	{
+		if (cache.receivable_sums.get (account).value_or (1) == 0)
+		{
+			continue;
+		}
+		// Entries of accounts between the requested ones are never visited, the cursor seeks past them
+		if (!positioned || (i != end && i->first.account < account))
+		{
+			i = store.pending.begin (transaction, nano::pending_key (account, 0));
+			positioned = true;
+		}
+		if (i == end)
+		{
+			break;
+		}
+		for (bool more = true; more && i != end && i->first.account == account; ++i)
+		{
+			nano::pending_key const & key (i->first);
+			nano::pending_info const & info (i->second);
+			more = action (key, info, check_confirmation && is_confirmed (key, info));
+		}
+	}
+}
+
 // Both stack and result set are bounded to limit maximum memory usage
 // Callers must ensure that the target block was confirmed, and if not, call this function multiple times
 std::deque<std::shared_ptr<nano::block>> nano::ledger::confirm (secure::write_transaction & transaction, nano::block_hash const & target_hash, size_t max_blocks)
@@ -833,38 +1106,73 @@ std::deque<std::shared_ptr<nano::block>> nano::ledger::confirm (secure::write_tr
 		auto block = any.block_get (transaction, hash);
 		release_assert (block);
 
-		auto dependents = dependent_blocks (transaction, *block);
-		for (auto const & dependent : dependents)
+		auto const account = block->account ();
+		auto const confirmed_info = store.confirmation_height.get (transaction, account).value_or (nano::confirmation_height_info{});
+		if (block->sideband ().height <= confirmed_info.height)
 		{
-			if (!dependent.is_zero () && !confirmed.block_exists_or_pruned (transaction, dependent))
-			{
-				stats.inc (nano::stat::type::confirmation_height, nano::stat::detail::dependent_unconfirmed);
-
-				stack.push_back (dependent);
+			// Already confirmed as part of another segment
+			stack.pop_back ();
+			continue;
+		}
 
-				// Limit the stack size to avoid excessive memory usage
-				// This will forget the bottom of the dependency tree
-				if (stack.size () > max_blocks)
+		// Blocks are confirmed together bottom up, walking from the confirmation height towards the block and stopping at the first unconfirmed dependency
+		// Only the walked blocks are read, so resuming after a dependency was confirmed does not revisit the confirmed part of the chain
+		std::deque<std::shared_ptr<nano::block>> segment;
+		std::optional<nano::block_hash> unconfirmed_dependency;
+		auto const segment_max = max_blocks - result.size ();
+		for (auto current = lowest_unconfirmed (transaction, block, confirmed_info); current != nullptr;)
+		{
+			// The previous block is either confirmed or part of the segment, only dependencies on other chains need checking
+			for (auto const & dependent : dependent_blocks (transaction, *current))
+			{
+				if (!dependent.is_zero () && dependent != current->previous () && !confirmed.block_exists_or_pruned (transaction, dependent))
 				{
-					stack.pop_front ();
+					// Sends to self are satisfied by lower blocks of the same segment
+					auto source = any.block_get (transaction, dependent);
+					if (!source || source->account () != account || source->sideband ().height >= current->sideband ().height)
+					{
+						unconfirmed_dependency = dependent;
+						break;
+					}
 				}
 			}
+			if (unconfirmed_dependency)
+			{
+				break;
+			}
+			segment.push_back (current);
+			if (current->hash () == hash || segment.size () >= segment_max)
+			{
+				break;
+			}
+			auto successor = any.block_successor (transaction, current->hash ());
+			release_assert (successor);
+			current = any.block_get (transaction, *successor);
+			release_assert (current);
 		}
+		bool const complete = !unconfirmed_dependency && !segment.empty () && segment.back ()->hash () == hash;
 
-		if (stack.back () == hash)
+		if (!segment.empty ())
+		{
+			confirm_segment (transaction, segment);
+			result.insert (result.end (), segment.begin (), segment.end ());
+		}
+		if (complete)
 		{
 			stack.pop_back ();
-			if (!confirmed.block_exists_or_pruned (transaction, hash))
-			{
-				// We must only confirm blocks that have their dependencies confirmed
-				debug_assert (dependents_confirmed (transaction, *block));
-				confirm_one (transaction, *block);
-				result.push_back (block);
-			}
 		}
-		else
+		if (unconfirmed_dependency)
 		{
-			// Unconfirmed dependencies were added
+			stats.inc (nano::stat::type::confirmation_height, nano::stat::detail::dependent_unconfirmed);
+
+			stack.push_back (*unconfirmed_dependency);
+
+			// Limit the stack size to avoid excessive memory usage
+			// This will forget the bottom of the dependency tree
+			if (stack.size () > max_blocks)
+			{
+				stack.pop_front ();
+			}
 		}
 
 		// Refresh the transaction to avoid long-running transactions
@@ -888,14 +1196,50 @@ std::deque<std::shared_ptr<nano::block>> nano::ledger::confirm (secure::write_tr
 	return result;
 }
 
-void nano::ledger::confirm_one (secure::write_transaction & transaction, nano::block const & block)
+/*
+ * Returns the block directly above the confirmation height of the account of \p top, which has to be unconfirmed
+ */
+std::shared_ptr<nano::block> nano::ledger::lowest_unconfirmed (secure::transaction const & transaction, std::shared_ptr<nano::block> const & top, nano::confirmation_height_info const & confirmed_info) const
 {
-	debug_assert ((!store.confirmation_height.get (transaction, block.account ()) && block.sideband ().height == 1) || store.confirmation_height.get (transaction, block.account ()).value ().height + 1 == block.sideband ().height);
-	confirmation_height_info info{ block.sideband ().height, block.hash () };
-	store.confirmation_height.put (transaction, block.account (), info);
-	++cache.cemented_count;
+	debug_assert (top->sideband ().height > confirmed_info.height);
+	std::optional<nano::block_hash> lowest;
+	if (confirmed_info.height == 0)
+	{
+		auto info = any.account_get (transaction, top->account ());
+		release_assert (info);
+		lowest = info->open_block;
+	}
+	else
+	{
+		lowest = any.block_successor (transaction, confirmed_info.frontier);
+	}
+	if (lowest)
+	{
+		auto result = any.block_get (transaction, *lowest);
+		release_assert (result);
+		return result;
+	}
+	// The confirmed frontier was pruned, its successor is found by walking down from the top instead
+	auto current = top;
+	while (current->sideband ().height > confirmed_info.height + 1)
+	{
+		current = any.block_get (transaction, current->previous ());
+		release_assert (current);
+	}
+	return current;
+}
 
-	stats.inc (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed);
+void nano::ledger::confirm_segment (secure::write_transaction & transaction, std::deque<std::shared_ptr<nano::block>> const & segment)
+{
+	auto const & bottom = *segment.front ();
+	auto const & top = *segment.back ();
+	debug_assert ((!store.confirmation_height.get (transaction, bottom.account ()) && bottom.sideband ().height == 1) || store.confirmation_height.get (transaction, bottom.account ()).value ().height + 1 == bottom.sideband ().height);
+	debug_assert (top.sideband ().height - bottom.sideband ().height + 1 == segment.size ());
+	confirmation_height_info info{ top.sideband ().height, top.hash () };
+	store.confirmation_height.put (transaction, top.account (), info);
+	cache.cemented_count += segment.size ();
+
+	stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed, segment.size ());
 }
 
 nano::block_status nano::ledger::process (secure::write_transaction const & transaction_a, std::shared_ptr<nano::block> block_a)
@@ -1274,221 +1618,356 @@ auto nano::ledger::block_priority (nano::secure::transaction const & transaction
 	return { priority_balance, priority_timestamp };
 }
 
-// A precondition is that the store is an LMDB store
+namespace
+{
+/** Files and totals of a table converted into SST files */
+class sst_conversion final
+{
+public:
+	std::vector<std::filesystem::path> files;
+	uint64_t entries{ 0 };
+	uint64_t bytes{ 0 };
+	bool error{ false };
+};
+
+/**
+ * Adds the entries of [i, n) to an SST file using \p put, returns the number of entries or nullopt on error.
+ * The tables are iterated in LMDB key order, which is the bytewise order RocksDB expects.
+ */
+template <typename Iterator, typename Put>
+std::optional<uint64_t> write_sst (Iterator i, Iterator const & n, Put const & put)
+{
+	uint64_t entries{ 0 };
+	for (; i != n; ++i, ++entries)
+	{
+		if (!put (*i).ok ())
+		{
+			return std::nullopt;
+		}
+	}
+	return entries;
+}
+
+/** Conversion of a key range of \p table whose keys and values are stored the same way by both databases */
+template <typename T, typename Table>
+std::function<std::optional<uint64_t> (T const &, T const &, bool, ::rocksdb::SstFileWriter &)> convert_entries (nano::store::component & store, Table const & table)
+{
+	return [&store, &table] (T const & start, T const & end, bool is_last, ::rocksdb::SstFileWriter & writer) {
+		auto transaction = store.tx_begin_read ();
+		return write_sst (table.begin (transaction, start), !is_last ? table.begin (transaction, end) : table.end (transaction), [&writer] (auto const & entry) {
+			return writer.Put (nano::store::rocksdb::db_val{ entry.first }, nano::store::rocksdb::db_val{ entry.second });
+		});
+	};
+}
+
+/**
+ * Converts a table into sorted SST files in parallel, one file per key range. A file is only given its final name once it is complete,
+ * so when an interrupted migration is resumed with the same range split only the missing ranges are converted again.
+ * \p convert writes the entries of a range into the given writer and returns their number or nullopt on error.
+ */
+template <typename T>
+sst_conversion convert_to_sst (nano::store::rocksdb::component & rocksdb_store, nano::tables table, std::string const & name, std::filesystem::path const & directory, nano::parallel_traversal_config const & config, std::function<std::optional<uint64_t> (T const & start, T const & end, bool is_last, ::rocksdb::SstFileWriter &)> const & convert)
+{
+	sst_conversion result;
+	nano::mutex mutex;
+	parallel_traversal<T> (config, [&] (T const & start, T const & end, bool const is_last, unsigned const) {
+		// Runs on traversal threads, filesystem errors are reported through error codes as exceptions would terminate the process
+		auto const file = directory / (name + "_" + start.str () + ".sst");
+		std::optional<uint64_t> entries;
+		std::error_code ec;
+		if (std::filesystem::exists (file, ec))
+		{
+			entries = rocksdb_store.sst_entries (table, file);
+		}
+		else if (!ec)
+		{
+			auto temporary = file;
+			temporary += ".tmp";
+			auto writer = rocksdb_store.sst_writer (table);
+			if (writer->Open (temporary.string ()).ok ())
+			{
+				entries = convert (start, end, is_last, *writer);
+			}
+			// Empty ranges have no file, RocksDB does not create SST files without entries
+			if (entries && *entries > 0)
+			{
+				auto const finished = writer->Finish ().ok ();
+				if (finished)
+				{
+					std::filesystem::rename (temporary, file, ec);
+				}
+				if (!finished || ec)
+				{
+					entries = std::nullopt;
+				}
+			}
+			else
+			{
+				std::filesystem::remove (temporary, ec);
+				if (ec)
+				{
+					entries = std::nullopt;
+				}
+			}
+		}
+		uint64_t bytes{ 0 };
+		if (entries && *entries > 0)
+		{
+			bytes = std::filesystem::file_size (file, ec);
+			if (ec)
+			{
+				entries = std::nullopt;
+			}
+		}
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		if (!entries)
+		{
+			result.error = true;
+		}
+		else if (*entries > 0)
+		{
+			result.entries += *entries;
+			result.bytes += bytes;
+			result.files.push_back (file);
+		}
+	});
+	return result;
+}
+}
+
+/*
+ * Tables are converted one by one into sorted SST files which are then ingested into RocksDB, bypassing its write path.
+ * Progress is recorded in a checkpoint file in the rocksdb_migration directory: once a table has been ingested it is not converted again,
+ * and the range split of the first attempt is reused so completed SST files of an interrupted table are kept.
+ * A precondition is that the store is an LMDB store.
+ */
 bool nano::ledger::migrate_lmdb_to_rocksdb (std::filesystem::path const & data_path_a) const
 {
 	nano::logger logger;
 
-	logger.info (nano::log::type::ledger, "Migrating LMDB database to RocksDB. This will take a while...");
+	auto rockdb_data_path = data_path_a / "rocksdb";
+	auto migration_path = data_path_a / "rocksdb_migration";
+	auto checkpoint_path = migration_path / "checkpoint.json";
+	auto const resume = std::filesystem::exists (checkpoint_path);
+
+	if (!resume)
+	{
+		logger.info (nano::log::type::ledger, "Migrating LMDB database to RocksDB. This will take a while...");
 
-	std::filesystem::space_info si = std::filesystem::space (data_path_a);
-	auto file_size = std::filesystem::file_size (data_path_a / "data.ldb");
-	const auto estimated_required_space = file_size * 0.65; // RocksDb database size is approximately 65% of the lmdb size
+		std::filesystem::space_info si = std::filesystem::space (data_path_a);
+		auto file_size = std::filesystem::file_size (data_path_a / "data.ldb");
+		// RocksDb database size is approximately 65% of the lmdb size. SST files of a table are kept in the migration directory until ingested,
+		// and are copied instead of moved when RocksDB cannot link them, so up to twice that may be needed
+		const auto estimated_required_space = file_size * 1.3;
 
-	if (si.available < estimated_required_space)
+		if (si.available < estimated_required_space)
+		{
+			logger.warn (nano::log::type::ledger, "You may not have enough available disk space. Estimated free space requirement is {} GB", estimated_required_space / 1024 / 1024 / 1024);
+		}
+
+		if (std::filesystem::exists (rockdb_data_path))
+		{
+			logger.error (nano::log::type::ledger, "Existing RocksDB folder found in '{}'. Please remove it and try again.", rockdb_data_path.string ());
+			return true;
+		}
+	}
+	else
 	{
-		logger.warn (nano::log::type::ledger, "You may not have enough available disk space. Estimated free space requirement is {} GB", estimated_required_space / 1024 / 1024 / 1024);
+		logger.info (nano::log::type::ledger, "Resuming migration of LMDB database to RocksDB from '{}'", checkpoint_path.string ());
 	}
 
 	boost::system::error_code error_chmod;
 	nano::set_secure_perm_directory (data_path_a, error_chmod);
-	auto rockdb_data_path = data_path_a / "rocksdb";
+	std::filesystem::create_directories (migration_path);
 
-	if (std::filesystem::exists (rockdb_data_path))
+	boost::property_tree::ptree checkpoint;
+	if (resume)
 	{
-		logger.error (nano::log::type::ledger, "Existing RocksDB folder found in '{}'. Please remove it and try again.", rockdb_data_path.string ());
-		return true;
+		try
+		{
+			boost::property_tree::read_json (checkpoint_path.string (), checkpoint);
+		}
+		catch (boost::property_tree::json_parser_error const & ex)
+		{
+			logger.error (nano::log::type::ledger, "Unable to read migration checkpoint: {}", ex.message ());
+			return true;
+		}
 	}
+	nano::parallel_traversal_config traversal_config;
+	traversal_config.threads = checkpoint.get<unsigned> ("threads", traversal_config.thread_count ());
+	checkpoint.put ("threads", traversal_config.threads);
+	auto write_checkpoint = [&checkpoint, &checkpoint_path] () {
+		// Replaced atomically so an interruption while writing cannot lose progress
+		auto temporary = checkpoint_path;
+		temporary += ".tmp";
+		boost::property_tree::write_json (temporary.string (), checkpoint);
+		std::filesystem::rename (temporary, checkpoint_path);
+	};
+	write_checkpoint ();
 
 	auto error (false);
 
 	// Open rocksdb database
 	nano::rocksdb_config rocksdb_config;
 	rocksdb_config.enable = true;
-	auto rocksdb_store = nano::make_store (logger, data_path_a, nano::dev::constants, false, true, rocksdb_config);
+	auto rocksdb_store_impl = nano::make_store (logger, data_path_a, nano::dev::constants, false, true, rocksdb_config);
 
-	if (!rocksdb_store->init_error ())
+	if (!rocksdb_store_impl->init_error ())
 	{
-		auto table_size = store.count (store.tx_begin_read (), tables::blocks);
-		logger.info (nano::log::type::ledger, "Step 1 of 7: Converting {} entries from blocks table", table_size);
-		std::atomic<std::size_t> count = 0;
-		store.block.for_each_par (
-		[&] (store::read_transaction const & /*unused*/, auto i, auto n) {
-			auto rocksdb_transaction = rocksdb_store->tx_begin_write ();
-			for (; i != n; ++i)
-			{
-				rocksdb_transaction.refresh_if_needed ();
-				std::vector<uint8_t> vector;
-				{
-					nano::vectorstream stream (vector);
-					nano::serialize_block (stream, *i->second.block);
-					i->second.sideband.serialize (stream, i->second.block->type ());
-				}
-				rocksdb_store->block.raw_put (rocksdb_transaction, vector, i->first);
-
-				if (auto count_l = ++count; count_l % 5000000 == 0)
-				{
-					logger.info (nano::log::type::ledger, "{} blocks converted ({}%)", count_l, count_l * 100 / table_size);
-				}
-			}
-		});
-		logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count.load (), table_size > 0 ? count.load () * 100 / table_size : 100);
-
-		table_size = store.count (store.tx_begin_read (), tables::pending);
-		logger.info (nano::log::type::ledger, "Step 2 of 7: Converting {} entries from pending table", table_size);
-		count = 0;
-		store.pending.for_each_par (
-		[&] (store::read_transaction const & /*unused*/, auto i, auto n) {
-			auto rocksdb_transaction = rocksdb_store->tx_begin_write ();
-			for (; i != n; ++i)
+		auto & rocksdb_store = *boost::polymorphic_downcast<nano::store::rocksdb::component *> (rocksdb_store_impl.get ());
+		auto const migration_start = std::chrono::steady_clock::now ();
+		uint64_t total_bytes{ 0 };
+		unsigned step{ 0 };
+
+		// The range type of each table is deduced from the std::function wrapping its conversion
+		auto migrate_table = [&] (nano::tables table, std::string const & name, auto const & convert) {
+			++step;
+			auto const table_size = store.count (store.tx_begin_read (), table);
+			if (auto completed = checkpoint.get_optional<uint64_t> ("completed." + name))
 			{
-				rocksdb_transaction.refresh_if_needed ();
-				rocksdb_store->pending.put (rocksdb_transaction, i->first, i->second);
-				if (auto count_l = ++count; count_l % 500000 == 0)
-				{
-					logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count_l, count_l * 100 / table_size);
-				}
-			}
-		});
-		logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count.load (), table_size > 0 ? count.load () * 100 / table_size : 100);
-
-		table_size = store.count (store.tx_begin_read (), tables::confirmation_height);
-		logger.info (nano::log::type::ledger, "Step 3 of 7: Converting {} entries from confirmation_height table", table_size);
-		count = 0;
-		store.confirmation_height.for_each_par (
-		[&] (store::read_transaction const & /*unused*/, auto i, auto n) {
-			auto rocksdb_transaction = rocksdb_store->tx_begin_write ();
-			for (; i != n; ++i)
-			{
-				rocksdb_transaction.refresh_if_needed ();
-				rocksdb_store->confirmation_height.put (rocksdb_transaction, i->first, i->second);
-				if (auto count_l = ++count; count_l % 500000 == 0)
-				{
-					logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count_l, count_l * 100 / table_size);
-				}
+				logger.info (nano::log::type::ledger, "Step {} of 7: {} entries from {} table already migrated", step, *completed, name);
+				return;
 			}
-		});
-		logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count.load (), table_size > 0 ? count.load () * 100 / table_size : 100);
-
-		table_size = store.count (store.tx_begin_read (), tables::accounts);
-		logger.info (nano::log::type::ledger, "Step 4 of 7: Converting {} entries from accounts table", table_size);
-		count = 0;
-		store.account.for_each_par (
-		[&] (store::read_transaction const & /*unused*/, auto i, auto n) {
-			auto rocksdb_transaction = rocksdb_store->tx_begin_write ();
-			for (; i != n; ++i)
+			logger.info (nano::log::type::ledger, "Step {} of 7: Converting {} entries from {} table", step, table_size, name);
+			auto const start = std::chrono::steady_clock::now ();
+			auto result = convert_to_sst (rocksdb_store, table, name, migration_path, traversal_config, convert);
+			if (result.error)
 			{
-				rocksdb_transaction.refresh_if_needed ();
-				rocksdb_store->account.put (rocksdb_transaction, i->first, i->second);
-				if (auto count_l = ++count; count_l % 500000 == 0)
-				{
-					logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count_l, count_l * 100 / table_size);
-				}
+				logger.error (nano::log::type::ledger, "Failed to write SST files for {} table", name);
+				error = true;
+				return;
 			}
-		});
-		logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count.load (), table_size > 0 ? count.load () * 100 / table_size : 100);
-
-		table_size = store.count (store.tx_begin_read (), tables::rep_weights);
-		logger.info (nano::log::type::ledger, "Step 5 of 7: Converting {} entries from rep_weights table", table_size);
-		count = 0;
-		store.rep_weight.for_each_par (
-		[&] (store::read_transaction const & /*unused*/, auto i, auto n) {
-			auto rocksdb_transaction = rocksdb_store->tx_begin_write ();
-			for (; i != n; ++i)
+			if (result.entries != table_size)
 			{
-				rocksdb_transaction.refresh_if_needed ();
-				rocksdb_store->rep_weight.put (rocksdb_transaction, i->first, i->second.number ());
-				if (auto count_l = ++count; count_l % 500000 == 0)
-				{
-					logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count_l, count_l * 100 / table_size);
-				}
+				logger.error (nano::log::type::ledger, "Converted {} entries from {} table but it contains {}", result.entries, name, table_size);
+				error = true;
+				return;
 			}
-		});
-		logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count.load (), table_size > 0 ? count.load () * 100 / table_size : 100);
-
-		table_size = store.count (store.tx_begin_read (), tables::pruned);
-		logger.info (nano::log::type::ledger, "Step 6 of 7: Converting {} entries from pruned table", table_size);
-		count = 0;
-		store.pruned.for_each_par (
-		[&] (store::read_transaction const & /*unused*/, auto i, auto n) {
-			auto rocksdb_transaction = rocksdb_store->tx_begin_write ();
-			for (; i != n; ++i)
+			if (!result.files.empty () && rocksdb_store.ingest (table, result.files))
 			{
-				rocksdb_transaction.refresh_if_needed ();
-				rocksdb_store->pruned.put (rocksdb_transaction, i->first);
-				if (auto count_l = ++count; count_l % 500000 == 0)
-				{
-					logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count_l, count_l * 100 / table_size);
-				}
+				error = true;
+				return;
 			}
-		});
-		logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count.load (), table_size > 0 ? count.load () * 100 / table_size : 100);
-
-		table_size = store.count (store.tx_begin_read (), tables::final_votes);
-		logger.info (nano::log::type::ledger, "Step 7 of 7: Converting {} entries from final_votes table", table_size);
-		count = 0;
-		store.final_vote.for_each_par (
-		[&] (store::read_transaction const & /*unused*/, auto i, auto n) {
-			auto rocksdb_transaction = rocksdb_store->tx_begin_write ();
-			for (; i != n; ++i)
-			{
-				rocksdb_transaction.refresh_if_needed ();
-				rocksdb_store->final_vote.put (rocksdb_transaction, i->first, i->second);
-				if (auto count_l = ++count; count_l % 500000 == 0)
+			checkpoint.put ("completed." + name, result.entries);
+			write_checkpoint ();
+			total_bytes += result.bytes;
+
+			auto const seconds = std::max (std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count (), 0.001);
+			logger.info (nano::log::type::ledger, "{} entries ({} MB) converted in {:.1f} s, {:.0f} entries/s, {:.1f} MB/s", result.entries, result.bytes / 1024 / 1024, seconds, result.entries / seconds, result.bytes / 1024.0 / 1024.0 / seconds);
+		};
+
+		using db_val = nano::store::rocksdb::db_val;
+		migrate_table (tables::blocks, "blocks", std::function{ [this] (nano::uint256_t const & start, nano::uint256_t const & end, bool is_last, ::rocksdb::SstFileWriter & writer) {
+			auto transaction = store.tx_begin_read ();
+			return write_sst (store.block.begin (transaction, start), !is_last ? store.block.begin (transaction, end) : store.block.end (transaction), [&writer] (auto const & entry) {
+				std::vector<uint8_t> vector;
 				{
-					logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count_l, count_l * 100 / table_size);
+					nano::vectorstream stream (vector);
+					nano::serialize_block (stream, *entry.second.block);
+					entry.second.sideband.serialize (stream, entry.second.block->type ());
 				}
-			}
-		});
-		logger.info (nano::log::type::ledger, "{} entries converted ({}%)", count.load (), table_size > 0 ? count.load () * 100 / table_size : 100);
-
-		logger.info (nano::log::type::ledger, "Finalizing migration...");
-
-		auto lmdb_transaction (tx_begin_read ());
-		auto version = store.version.get (lmdb_transaction);
-		auto rocksdb_transaction (rocksdb_store->tx_begin_write ());
-		rocksdb_store->version.put (rocksdb_transaction, version);
-
-		for (auto i (store.online_weight.begin (lmdb_transaction)), n (store.online_weight.end (lmdb_transaction)); i != n; ++i)
+				return writer.Put (db_val{ entry.first }, db_val{ vector.size (), vector.data () });
+			});
+		} });
+		if (!error)
 		{
-			rocksdb_store->online_weight.put (rocksdb_transaction, i->first, i->second);
+			migrate_table (tables::pending, "pending", std::function{ [this] (nano::uint512_t const & start, nano::uint512_t const & end, bool is_last, ::rocksdb::SstFileWriter & writer) {
+				nano::uint512_union union_start (start);
+				nano::uint512_union union_end (end);
+				nano::pending_key key_start (union_start.uint256s[0].number (), union_start.uint256s[1].number ());
+				nano::pending_key key_end (union_end.uint256s[0].number (), union_end.uint256s[1].number ());
+				auto transaction = store.tx_begin_read ();
+				return write_sst (store.pending.begin (transaction, key_start), !is_last ? store.pending.begin (transaction, key_end) : store.pending.end (transaction), [&writer] (auto const & entry) {
+					return writer.Put (db_val{ entry.first }, db_val{ entry.second });
+				});
+			} });
 		}
-
-		for (auto i (store.peer.begin (lmdb_transaction)), n (store.peer.end (lmdb_transaction)); i != n; ++i)
+		if (!error)
 		{
-			rocksdb_store->peer.put (rocksdb_transaction, i->first, i->second);
+			migrate_table (tables::confirmation_height, "confirmation_height", convert_entries<nano::uint256_t> (store, store.confirmation_height));
+		}
+		if (!error)
+		{
+			migrate_table (tables::accounts, "accounts", convert_entries<nano::uint256_t> (store, store.account));
+		}
+		if (!error)
+		{
+			migrate_table (tables::rep_weights, "rep_weights", convert_entries<nano::uint256_t> (store, store.rep_weight));
+		}
+		if (!error)
+		{
+			migrate_table (tables::pruned, "pruned", convert_entries<nano::uint256_t> (store, store.pruned));
+		}
+		if (!error)
+		{
+			migrate_table (tables::final_votes, "final_votes", convert_entries<nano::uint512_t> (store, store.final_vote));
 		}
 
-		// Compare counts
-		error |= store.peer.count (lmdb_transaction) != rocksdb_store->peer.count (rocksdb_transaction);
-		error |= store.pruned.count (lmdb_transaction) != rocksdb_store->pruned.count (rocksdb_transaction);
-		error |= store.final_vote.count (lmdb_transaction) != rocksdb_store->final_vote.count (rocksdb_transaction);
-		error |= store.online_weight.count (lmdb_transaction) != rocksdb_store->online_weight.count (rocksdb_transaction);
-		error |= store.rep_weight.count (lmdb_transaction) != rocksdb_store->rep_weight.count (rocksdb_transaction);
-		error |= store.version.get (lmdb_transaction) != rocksdb_store->version.get (rocksdb_transaction);
-
-		// For large tables a random key is used instead and makes sure it exists
-		auto blocks = random_blocks (lmdb_transaction, 42);
-		release_assert (!blocks.empty ());
-		for (auto const & block : blocks)
+		if (!error)
 		{
-			auto const account = block->account ();
+			logger.info (nano::log::type::ledger, "Finalizing migration...");
 
-			error |= rocksdb_store->block.get (rocksdb_transaction, block->hash ()) == nullptr;
+			auto lmdb_transaction (tx_begin_read ());
+			auto version = store.version.get (lmdb_transaction);
+			auto rocksdb_transaction (rocksdb_store.tx_begin_write ());
+			rocksdb_store.version.put (rocksdb_transaction, version);
 
-			nano::account_info account_info;
-			error |= rocksdb_store->account.get (rocksdb_transaction, account, account_info);
+			for (auto i (store.online_weight.begin (lmdb_transaction)), n (store.online_weight.end (lmdb_transaction)); i != n; ++i)
+			{
+				rocksdb_store.online_weight.put (rocksdb_transaction, i->first, i->second);
+			}
 
-			// If confirmation height exists in the lmdb ledger for this account it should exist in the rocksdb ledger
-			nano::confirmation_height_info confirmation_height_info{};
-			if (!store.confirmation_height.get (lmdb_transaction, account, confirmation_height_info))
+			for (auto i (store.peer.begin (lmdb_transaction)), n (store.peer.end (lmdb_transaction)); i != n; ++i)
 			{
-				error |= rocksdb_store->confirmation_height.get (rocksdb_transaction, account, confirmation_height_info);
+				rocksdb_store.peer.put (rocksdb_transaction, i->first, i->second);
+			}
+
+			// Compare counts, the number of entries ingested into the large tables has been recorded in the checkpoint
+			error |= checkpoint.get<uint64_t> ("completed.blocks") != store.count (lmdb_transaction, tables::blocks);
+			error |= checkpoint.get<uint64_t> ("completed.pending") != store.count (lmdb_transaction, tables::pending);
+			error |= checkpoint.get<uint64_t> ("completed.confirmation_height") != store.count (lmdb_transaction, tables::confirmation_height);
+			error |= checkpoint.get<uint64_t> ("completed.accounts") != store.count (lmdb_transaction, tables::accounts);
+			error |= store.peer.count (lmdb_transaction) != rocksdb_store.peer.count (rocksdb_transaction);
+			error |= store.pruned.count (lmdb_transaction) != rocksdb_store.pruned.count (rocksdb_transaction);
+			error |= store.final_vote.count (lmdb_transaction) != rocksdb_store.final_vote.count (rocksdb_transaction);
+			error |= store.online_weight.count (lmdb_transaction) != rocksdb_store.online_weight.count (rocksdb_transaction);
+			error |= store.rep_weight.count (lmdb_transaction) != rocksdb_store.rep_weight.count (rocksdb_transaction);
+			error |= store.version.get (lmdb_transaction) != rocksdb_store.version.get (rocksdb_transaction);
+
+			// For large tables a random key is used instead and makes sure it exists
+			auto blocks = random_blocks (lmdb_transaction, 42);
+			release_assert (!blocks.empty ());
+			for (auto const & block : blocks)
+			{
+				auto const account = block->account ();
+
+				error |= rocksdb_store.block.get (rocksdb_transaction, block->hash ()) == nullptr;
+
+				nano::account_info account_info;
+				error |= rocksdb_store.account.get (rocksdb_transaction, account, account_info);
+
+				// If confirmation height exists in the lmdb ledger for this account it should exist in the rocksdb ledger
+				nano::confirmation_height_info confirmation_height_info{};
+				if (!store.confirmation_height.get (lmdb_transaction, account, confirmation_height_info))
+				{
+					error |= rocksdb_store.confirmation_height.get (rocksdb_transaction, account, confirmation_height_info);
+				}
 			}
 		}
 
-		logger.info (nano::log::type::ledger, "Migration completed. Make sure to enable RocksDB in the config file under [node.rocksdb]");
-		logger.info (nano::log::type::ledger, "After confirming correct node operation, the data.ldb file can be deleted if no longer required");
+		if (!error)
+		{
+			std::filesystem::remove_all (migration_path);
+
+			auto const elapsed = std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now () - migration_start);
+			logger.info (nano::log::type::ledger, "Migration completed in {} s, {} MB written to SST files", elapsed.count (), total_bytes / 1024 / 1024);
+			logger.info (nano::log::type::ledger, "Make sure to enable RocksDB in the config file under [node.rocksdb]");
+			logger.info (nano::log::type::ledger, "After confirming correct node operation, the data.ldb file can be deleted if no longer required");
+		}
+		else
+		{
+			logger.error (nano::log::type::ledger, "Migration failed, running it again resumes from '{}'", checkpoint_path.string ());
+		}
 	}
 	else
 	{
@@ -1554,5 +2033,6 @@ nano::container_info nano::ledger::container_info () const
 	nano::container_info info;
 	info.put ("bootstrap_weights", bootstrap_weights);
 	info.add ("rep_weights", cache.rep_weights.container_info ());
+	info.add ("receivable_sums", cache.receivable_sums.container_info ());
 	return info;
 }
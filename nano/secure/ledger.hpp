@@ -9,6 +9,7 @@
 #include <nano/secure/transaction.hpp>
 
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 
@@ -21,6 +22,7 @@ namespace nano
 {
 class block;
 enum class block_status;
+class confirmation_height_info;
 enum class epoch : uint8_t;
 class ledger_constants;
 class ledger_set_any;
@@ -45,6 +47,13 @@ public:
 
 	bool unconfirmed_exists (secure::transaction const &, nano::block_hash const &);
 	nano::uint128_t account_receivable (secure::transaction const &, nano::account const &, bool = false);
+	/**
+	 * Visits the receivable entries of \p accounts, which must be sorted in ascending order, in a single forward pass over the pending table.
+	 * The cursor is only repositioned when it falls behind the next account and accounts the receivable sums cache knows to have nothing receivable are skipped without a lookup.
+	 * With \p check_confirmation the confirmation of each send is passed to \p action, confirmation heights are looked up once per source account and sends from fully confirmed accounts need no block lookup.
+	 * \p action returns false to skip the remaining entries of the current account.
+	 */
+	void receivable_for_each (secure::transaction const &, std::vector<nano::account> const & accounts, bool check_confirmation, std::function<bool (nano::pending_key const &, nano::pending_info const &, bool confirmed)> const & action) const;
 	/**
 	 * Returns the cached vote weight for the given representative.
 	 * If the weight is below the cache limit it returns 0.
@@ -66,6 +75,9 @@ public:
 	bool rollback (secure::write_transaction const &, nano::block_hash const &, std::deque<std::shared_ptr<nano::block>> & rollback_list);
 	bool rollback (secure::write_transaction const &, nano::block_hash const &);
 	void update_account (secure::write_transaction const &, nano::account const &, nano::account_info const &, nano::account_info const &);
+	/** Writes to the pending table, keeping the receivable sums cache up to date */
+	void pending_put (secure::write_transaction const &, nano::pending_key const &, nano::pending_info const &);
+	void pending_del (secure::write_transaction const &, nano::pending_key const &);
 	uint64_t pruning_action (secure::write_transaction &, nano::block_hash const &, uint64_t const);
 	void dump_account_chain (nano::account const &, std::ostream & = std::cout);
 	bool dependents_confirmed (secure::transaction const &, nano::block const &) const;
@@ -86,6 +98,13 @@ public:
 	uint64_t pruned_count () const;
 	uint64_t backlog_count () const;
 
+	/**
+	 * Writes the ledger cache to the snapshot file configured in the generate cache flags, tagged with the store identity and commit sequence.
+	 * Writers are blocked while the cache is captured so it matches the committed database state.
+	 * Returns true if no snapshot was written, either because snapshots are disabled, the cache was only partially generated or on I/O error
+	 */
+	bool write_cache_snapshot ();
+
 	// Returned priority balance is maximum of block balance and previous block balance to handle full account balance send cases
 	// Returned timestamp is the previous block timestamp or the current timestamp if there's no previous block
 	using block_priority_result = std::pair<nano::amount, nano::priority_timestamp>;
@@ -109,7 +128,20 @@ public:
 
 private:
 	void initialize (nano::generate_cache_flags const &);
-	void confirm_one (secure::write_transaction &, nano::block const & block);
+	void initialize_receivable_sums ();
+	/** Loads the ledger cache from the snapshot file, returns true if it is missing, corrupt or does not match the database */
+	bool read_cache_snapshot ();
+	/** Checksum of a snapshot payload, also covers the store vendor as commit sequences are only comparable within one store implementation */
+	nano::uint256_union cache_snapshot_checksum (std::vector<uint8_t> const & payload) const;
+	std::shared_ptr<nano::block> lowest_unconfirmed (secure::transaction const &, std::shared_ptr<nano::block> const & top, nano::confirmation_height_info const &) const;
+	/** Confirms consecutive blocks of a single account with one confirmation height update */
+	void confirm_segment (secure::write_transaction &, std::deque<std::shared_ptr<nano::block>> const & segment);
+
+	std::filesystem::path const cache_snapshot;
+	/** Whether all caches have been generated or loaded, only complete caches are written to snapshots */
+	bool cache_complete{ false };
+
+	static uint8_t constexpr cache_snapshot_version{ 2 };
 
 	std::unique_ptr<ledger_set_any> any_impl;
 	std::unique_ptr<ledger_set_confirmed> confirmed_impl;
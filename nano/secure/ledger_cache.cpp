@@ -4,3 +4,29 @@ nano::ledger_cache::ledger_cache (nano::store::rep_weight & rep_weight_store_a,
 	rep_weights{ rep_weight_store_a, min_rep_weight_a }
 {
 }
+
+void nano::ledger_cache::serialize (nano::stream & stream_a) const
+{
+	nano::write (stream_a, cemented_count.load ());
+	nano::write (stream_a, block_count.load ());
+	nano::write (stream_a, pruned_count.load ());
+	nano::write (stream_a, account_count.load ());
+	rep_weights.serialize (stream_a);
+}
+
+void nano::ledger_cache::deserialize (nano::stream & stream_a)
+{
+	uint64_t cemented_count_l;
+	uint64_t block_count_l;
+	uint64_t pruned_count_l;
+	uint64_t account_count_l;
+	nano::read (stream_a, cemented_count_l);
+	nano::read (stream_a, block_count_l);
+	nano::read (stream_a, pruned_count_l);
+	nano::read (stream_a, account_count_l);
+	rep_weights.deserialize (stream_a);
+	cemented_count = cemented_count_l;
+	block_count = block_count_l;
+	pruned_count = pruned_count_l;
+	account_count = account_count_l;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <nano/lib/numbers.hpp>
+#include <nano/lib/stream.hpp>
+#include <nano/secure/receivable_sums.hpp>
 #include <nano/secure/rep_weights.hpp>
 #include <nano/store/rep_weight.hpp>
 
@@ -26,6 +28,12 @@ class ledger_cache
 public:
 	explicit ledger_cache (nano::store::rep_weight & rep_weight_store_a, nano::uint128_t min_rep_weight_a = 0);
 	nano::rep_weights rep_weights;
+	/** Not part of snapshots, generated from the pending table at startup when enabled */
+	nano::receivable_sums receivable_sums;
+
+	void serialize (nano::stream &) const;
+	/** Replaces the cached counts and weights, throws std::runtime_error if they cannot be read */
+	void deserialize (nano::stream &);
 
 private:
 	std::atomic<uint64_t> cemented_count{ 0 };
@@ -1,29 +1,113 @@
 #pragma once
 
+#include <nano/lib/locks.hpp>
 #include <nano/lib/thread_roles.hpp>
 #include <nano/lib/threading.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <optional>
 #include <thread>
 #include <vector>
 
+namespace nano
+{
+class parallel_traversal_config final
+{
+public:
+	/** Number of threads, 0 selects a count suitable for I/O bound traversals */
+	unsigned threads{ 0 };
+	/** The key space is split into this many ranges per thread so that idle threads can take over ranges from slower ones */
+	unsigned ranges_per_thread{ 16 };
+	/** Called from the traversal threads after each range, with the number of completed and total ranges */
+	std::function<void (std::size_t completed, std::size_t total)> progress;
+
+	unsigned thread_count () const
+	{
+		// Between 10 and 40 threads, scales well even in low power systems as long as actions are I/O bound
+		return threads != 0 ? threads : std::max (10u, std::min (40u, 10 * nano::hardware_concurrency ()));
+	}
+};
+
+/**
+ * Hands out ranges to traversal threads. Each thread starts with its own run of adjacent ranges to keep database access local.
+ * A thread which finished its run takes over the upper half of the largest remaining run of another thread.
+ */
+class parallel_traversal_scheduler final
+{
+public:
+	parallel_traversal_scheduler (unsigned threads, std::size_t ranges)
+	{
+		runs.reserve (threads);
+		for (unsigned thread = 0; thread < threads; ++thread)
+		{
+			runs.emplace_back (ranges * thread / threads, ranges * (thread + 1) / threads);
+		}
+	}
+
+	/** Returns the index of the next range to traverse by \p thread or nullopt once all ranges have been handed out */
+	std::optional<std::size_t> next (unsigned thread)
+	{
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		auto & [begin, end] = runs[thread];
+		if (begin == end)
+		{
+			auto largest = std::max_element (runs.begin (), runs.end (), [] (auto const & lhs, auto const & rhs) {
+				return lhs.second - lhs.first < rhs.second - rhs.first;
+			});
+			if (largest->first == largest->second)
+			{
+				return std::nullopt;
+			}
+			auto middle = largest->first + (largest->second - largest->first) / 2;
+			begin = middle;
+			end = largest->second;
+			largest->second = middle;
+		}
+		return begin++;
+	}
+
+private:
+	nano::mutex mutex;
+	// Ranges [first, second) not yet started by each thread
+	std::vector<std::pair<std::size_t, std::size_t>> runs;
+};
+}
+
+/**
+ * Splits the key space of \p T into ranges and calls \p action for each of them from a pool of threads.
+ * The action receives the range, whether it is the last range (which is unbounded) and the index of the calling thread,
+ * which allows results to be accumulated per thread and merged once the traversal has finished.
+ */
 template <typename T>
-void parallel_traversal (std::function<void (T const &, T const &, bool const)> const & action)
+void parallel_traversal (nano::parallel_traversal_config const & config, std::function<void (T const &, T const &, bool const, unsigned const)> const & action)
 {
-	// Between 10 and 40 threads, scales well even in low power systems as long as actions are I/O bound
-	unsigned const thread_count = std::max (10u, std::min (40u, 10 * nano::hardware_concurrency ()));
+	auto const thread_count = config.thread_count ();
+	auto const range_count = static_cast<std::size_t> (thread_count) * std::max (config.ranges_per_thread, 1u);
 	T const value_max{ std::numeric_limits<T>::max () };
-	T const split = value_max / thread_count;
+	T const split = value_max / range_count;
+	nano::parallel_traversal_scheduler scheduler{ thread_count, range_count };
+	std::atomic<std::size_t> completed{ 0 };
 	std::vector<std::thread> threads;
 	threads.reserve (thread_count);
 	for (unsigned thread (0); thread < thread_count; ++thread)
 	{
-		T const start = thread * split;
-		T const end = (thread + 1) * split;
-		bool const is_last = thread == thread_count - 1;
-
-		threads.emplace_back ([&action, start, end, is_last] {
+		threads.emplace_back ([&, thread] {
 			nano::thread_role::set (nano::thread_role::name::db_parallel_traversal);
-			action (start, end, is_last);
+			while (auto range = scheduler.next (thread))
+			{
+				T const start = T{ *range } * split;
+				T const end = T{ *range + 1 } * split;
+				bool const is_last = *range == range_count - 1;
+				action (start, end, is_last, thread);
+				auto const completed_l = ++completed;
+				if (config.progress)
+				{
+					config.progress (completed_l, range_count);
+				}
+			}
 		});
 	}
 	for (auto & thread : threads)
@@ -31,3 +115,11 @@ void parallel_traversal (std::function<void (T const &, T const &, bool const)>
 		thread.join ();
 	}
 }
+
+template <typename T>
+void parallel_traversal (std::function<void (T const &, T const &, bool const)> const & action)
+{
+	parallel_traversal<T> (nano::parallel_traversal_config{}, [&action] (T const & start, T const & end, bool const is_last, unsigned const) {
+		action (start, end, is_last);
+	});
+}
@@ -0,0 +1,74 @@
+#include <nano/lib/utility.hpp>
+#include <nano/secure/receivable_sums.hpp>
+
+bool nano::receivable_sums::enabled () const
+{
+	return enabled_m.load ();
+}
+
+void nano::receivable_sums::enable ()
+{
+	enabled_m = true;
+}
+
+void nano::receivable_sums::add (nano::account const & account_a, nano::uint128_t const & amount_a)
+{
+	if (enabled ())
+	{
+		std::unique_lock guard{ mutex };
+		sums[account_a] += amount_a;
+	}
+}
+
+void nano::receivable_sums::subtract (nano::account const & account_a, nano::uint128_t const & amount_a)
+{
+	if (enabled ())
+	{
+		std::unique_lock guard{ mutex };
+		auto existing = sums.find (account_a);
+		debug_assert (existing != sums.end () && existing->second >= amount_a);
+		if (existing != sums.end ())
+		{
+			existing->second -= std::min (existing->second, amount_a);
+			if (existing->second == 0)
+			{
+				sums.erase (existing);
+			}
+		}
+	}
+}
+
+std::optional<nano::uint128_t> nano::receivable_sums::get (nano::account const & account_a) const
+{
+	if (!enabled ())
+	{
+		return std::nullopt;
+	}
+	std::shared_lock guard{ mutex };
+	auto existing = sums.find (account_a);
+	return existing != sums.end () ? existing->second : nano::uint128_t{ 0 };
+}
+
+void nano::receivable_sums::merge (std::unordered_map<nano::account, nano::uint128_t> const & other_a)
+{
+	std::unique_lock guard{ mutex };
+	for (auto const & [account, amount] : other_a)
+	{
+		sums[account] += amount;
+	}
+}
+
+size_t nano::receivable_sums::size () const
+{
+	std::shared_lock guard{ mutex };
+	return sums.size ();
+}
+
+nano::container_info nano::receivable_sums::container_info () const
+{
+	std::shared_lock guard{ mutex };
+
+	nano::container_info info;
+	info.put ("sums", sums);
+	return info;
+}
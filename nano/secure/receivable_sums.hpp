@@ -0,0 +1,39 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+#include <nano/lib/numbers_templ.hpp>
+#include <nano/lib/utility.hpp>
+
+#include <atomic>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace nano
+{
+/**
+ * Sum of the receivable amounts of each destination account, regardless of whether the sends are confirmed.
+ * Only kept when enabled through the generate cache flags, the ledger updates it together with the pending table.
+ */
+class receivable_sums final
+{
+public:
+	bool enabled () const;
+	/** Only use this method after the sums have been generated from the pending table */
+	void enable ();
+	void add (nano::account const &, nano::uint128_t const & amount);
+	void subtract (nano::account const &, nano::uint128_t const & amount);
+	/** Returns the receivable sum of \p account, or nullopt if the cache is disabled */
+	std::optional<nano::uint128_t> get (nano::account const &) const;
+	/* Only use this method when generating the sums from the pending table */
+	void merge (std::unordered_map<nano::account, nano::uint128_t> const &);
+	size_t size () const;
+	nano::container_info container_info () const;
+
+private:
+	mutable std::shared_mutex mutex;
+	/** Accounts without receivable entries are not stored */
+	std::unordered_map<nano::account, nano::uint128_t> sums;
+	std::atomic<bool> enabled_m{ false };
+};
+}
@@ -68,6 +68,41 @@ void nano::rep_weights::copy_from (nano::rep_weights & other_a)
 	}
 }
 
+void nano::rep_weights::serialize (nano::stream & stream_a) const
+{
+	std::shared_lock guard{ mutex };
+	nano::write (stream_a, nano::uint128_union{ min_weight });
+	nano::write (stream_a, static_cast<uint64_t> (rep_amounts.size ()));
+	for (auto const & [rep, amount] : rep_amounts)
+	{
+		nano::write (stream_a, rep);
+		nano::write (stream_a, nano::uint128_union{ amount });
+	}
+}
+
+void nano::rep_weights::deserialize (nano::stream & stream_a)
+{
+	nano::uint128_union min_weight_l;
+	nano::read (stream_a, min_weight_l);
+	if (min_weight_l != min_weight)
+	{
+		throw std::runtime_error ("Representative weights were filtered with a different minimum weight");
+	}
+	uint64_t count;
+	nano::read (stream_a, count);
+	std::unordered_map<nano::account, nano::uint128_t> rep_amounts_l;
+	for (uint64_t i = 0; i < count; ++i)
+	{
+		nano::account rep;
+		nano::uint128_union amount;
+		nano::read (stream_a, rep);
+		nano::read (stream_a, amount);
+		rep_amounts_l.emplace (rep, amount.number ());
+	}
+	std::unique_lock guard{ mutex };
+	rep_amounts = std::move (rep_amounts_l);
+}
+
 void nano::rep_weights::put_cache (nano::account const & account_a, nano::uint128_union const & representation_a)
 {
 	auto it = rep_amounts.find (account_a);
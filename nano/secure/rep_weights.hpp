@@ -2,6 +2,7 @@
 
 #include <nano/lib/numbers.hpp>
 #include <nano/lib/numbers_templ.hpp>
+#include <nano/lib/stream.hpp>
 #include <nano/lib/utility.hpp>
 
 #include <memory>
@@ -29,6 +30,10 @@ public:
 	std::unordered_map<nano::account, nano::uint128_t> get_rep_amounts () const;
 	/* Only use this method when loading rep weights from the database table */
 	void copy_from (rep_weights & other_a);
+	/* Writes the cached weights together with the minimum weight they were filtered with */
+	void serialize (nano::stream &) const;
+	/* Replaces the cached weights, throws if they cannot be read or were filtered with a different minimum weight. Only use this method when loading a ledger cache snapshot */
+	void deserialize (nano::stream &);
 	size_t size () const;
 	nano::container_info container_info () const;
 
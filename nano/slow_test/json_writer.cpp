@@ -0,0 +1,77 @@
+#include <nano/lib/json_writer.hpp>
+#include <nano/lib/numbers.hpp>
+
+#include <gtest/gtest.h>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Compares building an account_history shaped response through a ptree and write_json against streaming it through json_writer
+TEST (json_writer, benchmark_history)
+{
+	auto const entries = 100'000;
+	auto const account_text = nano::account{ 1 }.to_account ();
+
+	auto fill = [&] (auto && put_entry) {
+		for (auto i = 0; i < entries; ++i)
+		{
+			put_entry ("send", account_text, std::to_string (i * 1000), std::to_string (i), nano::block_hash{ static_cast<uint64_t> (i) }.to_string ());
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now ();
+	std::string ptree_result;
+	{
+		boost::property_tree::ptree response;
+		response.put ("account", account_text);
+		boost::property_tree::ptree history;
+		fill ([&history] (auto const & type, auto const & account, auto const & amount, auto const & height, auto const & hash) {
+			boost::property_tree::ptree entry;
+			entry.put ("type", type);
+			entry.put ("account", account);
+			entry.put ("amount", amount);
+			entry.put ("local_timestamp", "0");
+			entry.put ("height", height);
+			entry.put ("hash", hash);
+			entry.put ("confirmed", "true");
+			history.push_back (std::make_pair ("", entry));
+		});
+		response.add_child ("history", history);
+		std::stringstream ostream;
+		boost::property_tree::write_json (ostream, response);
+		ptree_result = ostream.str ();
+	}
+	auto ptree_duration = std::chrono::steady_clock::now () - start;
+
+	start = std::chrono::steady_clock::now ();
+	std::string writer_result;
+	{
+		nano::json_writer writer;
+		writer.put ("account", account_text);
+		writer.begin_array ("history");
+		fill ([&writer] (auto const & type, auto const & account, auto const & amount, auto const & height, auto const & hash) {
+			writer.begin_object ();
+			writer.put ("type", type);
+			writer.put ("account", account);
+			writer.put ("amount", amount);
+			writer.put ("local_timestamp", "0");
+			writer.put ("height", height);
+			writer.put ("hash", hash);
+			writer.put ("confirmed", "true");
+			writer.end ();
+		});
+		writer.end ();
+		writer_result = writer.finish ();
+	}
+	auto writer_duration = std::chrono::steady_clock::now () - start;
+
+	ASSERT_EQ (ptree_result, writer_result);
+	std::cout << "entries: " << entries << ", bytes: " << writer_result.size () << std::endl;
+	std::cout << "ptree + write_json: " << std::chrono::duration_cast<std::chrono::milliseconds> (ptree_duration).count () << " ms" << std::endl;
+	std::cout << "json_writer: " << std::chrono::duration_cast<std::chrono::milliseconds> (writer_duration).count () << " ms" << std::endl;
+}
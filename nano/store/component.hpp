@@ -89,6 +89,8 @@ namespace store
 		virtual read_transaction tx_begin_read () const = 0;
 
 		virtual std::string vendor_get () const = 0;
+		/** Identifies the last committed write, changes with every commit which modified the database including across restarts */
+		virtual uint64_t commit_sequence () const = 0;
 	};
 } // namespace store
 } // namespace nano
@@ -178,6 +178,15 @@ std::string nano::store::lmdb::component::vendor_get () const
 	return boost::str (boost::format ("LMDB %1%.%2%.%3%") % MDB_VERSION_MAJOR % MDB_VERSION_MINOR % MDB_VERSION_PATCH);
 }
 
+uint64_t nano::store::lmdb::component::commit_sequence () const
+{
+	// Transaction ids are only incremented by write transactions which modified the environment
+	MDB_envinfo info;
+	auto status = mdb_env_info (env, &info);
+	release_assert_success (status);
+	return info.me_last_txnid;
+}
+
 nano::store::lmdb::txn_callbacks nano::store::lmdb::component::create_txn_callbacks () const
 {
 	nano::store::lmdb::txn_callbacks mdb_txn_callbacks;
@@ -68,6 +68,7 @@ public:
 	store::read_transaction tx_begin_read () const override;
 
 	std::string vendor_get () const override;
+	uint64_t commit_sequence () const override;
 
 	void serialize_mdb_tracker (boost::property_tree::ptree &, std::chrono::milliseconds, std::chrono::milliseconds) override;
 
@@ -15,6 +15,8 @@ public:
 	explicit version (nano::store::lmdb::component & store_a);
 	void put (store::write_transaction const & transaction_a, int version_a) override;
 	int get (store::transaction const & transaction_a) const override;
+	nano::uint256_union identity_get (store::transaction const & transaction_a) const override;
+	void identity_put (store::write_transaction const & transaction_a, nano::uint256_union const & identity_a) override;
 
 	/**
 	 * Meta information about block store, such as versions.
@@ -15,6 +15,7 @@
 #include <rocksdb/merge_operator.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/slice_transform.h>
+#include <rocksdb/sst_file_reader.h>
 #include <rocksdb/utilities/backup_engine.h>
 #include <rocksdb/utilities/transaction.h>
 
@@ -421,6 +422,11 @@ std::string nano::store::rocksdb::component::vendor_get () const
 	return boost::str (boost::format ("RocksDB %1%.%2%.%3%") % ROCKSDB_MAJOR % ROCKSDB_MINOR % ROCKSDB_PATCH);
 }
 
+uint64_t nano::store::rocksdb::component::commit_sequence () const
+{
+	return db->GetLatestSequenceNumber ();
+}
+
 std::vector<::rocksdb::ColumnFamilyDescriptor> nano::store::rocksdb::component::get_single_column_family (std::string cf_name) const
 {
 	std::vector<::rocksdb::ColumnFamilyDescriptor> minimum_cf_set{
@@ -912,6 +918,36 @@ unsigned nano::store::rocksdb::component::max_block_write_batch_num () const
 	return max_block_write_batch_num_m;
 }
 
+std::unique_ptr<::rocksdb::SstFileWriter> nano::store::rocksdb::component::sst_writer (tables table_a) const
+{
+	auto column_family = table_to_column_family (table_a);
+	return std::make_unique<::rocksdb::SstFileWriter> (::rocksdb::EnvOptions{}, db->GetOptions (column_family), column_family);
+}
+
+std::optional<uint64_t> nano::store::rocksdb::component::sst_entries (tables table_a, std::filesystem::path const & file_a) const
+{
+	::rocksdb::SstFileReader reader{ db->GetOptions (table_to_column_family (table_a)) };
+	if (!reader.Open (file_a.string ()).ok () || !reader.VerifyChecksum ().ok ())
+	{
+		return std::nullopt;
+	}
+	return reader.GetTableProperties ()->num_entries;
+}
+
+bool nano::store::rocksdb::component::ingest (tables table_a, std::vector<std::filesystem::path> const & files_a)
+{
+	std::vector<std::string> files;
+	std::transform (files_a.begin (), files_a.end (), std::back_inserter (files), [] (auto const & file) { return file.string (); });
+	::rocksdb::IngestExternalFileOptions options;
+	options.move_files = true;
+	auto status = db->IngestExternalFile (table_to_column_family (table_a), files, options);
+	if (!status.ok ())
+	{
+		logger.error (nano::log::type::rocksdb, "Failed to ingest SST files: {}", status.ToString ());
+	}
+	return !status.ok ();
+}
+
 std::string nano::store::rocksdb::component::error_string (int status) const
 {
 	return std::to_string (status);
@@ -21,6 +21,7 @@
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/options.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/sst_file_writer.h>
 #include <rocksdb/table.h>
 #include <rocksdb/utilities/transaction_db.h>
 
@@ -70,6 +71,7 @@ public:
 	store::read_transaction tx_begin_read () const override;
 
 	std::string vendor_get () const override;
+	uint64_t commit_sequence () const override;
 
 	uint64_t count (store::transaction const & transaction_a, tables table_a) const override;
 
@@ -85,6 +87,13 @@ public:
 
 	unsigned max_block_write_batch_num () const override;
 
+	/** Creates a writer for an SST file using the options of \p table_a, entries have to be added in ascending key order */
+	std::unique_ptr<::rocksdb::SstFileWriter> sst_writer (tables table_a) const;
+	/** Number of entries in an SST file created by sst_writer, nullopt if the file cannot be read */
+	std::optional<uint64_t> sst_entries (tables table_a, std::filesystem::path const & file_a) const;
+	/** Bulk loads SST files created by sst_writer into \p table_a, the files are moved into the database and must not overlap each other. Returns true on error */
+	bool ingest (tables table_a, std::vector<std::filesystem::path> const & files_a);
+
 	bool init_error () const override;
 
 	std::string error_string (int status) const override;
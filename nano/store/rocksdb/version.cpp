@@ -26,3 +26,23 @@ int nano::store::rocksdb::version::get (store::transaction const & transaction_a
 	}
 	return result;
 }
+
+nano::uint256_union nano::store::rocksdb::version::identity_get (store::transaction const & transaction_a) const
+{
+	nano::uint256_union identity_key{ 2 };
+	nano::store::rocksdb::db_val data;
+	auto status = store.get (transaction_a, tables::meta, identity_key, data);
+	nano::uint256_union result{ 0 };
+	if (store.success (status))
+	{
+		result = nano::uint256_union{ data };
+	}
+	return result;
+}
+
+void nano::store::rocksdb::version::identity_put (store::write_transaction const & transaction_a, nano::uint256_union const & identity_a)
+{
+	nano::uint256_union identity_key{ 2 };
+	auto status = store.put (transaction_a, tables::meta, identity_key, identity_a);
+	store.release_assert_success (status);
+}
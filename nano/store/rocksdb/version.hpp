@@ -13,5 +13,7 @@ public:
 	explicit version (nano::store::rocksdb::component & store_a);
 	void put (store::write_transaction const & transaction_a, int version_a) override;
 	int get (store::transaction const & transaction_a) const override;
+	nano::uint256_union identity_get (store::transaction const & transaction_a) const override;
+	void identity_put (store::write_transaction const & transaction_a, nano::uint256_union const & identity_a) override;
 };
 } // namespace nano::store::rocksdb
@@ -19,5 +19,8 @@ class version
 public:
 	virtual void put (store::write_transaction const &, int) = 0;
 	virtual int get (store::transaction const &) const = 0;
+	/** Random identifier of the database, unlike commit sequences it is not shared by different databases. Zero if none was stored yet */
+	virtual nano::uint256_union identity_get (store::transaction const &) const = 0;
+	virtual void identity_put (store::write_transaction const &, nano::uint256_union const &) = 0;
 };
 } // namespace nano::store
@@ -0,0 +1,525 @@
+#include <nano/lib/blocks.hpp>
+#include <nano/lib/stats_sinks.hpp>
+#include <nano/node/confirming_set.hpp>
+#include <nano/node/network.hpp>
+#include <nano/node/node.hpp>
+#include <nano/node/repcrawler.hpp>
+#include <nano/node/transport/inproc.hpp>
+#include <nano/test_common/simulator.hpp>
+#include <nano/test_common/system.hpp>
+
+#include <boost/format.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+namespace
+{
+// Keeps the keys of representatives apart from keys tests derive from the same seed
+uint32_t constexpr representative_index = 3'000'000;
+
+std::vector<nano::keypair> make_representatives (nano::test::simulator_config const & config)
+{
+	std::vector<nano::keypair> result;
+	for (std::size_t i = 0; i < std::min (config.representatives, config.nodes); ++i)
+	{
+		result.emplace_back (nano::deterministic_key (nano::raw_key{ config.seed }, representative_index + static_cast<uint32_t> (i)));
+	}
+	return result;
+}
+
+/** Value at \p percentile of \p samples, which are sorted in place */
+std::chrono::nanoseconds percentile (std::vector<std::chrono::nanoseconds> & samples, double percentile)
+{
+	if (samples.empty ())
+	{
+		return std::chrono::nanoseconds{ 0 };
+	}
+	std::sort (samples.begin (), samples.end ());
+	return samples[static_cast<std::size_t> ((samples.size () - 1) * percentile / 100.0)];
+}
+
+boost::property_tree::ptree serialize_latencies (std::vector<std::chrono::nanoseconds> samples)
+{
+	boost::property_tree::ptree result;
+	result.put ("count", samples.size ());
+	result.put ("p50_us", std::chrono::duration_cast<std::chrono::microseconds> (percentile (samples, 50)).count ());
+	result.put ("p99_us", std::chrono::duration_cast<std::chrono::microseconds> (percentile (samples, 99)).count ());
+	result.put ("max_us", std::chrono::duration_cast<std::chrono::microseconds> (percentile (samples, 100)).count ());
+	return result;
+}
+}
+
+/*
+ * link_scheduler
+ */
+
+nano::test::link_scheduler::link_scheduler () :
+	thread{ [this] () { run (); } }
+{
+}
+
+nano::test::link_scheduler::~link_scheduler ()
+{
+	stop ();
+}
+
+void nano::test::link_scheduler::stop ()
+{
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		stopped = true;
+		// Deliveries hold their channels, which hold this scheduler
+		deliveries = {};
+	}
+	condition.notify_all ();
+	if (thread.joinable ())
+	{
+		thread.join ();
+	}
+}
+
+void nano::test::link_scheduler::push (std::chrono::steady_clock::time_point arrival, std::shared_ptr<nano::test::simulated_channel> const & channel, nano::shared_const_buffer const & buffer)
+{
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		if (stopped)
+		{
+			return;
+		}
+		deliveries.push ({ arrival, sequence++, channel, buffer });
+	}
+	condition.notify_all ();
+}
+
+void nano::test::link_scheduler::run ()
+{
+	nano::unique_lock<nano::mutex> lock{ mutex };
+	while (!stopped)
+	{
+		if (deliveries.empty ())
+		{
+			condition.wait (lock);
+			continue;
+		}
+		auto const arrival = deliveries.top ().arrival;
+		if (arrival > std::chrono::steady_clock::now ())
+		{
+			condition.wait_until (lock, arrival);
+			continue;
+		}
+		auto next = deliveries.top ();
+		deliveries.pop ();
+		lock.unlock ();
+		next.channel->deliver (next.buffer);
+		lock.lock ();
+	}
+}
+
+/*
+ * simulated_channel
+ */
+
+nano::test::simulated_channel::simulated_channel (std::shared_ptr<nano::test::link_scheduler> scheduler_a, nano::node & node, nano::node & destination, nano::test::link_model const & model_a, uint64_t seed) :
+	transport::channel{ node },
+	destination{ destination },
+	scheduler{ std::move (scheduler_a) },
+	local_endpoint{ node.network.endpoint () },
+	remote_endpoint{ destination.network.endpoint () },
+	model{ model_a },
+	rng{ seed }
+{
+	set_node_id (destination.node_id.pub);
+	set_network_version (destination.network_params.network.protocol_version);
+}
+
+bool nano::test::simulated_channel::send_buffer (nano::shared_const_buffer const & buffer, nano::transport::traffic_type, nano::transport::channel::callback_t callback)
+{
+	if (closed)
+	{
+		return false;
+	}
+	auto const now = std::chrono::steady_clock::now ();
+	std::optional<std::chrono::steady_clock::time_point> arrival;
+	{
+		nano::lock_guard<nano::mutex> guard{ link_mutex };
+		auto const start = std::max (now, busy_until);
+		if (start - now > model.backlog)
+		{
+			++dropped;
+			return false;
+		}
+		auto const transmission = model.bandwidth > 0 ? std::chrono::nanoseconds{ buffer.size () * 1'000'000'000 / model.bandwidth } : std::chrono::nanoseconds{ 0 };
+		busy_until = start + transmission;
+		// Both values are drawn for every message, so the fate of a message only depends on its position on the link
+		auto const lost_l = std::uniform_real_distribution<double>{ 0.0, 1.0 }(rng) < model.loss;
+		auto const jitter = std::chrono::microseconds{ std::uniform_int_distribution<int64_t>{ 0, model.jitter.count () }(rng) };
+		if (!lost_l)
+		{
+			last_arrival = std::max (busy_until + model.latency + jitter, last_arrival);
+			arrival = last_arrival;
+		}
+	}
+	++sent;
+	sent_bytes += buffer.size ();
+	if (arrival)
+	{
+		scheduler->push (*arrival, shared_from_this (), buffer);
+	}
+	else
+	{
+		++lost;
+	}
+
+	if (callback)
+	{
+		node.io_ctx.post ([callback_l = std::move (callback), buffer_size = buffer.size ()] () {
+			callback_l (boost::system::errc::make_error_code (boost::system::errc::success), buffer_size);
+		});
+	}
+	return true;
+}
+
+bool nano::test::simulated_channel::max (nano::transport::traffic_type)
+{
+	nano::lock_guard<nano::mutex> guard{ link_mutex };
+	return busy_until - std::chrono::steady_clock::now () > model.backlog;
+}
+
+void nano::test::simulated_channel::set_model (nano::test::link_model const & model_a)
+{
+	nano::lock_guard<nano::mutex> guard{ link_mutex };
+	model = model_a;
+}
+
+void nano::test::simulated_channel::set_reverse (std::shared_ptr<nano::test::simulated_channel> const & reverse_a)
+{
+	reverse = reverse_a;
+}
+
+void nano::test::simulated_channel::deliver (nano::shared_const_buffer const & buffer)
+{
+	auto reverse_l = reverse.lock ();
+	if (!reverse_l || closed || destination.stopped)
+	{
+		return;
+	}
+	++delivered;
+	reverse_l->set_last_packet_received (std::chrono::steady_clock::now ());
+	// Parsed by the destination like a message read from its socket, so its duplicate filter applies
+	nano::transport::inproc::deliver (destination, destination, buffer.to_bytes (), reverse_l);
+}
+
+std::string nano::test::simulated_channel::to_string () const
+{
+	return boost::str (boost::format ("%1%") % remote_endpoint);
+}
+
+/*
+ * simulator
+ */
+
+nano::test::simulator::simulator (nano::test::system & system_a, nano::test::simulator_config const & config_a) :
+	representatives{ make_representatives (config_a) },
+	system{ system_a },
+	config{ config_a },
+	scheduler{ std::make_shared<nano::test::link_scheduler> () },
+	links (config_a.nodes),
+	tracker{ std::make_shared<confirmation_tracker> () }
+{
+	// Leaves a hundredth of the supply with genesis so tests have funds to send
+	if (!representatives.empty ())
+	{
+		system.ledger_initialization_set ({ representatives.begin (), representatives.end () }, nano::dev::constants.genesis_amount / 100);
+		system.set_cemented_initialization_blocks (system.initialization_blocks);
+		system.set_initialization_blocks ({});
+	}
+
+	nano::node_flags flags;
+	// Nodes only talk over simulated links
+	flags.disable_tcp_realtime = true;
+	for (std::size_t i = 0; i < config.nodes; ++i)
+	{
+		auto node_config = system.default_config ();
+		node_config.enable_voting = i < representatives.size ();
+		if (config.configure)
+		{
+			config.configure (node_config, i);
+		}
+		auto node = system.make_disconnected_node (node_config, flags);
+		if (i < representatives.size ())
+		{
+			node->wallets.create (nano::random_wallet_id ())->insert_adhoc (representatives[i].prv);
+		}
+		node->confirming_set.batch_cemented.add ([tracker_l = tracker, i] (auto const & cemented) {
+			for (auto const & context : cemented)
+			{
+				tracker_l->cemented (i, context.block->hash ());
+			}
+		});
+		nodes.push_back (node);
+	}
+
+	// A random tree keeps all nodes reachable, random peers are added until every node has enough links
+	std::mt19937_64 rng{ config.seed };
+	auto const full_mesh = config.peers == 0 || config.peers + 1 >= config.nodes;
+	for (std::size_t i = 1; i < config.nodes; ++i)
+	{
+		if (full_mesh)
+		{
+			for (std::size_t j = 0; j < i; ++j)
+			{
+				link (i, j, config.link);
+			}
+		}
+		else
+		{
+			link (i, std::uniform_int_distribution<std::size_t>{ 0, i - 1 }(rng), config.link);
+		}
+	}
+	for (std::size_t i = 0; i < config.nodes && !full_mesh; ++i)
+	{
+		while (links[i].size () < config.peers)
+		{
+			auto const peer = std::uniform_int_distribution<std::size_t>{ 0, config.nodes - 1 }(rng);
+			if (peer != i && !links[i].contains (peer))
+			{
+				link (i, peer, config.link);
+			}
+		}
+	}
+}
+
+nano::test::simulator::~simulator ()
+{
+	stop ();
+}
+
+void nano::test::simulator::stop ()
+{
+	for (auto const & node : nodes)
+	{
+		system.stop_node (*node);
+	}
+	scheduler->stop ();
+	nano::lock_guard<nano::mutex> guard{ mutex };
+	for (auto const & outgoing : links)
+	{
+		for (auto const & [peer, channel] : outgoing)
+		{
+			channel->close ();
+		}
+	}
+}
+
+nano::node & nano::test::simulator::node (std::size_t index) const
+{
+	debug_assert (index < nodes.size ());
+	return *nodes[index];
+}
+
+std::size_t nano::test::simulator::size () const
+{
+	return nodes.size ();
+}
+
+void nano::test::simulator::link (std::size_t first, std::size_t second, nano::test::link_model const & model)
+{
+	debug_assert (first != second);
+	auto seed = [this] (std::size_t source, std::size_t destination) {
+		std::seed_seq sequence{ config.seed, uint64_t{ source }, uint64_t{ destination } };
+		std::array<uint32_t, 2> words;
+		sequence.generate (words.begin (), words.end ());
+		return uint64_t{ words[0] } << 32 | words[1];
+	};
+	auto forward = std::make_shared<nano::test::simulated_channel> (scheduler, *nodes[first], *nodes[second], model, seed (first, second));
+	auto backward = std::make_shared<nano::test::simulated_channel> (scheduler, *nodes[second], *nodes[first], model, seed (second, first));
+	forward->set_reverse (backward);
+	backward->set_reverse (forward);
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		links[first][second] = forward;
+		links[second][first] = backward;
+	}
+	nodes[first]->network.tcp_channels.attach (forward);
+	nodes[second]->network.tcp_channels.attach (backward);
+}
+
+void nano::test::simulator::set_link (std::size_t first, std::size_t second, nano::test::link_model const & model)
+{
+	debug_assert (first < nodes.size () && second < nodes.size ());
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		if (auto existing = links[first].find (second); existing != links[first].end ())
+		{
+			existing->second->set_model (model);
+			links[second].at (first)->set_model (model);
+			return;
+		}
+	}
+	link (first, second, model);
+}
+
+bool nano::test::simulator::wait_representatives (std::chrono::nanoseconds timeout)
+{
+	// Representatives are only found among the peers of a node
+	std::vector<std::size_t> expected (nodes.size (), 0);
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		for (std::size_t i = 0; i < nodes.size (); ++i)
+		{
+			expected[i] = std::count_if (links[i].begin (), links[i].end (), [this] (auto const & link) { return link.first < representatives.size (); });
+		}
+	}
+	auto ec = system.poll_until_true (timeout, [this, &expected] () {
+		for (std::size_t i = 0; i < nodes.size (); ++i)
+		{
+			if (nodes[i]->rep_crawler.representative_count () < expected[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	});
+	return static_cast<bool> (ec);
+}
+
+bool nano::test::simulator::confirm (std::vector<std::shared_ptr<nano::block>> const & blocks, std::size_t origin, std::chrono::nanoseconds timeout)
+{
+	debug_assert (origin < nodes.size ());
+	tracker->start (blocks, nodes.size ());
+	auto & node = *nodes[origin];
+	for (auto const & block : blocks)
+	{
+		node.process_active (block);
+		node.network.flood_block_initial (block);
+	}
+	auto ec = system.poll_until_true (timeout, [this] () { return tracker->done (); });
+	return static_cast<bool> (ec);
+}
+
+std::vector<std::chrono::nanoseconds> nano::test::simulator::network_latencies () const
+{
+	nano::lock_guard<nano::mutex> guard{ tracker->mutex };
+	std::vector<std::chrono::nanoseconds> result;
+	for (std::size_t block = 0; block < tracker->started.size (); ++block)
+	{
+		std::chrono::nanoseconds latest{ 0 };
+		bool cemented_all = true;
+		for (auto const & latencies : tracker->latencies)
+		{
+			cemented_all = cemented_all && latencies[block].count () > 0;
+			latest = std::max (latest, latencies[block]);
+		}
+		if (cemented_all)
+		{
+			result.push_back (latest);
+		}
+	}
+	return result;
+}
+
+boost::property_tree::ptree nano::test::simulator::serialize () const
+{
+	boost::property_tree::ptree nodes_l;
+	for (std::size_t i = 0; i < nodes.size (); ++i)
+	{
+		auto & node = *nodes[i];
+		boost::property_tree::ptree entry;
+		entry.put ("index", i);
+		entry.put ("node_id", node.node_id.pub.to_node_id ());
+		entry.put ("representative", i < representatives.size ());
+
+		boost::property_tree::ptree links_l;
+		{
+			nano::lock_guard<nano::mutex> guard{ mutex };
+			for (auto const & [peer, channel] : links[i])
+			{
+				boost::property_tree::ptree link_l;
+				link_l.put ("peer", peer);
+				link_l.put ("sent", channel->sent.load ());
+				link_l.put ("sent_bytes", channel->sent_bytes.load ());
+				link_l.put ("dropped", channel->dropped.load ());
+				link_l.put ("lost", channel->lost.load ());
+				link_l.put ("delivered", channel->delivered.load ());
+				links_l.push_back (std::make_pair ("", link_l));
+			}
+		}
+		entry.add_child ("links", links_l);
+
+		std::vector<std::chrono::nanoseconds> cemented;
+		{
+			nano::lock_guard<nano::mutex> guard{ tracker->mutex };
+			if (i < tracker->latencies.size ())
+			{
+				std::copy_if (tracker->latencies[i].begin (), tracker->latencies[i].end (), std::back_inserter (cemented), [] (auto const & latency) { return latency.count () > 0; });
+			}
+		}
+		entry.add_child ("confirmation", serialize_latencies (std::move (cemented)));
+
+		nano::stat_json_writer sink;
+		node.stats.log_counters (sink);
+		entry.add_child ("stats", sink.to_ptree ());
+		nodes_l.push_back (std::make_pair ("", entry));
+	}
+
+	boost::property_tree::ptree result;
+	result.put ("nodes_count", nodes.size ());
+	result.put ("representatives", representatives.size ());
+	result.put ("seed", config.seed);
+	result.add_child ("confirmation", serialize_latencies (network_latencies ()));
+	result.add_child ("nodes", nodes_l);
+	return result;
+}
+
+bool nano::test::simulator::write_json (std::filesystem::path const & path) const
+{
+	std::ofstream file{ path };
+	if (!file)
+	{
+		return true;
+	}
+	boost::property_tree::write_json (file, serialize ());
+	return !file;
+}
+
+/*
+ * simulator::confirmation_tracker
+ */
+
+void nano::test::simulator::confirmation_tracker::start (std::vector<std::shared_ptr<nano::block>> const & blocks, std::size_t nodes)
+{
+	nano::lock_guard<nano::mutex> guard{ mutex };
+	indices.clear ();
+	for (auto const & block : blocks)
+	{
+		indices.emplace (block->hash (), indices.size ());
+	}
+	started.assign (blocks.size (), std::chrono::steady_clock::now ());
+	latencies.assign (nodes, std::vector<std::chrono::nanoseconds> (blocks.size (), std::chrono::nanoseconds{ 0 }));
+	remaining = nodes * blocks.size ();
+}
+
+void nano::test::simulator::confirmation_tracker::cemented (std::size_t node, nano::block_hash const & hash)
+{
+	auto const now = std::chrono::steady_clock::now ();
+	nano::lock_guard<nano::mutex> guard{ mutex };
+	if (auto existing = indices.find (hash); existing != indices.end () && node < latencies.size ())
+	{
+		auto & latency = latencies[node][existing->second];
+		if (latency.count () == 0)
+		{
+			latency = std::max<std::chrono::nanoseconds> (now - started[existing->second], std::chrono::nanoseconds{ 1 });
+			--remaining;
+		}
+	}
+}
+
+bool nano::test::simulator::confirmation_tracker::done () const
+{
+	nano::lock_guard<nano::mutex> guard{ mutex };
+	return remaining == 0;
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+#include <nano/node/fwd.hpp>
+#include <nano/node/transport/channel.hpp>
+#include <nano/secure/common.hpp>
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace nano::test
+{
+class system;
+
+/** Delivery characteristics of one direction of a link between two simulated nodes */
+class link_model final
+{
+public:
+	/** Propagation delay of every message */
+	std::chrono::microseconds latency{ 20'000 };
+	/** Upper bound of a uniformly distributed delay added to the latency. Messages of a link are still delivered in order */
+	std::chrono::microseconds jitter{ 0 };
+	/** Bytes per second, messages queue behind each other once the link is saturated. 0 is unlimited */
+	uint64_t bandwidth{ 0 };
+	/** Probability in [0, 1] of a message being lost after it was transmitted */
+	double loss{ 0.0 };
+	/** Messages are dropped instead of queued once transmitting the queued messages takes longer than this */
+	std::chrono::milliseconds backlog{ 1000 };
+};
+
+class simulator_config final
+{
+public:
+	std::size_t nodes{ 50 };
+	/** Number of nodes voting, the genesis weight is split evenly between them */
+	std::size_t representatives{ 8 };
+	/** Number of random peers every node links to, links are bidirectional. 0 links all pairs of nodes */
+	std::size_t peers{ 8 };
+	/** Model of all links until changed with simulator::set_link */
+	nano::test::link_model link;
+	/** Seed of the topology and of the loss and jitter of every link */
+	uint64_t seed{ 0 };
+	/** Called with the index of every node before it is started */
+	std::function<void (nano::node_config &, std::size_t index)> configure;
+};
+
+class simulated_channel;
+
+/**
+ * Delivers the messages of all links in the order of their arrival times, ties are resolved by the order they were sent in.
+ * Delivery runs on a single thread, the receiving node parses the message and queues it like a message read from a socket.
+ */
+class link_scheduler final
+{
+public:
+	link_scheduler ();
+	~link_scheduler ();
+
+	void stop ();
+	void push (std::chrono::steady_clock::time_point arrival, std::shared_ptr<nano::test::simulated_channel> const &, nano::shared_const_buffer const &);
+
+private:
+	void run ();
+
+	class delivery final
+	{
+	public:
+		std::chrono::steady_clock::time_point arrival;
+		uint64_t sequence;
+		std::shared_ptr<nano::test::simulated_channel> channel;
+		nano::shared_const_buffer buffer;
+
+		bool operator> (delivery const & other) const
+		{
+			return std::tie (arrival, sequence) > std::tie (other.arrival, other.sequence);
+		}
+	};
+
+	std::priority_queue<delivery, std::vector<delivery>, std::greater<delivery>> deliveries;
+	uint64_t sequence{ 0 };
+	bool stopped{ false };
+	nano::mutex mutex;
+	nano::condition_variable condition;
+	std::thread thread;
+};
+
+/**
+ * One direction of a simulated link, owned by the sending node.
+ * Messages are transmitted one after another at the bandwidth of the link and delivered after its latency.
+ * The reverse direction of the link is the reply channel of every delivered message, as with a tcp connection.
+ */
+class simulated_channel final : public nano::transport::channel, public std::enable_shared_from_this<simulated_channel>
+{
+public:
+	simulated_channel (std::shared_ptr<nano::test::link_scheduler>, nano::node & node, nano::node & destination, nano::test::link_model const &, uint64_t seed);
+
+	std::string to_string () const override;
+
+	nano::endpoint get_remote_endpoint () const override
+	{
+		return remote_endpoint;
+	}
+
+	nano::endpoint get_local_endpoint () const override
+	{
+		return local_endpoint;
+	}
+
+	nano::transport::transport_type get_type () const override
+	{
+		return nano::transport::transport_type::simulated;
+	}
+
+	void close () override
+	{
+		closed = true;
+	}
+
+	bool alive () const override
+	{
+		return !closed;
+	}
+
+	bool max (nano::transport::traffic_type) override;
+
+	void set_model (nano::test::link_model const &);
+	void set_reverse (std::shared_ptr<nano::test::simulated_channel> const &);
+	/** Passes a message that arrived to the destination node */
+	void deliver (nano::shared_const_buffer const &);
+
+	nano::node & destination;
+
+	std::atomic<uint64_t> sent{ 0 };
+	std::atomic<uint64_t> sent_bytes{ 0 };
+	/** Messages dropped because the backlog of the link was full */
+	std::atomic<uint64_t> dropped{ 0 };
+	std::atomic<uint64_t> lost{ 0 };
+	std::atomic<uint64_t> delivered{ 0 };
+
+protected:
+	bool send_buffer (nano::shared_const_buffer const &, nano::transport::traffic_type, nano::transport::channel::callback_t) override;
+
+private:
+	std::shared_ptr<nano::test::link_scheduler> scheduler;
+	nano::endpoint const local_endpoint;
+	nano::endpoint const remote_endpoint;
+	std::weak_ptr<nano::test::simulated_channel> reverse;
+	std::atomic<bool> closed{ false };
+
+	nano::mutex link_mutex;
+	nano::test::link_model model;
+	std::mt19937_64 rng;
+	/** Time the last queued message is fully transmitted */
+	std::chrono::steady_clock::time_point busy_until;
+	std::chrono::steady_clock::time_point last_arrival;
+};
+
+/**
+ * Runs a network of nodes in one process, connected by simulated links with configurable latency, bandwidth and loss instead of tcp connections.
+ * Nodes are created by \p system and use the regular networking, flooding and voting code, links are attached to their channel lists.
+ * Network wide confirmation latency is measured with confirm () and written together with the stats of every node by serialize ().
+ */
+class simulator final
+{
+public:
+	/** The initialization blocks of \p system are replaced by cemented blocks splitting the genesis weight between the representatives */
+	simulator (nano::test::system &, nano::test::simulator_config const &);
+	~simulator ();
+
+	/** Stops all nodes of the simulation and then the delivery of messages */
+	void stop ();
+
+	nano::node & node (std::size_t index) const;
+	std::size_t size () const;
+
+	/** Changes the model of both directions of the link between two nodes, linking them if they were not linked */
+	void set_link (std::size_t first, std::size_t second, nano::test::link_model const &);
+	/** Waits until every node found all representatives, otherwise votes are only flooded randomly
+	 * @returns true if the representatives were not found within \p timeout */
+	bool wait_representatives (std::chrono::nanoseconds timeout);
+
+	/**
+	 * Processes \p blocks on the node at \p origin, which floods them, and waits until every node cemented all of them.
+	 * The time from processing a block until a node cemented it is recorded for every node.
+	 * @returns true if not all nodes cemented all blocks within \p timeout
+	 */
+	bool confirm (std::vector<std::shared_ptr<nano::block>> const & blocks, std::size_t origin, std::chrono::nanoseconds timeout);
+
+	/** Time until each block of the last confirm () was cemented by every node, in the order of the blocks */
+	std::vector<std::chrono::nanoseconds> network_latencies () const;
+
+	/** Links, confirmation latencies and stats counters of every node */
+	boost::property_tree::ptree serialize () const;
+	/** @returns true on error */
+	bool write_json (std::filesystem::path const &) const;
+
+	std::vector<nano::keypair> const representatives;
+
+private:
+	class confirmation_tracker final
+	{
+	public:
+		void start (std::vector<std::shared_ptr<nano::block>> const & blocks, std::size_t nodes);
+		void cemented (std::size_t node, nano::block_hash const &);
+		bool done () const;
+
+		mutable nano::mutex mutex;
+		std::unordered_map<nano::block_hash, std::size_t> indices;
+		std::vector<std::chrono::steady_clock::time_point> started;
+		/** Latency per node and block, zero while the block is not cemented */
+		std::vector<std::vector<std::chrono::nanoseconds>> latencies;
+		std::size_t remaining{ 0 };
+	};
+
+	void link (std::size_t first, std::size_t second, nano::test::link_model const &);
+
+	nano::test::system & system;
+	nano::test::simulator_config const config;
+	std::shared_ptr<nano::test::link_scheduler> scheduler;
+	std::vector<std::shared_ptr<nano::node>> nodes;
+	/** Outgoing channels of every node by the index of the destination */
+	std::vector<std::unordered_map<std::size_t, std::shared_ptr<nano::test::simulated_channel>>> links;
+	// Shared with the cementing observers of the nodes, which cannot be removed
+	std::shared_ptr<confirmation_tracker> tracker;
+	mutable nano::mutex mutex;
+};
+}
@@ -5,6 +5,7 @@
 #include <nano/node/active_elections.hpp>
 #include <nano/node/endpoint.hpp>
 #include <nano/node/transport/tcp_listener.hpp>
+#include <nano/secure/block_corpus.hpp>
 #include <nano/secure/ledger.hpp>
 #include <nano/secure/ledger_set_any.hpp>
 #include <nano/test_common/system.hpp>
@@ -105,6 +106,11 @@ void nano::test::system::set_cemented_initialization_blocks (std::deque<std::sha
 	this->initialization_blocks_cemented = std::move (blocks);
 }
 
+void nano::test::system::set_initialization_corpus (std::filesystem::path const & path)
+{
+	this->initialization_corpus = path;
+}
+
 nano::node & nano::test::system::node (std::size_t index) const
 {
 	debug_assert (index < nodes.size ());
@@ -196,6 +202,18 @@ void nano::test::system::setup_node (nano::node & node)
 		})
 		!= cemented.end ());
 	}
+
+	if (initialization_corpus)
+	{
+		nano::block_corpus corpus{ *initialization_corpus };
+		for (uint64_t i = 0; i < corpus.block_count; ++i)
+		{
+			transaction.refresh_if_needed ();
+			auto result = node.ledger.process (transaction, corpus.next ());
+			// Corpus files are generated outside of the test, a mismatch with the ledger must not go unnoticed in release builds
+			release_assert (result == nano::block_status::progress, "corpus block " + std::to_string (i) + " failed to process: " + std::string{ nano::to_string (result) });
+		}
+	}
 }
 
 void nano::test::system::register_node (std::shared_ptr<nano::node> const & node)
@@ -5,6 +5,7 @@
 #include <nano/node/node.hpp>
 
 #include <chrono>
+#include <filesystem>
 #include <optional>
 
 namespace nano
@@ -29,6 +30,8 @@ namespace test
 
 		void set_initialization_blocks (std::deque<std::shared_ptr<nano::block>> blocks);
 		void set_cemented_initialization_blocks (std::deque<std::shared_ptr<nano::block>> blocks);
+		/** Blocks of the corpus at \p path, except its forks, are streamed into the ledger of every node added after the initialization blocks */
+		void set_initialization_corpus (std::filesystem::path const & path);
 
 		void ledger_initialization_set (std::deque<nano::keypair> const & reps, nano::amount const & reserve = 0);
 		void generate_activity (nano::node &, std::vector<nano::account> &);
@@ -95,6 +98,7 @@ namespace test
 		unsigned node_sequence{ 0 };
 		std::deque<std::shared_ptr<nano::block>> initialization_blocks;
 		std::deque<std::shared_ptr<nano::block>> initialization_blocks_cemented;
+		std::optional<std::filesystem::path> initialization_corpus;
 	};
 
 	std::shared_ptr<nano::state_block> upgrade_epoch (nano::work_pool &, nano::ledger &, nano::epoch);